@@ -42,6 +42,11 @@ function(create_vulkan_library)
 
     add_library(Anito3DVulkan STATIC
         ${CMAKE_CURRENT_SOURCE_DIR}/VulkanMain.cpp
+        ${CMAKE_CURRENT_SOURCE_DIR}/GpuProfiler.cpp
+        ${CMAKE_CURRENT_SOURCE_DIR}/FrameContext.cpp
+        ${CMAKE_CURRENT_SOURCE_DIR}/PipelineCache.cpp
+        ${CMAKE_CURRENT_SOURCE_DIR}/GpuMemoryAllocator.cpp
+        ${CMAKE_CURRENT_SOURCE_DIR}/StagingRing.cpp
         ${PROJ_EXTERNAL_PATH}/imgui-src/imgui.cpp
         ${PROJ_EXTERNAL_PATH}/imgui-src/imgui_draw.cpp
         ${PROJ_EXTERNAL_PATH}/imgui-src/imgui_widgets.cpp
@@ -51,6 +56,7 @@ function(create_vulkan_library)
     )
     target_include_directories(Anito3DVulkan PUBLIC
         ${CMAKE_CURRENT_SOURCE_DIR}
+        ${CMAKE_CURRENT_SOURCE_DIR}/../io
         ${vk_bootstrap_SOURCE_DIR}
         ${imgui_SOURCE_DIR}
         ${imgui_SOURCE_DIR}/backends
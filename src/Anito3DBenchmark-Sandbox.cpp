@@ -8,16 +8,32 @@
 
 #include "vulkanMain.hpp"
 #include "MeshEntity.hpp"
+#include "AssetImporter.hpp"
 #include "ImGuiMain.hpp"
+#include "BenchmarkOptions.hpp"
+#include "HeadlessRunner.hpp"
+#include "Trace.hpp"
 
 #define GLFW_EXPOSE_NATIVE_WIN32
 #include <GLFW/glfw3native.h>
 
-void loadModel(const std::string& modelPath);
 void loadModels(const std::vector<std::string>& modelPaths);
+void writeTrace(const Anito3D::BenchmarkOptions& options);
 void glfwErrorCallback(int error, const char* description);
 
 int main(int argc, char* argv[]) {
+    // Parse command line (headless benchmark mode skips GLFW/ImGui entirely)
+    Anito3D::BenchmarkOptions benchmarkOptions;
+    std::string argumentError;
+    if (!Anito3D::BenchmarkOptions::Parse(argc, argv, benchmarkOptions, argumentError)) {
+        std::cerr << argumentError << "\n" << Anito3D::BenchmarkOptions::Usage(argv[0]);
+        return 1;
+    }
+    if (benchmarkOptions.showHelp) {
+        std::cout << Anito3D::BenchmarkOptions::Usage(argv[0]);
+        return 0;
+    }
+
 	// Set up logging directory and file
     std::filesystem::create_directories(ANITO3DSANDBOX_LOG_PATH);
     std::string logFile = std::string(ANITO3DSANDBOX_LOG_PATH) + "/Anito3DLog";
@@ -29,13 +45,33 @@ int main(int argc, char* argv[]) {
 	std::cout << "Hello, Anito3D Benchmark Sandbox!" << std::endl;
     LOG(INFO) << "Starting Anito3DBenchmark-Sandbox";
 
+    if (!benchmarkOptions.tracePath.empty()) {
+        Anito3D::Trace::Start();
+        ANITO3D_TRACE_THREAD_NAME("Main");
+    }
+
+    if (benchmarkOptions.headless) {
+        Anito3D::HeadlessRunner headlessRunner(benchmarkOptions);
+        int exitCode = headlessRunner.Run();
+        LOG(INFO) << "Anito3DBenchmark-Sandbox headless run finished with exit code " << exitCode;
+        writeTrace(benchmarkOptions);
+        return exitCode;
+    }
+
     // Initialize GLFW
     glfwSetErrorCallback(glfwErrorCallback);
     if (!glfwInit()) {
         LOG(ERROR) << "Failed to initialize GLFW";
+        writeTrace(benchmarkOptions);
         return 1;
     }
 
+    Anito3D::VulkanSettings vulkanSettings;
+    vulkanSettings.framesInFlight = benchmarkOptions.framesInFlight;
+    Anito3D::VulkanSettings::parsePresentMode(benchmarkOptions.presentMode, vulkanSettings.presentMode);
+
+    // Lives across menu <-> renderer transitions; only the window and swapchain are recreated
+    Anito3D::VulkanMain vulkanMain;
     while (true) {
         // Create main menu window
         glfwWindowHint(GLFW_CLIENT_API, GLFW_NO_API);
@@ -43,21 +79,23 @@ int main(int argc, char* argv[]) {
         if (!window) {
             LOG(ERROR) << "Failed to create main menu window";
             glfwTerminate();
+            writeTrace(benchmarkOptions);
             return 1;
         }
         LOG(INFO) << "Main menu window created successfully";
 
-        // Initialize VulkanMain
-        Anito3D::VulkanMain vulkanMain;
+        // Initialize VulkanMain, or attach the new window to the existing device
         try {
-            if (!vulkanMain.init(window, 1280, 720)) {
+            if (!vulkanMain.init(window, 1280, 720, vulkanSettings)) {
                 LOG(ERROR) << "Failed to initialize VulkanMain";
+                vulkanMain.cleanup();
                 glfwDestroyWindow(window);
                 continue; // Retry main menu
             }
         }
         catch (const std::exception& e) {
             LOG(ERROR) << "VulkanMain initialization exception: " << e.what();
+            vulkanMain.cleanup();
             glfwDestroyWindow(window);
             continue;
         }
@@ -87,33 +125,50 @@ int main(int argc, char* argv[]) {
         }
         // Add cases for Diligent (2), Falcor (3), etc., later
 
-        // Cleanup main menu
-        vulkanMain.cleanup();
+        // Release the main menu window, keeping the device for the next one
+        vulkanMain.releaseWindow();
         glfwDestroyWindow(window);
 
     }
 
+    vulkanMain.cleanup();
 
     glfwTerminate();
     LOG(INFO) << "Anito3DBenchmark-Sandbox terminated";
+    writeTrace(benchmarkOptions);
 
     return 0;
 }
 
-void loadModel(const std::string& modelPath) {
-    Anito3D::MeshEntity meshEntity;
-    if (meshEntity.LoadMesh(modelPath)) {
-        LOG(INFO) << "Successfully loaded mesh with " << meshEntity.GetMeshData().vertices.size() << " vertices";
-    }
-    else {
-        LOG(ERROR) << "Failed to load mesh from " << modelPath;
+void loadModels(const std::vector<std::string>& modelPaths) {
+    Anito3D::AssetImportSummary summary = Anito3D::AssetImporter::ImportBatch(modelPaths);
+
+    for (const auto& result : summary.results) {
+        if (result.success) {
+            const Anito3D::MeshDataView meshView = result.entity->GetMeshView();
+            LOG(INFO) << "Successfully loaded mesh " << result.path << " with " << meshView.vertices.size() << " vertices in "
+                << meshView.subMeshes.size() << " submeshes (" << result.milliseconds << " ms"
+                << (result.fromCache ? ", cached" : "") << ")";
+        }
+        else {
+            LOG(ERROR) << "Failed to load mesh from " << result.path;
+        }
     }
+    LOG(INFO) << "Loaded " << summary.GetSuccessCount() << "/" << summary.results.size() << " models in "
+        << summary.wallMilliseconds << " ms on " << summary.threadCount << " threads (serial sum "
+        << summary.serialMilliseconds << " ms)";
 }
 
-void loadModels(const std::vector<std::string>& modelPaths) {
-    for (const auto& modelPath : modelPaths) {
-        loadModel(modelPath);
+void writeTrace(const Anito3D::BenchmarkOptions& options) {
+    if (options.tracePath.empty()) return;
+
+    Anito3D::Trace::Stop();
+    if (!Anito3D::Trace::WriteChromeJson(options.tracePath)) {
+        LOG(ERROR) << "Failed to write trace to " << options.tracePath;
+        return;
     }
+    LOG(INFO) << "Trace with " << Anito3D::Trace::GetEventCount() << " events written to " << options.tracePath
+        << " (" << Anito3D::Trace::GetDroppedEventCount() << " dropped)";
 }
 
 void glfwErrorCallback(int error, const char* description) {
@@ -0,0 +1,273 @@
+#include "BenchmarkOptions.hpp"
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <sstream>
+
+namespace Anito3D {
+
+    namespace {
+        bool ParseUnsigned(const std::string& text, uint32_t& value) {
+            if (text.empty() || !std::all_of(text.begin(), text.end(), [](unsigned char c) { return std::isdigit(c); })) {
+                return false;
+            }
+            try {
+                unsigned long parsed = std::stoul(text);
+                if (parsed > UINT32_MAX) return false;
+                value = static_cast<uint32_t>(parsed);
+            }
+            catch (const std::exception&) {
+                return false;
+            }
+            return true;
+        }
+
+        bool ParseFloat(const std::string& text, float& value) {
+            try {
+                size_t parsedLength = 0;
+                float parsed = std::stof(text, &parsedLength);
+                if (parsedLength != text.size() || !std::isfinite(parsed)) return false;
+                value = parsed;
+            }
+            catch (const std::exception&) {
+                return false;
+            }
+            return true;
+        }
+
+        void SplitList(const std::string& text, std::vector<std::string>& out) {
+            std::stringstream stream(text);
+            std::string item;
+            while (std::getline(stream, item, ',')) {
+                if (!item.empty()) out.push_back(item);
+            }
+        }
+    }
+
+    bool BenchmarkOptions::Parse(int argc, char* argv[], BenchmarkOptions& options, std::string& error) {
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+
+            // Options taking a value accept both "--key value" and "--key=value"
+            std::string value;
+            bool hasInlineValue = false;
+            size_t equalsPos = arg.find('=');
+            if (arg.rfind("--", 0) == 0 && equalsPos != std::string::npos) {
+                value = arg.substr(equalsPos + 1);
+                arg = arg.substr(0, equalsPos);
+                hasInlineValue = true;
+            }
+
+            auto nextValue = [&](std::string& out) {
+                if (hasInlineValue) {
+                    out = value;
+                    return true;
+                }
+                if (i + 1 >= argc) {
+                    error = "Missing value for " + arg;
+                    return false;
+                }
+                out = argv[++i];
+                return true;
+            };
+
+            if (arg == "--headless") {
+                options.headless = true;
+            }
+            else if (arg == "--help" || arg == "-h") {
+                options.showHelp = true;
+            }
+            else if (arg == "--renderer") {
+                if (!nextValue(options.renderer)) return false;
+                std::transform(options.renderer.begin(), options.renderer.end(), options.renderer.begin(),
+                    [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+            }
+            else if (arg == "--models" || arg == "--model") {
+                std::string list;
+                if (!nextValue(list)) return false;
+                SplitList(list, options.models);
+            }
+            else if (arg == "--scene") {
+                if (!nextValue(options.scene)) return false;
+            }
+            else if (arg == "--resolution") {
+                std::string res;
+                if (!nextValue(res)) return false;
+                if (!ParseResolution(res, options.width, options.height)) {
+                    error = "Invalid resolution: " + res + " (expected WIDTHxHEIGHT)";
+                    return false;
+                }
+            }
+            else if (arg == "--frames") {
+                std::string count;
+                if (!nextValue(count)) return false;
+                if (!ParseUnsigned(count, options.frames) || options.frames == 0) {
+                    error = "Invalid frame count: " + count;
+                    return false;
+                }
+            }
+            else if (arg == "--warmup") {
+                std::string count;
+                if (!nextValue(count)) return false;
+                if (!ParseUnsigned(count, options.warmupFrames)) {
+                    error = "Invalid warmup frame count: " + count;
+                    return false;
+                }
+            }
+            else if (arg == "--no-frame-stats") {
+                options.frameStats = false;
+            }
+            else if (arg == "--frames-in-flight") {
+                std::string count;
+                if (!nextValue(count)) return false;
+                if (!ParseUnsigned(count, options.framesInFlight) || options.framesInFlight < 1 || options.framesInFlight > 4) {
+                    error = "Invalid frames in flight: " + count + " (expected 1-4)";
+                    return false;
+                }
+            }
+            else if (arg == "--present-mode") {
+                if (!nextValue(options.presentMode)) return false;
+                std::transform(options.presentMode.begin(), options.presentMode.end(), options.presentMode.begin(),
+                    [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+                if (options.presentMode != "fifo" && options.presentMode != "mailbox" && options.presentMode != "immediate" && options.presentMode != "offscreen") {
+                    error = "Invalid present mode: " + options.presentMode + " (expected fifo, mailbox, immediate or offscreen)";
+                    return false;
+                }
+            }
+            else if (arg == "--threads") {
+                std::string count;
+                if (!nextValue(count)) return false;
+                if (!ParseUnsigned(count, options.threads)) {
+                    error = "Invalid thread count: " + count;
+                    return false;
+                }
+            }
+            else if (arg == "--import-threads") {
+                std::string count;
+                if (!nextValue(count)) return false;
+                if (!ParseUnsigned(count, options.importThreads)) {
+                    error = "Invalid import thread count: " + count;
+                    return false;
+                }
+            }
+            else if (arg == "--no-mesh-cache") {
+                options.useMeshCache = false;
+            }
+            else if (arg == "--copy-mesh-cache") {
+                options.copyMeshCache = true;
+            }
+            else if (arg == "--optimize-meshes") {
+                options.optimizeMeshes = true;
+            }
+            else if (arg == "--lods") {
+                options.generateLods = true;
+            }
+            else if (arg == "--weld") {
+                options.weldVertices = true;
+            }
+            else if (arg == "--weld-epsilon") {
+                std::string epsilon;
+                if (!nextValue(epsilon)) return false;
+                if (!ParseFloat(epsilon, options.weldEpsilon) || options.weldEpsilon < 0.0f) {
+                    error = "Invalid weld epsilon: " + epsilon;
+                    return false;
+                }
+                options.weldVertices = true;
+            }
+            else if (arg == "--no-narrow-indices") {
+                options.narrowIndices = false;
+            }
+            else if (arg == "--ray-tracing") {
+                options.rayTracing = true;
+            }
+            else if (arg == "--pbr") {
+                options.pbr = true;
+            }
+            else if (arg == "--gi") {
+                options.globalIllumination = true;
+            }
+            else if (arg == "--spp") {
+                std::string count;
+                if (!nextValue(count)) return false;
+                if (!ParseUnsigned(count, options.samplesPerPixel) || options.samplesPerPixel == 0) {
+                    error = "Invalid samples per pixel: " + count;
+                    return false;
+                }
+            }
+            else if (arg == "--image") {
+                if (!nextValue(options.imagePath)) return false;
+            }
+            else if (arg == "--micro") {
+                std::string list;
+                if (!nextValue(list)) return false;
+                SplitList(list, options.microBenchmarks);
+            }
+            else if (arg == "--gpu") {
+                options.gpuMicroBenchmarks = true;
+            }
+            else if (arg == "--report") {
+                if (!nextValue(options.reportPath)) return false;
+            }
+            else if (arg == "--trace") {
+                if (!nextValue(options.tracePath)) return false;
+            }
+            else {
+                error = "Unknown argument: " + arg;
+                return false;
+            }
+        }
+        return true;
+    }
+
+    std::string BenchmarkOptions::Usage(const char* programName) {
+        std::ostringstream usage;
+        usage << "Usage: " << (programName ? programName : "Anito3DBenchmarkSandbox") << " [options]\n"
+            << "  --headless              Run without a window or menu\n"
+            << "  --renderer <name>       Headless renderer to run: none, raytracer, software (default: none)\n"
+            << "  --models <a,b,...>      Comma separated model paths to load\n"
+            << "  --scene <path>          Scene file to load\n"
+            << "  --resolution <WxH>      Render resolution (default: 1280x720)\n"
+            << "  --frames <N>            Measured frames (default: 300)\n"
+            << "  --warmup <N>            Warmup frames before measuring (default: 30)\n"
+            << "  --no-frame-stats        Skip per-phase frame timing\n"
+            << "  --frames-in-flight <N>  Frames recorded ahead of the GPU in the Vulkan window, 1-4 (default: 2)\n"
+            << "  --present-mode <mode>   Vulkan window presentation: fifo, mailbox, immediate, offscreen (default: fifo)\n"
+            << "  --threads <N>           Job system threads (default: 0 = all cores, 1 = main thread only)\n"
+            << "  --import-threads <N>    Asset import threads (default: 0 = as --threads, 1 = serial)\n"
+            << "  --no-mesh-cache         Always import through Assimp\n"
+            << "  --copy-mesh-cache       Copy cache hits out of the mapped file at load time\n"
+            << "  --optimize-meshes       Optimize index/vertex order after import\n"
+            << "  --lods                  Generate an LOD chain for every loaded model\n"
+            << "  --weld                  Merge duplicate vertices after import\n"
+            << "  --weld-epsilon <e>      Weld vertices whose attributes are within distance e (implies --weld)\n"
+            << "  --no-narrow-indices     Keep 32-bit indices\n"
+            << "  --ray-tracing           Traced shadows and reflections\n"
+            << "  --pbr                   Metallic/roughness shading\n"
+            << "  --gi                    Path-traced indirect lighting\n"
+            << "  --spp <N>               Samples per pixel per frame (default: 1)\n"
+            << "  --image <path>          Output image, .ppm or .pfm (default: Anito3DFrame.ppm)\n"
+            << "  --micro <a,b,...|all>   CPU micro benchmark suites to run after loading\n"
+            << "  --gpu                   Allow the micro suites that need a Vulkan device (gpuUpload, pipelineCache)\n"
+            << "  --report <path>         JSON report output path\n"
+            << "  --trace <path>          Record a Chrome/Perfetto trace of the run\n"
+            << "  --help                  Show this help\n";
+        return usage.str();
+    }
+
+    bool BenchmarkOptions::ParseResolution(const std::string& text, uint32_t& width, uint32_t& height) {
+        size_t xPos = text.find('x');
+        if (xPos == std::string::npos) return false;
+
+        uint32_t w = 0, h = 0;
+        if (!ParseUnsigned(text.substr(0, xPos), w) || !ParseUnsigned(text.substr(xPos + 1), h)) return false;
+        if (w == 0 || h == 0) return false;
+
+        width = w;
+        height = h;
+        return true;
+    }
+
+    std::string BenchmarkOptions::GetResolutionString() const {
+        return std::to_string(width) + "x" + std::to_string(height);
+    }
+}
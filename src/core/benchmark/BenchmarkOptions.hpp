@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Anito3D {
+
+    // Settings for a benchmark run. Filled either from the command line (headless)
+    // or mirrored from the ImGuiMain selections.
+    struct BenchmarkOptions {
+        bool headless = false;
+        bool showHelp = false;
+
+        std::string renderer = "none";
+        std::vector<std::string> models;
+        std::string scene;
+        uint32_t width = 1280;
+        uint32_t height = 720;
+
+        uint32_t frames = 300;     // Measured frames
+        uint32_t warmupFrames = 30; // Frames run before measurement starts
+        bool frameStats = true;     // Per-phase frame timing, histogram and stutter detection
+        uint32_t framesInFlight = 2; // Frames the CPU may record ahead of the GPU in the Vulkan window (1-4)
+        std::string presentMode = "fifo"; // Vulkan window presentation: fifo, mailbox, immediate or offscreen
+
+        bool useMeshCache = true;  // Load/store the binary mesh cache
+        bool copyMeshCache = false; // Copy cache hits into owned arrays instead of reading the mapped file
+        uint32_t threads = 0;       // Job system threads for import and per-frame work (0 = all hardware threads, 1 = main thread only)
+        uint32_t importThreads = 0; // Asset import threads (0 = the job system's)
+        bool optimizeMeshes = false; // Vertex cache/overdraw/fetch optimization after import
+        bool weldVertices = false;   // Merge duplicate vertices after import
+        bool narrowIndices = true;   // Switch ranges under 65536 vertices to 16-bit indices
+        float weldEpsilon = 0.0f;    // Weld tolerance for position/normal/uv (0 = exact)
+        bool generateLods = false;   // Build a simplified LOD chain for every loaded model
+
+        // Feature toggles (the menu's Ray Tracing / PBR / Global Illumination checkboxes)
+        bool rayTracing = false;
+        bool pbr = false;
+        bool globalIllumination = false;
+        uint32_t samplesPerPixel = 1; // Per frame, for accumulating renderers
+        std::string imagePath = "Anito3DFrame.ppm"; // Final image of image-producing renderers (.ppm or .pfm, empty = none)
+
+        std::vector<std::string> microBenchmarks; // CPU micro benchmark suites to run ("all" for every suite)
+        bool gpuMicroBenchmarks = false;          // Also allow the suites that create a headless Vulkan device
+
+        std::string reportPath = "Anito3DBenchmarkReport.json";
+        std::string tracePath; // Chrome trace JSON of the whole run (empty = not traced)
+
+        // Parse command line arguments, returns false and fills error on invalid input
+        static bool Parse(int argc, char* argv[], BenchmarkOptions& options, std::string& error);
+        static std::string Usage(const char* programName);
+
+        // Parse "WIDTHxHEIGHT" (same format as the ImGuiMain resolution list)
+        static bool ParseResolution(const std::string& text, uint32_t& width, uint32_t& height);
+
+        std::string GetResolutionString() const;
+    };
+
+}
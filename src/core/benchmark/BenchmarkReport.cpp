@@ -0,0 +1,235 @@
+#include "BenchmarkReport.hpp"
+#include "JsonWriter.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <numeric>
+#include <ng-log/logging.h>
+
+namespace Anito3D {
+
+    FrameTimeSummary FrameTimeSummary::Compute(std::vector<double> samples) {
+        FrameTimeSummary summary;
+        if (samples.empty()) return summary;
+
+        std::sort(samples.begin(), samples.end());
+        summary.count = samples.size();
+        summary.min = samples.front();
+        summary.max = samples.back();
+        summary.mean = std::accumulate(samples.begin(), samples.end(), 0.0) / static_cast<double>(samples.size());
+
+        double variance = 0.0;
+        for (double sample : samples) {
+            variance += (sample - summary.mean) * (sample - summary.mean);
+        }
+        summary.stdDev = std::sqrt(variance / static_cast<double>(samples.size()));
+
+        summary.p50 = Percentile(samples, 50.0);
+        summary.p90 = Percentile(samples, 90.0);
+        summary.p95 = Percentile(samples, 95.0);
+        summary.p99 = Percentile(samples, 99.0);
+        return summary;
+    }
+
+    double FrameTimeSummary::Percentile(const std::vector<double>& sortedSamples, double percentile) {
+        if (sortedSamples.empty()) return 0.0;
+
+        double rank = std::clamp(percentile, 0.0, 100.0) / 100.0 * static_cast<double>(sortedSamples.size() - 1);
+        size_t lower = static_cast<size_t>(std::floor(rank));
+        size_t upper = std::min(lower + 1, sortedSamples.size() - 1);
+        double fraction = rank - static_cast<double>(lower);
+        return sortedSamples[lower] + (sortedSamples[upper] - sortedSamples[lower]) * fraction;
+    }
+
+    void BenchmarkReport::CaptureMemory(const std::string& label) {
+        memorySnapshots.emplace_back(label, QueryProcessMemory());
+    }
+
+    void BenchmarkReport::SetMetric(const std::string& section, const std::string& key, const MetricValue& value) {
+        auto sectionIt = std::find_if(sections.begin(), sections.end(),
+            [&](const Section& s) { return s.name == section; });
+        if (sectionIt == sections.end()) {
+            sections.push_back({ section, {} });
+            sectionIt = sections.end() - 1;
+        }
+
+        auto valueIt = std::find_if(sectionIt->values.begin(), sectionIt->values.end(),
+            [&](const auto& entry) { return entry.first == key; });
+        if (valueIt != sectionIt->values.end()) {
+            valueIt->second = value;
+        }
+        else {
+            sectionIt->values.emplace_back(key, value);
+        }
+    }
+
+    bool BenchmarkReport::WriteJson(const std::string& path) const {
+        std::filesystem::path outputPath(path);
+        if (outputPath.has_parent_path()) {
+            std::error_code ec;
+            std::filesystem::create_directories(outputPath.parent_path(), ec);
+        }
+
+        std::ofstream file(outputPath);
+        if (!file) {
+            LOG(ERROR) << "Failed to open benchmark report for writing: " << path;
+            return false;
+        }
+
+        JsonWriter writer(file);
+        Write(writer);
+        file << '\n';
+
+        if (!file) {
+            LOG(ERROR) << "Failed to write benchmark report: " << path;
+            return false;
+        }
+        LOG(INFO) << "Benchmark report written to " << path;
+        return true;
+    }
+
+    void BenchmarkReport::Write(JsonWriter& writer) const {
+        writer.BeginObject();
+        writer.Field("version", 1);
+
+        std::time_t now = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+        char timestamp[32] = {};
+        std::strftime(timestamp, sizeof(timestamp), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&now));
+        writer.Field("timestamp", timestamp);
+
+        // Run configuration
+        writer.Key("config");
+        writer.BeginObject();
+        writer.Field("headless", options.headless);
+        writer.Field("renderer", options.renderer);
+        writer.Key("models");
+        writer.BeginArray();
+        for (const auto& model : options.models) writer.Value(model);
+        writer.EndArray();
+        writer.Field("scene", options.scene);
+        writer.Field("resolution", options.GetResolutionString());
+        writer.Field("frames", options.frames);
+        writer.Field("warmupFrames", options.warmupFrames);
+        writer.Field("frameStats", options.frameStats);
+        writer.Field("meshCache", options.useMeshCache);
+        writer.Field("threads", options.threads);
+        writer.Field("importThreads", options.importThreads);
+        writer.Field("optimizeMeshes", options.optimizeMeshes);
+        writer.Field("weldVertices", options.weldVertices);
+        writer.Field("narrowIndices", options.narrowIndices);
+        writer.Field("weldEpsilon", static_cast<double>(options.weldEpsilon));
+        writer.Field("lods", options.generateLods);
+        writer.Field("copyMeshCache", options.copyMeshCache);
+        writer.Field("rayTracing", options.rayTracing);
+        writer.Field("pbr", options.pbr);
+        writer.Field("globalIllumination", options.globalIllumination);
+        writer.Field("samplesPerPixel", options.samplesPerPixel);
+        writer.Field("imagePath", options.imagePath);
+        writer.Field("tracePath", options.tracePath);
+        writer.Key("micro");
+        writer.BeginArray();
+        for (const auto& suite : options.microBenchmarks) writer.Value(suite);
+        writer.EndArray();
+        writer.Field("gpuMicro", options.gpuMicroBenchmarks);
+        writer.EndObject();
+
+        // Asset loading
+        writer.Key("load");
+        writer.BeginObject();
+        writer.Field("totalMs", totalLoadMilliseconds);
+        writer.Key("files");
+        writer.BeginArray();
+        for (const auto& record : fileLoads) {
+            writer.BeginObject();
+            writer.Field("path", record.path);
+            writer.Field("success", record.success);
+            writer.Field("fromCache", record.fromCache);
+            writer.Field("storage", record.storage);
+            writer.Field("ms", record.milliseconds);
+            writer.Field("vertices", record.vertexCount);
+            writer.Field("indices", record.indexCount);
+            writer.Field("subMeshes", record.subMeshCount);
+            writer.EndObject();
+        }
+        writer.EndArray();
+        writer.EndObject();
+
+        // Frame timings
+        FrameTimeSummary summary = FrameTimeSummary::Compute(frameTimes);
+        writer.Key("frames");
+        writer.BeginObject();
+        writer.Field("count", static_cast<uint64_t>(summary.count));
+        writer.Field("meanMs", summary.mean);
+        writer.Field("stdDevMs", summary.stdDev);
+        writer.Field("minMs", summary.min);
+        writer.Field("maxMs", summary.max);
+        writer.Field("p50Ms", summary.p50);
+        writer.Field("p90Ms", summary.p90);
+        writer.Field("p95Ms", summary.p95);
+        writer.Field("p99Ms", summary.p99);
+        writer.Field("fps", summary.mean > 0.0 ? 1000.0 / summary.mean : 0.0);
+        writer.Key("cpuMs");
+        writer.BeginArray();
+        for (double frameTime : frameTimes) writer.Value(frameTime);
+        writer.EndArray();
+        if (frameStatistics.frames > 0) {
+            writer.Key("phases");
+            writer.BeginObject();
+            auto writePhase = [&](const FramePhaseStatistics& phase) {
+                writer.Key(phase.name);
+                writer.BeginObject();
+                writer.Field("meanMs", phase.mean);
+                writer.Field("p50Ms", phase.p50);
+                writer.Field("p95Ms", phase.p95);
+                writer.Field("p99Ms", phase.p99);
+                writer.Field("maxMs", phase.max);
+                writer.EndObject();
+            };
+            for (const auto& phase : frameStatistics.phases) writePhase(phase);
+            if (frameStatistics.gpuFrames > 0) writePhase(frameStatistics.gpu);
+            writer.EndObject();
+            writer.Key("histogram");
+            writer.BeginArray();
+            for (size_t bucket = 0; bucket < frameStatistics.histogram.size(); ++bucket) {
+                writer.BeginObject();
+                if (bucket < FrameStatistics::HistogramBounds.size()) writer.Field("upToMs", FrameStatistics::HistogramBounds[bucket]);
+                writer.Field("frames", static_cast<uint64_t>(frameStatistics.histogram[bucket]));
+                writer.EndObject();
+            }
+            writer.EndArray();
+            writer.Field("stutters", static_cast<uint64_t>(frameStatistics.stutters));
+        }
+        writer.EndObject();
+
+        // Memory high-water marks
+        writer.Key("memory");
+        writer.BeginObject();
+        for (const auto& [label, stats] : memorySnapshots) {
+            writer.Key(label);
+            writer.BeginObject();
+            writer.Field("residentBytes", stats.currentResidentBytes);
+            writer.Field("peakResidentBytes", stats.peakResidentBytes);
+            writer.EndObject();
+        }
+        writer.EndObject();
+
+        // Subsystem metrics
+        writer.Key("metrics");
+        writer.BeginObject();
+        for (const auto& section : sections) {
+            writer.Key(section.name);
+            writer.BeginObject();
+            for (const auto& [key, value] : section.values) {
+                writer.Key(key);
+                std::visit([&](const auto& v) { writer.Value(v); }, value);
+            }
+            writer.EndObject();
+        }
+        writer.EndObject();
+
+        writer.EndObject();
+    }
+}
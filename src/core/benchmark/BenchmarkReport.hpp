@@ -0,0 +1,91 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "BenchmarkOptions.hpp"
+#include "FrameProfiler.hpp"
+#include "ProcessMemory.hpp"
+
+namespace Anito3D {
+
+    class JsonWriter;
+
+    // Per-file load result
+    struct FileLoadRecord {
+        std::string path;
+        bool success = false;
+        bool fromCache = false;
+        std::string storage; // ToString(MeshStorage): imported, cacheMapped or cacheCopied
+        double milliseconds = 0.0;
+        uint64_t vertexCount = 0;
+        uint64_t indexCount = 0;
+        uint64_t subMeshCount = 0;
+    };
+
+    // Summary statistics over a set of frame times (milliseconds)
+    struct FrameTimeSummary {
+        size_t count = 0;
+        double mean = 0.0;
+        double stdDev = 0.0;
+        double min = 0.0;
+        double max = 0.0;
+        double p50 = 0.0;
+        double p90 = 0.0;
+        double p95 = 0.0;
+        double p99 = 0.0;
+
+        static FrameTimeSummary Compute(std::vector<double> samples);
+        // Linearly interpolated percentile over sorted samples, percentile in [0, 100]
+        static double Percentile(const std::vector<double>& sortedSamples, double percentile);
+    };
+
+    // Collects everything measured during a benchmark run and serializes it as JSON.
+    // Subsystems add their own numbers through SetMetric so the report layout stays stable.
+    class BenchmarkReport {
+    public:
+        using MetricValue = std::variant<double, uint64_t, bool, std::string>;
+
+        BenchmarkReport() = default;
+
+        void SetOptions(const BenchmarkOptions& options) { this->options = options; }
+        const BenchmarkOptions& GetOptions() const { return options; }
+
+        void AddFileLoad(const FileLoadRecord& record) { fileLoads.push_back(record); }
+        void SetTotalLoadTime(double milliseconds) { totalLoadMilliseconds = milliseconds; }
+
+        void ReserveFrames(size_t count) { frameTimes.reserve(count); }
+        void AddFrameTime(double milliseconds) { frameTimes.push_back(milliseconds); }
+        const std::vector<double>& GetFrameTimes() const { return frameTimes; }
+
+        // Per-phase breakdown, histogram and stutters of the measured frames (see FrameProfiler)
+        void SetFrameStatistics(const FrameStatistics& statistics) { frameStatistics = statistics; }
+
+        // Record a memory high-water mark snapshot under the given label (e.g. "afterLoad")
+        void CaptureMemory(const std::string& label);
+
+        // Free-form metrics grouped by section, kept in insertion order
+        void SetMetric(const std::string& section, const std::string& key, const MetricValue& value);
+
+        bool WriteJson(const std::string& path) const;
+        void Write(JsonWriter& writer) const;
+
+    private:
+        struct Section {
+            std::string name;
+            std::vector<std::pair<std::string, MetricValue>> values;
+        };
+
+        BenchmarkOptions options;
+        std::vector<FileLoadRecord> fileLoads;
+        double totalLoadMilliseconds = 0.0;
+        std::vector<double> frameTimes;
+        FrameStatistics frameStatistics;
+        std::vector<std::pair<std::string, ProcessMemoryStats>> memorySnapshots;
+        std::vector<Section> sections;
+    };
+
+}
@@ -0,0 +1,111 @@
+#include "MicroBenchmarks.hpp"
+#include "Bvh.hpp"
+#include "ThreadPool.hpp"
+#include <random>
+#include <ng-log/logging.h>
+
+namespace Anito3D {
+
+    namespace {
+        constexpr uint32_t BuildRepeats = 3;
+        constexpr uint32_t CollapseRepeats = 3;
+        constexpr size_t RayCount = 500000;
+
+        // Rays from a sphere around the scene towards random points inside its box, so most
+        // of them reach the geometry and some miss it
+        std::vector<Ray> GenerateRays(const MeshData::Bounds& bounds) {
+            std::mt19937 random(42);
+            std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+            std::normal_distribution<float> normal(0.0f, 1.0f);
+            std::vector<Ray> rays(RayCount);
+            const float radius = std::max(bounds.radius, 1e-3f) * 2.0f;
+            for (Ray& ray : rays) {
+                glm::vec3 direction(normal(random), normal(random), normal(random));
+                if (glm::dot(direction, direction) < 1e-6f) direction = glm::vec3(0.0f, 0.0f, 1.0f);
+                ray.origin = bounds.center + glm::normalize(direction) * radius;
+                const glm::vec3 target = glm::mix(bounds.min, bounds.max, glm::vec3(unit(random), unit(random), unit(random)));
+                ray.direction = glm::normalize(target - ray.origin);
+            }
+            return rays;
+        }
+
+        template <typename Tree>
+        double TraceRays(const Tree& tree, const std::vector<Ray>& rays, std::vector<RayHit>& hits) {
+            return MicroBenchmarks::MeasureBest(1, [&]() {
+                for (size_t i = 0; i < rays.size(); ++i) {
+                    hits[i] = {};
+                    tree.Intersect(rays[i], hits[i]);
+                }
+            });
+        }
+    }
+
+    void RunBvhBenchmark(MicroBenchmarkContext& context) {
+        const std::string suite = "bvh";
+        BenchmarkReport& report = context.report;
+        ThreadPool pool;
+        report.SetMetric(suite, "threads", static_cast<uint64_t>(pool.GetThreadCount() + 1));
+        report.SetMetric(suite, "rays", static_cast<uint64_t>(RayCount));
+
+        for (const auto& mesh : context.GetMeshes()) {
+            const std::string prefix = mesh.name + ".";
+            const BvhBuildOptions options;
+
+            BvhBuildStatistics serial, parallel;
+            const double serialMs = MicroBenchmarks::MeasureBest(BuildRepeats, [&]() { Bvh::Build(*mesh.meshData, options, nullptr, &serial); });
+            Bvh bvh;
+            const double parallelMs = MicroBenchmarks::MeasureBest(BuildRepeats, [&]() { bvh = Bvh::Build(*mesh.meshData, options, &pool, &parallel); });
+            if (bvh.IsEmpty()) continue;
+
+            report.SetMetric(suite, prefix + "triangles", parallel.triangles);
+            report.SetMetric(suite, prefix + "serialBuildMs", serialMs);
+            report.SetMetric(suite, prefix + "parallelBuildMs", parallelMs);
+            report.SetMetric(suite, prefix + "buildSpeedup", parallelMs > 0.0 ? serialMs / parallelMs : 0.0);
+            report.SetMetric(suite, prefix + "buildTasks", parallel.tasks);
+            report.SetMetric(suite, prefix + "nodes", parallel.nodes);
+            report.SetMetric(suite, prefix + "leaves", parallel.leaves);
+            report.SetMetric(suite, prefix + "maxDepth", static_cast<uint64_t>(parallel.maxDepth));
+            report.SetMetric(suite, prefix + "sahCost", static_cast<double>(parallel.sahCost));
+            report.SetMetric(suite, prefix + "serialSahCost", static_cast<double>(serial.sahCost));
+            report.SetMetric(suite, prefix + "nodeMemoryBytes", static_cast<uint64_t>(bvh.GetNodes().size() * sizeof(BvhNode)));
+            LOG(INFO) << "BVH " << mesh.name << " (" << parallel.triangles << " triangles): " << serialMs << " ms serial, " << parallelMs
+                << " ms parallel (" << parallel.tasks << " tasks), " << parallel.nodes << " nodes, " << parallel.leaves << " leaves, depth "
+                << parallel.maxDepth << ", SAH cost " << parallel.sahCost;
+
+            Bvh4 bvh4;
+            Bvh8 bvh8;
+            const double collapse4Ms = MicroBenchmarks::MeasureBest(CollapseRepeats, [&]() { bvh4 = Bvh4::Collapse(bvh); });
+            const double collapse8Ms = MicroBenchmarks::MeasureBest(CollapseRepeats, [&]() { bvh8 = Bvh8::Collapse(bvh); });
+            report.SetMetric(suite, prefix + "wide4.nodes", static_cast<uint64_t>(bvh4.GetNodes().size()));
+            report.SetMetric(suite, prefix + "wide4.collapseMs", collapse4Ms);
+            report.SetMetric(suite, prefix + "wide8.nodes", static_cast<uint64_t>(bvh8.GetNodes().size()));
+            report.SetMetric(suite, prefix + "wide8.collapseMs", collapse8Ms);
+
+            // Closest-hit throughput; the wide trees must agree with the binary one
+            const std::vector<Ray> rays = GenerateRays(mesh.meshData->bounds);
+            std::vector<RayHit> binaryHits(rays.size()), wideHits(rays.size());
+            const double binaryMs = TraceRays(bvh, rays, binaryHits);
+            uint64_t hitCount = 0;
+            for (const RayHit& hit : binaryHits) hitCount += hit.IsHit();
+            report.SetMetric(suite, prefix + "binary.mraysPerSecond", binaryMs > 0.0 ? rays.size() / (binaryMs * 1000.0) : 0.0);
+            report.SetMetric(suite, prefix + "hitRate", static_cast<double>(hitCount) / rays.size());
+
+            auto traceWide = [&](const auto& tree, const std::string& name) {
+                const double ms = TraceRays(tree, rays, wideHits);
+                uint64_t mismatches = 0;
+                for (size_t i = 0; i < rays.size(); ++i) {
+                    // Equal-distance hits on shared edges may resolve to either triangle
+                    mismatches += binaryHits[i].IsHit() != wideHits[i].IsHit() || binaryHits[i].t != wideHits[i].t;
+                }
+                report.SetMetric(suite, prefix + name + ".mraysPerSecond", ms > 0.0 ? rays.size() / (ms * 1000.0) : 0.0);
+                report.SetMetric(suite, prefix + name + ".matchesBinary", mismatches == 0);
+                LOG(INFO) << "BVH " << mesh.name << " " << name << ": " << tree.GetNodes().size() << " nodes, "
+                    << rays.size() / (ms * 1000.0) << " Mrays/s" << (mismatches == 0 ? "" : " (MISMATCH)");
+            };
+            LOG(INFO) << "BVH " << mesh.name << " binary: " << rays.size() / (binaryMs * 1000.0) << " Mrays/s, "
+                << 100.0 * hitCount / rays.size() << "% hit";
+            traceWide(bvh4, "wide4");
+            traceWide(bvh8, "wide8");
+        }
+    }
+}
@@ -0,0 +1,145 @@
+#include "MicroBenchmarks.hpp"
+#include "Components.hpp"
+#include "Entity.hpp"
+#include "SystemScheduler.hpp"
+#include "ThreadPool.hpp"
+#include "World.hpp"
+#include <algorithm>
+#include <ng-log/logging.h>
+#include <random>
+
+namespace Anito3D {
+
+    namespace {
+        constexpr size_t EntityCounts[] = { 100000, 1000000 };
+        constexpr uint32_t Frames = 10;
+        constexpr float DeltaTime = 1.0f / 60.0f;
+
+        // Custom components of the benchmark
+        struct Velocity {
+            glm::vec3 linear;
+            glm::vec3 angular; // Axis * radians per second
+        };
+        struct Lifetime {
+            float age = 0.0f;
+        };
+
+        // The object-oriented path: one heap object per entity, per-frame work in a virtual Update
+        class MovingEntity : public Entity {
+        public:
+            MovingEntity(const glm::vec3& start, const Velocity& velocity, float localRadius)
+                : velocity(velocity), localRadius(localRadius) {
+                position = start;
+            }
+
+            void Update(float deltaTime) override {
+                position += velocity.linear * deltaTime;
+                rotation += glm::degrees(velocity.angular) * deltaTime;
+                age += deltaTime;
+                world = GetLocalMatrix();
+                boundsCenter = glm::vec3(world[3]);
+                boundsRadius = localRadius * std::max({ scale.x, scale.y, scale.z });
+            }
+
+            float GetBoundsRadius() const { return boundsRadius; }
+
+        private:
+            Velocity velocity;
+            float localRadius;
+            float age = 0.0f;
+            glm::mat4 world{ 1.0f };
+            glm::vec3 boundsCenter{ 0.0f };
+            float boundsRadius = 0.0f;
+        };
+
+        void AddMovementSystems(SystemScheduler& scheduler) {
+            scheduler.Add<const Velocity, Transform>("move", [](float deltaTime, uint32_t count, const Velocity* velocities, Transform* transforms) {
+                for (uint32_t i = 0; i < count; ++i) {
+                    transforms[i].position += velocities[i].linear * deltaTime;
+                    transforms[i].rotation = glm::normalize(glm::quat(velocities[i].angular * deltaTime) * transforms[i].rotation);
+                }
+            });
+            // Touches nothing "move" uses, so it shares its phase
+            scheduler.Add<Lifetime>("age", [](float deltaTime, uint32_t count, Lifetime* lifetimes) {
+                for (uint32_t i = 0; i < count; ++i) lifetimes[i].age += deltaTime;
+            });
+            AddTransformSystems(scheduler);
+        }
+
+        template <typename F>
+        double MeasureFrames(F&& frame) {
+            return MicroBenchmarks::MeasureBest(1, [&]() {
+                for (uint32_t i = 0; i < Frames; ++i) frame();
+            }) / Frames;
+        }
+    }
+
+    void RunEcsBenchmark(MicroBenchmarkContext& context) {
+        const std::string suite = "ecs";
+        BenchmarkReport& report = context.report;
+
+        ThreadPool pool;
+        report.SetMetric(suite, "threads", static_cast<uint64_t>(pool.GetThreadCount() + 1));
+
+        const std::vector<MicroBenchmarkMesh> meshes = context.GetMeshes();
+        std::vector<MeshReference> meshReferences;
+        for (const auto& mesh : meshes) meshReferences.push_back(MeshReference::FromMeshData(*mesh.meshData));
+
+        for (size_t count : EntityCounts) {
+            std::mt19937 random(1234);
+            std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+            auto randomVector = [&](float scale) { return glm::vec3(unit(random), unit(random), unit(random)) * scale; };
+
+            // Object-oriented baseline, visited in allocation order and in a shuffled order
+            // (entities created and destroyed over time end up scattered across the heap)
+            std::vector<std::unique_ptr<MovingEntity>> objects;
+            objects.reserve(count);
+            for (size_t i = 0; i < count; ++i) {
+                const MeshReference& mesh = meshReferences[i % meshReferences.size()];
+                objects.push_back(std::make_unique<MovingEntity>(randomVector(100.0f), Velocity{ randomVector(1.0f), randomVector(0.5f) }, mesh.localRadius));
+            }
+            double virtualMs = MeasureFrames([&]() {
+                for (auto& object : objects) object->Update(DeltaTime);
+            });
+            std::shuffle(objects.begin(), objects.end(), random);
+            double virtualShuffledMs = MeasureFrames([&]() {
+                for (auto& object : objects) object->Update(DeltaTime);
+            });
+            objects.clear();
+
+            // Same work as chunk systems; every fourth entity has a Lifetime, giving two archetypes
+            World world;
+            for (size_t i = 0; i < count; ++i) {
+                const MeshReference& mesh = meshReferences[i % meshReferences.size()];
+                Transform transform;
+                transform.position = randomVector(100.0f);
+                const Velocity velocity{ randomVector(1.0f), randomVector(0.5f) };
+                if (i % 4 == 0) world.Create(transform, velocity, WorldTransform{}, mesh, WorldBounds{}, Lifetime{});
+                else world.Create(transform, velocity, WorldTransform{}, mesh, WorldBounds{});
+            }
+            SystemScheduler scheduler;
+            AddMovementSystems(scheduler);
+
+            double ecsMs = MeasureFrames([&]() { scheduler.Run(world, DeltaTime); });
+            double ecsParallelMs = MeasureFrames([&]() { scheduler.Run(world, DeltaTime, &pool); });
+
+            size_t chunks = 0;
+            for (const auto& archetype : world.GetArchetypes()) chunks += archetype->GetChunkCount();
+
+            const std::string prefix = std::to_string(count);
+            report.SetMetric(suite, prefix + ".virtualMs", virtualMs);
+            report.SetMetric(suite, prefix + ".virtualShuffledMs", virtualShuffledMs);
+            report.SetMetric(suite, prefix + ".ecsMs", ecsMs);
+            report.SetMetric(suite, prefix + ".ecsParallelMs", ecsParallelMs);
+            report.SetMetric(suite, prefix + ".speedup", ecsMs > 0.0 ? virtualShuffledMs / ecsMs : 0.0);
+            report.SetMetric(suite, prefix + ".parallelSpeedup", ecsParallelMs > 0.0 ? virtualShuffledMs / ecsParallelMs : 0.0);
+            report.SetMetric(suite, prefix + ".archetypes", static_cast<uint64_t>(world.GetArchetypes().size()));
+            report.SetMetric(suite, prefix + ".chunks", static_cast<uint64_t>(chunks));
+            report.SetMetric(suite, prefix + ".phases", static_cast<uint64_t>(scheduler.GetPhases().size()));
+
+            LOG(INFO) << "ECS " << count << " entities: virtual Update " << virtualMs << " ms (" << virtualShuffledMs
+                << " ms scattered), systems " << ecsMs << " ms, parallel " << ecsParallelMs << " ms per frame ("
+                << scheduler.GetSystemCount() << " systems in " << scheduler.GetPhases().size() << " phases, " << chunks << " chunks)";
+        }
+    }
+}
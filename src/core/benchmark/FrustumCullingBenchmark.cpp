@@ -0,0 +1,131 @@
+#include "MicroBenchmarks.hpp"
+#include "FrustumCuller.hpp"
+#include "MeshBounds.hpp"
+#include "ThreadPool.hpp"
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <glm/gtc/constants.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <ng-log/logging.h>
+
+namespace Anito3D {
+
+    namespace {
+        constexpr size_t ObjectCount = 1000000;
+        constexpr uint32_t Frames = 60;
+        constexpr uint32_t BoundsRepeats = 5;
+        constexpr float WorldExtent = 1000.0f; // Objects fill [-extent, extent]^3
+        constexpr float FieldOfView = 60.0f;
+        constexpr float AspectRatio = 16.0f / 9.0f;
+
+        // Camera circling inside the object field, looking tangentially and slightly down
+        glm::mat4 OrbitViewProjection(uint32_t frame) {
+            const float angle = static_cast<float>(frame) / Frames * 2.0f * glm::pi<float>();
+            const glm::vec3 eye(std::cos(angle) * WorldExtent * 0.5f, WorldExtent * 0.1f, std::sin(angle) * WorldExtent * 0.5f);
+            const glm::vec3 forward(-std::sin(angle), -0.2f, std::cos(angle));
+            const glm::mat4 projection = glm::perspective(glm::radians(FieldOfView), AspectRatio, 0.5f, WorldExtent);
+            return projection * glm::lookAt(eye, eye + forward, glm::vec3(0.0f, 1.0f, 0.0f));
+        }
+    }
+
+    void RunFrustumCullingBenchmark(MicroBenchmarkContext& context) {
+        const std::string suite = "frustumCulling";
+        BenchmarkReport& report = context.report;
+
+        // Load-time bounds: SIMD min/max against the scalar loop over every loaded mesh
+        for (const auto& mesh : context.GetMeshes()) {
+            const std::span<const glm::vec3> positions(mesh.meshData->vertices);
+            glm::vec3 scalarMin, scalarMax, simdMin, simdMax;
+            const double scalarMs = MicroBenchmarks::MeasureBest(BoundsRepeats, [&]() { MeshBounds::ComputeMinMaxScalar(positions, scalarMin, scalarMax); });
+            const double simdMs = MicroBenchmarks::MeasureBest(BoundsRepeats, [&]() { MeshBounds::ComputeMinMax(positions, simdMin, simdMax); });
+            const double boundsMs = MicroBenchmarks::MeasureBest(BoundsRepeats, [&]() { MeshBounds::Compute(positions); });
+
+            report.SetMetric(suite, mesh.name + ".minMaxScalarMs", scalarMs);
+            report.SetMetric(suite, mesh.name + ".minMaxSimdMs", simdMs);
+            report.SetMetric(suite, mesh.name + ".boundsMs", boundsMs);
+            report.SetMetric(suite, mesh.name + ".minMaxMatches", scalarMin == simdMin && scalarMax == simdMax);
+            LOG(INFO) << "Bounds " << mesh.name << " (" << positions.size() << " vertices): min/max " << scalarMs << " ms scalar, "
+                << simdMs << " ms SSE2, box + sphere " << boundsMs << " ms";
+        }
+
+        std::mt19937 random(1234);
+        std::uniform_real_distribution<float> position(-WorldExtent, WorldExtent);
+        std::uniform_real_distribution<float> size(0.5f, 5.0f);
+        BoundingBoxArray boxes;
+        std::vector<MeshData::Bounds> objectBounds(ObjectCount); // Same objects as spheres (the per-object path)
+        boxes.Reserve(ObjectCount);
+        for (size_t i = 0; i < ObjectCount; ++i) {
+            const glm::vec3 center(position(random), position(random), position(random));
+            const glm::vec3 extent(size(random), size(random), size(random));
+            boxes.Add(center - extent, center + extent);
+            objectBounds[i].center = center;
+            objectBounds[i].radius = glm::length(extent);
+        }
+
+        ThreadPool pool;
+        const CullPath bestPath = FrustumCuller::GetBestPath();
+        report.SetMetric(suite, "objects", static_cast<uint64_t>(ObjectCount));
+        report.SetMetric(suite, "frames", static_cast<uint64_t>(Frames));
+        report.SetMetric(suite, "bestPath", std::string(FrustumCuller::ToString(bestPath)));
+        report.SetMetric(suite, "threads", static_cast<uint64_t>(pool.GetThreadCount() + 1));
+
+        // Reference per-object sphere test (AoS, one object at a time)
+        std::vector<uint32_t> sphereVisible;
+        sphereVisible.reserve(ObjectCount);
+        double sphereMs = 0.0;
+        uint64_t sphereVisibleTotal = 0;
+        for (uint32_t frame = 0; frame < Frames; ++frame) {
+            const Frustum frustum = Frustum::FromMatrix(OrbitViewProjection(frame));
+            sphereMs += MicroBenchmarks::MeasureBest(1, [&]() {
+                sphereVisible.clear();
+                for (size_t i = 0; i < ObjectCount; ++i) {
+                    if (frustum.IntersectsSphere(objectBounds[i].center, objectBounds[i].radius)) sphereVisible.push_back(static_cast<uint32_t>(i));
+                }
+            });
+            sphereVisibleTotal += sphereVisible.size();
+        }
+        report.SetMetric(suite, "sphereMs", sphereMs / Frames);
+        report.SetMetric(suite, "sphereVisible", static_cast<double>(sphereVisibleTotal) / Frames);
+
+        struct Variant {
+            std::string name;
+            CullPath path;
+            ThreadPool* pool;
+        };
+        std::vector<Variant> variants;
+        for (CullPath path : { CullPath::Scalar, CullPath::Sse2, CullPath::Avx2 }) {
+            if (FrustumCuller::IsSupported(path)) variants.push_back({ FrustumCuller::ToString(path), path, nullptr });
+        }
+        variants.push_back({ "parallel", bestPath, &pool });
+
+        // Every variant must produce the scalar path's list, frame by frame
+        std::vector<std::vector<uint32_t>> reference(Frames);
+        std::vector<uint32_t> visible;
+        for (const Variant& variant : variants) {
+            double cullMs = 0.0;
+            uint64_t visibleTotal = 0;
+            bool matches = true;
+            for (uint32_t frame = 0; frame < Frames; ++frame) {
+                const Frustum frustum = Frustum::FromMatrix(OrbitViewProjection(frame));
+                size_t count = 0;
+                cullMs += MicroBenchmarks::MeasureBest(1, [&]() { count = FrustumCuller::Cull(frustum, boxes, visible, variant.path, variant.pool); });
+                visibleTotal += count;
+
+                if (variant.path == CullPath::Scalar && !variant.pool) reference[frame].assign(visible.begin(), visible.begin() + count);
+                else matches &= std::equal(visible.begin(), visible.begin() + count, reference[frame].begin(), reference[frame].end());
+            }
+
+            const double averageVisible = static_cast<double>(visibleTotal) / Frames;
+            report.SetMetric(suite, variant.name + ".ms", cullMs / Frames);
+            report.SetMetric(suite, variant.name + ".mObjectsPerSecond", cullMs > 0.0 ? ObjectCount * Frames / (cullMs * 1000.0) : 0.0);
+            report.SetMetric(suite, variant.name + ".visible", averageVisible);
+            report.SetMetric(suite, variant.name + ".culled", static_cast<double>(ObjectCount) - averageVisible);
+            report.SetMetric(suite, variant.name + ".matchesScalar", matches);
+            LOG(INFO) << "Frustum culling " << ObjectCount << " boxes (" << variant.name << "): " << cullMs / Frames << " ms per frame, "
+                << averageVisible << " visible / " << ObjectCount - averageVisible << " culled" << (matches ? "" : " (MISMATCH)");
+        }
+        LOG(INFO) << "Frustum culling per-object spheres: " << sphereMs / Frames << " ms per frame, "
+            << static_cast<double>(sphereVisibleTotal) / Frames << " visible";
+    }
+}
@@ -0,0 +1,103 @@
+#include "MicroBenchmarks.hpp"
+#include "GpuMesh.hpp"
+#include "HeadlessVulkanDevice.hpp"
+#include "StagingRing.hpp"
+#include <algorithm>
+#include <ng-log/logging.h>
+
+namespace Anito3D {
+
+    namespace {
+        constexpr size_t MaxMeshes = 2048;                       // Roughly a Bistro-sized scene
+        constexpr uint64_t ByteBudget = 512ull * 1024 * 1024;    // Device memory the suite may fill
+
+        void ReportMemory(BenchmarkReport& report, const std::string& suite, const std::string& prefix, const GpuMemoryStats& stats) {
+            report.SetMetric(suite, prefix + "deviceMemoryBlocks", static_cast<uint64_t>(stats.blockCount));
+            report.SetMetric(suite, prefix + "dedicatedBlocks", static_cast<uint64_t>(stats.dedicatedBlockCount));
+            report.SetMetric(suite, prefix + "allocations", static_cast<uint64_t>(stats.allocationCount));
+            report.SetMetric(suite, prefix + "blockBytes", stats.blockBytes);
+            report.SetMetric(suite, prefix + "usedBytes", stats.usedBytes);
+            report.SetMetric(suite, prefix + "freeRegions", static_cast<uint64_t>(stats.freeRegionCount));
+            report.SetMetric(suite, prefix + "largestFreeRegionBytes", stats.largestFreeRegion);
+            report.SetMetric(suite, prefix + "fragmentation", stats.fragmentation);
+        }
+    }
+
+    void RunGpuUploadBenchmark(MicroBenchmarkContext& context) {
+        const std::string suite = "gpuUpload";
+        BenchmarkReport& report = context.report;
+
+        HeadlessVulkanDevice headless;
+        const bool available = headless.Init(suite.c_str());
+        report.SetMetric(suite, "available", available);
+        if (!available) return;
+        report.SetMetric(suite, "device", headless.device.physical_device.name);
+
+        GpuMemoryAllocator allocator;
+        StagingRing stagingRing;
+        allocator.init(headless.device.physical_device.physical_device, headless.device.device);
+        if (!stagingRing.init(allocator, headless.queue, headless.queueFamily)) {
+            allocator.cleanup();
+            return;
+        }
+        report.SetMetric(suite, "maxMemoryAllocationCount", static_cast<uint64_t>(allocator.getMaxAllocationCount()));
+        report.SetMetric(suite, "blockBytes", static_cast<uint64_t>(GpuMemoryAllocator::DefaultBlockSize));
+        report.SetMetric(suite, "stagingBytes", static_cast<uint64_t>(stagingRing.getCapacity()));
+
+        // Repeat the loaded meshes until the scene has MaxMeshes of them or fills the budget
+        const std::vector<MicroBenchmarkMesh> meshes = context.GetMeshes();
+        uint64_t sceneBytes = 0;
+        for (const auto& mesh : meshes) sceneBytes += mesh.meshData->GetVertexMemory() + mesh.meshData->GetIndexMemory();
+        const size_t copies = std::clamp<size_t>(ByteBudget / std::max<uint64_t>(sceneBytes, 1), 1, std::max<size_t>(MaxMeshes / meshes.size(), 1));
+
+        std::vector<GpuMesh> gpuMeshes(meshes.size() * copies);
+        uint64_t naiveAllocations = 0; // One vkAllocateMemory per stream buffer
+        bool success = true;
+        const double uploadMs = MicroBenchmarks::MeasureBest(1, [&]() {
+            for (size_t i = 0; i < gpuMeshes.size() && success; ++i) {
+                const MeshData& meshData = *meshes[i % meshes.size()].meshData;
+                success = GpuMesh::Upload(meshData, allocator, stagingRing, gpuMeshes[i]);
+                for (const auto* stream : { &gpuMeshes[i].positions, &gpuMeshes[i].normals, &gpuMeshes[i].texCoords, &gpuMeshes[i].indices, &gpuMeshes[i].indices16 }) {
+                    naiveAllocations += stream->size > 0;
+                }
+            }
+            success = stagingRing.finish() && success;
+        });
+
+        const StagingStats& staging = stagingRing.getStats();
+        report.SetMetric(suite, "success", success);
+        report.SetMetric(suite, "meshes", static_cast<uint64_t>(gpuMeshes.size()));
+        report.SetMetric(suite, "uploadedBytes", staging.bytes);
+        report.SetMetric(suite, "uploadMs", uploadMs);
+        report.SetMetric(suite, "uploadMBps", uploadMs > 0.0 ? staging.bytes / (uploadMs * 1000.0) : 0.0);
+        report.SetMetric(suite, "naiveAllocations", naiveAllocations);
+        report.SetMetric(suite, "copyCommands", staging.copyCommands);
+        report.SetMetric(suite, "copyRegions", staging.copyRegions);
+        report.SetMetric(suite, "submits", staging.submits);
+        report.SetMetric(suite, "stagingStalls", staging.stalls);
+        report.SetMetric(suite, "stagingStallMs", staging.stallMilliseconds);
+        ReportMemory(report, suite, "loaded.", allocator.getStats());
+
+        // Unload every other mesh, then load half of them again: the holes must be reused
+        for (size_t i = 0; i < gpuMeshes.size(); i += 2) GpuMesh::Destroy(allocator, gpuMeshes[i]);
+        const GpuMemoryStats unloaded = allocator.getStats();
+        ReportMemory(report, suite, "halfUnloaded.", unloaded);
+        for (size_t i = 0; i < gpuMeshes.size() && success; i += 4) {
+            success = GpuMesh::Upload(*meshes[i % meshes.size()].meshData, allocator, stagingRing, gpuMeshes[i]);
+        }
+        success = stagingRing.finish() && success;
+        const GpuMemoryStats reloaded = allocator.getStats();
+        ReportMemory(report, suite, "reloaded.", reloaded);
+        report.SetMetric(suite, "peakDeviceMemoryBlocks", static_cast<uint64_t>(reloaded.peakBlockCount));
+        report.SetMetric(suite, "peakUsedBytes", reloaded.peakUsedBytes);
+
+        LOG(INFO) << "GPU upload: " << gpuMeshes.size() << " meshes, " << staging.bytes / (1024 * 1024) << " MiB in " << uploadMs << " ms, "
+            << staging.copyCommands << " copy commands in " << staging.submits << " submits, " << reloaded.peakBlockCount
+            << " device memory blocks instead of " << naiveAllocations << " allocations; fragmentation " << unloaded.fragmentation
+            << " after unloading half, " << reloaded.blockCount << " blocks after reloading a quarter";
+
+        for (auto& mesh : gpuMeshes) GpuMesh::Destroy(allocator, mesh);
+        stagingRing.cleanup();
+        allocator.cleanup();
+    }
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "MeshEntity.hpp"
+
+namespace Anito3D {
+
+    class BenchmarkReport;
+
+    // Renderer backend usable without a window (no GLFW, no ImGui).
+    // The headless runner drives it for the configured number of frames.
+    class HeadlessRenderer {
+    public:
+        virtual ~HeadlessRenderer() = default;
+
+        virtual const char* GetName() const = 0;
+
+        virtual bool Init(uint32_t width, uint32_t height, const std::vector<std::unique_ptr<MeshEntity>>& entities) = 0;
+        virtual void RenderFrame(uint32_t frameIndex) = 0;
+        virtual void Shutdown() {}
+
+        // Add backend specific numbers to the report after the run
+        virtual void ReportStats(BenchmarkReport& report) const {}
+    };
+
+    // Does no rendering work; measures only the CPU side of the frame loop
+    class NullHeadlessRenderer : public HeadlessRenderer {
+    public:
+        const char* GetName() const override { return "none"; }
+        bool Init(uint32_t, uint32_t, const std::vector<std::unique_ptr<MeshEntity>>&) override { return true; }
+        void RenderFrame(uint32_t) override {}
+    };
+
+}
@@ -0,0 +1,265 @@
+#include "HeadlessRunner.hpp"
+#include "AssetImporter.hpp"
+#include "Components.hpp"
+#include "CpuRayTracer.hpp"
+#include "MicroBenchmarks.hpp"
+#include "SoftwareRasterizer.hpp"
+#include "Trace.hpp"
+#include <chrono>
+#include <filesystem>
+#include <ng-log/logging.h>
+
+namespace Anito3D {
+
+    namespace {
+        using Clock = std::chrono::steady_clock;
+
+        double ElapsedMilliseconds(Clock::time_point start, Clock::time_point end) {
+            return std::chrono::duration<double, std::milli>(end - start).count();
+        }
+
+        enum FramePhase : uint32_t {
+            TransformPhase,
+            SceneGraphPhase,
+            SystemsPhase,
+            RenderPhase
+        };
+    }
+
+    HeadlessRunner::HeadlessRunner(const BenchmarkOptions& options) : options(options),
+        frameProfiler({ "transforms", "sceneGraph", "systems", "render" }, options.frames, options.frameStats) {
+        report.SetOptions(options);
+        if (options.threads != 1) {
+            // The main thread helps while it waits, so it counts as one of the threads
+            threadPool = std::make_unique<ThreadPool>(options.threads == 0 ? 0 : options.threads - 1);
+        }
+    }
+
+    int HeadlessRunner::Run() {
+        LOG(INFO) << "Headless benchmark: renderer=" << options.renderer
+            << ", models=" << options.models.size()
+            << ", scene=" << (options.scene.empty() ? "None" : options.scene)
+            << ", resolution=" << options.GetResolutionString()
+            << ", frames=" << options.frames << " (+" << options.warmupFrames << " warmup)";
+
+        std::unique_ptr<HeadlessRenderer> renderer = CreateRenderer(options, threadPool.get());
+        if (!renderer) {
+            std::string available;
+            for (const auto& name : GetRendererNames()) {
+                available += (available.empty() ? "" : ", ") + name;
+            }
+            LOG(ERROR) << "Unknown headless renderer: " << options.renderer << " (available: " << available << ")";
+            return 1;
+        }
+
+        report.CaptureMemory("startup");
+        if (!LoadAssets()) {
+            LOG(ERROR) << "Headless benchmark aborted: asset loading failed";
+            report.WriteJson(options.reportPath);
+            return 1;
+        }
+        report.CaptureMemory("afterLoad");
+
+        if (!options.microBenchmarks.empty()) {
+            ANITO3D_TRACE_ZONE("MicroBenchmarks::Run");
+            MicroBenchmarkContext microContext{ options, entities, entityPaths, report };
+            if (!MicroBenchmarks::Run(options.microBenchmarks, microContext)) {
+                report.WriteJson(options.reportPath);
+                return 1;
+            }
+            report.CaptureMemory("afterMicroBenchmarks");
+        }
+
+        auto initStart = Clock::now();
+        bool initialized = false;
+        {
+            ANITO3D_TRACE_ZONE("HeadlessRenderer::Init");
+            initialized = renderer->Init(options.width, options.height, entities);
+        }
+        if (!initialized) {
+            LOG(ERROR) << "Failed to initialize headless renderer: " << renderer->GetName();
+            report.WriteJson(options.reportPath);
+            return 1;
+        }
+        report.SetMetric("renderer", "name", std::string(renderer->GetName()));
+        report.SetMetric("renderer", "initMs", ElapsedMilliseconds(initStart, Clock::now()));
+        report.CaptureMemory("afterRendererInit");
+
+        RunFrames(*renderer);
+        report.CaptureMemory("afterFrames");
+
+        renderer->ReportStats(report);
+        renderer->Shutdown();
+
+        // Mapped cache hits that a renderer or micro suite needed as an owned MeshData
+        uint64_t mapped = 0, copiedLater = 0;
+        for (size_t i = 0; i < entities.size(); ++i) {
+            if (loadStorage[i] != MeshStorage::CacheMapped) continue;
+            ++mapped;
+            if (entities[i]->GetStorage() == MeshStorage::CacheCopied) ++copiedLater;
+        }
+        report.SetMetric("import", "cacheMappedFiles", mapped);
+        report.SetMetric("import", "cacheCopiedOnDemand", copiedLater);
+
+        return report.WriteJson(options.reportPath) ? 0 : 1;
+    }
+
+    bool HeadlessRunner::LoadAssets() {
+        ANITO3D_TRACE_ZONE("HeadlessRunner::LoadAssets");
+        std::vector<std::string> paths;
+        for (const auto& model : options.models) {
+            paths.push_back(ResolveAssetPath(model));
+        }
+        if (!options.scene.empty()) {
+            paths.push_back(ResolveAssetPath(options.scene));
+        }
+
+        MeshLoadOptions loadOptions;
+        loadOptions.cache = options.useMeshCache ? &MeshCache::Default() : nullptr;
+        loadOptions.copyFromCache = options.copyMeshCache;
+        loadOptions.process.flags = options.narrowIndices ? MeshProcess::NarrowIndices : 0;
+        if (options.weldVertices) loadOptions.process.flags |= MeshProcess::WeldVertices;
+        if (options.optimizeMeshes) loadOptions.process.flags |= MeshProcess::Optimize;
+        loadOptions.process.weld.positionEpsilon = options.weldEpsilon;
+        loadOptions.process.weld.normalEpsilon = options.weldEpsilon;
+        loadOptions.process.weld.texCoordEpsilon = options.weldEpsilon;
+        const LodChainOptions lodOptions;
+        if (options.generateLods) loadOptions.lods = &lodOptions;
+        if (options.importThreads == 0) loadOptions.threadPool = threadPool.get();
+        const uint32_t importThreads = options.importThreads == 0 && !threadPool ? 1 : options.importThreads;
+        if (threadPool) threadPool->ResetStatistics();
+        AssetImportSummary summary = AssetImporter::ImportBatch(paths, loadOptions, importThreads);
+
+        bool allLoaded = true;
+        for (auto& result : summary.results) {
+            FileLoadRecord record;
+            record.path = result.path;
+            record.success = result.success;
+            record.fromCache = result.fromCache;
+            record.milliseconds = result.milliseconds;
+
+            if (result.success) {
+                const MeshDataView meshView = result.entity->GetMeshView();
+                record.storage = ToString(result.entity->GetStorage());
+                record.vertexCount = meshView.vertices.size();
+                record.indexCount = meshView.GetIndexCount();
+                record.subMeshCount = meshView.subMeshes.size();
+                LOG(INFO) << "Loaded " << record.path << " in " << record.milliseconds << " ms" << (record.fromCache ? " from cache" : "") << " ("
+                    << record.vertexCount << " vertices, " << record.subMeshCount << " submeshes)";
+                for (size_t level = 1; level < result.entity->GetLodCount(); ++level) {
+                    LOG(INFO) << "  LOD " << level << ": " << result.entity->GetLodMeshData(level).GetTriangleCount()
+                        << " triangles, error " << result.entity->GetLodError(level);
+                }
+                result.entity->AttachTransform(transforms);
+                result.entity->AttachScene(sceneGraph);
+                world.Create(SceneNodeReference{ &sceneGraph, result.entity->GetSceneNode() }, WorldTransform{},
+                    MeshReference::FromEntity(*result.entity), WorldBounds{});
+                loadStorage.push_back(result.entity->GetStorage());
+                entities.push_back(std::move(result.entity));
+                entityPaths.push_back(result.path);
+            }
+            else {
+                LOG(ERROR) << "Failed to load mesh from " << record.path;
+                allLoaded = false;
+            }
+            report.AddFileLoad(record);
+        }
+
+        sceneGraph.Update();
+        report.SetMetric("import", "sceneNodes", static_cast<uint64_t>(sceneGraph.GetNodeCount()));
+        report.SetMetric("import", "sceneDepth", static_cast<uint64_t>(sceneGraph.GetMaxDepth()));
+
+        report.SetTotalLoadTime(summary.wallMilliseconds);
+        report.SetMetric("import", "threads", static_cast<uint64_t>(summary.threadCount));
+        report.SetMetric("import", "wallMs", summary.wallMilliseconds);
+        report.SetMetric("import", "serialSumMs", summary.serialMilliseconds);
+        report.SetMetric("import", "speedup", summary.wallMilliseconds > 0.0 ? summary.serialMilliseconds / summary.wallMilliseconds : 0.0);
+        if (loadOptions.threadPool) ReportThreadUtilization("import");
+        LOG(INFO) << "Imported " << summary.GetSuccessCount() << "/" << paths.size() << " files in "
+            << summary.wallMilliseconds << " ms on " << summary.threadCount << " threads";
+
+        return allLoaded;
+    }
+
+    void HeadlessRunner::RunFrames(HeadlessRenderer& renderer) {
+        const uint32_t totalFrames = options.warmupFrames + options.frames;
+        report.ReserveFrames(options.frames);
+
+        AddTransformSystems(systems);
+
+        float deltaTime = 1.0f / 60.0f;
+        for (uint32_t frame = 0; frame < totalFrames; ++frame) {
+            if (frame == options.warmupFrames) {
+                if (threadPool) threadPool->ResetStatistics();
+                frameProfiler.Reset();
+            }
+            auto frameStart = Clock::now();
+            frameProfiler.BeginFrame();
+
+            transforms.UpdateWorldMatrices(threadPool.get());
+            frameProfiler.EndPhase(TransformPhase);
+            sceneGraph.Update(threadPool.get());
+            frameProfiler.EndPhase(SceneGraphPhase);
+            systems.Run(world, deltaTime, threadPool.get());
+            frameProfiler.EndPhase(SystemsPhase);
+            renderer.RenderFrame(frame);
+            frameProfiler.EndPhase(RenderPhase);
+            frameProfiler.EndFrame();
+
+            double frameMs = ElapsedMilliseconds(frameStart, Clock::now());
+            deltaTime = static_cast<float>(frameMs / 1000.0);
+            if (frame >= options.warmupFrames) {
+                report.AddFrameTime(frameMs);
+            }
+        }
+        LOG(INFO) << "Headless benchmark finished " << options.frames << " measured frames";
+        if (frameProfiler.IsEnabled()) {
+            const FrameStatistics statistics = frameProfiler.ComputeStatistics();
+            report.SetFrameStatistics(statistics);
+            for (const auto& phase : statistics.phases) {
+                LOG(INFO) << "  " << phase.name << ": mean " << phase.mean << " ms, p95 " << phase.p95 << " ms, p99 " << phase.p99 << " ms, max " << phase.max << " ms";
+            }
+            LOG(INFO) << "  " << statistics.stutters << " stutters";
+        }
+        if (threadPool) ReportThreadUtilization("jobs");
+    }
+
+    void HeadlessRunner::ReportThreadUtilization(const std::string& suite) {
+        const ThreadPoolStatistics statistics = threadPool->GetStatistics();
+        uint64_t jobs = statistics.external.jobs;
+        uint64_t steals = statistics.external.steals;
+        for (size_t i = 0; i < statistics.workers.size(); ++i) {
+            const WorkerStatistics& worker = statistics.workers[i];
+            report.SetMetric(suite, "worker" + std::to_string(i) + "Utilization", worker.utilization);
+            jobs += worker.jobs;
+            steals += worker.steals;
+        }
+        report.SetMetric(suite, "workers", static_cast<uint64_t>(statistics.workers.size()));
+        report.SetMetric(suite, "jobs", jobs);
+        report.SetMetric(suite, "steals", steals);
+        report.SetMetric(suite, "mainThreadHelpMs", statistics.external.busyMilliseconds);
+        report.SetMetric(suite, "averageUtilization", statistics.GetAverageUtilization());
+        LOG(INFO) << "Job system (" << suite << "): " << statistics.workers.size() << " workers, "
+            << jobs << " jobs, " << steals << " steals, " << statistics.GetAverageUtilization() * 100.0 << "% average utilization";
+    }
+
+    std::unique_ptr<HeadlessRenderer> HeadlessRunner::CreateRenderer(const BenchmarkOptions& options, ThreadPool* threadPool) {
+        if (options.renderer == "none") return std::make_unique<NullHeadlessRenderer>();
+        if (options.renderer == "raytracer") return std::make_unique<CpuRayTracer>(RayTracerSettings::FromOptions(options), threadPool);
+        if (options.renderer == "software") return std::make_unique<SoftwareRasterizer>(RasterizerSettings::FromOptions(options), threadPool);
+        return nullptr;
+    }
+
+    std::vector<std::string> HeadlessRunner::GetRendererNames() {
+        return { "none", "raytracer", "software" };
+    }
+
+    std::string HeadlessRunner::ResolveAssetPath(const std::string& path) {
+        if (std::filesystem::exists(path)) return path;
+
+        std::filesystem::path assetPath = std::filesystem::path(PROJ_ASSETS_DIR) / path;
+        if (std::filesystem::exists(assetPath)) return assetPath.string();
+
+        return path;
+    }
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "BenchmarkOptions.hpp"
+#include "BenchmarkReport.hpp"
+#include "FrameProfiler.hpp"
+#include "HeadlessRenderer.hpp"
+#include "MeshEntity.hpp"
+#include "SystemScheduler.hpp"
+#include "ThreadPool.hpp"
+
+namespace Anito3D {
+
+    // Runs a benchmark without GLFW/ImGui: loads the selected assets, drives the
+    // selected headless renderer for warmup + measured frames and writes the JSON report.
+    class HeadlessRunner {
+    public:
+        explicit HeadlessRunner(const BenchmarkOptions& options);
+        ~HeadlessRunner() = default;
+
+        // Returns the process exit code (0 on success)
+        int Run();
+
+        const BenchmarkReport& GetReport() const { return report; }
+
+        // Renderer named by options.renderer, configured from the options; null for unknown names
+        static std::unique_ptr<HeadlessRenderer> CreateRenderer(const BenchmarkOptions& options, ThreadPool* threadPool = nullptr);
+        static std::vector<std::string> GetRendererNames();
+
+        // Resolve a model/scene path relative to the working directory or the assets directory
+        static std::string ResolveAssetPath(const std::string& path);
+
+    private:
+        BenchmarkOptions options;
+        BenchmarkReport report;
+        std::unique_ptr<ThreadPool> threadPool; // Null when running on the main thread only
+        TransformStore transforms; // Declared before entities, which release their handles on destruction
+        SceneGraph sceneGraph;
+        World world;               // Per-frame data of the loaded entities, processed by systems
+        SystemScheduler systems;
+        FrameProfiler frameProfiler; // Phases of RunFrames, measured frames only
+        std::vector<std::unique_ptr<MeshEntity>> entities;
+        std::vector<std::string> entityPaths; // Source file of each entity
+        std::vector<MeshStorage> loadStorage; // Storage of each entity right after loading
+
+        bool LoadAssets();
+        void RunFrames(HeadlessRenderer& renderer);
+        void ReportThreadUtilization(const std::string& suite);
+    };
+
+}
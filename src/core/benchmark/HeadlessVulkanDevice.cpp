@@ -0,0 +1,37 @@
+#include "HeadlessVulkanDevice.hpp"
+#include <ng-log/logging.h>
+#include <string>
+
+namespace Anito3D {
+
+    HeadlessVulkanDevice::~HeadlessVulkanDevice() {
+        if (device.device) vkb::destroy_device(device);
+        if (instance.instance) vkb::destroy_instance(instance);
+    }
+
+    bool HeadlessVulkanDevice::Init(const char* suiteName) {
+        const std::string appName = std::string("Anito3D ") + suiteName + " benchmark";
+        auto instanceRet = vkb::InstanceBuilder().set_app_name(appName.c_str()).set_headless(true)
+            .require_api_version(1, 1, 0).build();
+        if (!instanceRet) {
+            LOG(WARNING) << suiteName << " benchmark: no Vulkan instance (" << instanceRet.error().message() << ")";
+            return false;
+        }
+        instance = instanceRet.value();
+        auto physicalDeviceRet = vkb::PhysicalDeviceSelector(instance).set_minimum_version(1, 1).select();
+        if (!physicalDeviceRet) {
+            LOG(WARNING) << suiteName << " benchmark: no Vulkan device (" << physicalDeviceRet.error().message() << ")";
+            return false;
+        }
+        auto deviceRet = vkb::DeviceBuilder(physicalDeviceRet.value()).build();
+        if (!deviceRet) {
+            LOG(WARNING) << suiteName << " benchmark: device creation failed (" << deviceRet.error().message() << ")";
+            return false;
+        }
+        device = deviceRet.value();
+        queue = device.get_queue(vkb::QueueType::graphics).value();
+        queueFamily = device.get_queue_index(vkb::QueueType::graphics).value();
+        return true;
+    }
+
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <VkBootstrap.h>
+#include <cstdint>
+
+namespace Anito3D {
+
+    // Surface-less instance and device for the GPU micro suites
+    struct HeadlessVulkanDevice {
+        vkb::Instance instance;
+        vkb::Device device;
+        VkQueue queue = VK_NULL_HANDLE;
+        uint32_t queueFamily = 0;
+
+        HeadlessVulkanDevice() = default;
+        HeadlessVulkanDevice(const HeadlessVulkanDevice&) = delete;
+        HeadlessVulkanDevice& operator=(const HeadlessVulkanDevice&) = delete;
+        ~HeadlessVulkanDevice();
+
+        // Logs a warning naming the suite and returns false when no Vulkan device is available
+        bool Init(const char* suiteName);
+    };
+
+}
@@ -0,0 +1,93 @@
+#include "MicroBenchmarks.hpp"
+#include "ThreadPool.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <ng-log/logging.h>
+
+namespace Anito3D {
+
+    namespace {
+        constexpr uint32_t Repeats = 5;
+        constexpr size_t ItemCount = 1 << 18;
+        constexpr size_t EmptyJobCount = 100000;
+        constexpr size_t ChainStages = 1000;
+        constexpr size_t JobsPerStage = 16;
+
+        // Cost grows with the index, so equal-sized blocks finish at very different times
+        float SkewedWork(size_t index) {
+            const size_t steps = 1 + index * 64 / ItemCount;
+            float value = static_cast<float>(index);
+            for (size_t i = 0; i < steps; ++i) value = std::sqrt(value + 1.0f);
+            return value;
+        }
+    }
+
+    void RunJobBenchmark(MicroBenchmarkContext& context) {
+        const std::string suite = "jobs";
+        BenchmarkReport& report = context.report;
+
+        ThreadPool pool;
+        const uint32_t threadCount = pool.GetThreadCount() + 1;
+        report.SetMetric(suite, "threads", static_cast<uint64_t>(threadCount));
+
+        std::vector<float> results(ItemCount);
+        double serialMs = MicroBenchmarks::MeasureBest(Repeats, [&]() {
+            for (size_t i = 0; i < ItemCount; ++i) results[i] = SkewedWork(i);
+        });
+        // One contiguous block per thread, the split a static scheduler would make
+        double staticMs = MicroBenchmarks::MeasureBest(Repeats, [&]() {
+            pool.ParallelFor(threadCount, [&](size_t block) {
+                const size_t end = ItemCount * (block + 1) / threadCount;
+                for (size_t i = ItemCount * block / threadCount; i < end; ++i) results[i] = SkewedWork(i);
+            });
+        });
+        pool.ResetStatistics();
+        double stealingMs = MicroBenchmarks::MeasureBest(Repeats, [&]() {
+            pool.ParallelForRange(ItemCount, [&](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; ++i) results[i] = SkewedWork(i);
+            });
+        });
+        const ThreadPoolStatistics statistics = pool.GetStatistics();
+        uint64_t steals = 0;
+        for (const auto& worker : statistics.workers) steals += worker.steals;
+
+        // Per-job cost of scheduling, running and waiting on trivial jobs
+        std::atomic<uint64_t> sink{ 0 };
+        double emptyMs = MicroBenchmarks::MeasureBest(Repeats, [&]() {
+            JobCounter counter;
+            for (size_t i = 0; i < EmptyJobCount; ++i) {
+                pool.Schedule([&sink]() { sink.fetch_add(1, std::memory_order_relaxed); }, &counter);
+            }
+            pool.Wait(counter);
+        });
+
+        // Stages of fan-out jobs, each stage released by the previous stage's counter
+        double chainMs = MicroBenchmarks::MeasureBest(Repeats, [&]() {
+            std::unique_ptr<JobCounter[]> stages = std::make_unique<JobCounter[]>(ChainStages);
+            for (size_t stage = 0; stage < ChainStages; ++stage) {
+                JobCounter* dependency = stage > 0 ? &stages[stage - 1] : nullptr;
+                for (size_t job = 0; job < JobsPerStage; ++job) {
+                    pool.Schedule([&sink]() { sink.fetch_add(1, std::memory_order_relaxed); }, &stages[stage], dependency);
+                }
+            }
+            pool.Wait(stages[ChainStages - 1]);
+            for (size_t stage = 0; stage + 1 < ChainStages; ++stage) pool.Wait(stages[stage]);
+        });
+
+        report.SetMetric(suite, "skewedSerialMs", serialMs);
+        report.SetMetric(suite, "skewedStaticMs", staticMs);
+        report.SetMetric(suite, "skewedStealingMs", stealingMs);
+        report.SetMetric(suite, "staticSpeedup", staticMs > 0.0 ? serialMs / staticMs : 0.0);
+        report.SetMetric(suite, "stealingSpeedup", stealingMs > 0.0 ? serialMs / stealingMs : 0.0);
+        report.SetMetric(suite, "steals", steals);
+        report.SetMetric(suite, "averageUtilization", statistics.GetAverageUtilization());
+        report.SetMetric(suite, "emptyJobNs", emptyMs * 1.0e6 / EmptyJobCount);
+        report.SetMetric(suite, "dependentJobNs", chainMs * 1.0e6 / (ChainStages * JobsPerStage));
+
+        LOG(INFO) << "Jobs on " << threadCount << " threads: skewed loop " << serialMs << " ms serial, " << staticMs
+            << " ms static blocks, " << stealingMs << " ms work stealing (" << steals << " steals); "
+            << emptyMs * 1.0e6 / EmptyJobCount << " ns per empty job, "
+            << chainMs * 1.0e6 / (ChainStages * JobsPerStage) << " ns per dependent job";
+    }
+}
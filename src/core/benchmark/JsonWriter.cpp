@@ -0,0 +1,125 @@
+#include "JsonWriter.hpp"
+#include <cmath>
+#include <cstdio>
+
+namespace Anito3D {
+
+    JsonWriter::JsonWriter(std::ostream& stream, bool pretty) : out(stream), pretty(pretty), pendingKey(false) {}
+
+    void JsonWriter::BeginObject() {
+        BeforeValue();
+        out << '{';
+        firstInScope.push_back(true);
+    }
+
+    void JsonWriter::EndObject() {
+        bool empty = firstInScope.back();
+        firstInScope.pop_back();
+        if (!empty) NewLine();
+        out << '}';
+    }
+
+    void JsonWriter::BeginArray() {
+        BeforeValue();
+        out << '[';
+        firstInScope.push_back(true);
+    }
+
+    void JsonWriter::EndArray() {
+        bool empty = firstInScope.back();
+        firstInScope.pop_back();
+        if (!empty) NewLine();
+        out << ']';
+    }
+
+    void JsonWriter::Key(const std::string& key) {
+        BeforeValue();
+        out << '"' << Escape(key) << "\":" << (pretty ? " " : "");
+        pendingKey = true;
+    }
+
+    void JsonWriter::Value(const std::string& value) {
+        BeforeValue();
+        out << '"' << Escape(value) << '"';
+    }
+
+    void JsonWriter::Value(const char* value) {
+        Value(std::string(value ? value : ""));
+    }
+
+    void JsonWriter::Value(double value) {
+        BeforeValue();
+        // JSON has no representation for NaN/Inf
+        if (!std::isfinite(value)) {
+            out << "null";
+            return;
+        }
+        char buffer[32];
+        std::snprintf(buffer, sizeof(buffer), "%.6g", value);
+        out << buffer;
+    }
+
+    void JsonWriter::Value(int64_t value) {
+        BeforeValue();
+        out << value;
+    }
+
+    void JsonWriter::Value(uint64_t value) {
+        BeforeValue();
+        out << value;
+    }
+
+    void JsonWriter::Value(bool value) {
+        BeforeValue();
+        out << (value ? "true" : "false");
+    }
+
+    void JsonWriter::Null() {
+        BeforeValue();
+        out << "null";
+    }
+
+    void JsonWriter::BeforeValue() {
+        if (pendingKey) {
+            pendingKey = false;
+            return;
+        }
+        if (firstInScope.empty()) return;
+
+        if (!firstInScope.back()) out << ',';
+        firstInScope.back() = false;
+        NewLine();
+    }
+
+    void JsonWriter::NewLine() {
+        if (!pretty) return;
+        out << '\n';
+        for (size_t i = 0; i < firstInScope.size(); ++i) {
+            out << "  ";
+        }
+    }
+
+    std::string JsonWriter::Escape(const std::string& text) {
+        std::string result;
+        result.reserve(text.size());
+        for (char c : text) {
+            switch (c) {
+            case '"': result += "\\\""; break;
+            case '\\': result += "\\\\"; break;
+            case '\n': result += "\\n"; break;
+            case '\r': result += "\\r"; break;
+            case '\t': result += "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    char buffer[8];
+                    std::snprintf(buffer, sizeof(buffer), "\\u%04x", c);
+                    result += buffer;
+                }
+                else {
+                    result += c;
+                }
+            }
+        }
+        return result;
+    }
+}
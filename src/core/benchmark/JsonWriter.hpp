@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace Anito3D {
+
+    // Minimal streaming JSON writer used for benchmark reports.
+    // Keeps track of commas/nesting so callers only emit keys and values.
+    class JsonWriter {
+    public:
+        explicit JsonWriter(std::ostream& stream, bool pretty = true);
+
+        void BeginObject();
+        void EndObject();
+        void BeginArray();
+        void EndArray();
+
+        void Key(const std::string& key);
+
+        void Value(const std::string& value);
+        void Value(const char* value);
+        void Value(double value);
+        void Value(int64_t value);
+        void Value(uint64_t value);
+        void Value(int value) { Value(static_cast<int64_t>(value)); }
+        void Value(uint32_t value) { Value(static_cast<uint64_t>(value)); }
+        void Value(bool value);
+        void Null();
+
+        // Convenience for "key": value pairs
+        template <typename T>
+        void Field(const std::string& key, const T& value) {
+            Key(key);
+            Value(value);
+        }
+
+    private:
+        std::ostream& out;
+        bool pretty;
+        bool pendingKey;
+        std::vector<bool> firstInScope; // One entry per open object/array
+
+        void BeforeValue();
+        void NewLine();
+        static std::string Escape(const std::string& text);
+    };
+
+}
@@ -0,0 +1,51 @@
+#include "MicroBenchmarks.hpp"
+#include "MeshOptimizer.hpp"
+#include <ng-log/logging.h>
+
+namespace Anito3D {
+
+    namespace {
+        void ReportCacheStatistics(BenchmarkReport& report, const std::string& section, const std::string& prefix,
+            const VertexCacheStatistics& cache, const OverdrawStatistics& overdraw) {
+            report.SetMetric(section, prefix + ".acmr", cache.GetAcmr());
+            report.SetMetric(section, prefix + ".atvr", cache.GetAtvr());
+            report.SetMetric(section, prefix + ".overdraw", overdraw.GetOverdraw());
+        }
+    }
+
+    void RunMeshOptimizerBenchmark(MicroBenchmarkContext& context) {
+        const std::string suite = "meshOptimizer";
+        BenchmarkReport& report = context.report;
+        report.SetMetric(suite, "cacheSize", static_cast<uint64_t>(MeshOptimizer::DefaultCacheSize));
+
+        for (const auto& mesh : context.GetMeshes()) {
+            const std::string& name = mesh.name;
+            MeshData optimized = *mesh.meshData;
+
+            VertexCacheStatistics cacheBefore = MeshOptimizer::AnalyzeVertexCache(optimized);
+            OverdrawStatistics overdrawBefore = MeshOptimizer::AnalyzeOverdraw(optimized);
+
+            // Time each pass on its own so the cost per stage is visible
+            double passMs[3] = {};
+            const uint32_t passes[3] = { MeshProcess::OptimizeVertexCache, MeshProcess::OptimizeOverdraw, MeshProcess::OptimizeVertexFetch };
+            for (int i = 0; i < 3; ++i) {
+                passMs[i] = MicroBenchmarks::MeasureBest(1, [&]() { MeshOptimizer::Optimize(optimized, passes[i]); });
+            }
+
+            VertexCacheStatistics cacheAfter = MeshOptimizer::AnalyzeVertexCache(optimized);
+            OverdrawStatistics overdrawAfter = MeshOptimizer::AnalyzeOverdraw(optimized);
+
+            report.SetMetric(suite, name + ".triangles", cacheBefore.triangleCount);
+            ReportCacheStatistics(report, suite, name + ".before", cacheBefore, overdrawBefore);
+            ReportCacheStatistics(report, suite, name + ".after", cacheAfter, overdrawAfter);
+            report.SetMetric(suite, name + ".vertexCacheMs", passMs[0]);
+            report.SetMetric(suite, name + ".overdrawMs", passMs[1]);
+            report.SetMetric(suite, name + ".vertexFetchMs", passMs[2]);
+
+            LOG(INFO) << "Mesh optimizer " << name << ": ACMR " << cacheBefore.GetAcmr() << " -> " << cacheAfter.GetAcmr()
+                << ", ATVR " << cacheBefore.GetAtvr() << " -> " << cacheAfter.GetAtvr()
+                << ", overdraw " << overdrawBefore.GetOverdraw() << " -> " << overdrawAfter.GetOverdraw()
+                << " (" << passMs[0] + passMs[1] + passMs[2] << " ms)";
+        }
+    }
+}
@@ -0,0 +1,69 @@
+#include "MicroBenchmarks.hpp"
+#include "MeshSimplifier.hpp"
+#include "ThreadPool.hpp"
+#include <ng-log/logging.h>
+
+namespace Anito3D {
+
+    namespace {
+        // Triangles fed into the simplifier over the whole chain (each level starts from the previous one)
+        uint64_t CountInputTriangles(const MeshData& base, const std::vector<MeshLod>& chain) {
+            uint64_t triangles = base.GetTriangleCount();
+            for (size_t i = 0; i + 1 < chain.size(); ++i) triangles += chain[i].meshData.GetTriangleCount();
+            return triangles;
+        }
+    }
+
+    void RunMeshSimplifierBenchmark(MicroBenchmarkContext& context) {
+        const std::string suite = "meshSimplifier";
+        BenchmarkReport& report = context.report;
+        const LodChainOptions options;
+
+        ThreadPool pool;
+        const uint32_t threadCount = pool.GetThreadCount() + 1;
+        report.SetMetric(suite, "threads", static_cast<uint64_t>(threadCount));
+
+        const std::vector<MicroBenchmarkMesh> meshes = context.GetMeshes();
+        uint64_t totalInputTriangles = 0;
+        double totalSerialMs = 0.0;
+
+        for (const auto& mesh : meshes) {
+            const std::string& name = mesh.name;
+            const MeshData& base = *mesh.meshData;
+
+            std::vector<MeshLod> chain;
+            double serialMs = MicroBenchmarks::MeasureBest(1, [&]() { chain = MeshSimplifier::BuildLodChain(base, options); });
+            double parallelMs = MicroBenchmarks::MeasureBest(1, [&]() { MeshSimplifier::BuildLodChain(base, options, &pool); });
+            const uint64_t inputTriangles = CountInputTriangles(base, chain);
+            totalInputTriangles += inputTriangles;
+            totalSerialMs += serialMs;
+
+            report.SetMetric(suite, name + ".triangles", static_cast<uint64_t>(base.GetTriangleCount()));
+            report.SetMetric(suite, name + ".extent", static_cast<double>(MeshSimplifier::GetExtent(base)));
+            report.SetMetric(suite, name + ".levels", static_cast<uint64_t>(chain.size()));
+            for (size_t level = 0; level < chain.size(); ++level) {
+                const std::string prefix = name + ".lod" + std::to_string(level + 1);
+                report.SetMetric(suite, prefix + ".triangles", static_cast<uint64_t>(chain[level].meshData.GetTriangleCount()));
+                report.SetMetric(suite, prefix + ".vertices", static_cast<uint64_t>(chain[level].meshData.GetVertexCount()));
+                report.SetMetric(suite, prefix + ".error", static_cast<double>(chain[level].error));
+                report.SetMetric(suite, prefix + ".quadricError", static_cast<double>(chain[level].quadricError));
+            }
+            report.SetMetric(suite, name + ".serialMs", serialMs);
+            report.SetMetric(suite, name + ".parallelMs", parallelMs);
+            report.SetMetric(suite, name + ".trianglesPerSecond", serialMs > 0.0 ? inputTriangles / (serialMs / 1000.0) : 0.0);
+
+            LOG(INFO) << "Mesh simplifier " << name << ": " << base.GetTriangleCount() << " triangles -> " << chain.size()
+                << " levels" << (chain.empty() ? "" : ", coarsest " + std::to_string(chain.back().meshData.GetTriangleCount()))
+                << " in " << serialMs << " ms (" << (serialMs > 0.0 ? inputTriangles / serialMs / 1000.0 : 0.0) << " Mtris/s), "
+                << parallelMs << " ms with ranges on " << threadCount << " threads";
+        }
+
+        // Whole set with one mesh per task, the way the asset importer builds chains
+        double batchMs = MicroBenchmarks::MeasureBest(1, [&]() {
+            pool.ParallelFor(meshes.size(), [&](size_t i) { MeshSimplifier::BuildLodChain(*meshes[i].meshData, options); });
+        });
+        report.SetMetric(suite, "serialTrianglesPerSecond", totalSerialMs > 0.0 ? totalInputTriangles / (totalSerialMs / 1000.0) : 0.0);
+        report.SetMetric(suite, "batchMs", batchMs);
+        report.SetMetric(suite, "batchTrianglesPerSecond", batchMs > 0.0 ? totalInputTriangles / (batchMs / 1000.0) : 0.0);
+    }
+}
@@ -0,0 +1,78 @@
+#include "MicroBenchmarks.hpp"
+#include "MeshProcessing.hpp"
+#include "ThreadPool.hpp"
+#include <ng-log/logging.h>
+
+namespace Anito3D {
+
+    namespace {
+        // One vertex per index (what Assimp produces without JoinIdenticalVertices), so the
+        // weld has the same work to do on cached and freshly imported meshes
+        MeshData Deindex(const MeshData& source) {
+            MeshData expanded;
+            expanded.materials = source.materials;
+            for (const auto& range : source.GetUniqueRanges()) {
+                MeshData::SubMesh subMesh = range;
+                subMesh.indexType = MeshData::IndexType::Uint32;
+                subMesh.firstIndex = static_cast<uint32_t>(expanded.indices.size());
+                subMesh.vertexOffset = static_cast<uint32_t>(expanded.vertices.size());
+                subMesh.vertexCount = range.indexCount;
+
+                for (uint32_t i = 0; i < range.indexCount; ++i) {
+                    const size_t vertex = range.vertexOffset + source.GetIndex(range, i);
+                    expanded.vertices.push_back(source.vertices[vertex]);
+                    if (!source.normals.empty()) expanded.normals.push_back(source.normals[vertex]);
+                    if (!source.texCoords.empty()) expanded.texCoords.push_back(source.texCoords[vertex]);
+                    expanded.indices.push_back(i);
+                }
+                expanded.subMeshes.push_back(subMesh);
+            }
+            return expanded;
+        }
+    }
+
+    void RunMeshWeldingBenchmark(MicroBenchmarkContext& context) {
+        const std::string suite = "meshWelding";
+        BenchmarkReport& report = context.report;
+
+        ThreadPool pool;
+        const uint32_t threadCount = pool.GetThreadCount() + 1; // Workers plus the calling thread
+        report.SetMetric(suite, "threads", static_cast<uint64_t>(threadCount));
+
+        for (const auto& mesh : context.GetMeshes()) {
+            const std::string& name = mesh.name;
+            const MeshData expanded = Deindex(*mesh.meshData);
+
+            MeshData serial;
+            MeshData parallel;
+            WeldStatistics statistics;
+            double serialMs = MicroBenchmarks::MeasureBest(3, [&]() {
+                serial = expanded;
+                statistics = MeshWelder::Weld(serial);
+            });
+            double parallelMs = MicroBenchmarks::MeasureBest(3, [&]() {
+                parallel = expanded;
+                MeshWelder::Weld(parallel, {}, &pool);
+            });
+
+            const size_t wideIndexBytes = parallel.GetIndexMemory();
+            double narrowMs = MicroBenchmarks::MeasureBest(1, [&]() { parallel.NarrowIndices(); });
+
+            report.SetMetric(suite, name + ".verticesBefore", statistics.verticesBefore);
+            report.SetMetric(suite, name + ".verticesAfter", statistics.verticesAfter);
+            report.SetMetric(suite, name + ".vertexBytesBefore", static_cast<uint64_t>(expanded.GetVertexMemory()));
+            report.SetMetric(suite, name + ".vertexBytesAfter", static_cast<uint64_t>(parallel.GetVertexMemory()));
+            report.SetMetric(suite, name + ".indexBytes32", static_cast<uint64_t>(wideIndexBytes));
+            report.SetMetric(suite, name + ".indexBytesNarrowed", static_cast<uint64_t>(parallel.GetIndexMemory()));
+            report.SetMetric(suite, name + ".weldSerialMs", serialMs);
+            report.SetMetric(suite, name + ".weldParallelMs", parallelMs);
+            report.SetMetric(suite, name + ".weldSpeedup", parallelMs > 0.0 ? serialMs / parallelMs : 0.0);
+            report.SetMetric(suite, name + ".narrowMs", narrowMs);
+            report.SetMetric(suite, name + ".matchesSerial", parallel.vertices == serial.vertices);
+
+            LOG(INFO) << "Mesh welding " << name << ": " << statistics.verticesBefore << " -> " << statistics.verticesAfter
+                << " vertices, index bytes " << wideIndexBytes << " -> " << parallel.GetIndexMemory()
+                << ", weld " << serialMs << " ms serial / " << parallelMs << " ms on " << threadCount << " threads";
+        }
+    }
+}
@@ -0,0 +1,122 @@
+#include "MicroBenchmarks.hpp"
+#include "MeshletBuilder.hpp"
+#include "MeshletCuller.hpp"
+#include "ThreadPool.hpp"
+#include <algorithm>
+#include <cmath>
+#include <glm/gtc/constants.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <ng-log/logging.h>
+
+namespace Anito3D {
+
+    namespace {
+        constexpr uint32_t PathFrames = 120;
+        constexpr float FieldOfView = 60.0f;
+        constexpr float AspectRatio = 16.0f / 9.0f;
+
+        struct CameraPath {
+            const char* name;
+            // Eye and target for t in [0, 1), relative to a bounding sphere of radius 1 at the origin
+            void (*pose)(float t, glm::vec3& eye, glm::vec3& target);
+        };
+
+        // Full turn around the model from outside its bounds: mostly backface rejection
+        void OrbitPose(float t, glm::vec3& eye, glm::vec3& target) {
+            const float angle = t * 2.0f * glm::pi<float>();
+            eye = glm::vec3(std::cos(angle) * 2.5f, 0.75f, std::sin(angle) * 2.5f);
+            target = glm::vec3(0.0f);
+        }
+
+        // Skims the surface looking along the path: large parts fall outside the frustum
+        void FlybyPose(float t, glm::vec3& eye, glm::vec3& target) {
+            eye = glm::vec3(-2.0f + 4.0f * t, 0.2f, 1.2f);
+            target = eye + glm::vec3(1.0f, -0.1f, -0.4f);
+        }
+
+        const CameraPath CameraPaths[] = {
+            { "orbit", OrbitPose },
+            { "flyby", FlybyPose },
+        };
+    }
+
+    void RunMeshletBenchmark(MicroBenchmarkContext& context) {
+        const std::string suite = "meshlets";
+        BenchmarkReport& report = context.report;
+        const MeshletBuildOptions options;
+
+        ThreadPool pool;
+        report.SetMetric(suite, "maxVertices", static_cast<uint64_t>(options.maxVertices));
+        report.SetMetric(suite, "maxTriangles", static_cast<uint64_t>(options.maxTriangles));
+        report.SetMetric(suite, "frames", static_cast<uint64_t>(PathFrames));
+
+        for (const auto& mesh : context.GetMeshes()) {
+            const std::string& name = mesh.name;
+            const MeshData& meshData = *mesh.meshData;
+
+            MeshletData meshlets;
+            double buildMs = MicroBenchmarks::MeasureBest(1, [&]() { meshlets = MeshletBuilder::Build(meshData, options); });
+            double parallelBuildMs = MicroBenchmarks::MeasureBest(1, [&]() { MeshletBuilder::Build(meshData, options, &pool); });
+
+            const size_t meshletCount = meshlets.meshlets.size();
+            const size_t coneCount = std::count_if(meshlets.bounds.begin(), meshlets.bounds.end(),
+                [](const MeshletBounds& bounds) { return bounds.coneCutoff < 1.0f; });
+            report.SetMetric(suite, name + ".buildMs", buildMs);
+            report.SetMetric(suite, name + ".parallelBuildMs", parallelBuildMs);
+            report.SetMetric(suite, name + ".meshlets", static_cast<uint64_t>(meshletCount));
+            report.SetMetric(suite, name + ".averageVertices", meshletCount ? static_cast<double>(meshlets.vertices.size()) / meshletCount : 0.0);
+            report.SetMetric(suite, name + ".averageTriangles", meshletCount ? static_cast<double>(meshlets.GetTriangleCount()) / meshletCount : 0.0);
+            report.SetMetric(suite, name + ".coneRatio", meshletCount ? static_cast<double>(coneCount) / meshletCount : 0.0);
+            report.SetMetric(suite, name + ".bytes", static_cast<uint64_t>(meshlets.GetMemory()));
+
+            LOG(INFO) << "Meshlets " << name << ": " << meshletCount << " meshlets ("
+                << (meshletCount ? static_cast<double>(meshlets.GetTriangleCount()) / meshletCount : 0.0) << " triangles avg) in "
+                << buildMs << " ms, " << parallelBuildMs << " ms parallel";
+
+            const glm::vec3 center = meshData.bounds.center;
+            const float radius = meshData.bounds.radius > 0.0f ? meshData.bounds.radius : 1.0f;
+            const glm::mat4 projection = glm::perspective(glm::radians(FieldOfView), AspectRatio, radius * 0.01f, radius * 10.0f);
+
+            std::vector<VisibleMeshlet> visible;
+            visible.reserve(meshletCount);
+            for (const CameraPath& path : CameraPaths) {
+                double minRejected = 1.0, maxRejected = 0.0, sumRejected = 0.0;
+                double sumFrustum = 0.0, sumBackface = 0.0, cullMs = 0.0;
+
+                for (uint32_t frame = 0; frame < PathFrames; ++frame) {
+                    glm::vec3 eye, target;
+                    path.pose(static_cast<float>(frame) / PathFrames, eye, target);
+                    eye = center + eye * radius;
+                    target = center + target * radius;
+                    const Frustum frustum = Frustum::FromMatrix(projection * glm::lookAt(eye, target, glm::vec3(0.0f, 1.0f, 0.0f)));
+
+                    MeshletCullStatistics statistics;
+                    visible.clear();
+                    cullMs += MicroBenchmarks::MeasureBest(1, [&]() {
+                        MeshletCuller::Cull(meshData, meshlets, glm::mat4(1.0f), frustum, eye, visible, &statistics);
+                    });
+
+                    const double rejected = statistics.GetRejectedTriangleRatio();
+                    const double triangles = statistics.triangles ? static_cast<double>(statistics.triangles) : 1.0;
+                    minRejected = std::min(minRejected, rejected);
+                    maxRejected = std::max(maxRejected, rejected);
+                    sumRejected += rejected;
+                    sumFrustum += statistics.trianglesFrustumCulled / triangles;
+                    sumBackface += statistics.trianglesBackfaceCulled / triangles;
+                }
+
+                const std::string prefix = name + "." + path.name;
+                report.SetMetric(suite, prefix + ".rejectedPercent", 100.0 * sumRejected / PathFrames);
+                report.SetMetric(suite, prefix + ".minRejectedPercent", 100.0 * minRejected);
+                report.SetMetric(suite, prefix + ".maxRejectedPercent", 100.0 * maxRejected);
+                report.SetMetric(suite, prefix + ".frustumPercent", 100.0 * sumFrustum / PathFrames);
+                report.SetMetric(suite, prefix + ".backfacePercent", 100.0 * sumBackface / PathFrames);
+                report.SetMetric(suite, prefix + ".cullUs", 1000.0 * cullMs / PathFrames);
+
+                LOG(INFO) << "Meshlet culling " << name << " (" << path.name << "): " << 100.0 * sumRejected / PathFrames
+                    << "% triangles rejected (" << 100.0 * sumFrustum / PathFrames << "% frustum, " << 100.0 * sumBackface / PathFrames
+                    << "% backface), " << 1000.0 * cullMs / PathFrames << " us per frame";
+            }
+        }
+    }
+}
@@ -0,0 +1,122 @@
+#include "MicroBenchmarks.hpp"
+#include "MeshBounds.hpp"
+#include <algorithm>
+#include <filesystem>
+#include <ng-log/logging.h>
+
+namespace Anito3D {
+
+    std::vector<MicroBenchmarkMesh> MicroBenchmarkContext::GetMeshes() const {
+        std::vector<MicroBenchmarkMesh> meshes;
+        for (size_t i = 0; i < entities.size(); ++i) {
+            if (entities[i]->GetMeshView().vertices.empty()) continue;
+            std::string name = i < entityPaths.size() ? std::filesystem::path(entityPaths[i]).filename().string() : "mesh" + std::to_string(i);
+            meshes.push_back({ name, &entities[i]->GetMeshData() });
+        }
+        if (meshes.empty()) {
+            static const MeshData sphere = MicroBenchmarks::GenerateSphere(512, 256);
+            meshes.push_back({ "sphere", &sphere });
+        }
+        return meshes;
+    }
+
+    const std::vector<MicroBenchmark>& MicroBenchmarks::GetAll() {
+        // Explicit table rather than static registration so the linker cannot drop suites
+        static const std::vector<MicroBenchmark> suites = {
+            { "vertexPacking", "Packed vertex format size, pack/unpack throughput and error", RunVertexPackingBenchmark },
+            { "meshOptimizer", "Vertex cache/overdraw/fetch reordering, ACMR/ATVR before and after", RunMeshOptimizerBenchmark },
+            { "meshWelding", "De-indexed mesh welding (serial vs thread pool) and 16-bit index narrowing", RunMeshWeldingBenchmark },
+            { "meshSimplifier", "Quadric LOD chain generation, triangles per level, error and triangles/s", RunMeshSimplifierBenchmark },
+            { "meshlets", "Meshlet building (64 vertices / 124 triangles) and CPU frustum + cone culling along camera paths", RunMeshletBenchmark },
+            { "transforms", "SoA transform store: dirty-only world matrix updates (scalar/SSE/parallel) vs Euler rebuild at 10k/100k/1M", RunTransformBenchmark },
+            { "sceneGraph", "Hierarchy world-transform propagation: full, parallel and single-node incremental updates", RunSceneGraphBenchmark },
+            { "ecs", "Archetype component storage with parallel chunk systems vs virtual Entity::Update at 100k/1M", RunEcsBenchmark },
+            { "jobs", "Work-stealing job system: skewed parallel loop (static blocks vs stealing), per-job and dependency overhead", RunJobBenchmark },
+            { "frustumCulling", "Load-time mesh bounds and bulk box culling of 1M objects (scalar/SSE2/AVX2/parallel), visible vs culled", RunFrustumCullingBenchmark },
+            { "bvh", "Parallel binned-SAH BVH build (serial vs jobs), node count, SAH cost, 4/8-wide collapse and closest-hit Mrays/s", RunBvhBenchmark },
+            { "gpuUpload", "Sub-allocated device-local mesh buffers filled through the staging ring: MB/s, copy commands, memory blocks and fragmentation", RunGpuUploadBenchmark, true },
+            { "pipelineCache", "Compute pipeline creation through a cold, then a warm (reloaded) VkPipelineCache: ms per pipeline and speedup", RunPipelineCacheBenchmark, true },
+        };
+        return suites;
+    }
+
+    bool MicroBenchmarks::Run(const std::vector<std::string>& names, MicroBenchmarkContext& context) {
+        const auto& suites = GetAll();
+        bool runAll = std::find(names.begin(), names.end(), "all") != names.end();
+
+        for (const auto& name : names) {
+            if (name == "all") continue;
+            auto found = std::find_if(suites.begin(), suites.end(), [&](const MicroBenchmark& suite) { return name == suite.name; });
+            if (found == suites.end()) {
+                std::string available;
+                for (const auto& suite : suites) {
+                    available += (available.empty() ? "" : ", ") + std::string(suite.name);
+                }
+                LOG(ERROR) << "Unknown micro benchmark: " << name << " (available: " << available << ")";
+                return false;
+            }
+        }
+
+        for (const auto& suite : suites) {
+            const bool named = std::find(names.begin(), names.end(), suite.name) != names.end();
+            if (!runAll && !named) continue;
+            if (suite.requiresGpu && !context.options.gpuMicroBenchmarks) {
+                // The headless CPU path never creates a Vulkan device unless asked to
+                if (named) LOG(WARNING) << "Skipping micro benchmark " << suite.name << ": it needs a Vulkan device, pass --gpu";
+                continue;
+            }
+
+            LOG(INFO) << "Micro benchmark: " << suite.name << " - " << suite.description;
+            auto start = std::chrono::steady_clock::now();
+            suite.run(context);
+            context.report.SetMetric(suite.name, "suiteMs",
+                std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+        }
+        return true;
+    }
+
+    MeshData MicroBenchmarks::GenerateSphere(uint32_t segments, uint32_t rings, float radius) {
+        MeshData meshData;
+        segments = std::max(segments, 3u);
+        rings = std::max(rings, 2u);
+
+        const float pi = 3.14159265358979f;
+        const size_t vertexCount = static_cast<size_t>(segments + 1) * (rings + 1);
+        meshData.vertices.reserve(vertexCount);
+        meshData.normals.reserve(vertexCount);
+        meshData.texCoords.reserve(vertexCount);
+
+        for (uint32_t ring = 0; ring <= rings; ++ring) {
+            float v = static_cast<float>(ring) / rings;
+            float theta = v * pi;
+            for (uint32_t segment = 0; segment <= segments; ++segment) {
+                float u = static_cast<float>(segment) / segments;
+                float phi = u * 2.0f * pi;
+                glm::vec3 normal(std::sin(theta) * std::cos(phi), std::cos(theta), std::sin(theta) * std::sin(phi));
+                meshData.vertices.push_back(normal * radius);
+                meshData.normals.push_back(normal);
+                meshData.texCoords.emplace_back(u, v);
+            }
+        }
+
+        meshData.indices.reserve(static_cast<size_t>(segments) * rings * 6);
+        for (uint32_t ring = 0; ring < rings; ++ring) {
+            for (uint32_t segment = 0; segment < segments; ++segment) {
+                uint32_t a = ring * (segments + 1) + segment;
+                uint32_t b = a + segments + 1;
+                meshData.indices.insert(meshData.indices.end(), { a, a + 1, b, a + 1, b + 1, b }); // Counter-clockwise from outside
+            }
+        }
+
+        MeshData::SubMesh subMesh;
+        subMesh.firstIndex = 0;
+        subMesh.indexCount = static_cast<uint32_t>(meshData.indices.size());
+        subMesh.vertexOffset = 0;
+        subMesh.vertexCount = static_cast<uint32_t>(vertexCount);
+        subMesh.materialId = 0;
+        meshData.subMeshes.push_back(subMesh);
+        meshData.materials.emplace_back();
+        MeshBounds::Update(meshData);
+        return meshData;
+    }
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "BenchmarkOptions.hpp"
+#include "BenchmarkReport.hpp"
+#include "MeshEntity.hpp"
+
+namespace Anito3D {
+
+    struct MicroBenchmarkMesh {
+        std::string name; // Source file name, used as metric key prefix
+        const MeshData* meshData;
+    };
+
+    // Inputs shared by every micro benchmark suite. Suites write their results into
+    // report.SetMetric(<suite name>, ...).
+    struct MicroBenchmarkContext {
+        const BenchmarkOptions& options;
+        const std::vector<std::unique_ptr<MeshEntity>>& entities;
+        const std::vector<std::string>& entityPaths;
+        BenchmarkReport& report;
+
+        // Loaded meshes, or a generated sphere when nothing was loaded
+        std::vector<MicroBenchmarkMesh> GetMeshes() const;
+    };
+
+    struct MicroBenchmark {
+        const char* name;
+        const char* description;
+        void (*run)(MicroBenchmarkContext& context);
+        bool requiresGpu = false; // Creates a headless Vulkan device, only runs with --gpu
+    };
+
+    class MicroBenchmarks {
+    public:
+        static const std::vector<MicroBenchmark>& GetAll();
+
+        // Runs the named suites ("all" runs every suite), returns false on unknown names.
+        // Suites that require a GPU are skipped unless options.gpuMicroBenchmarks is set.
+        static bool Run(const std::vector<std::string>& names, MicroBenchmarkContext& context);
+
+        // UV sphere with normals and texcoords, used when no models are loaded
+        static MeshData GenerateSphere(uint32_t segments, uint32_t rings, float radius = 1.0f);
+
+        // Best of `repeats` runs, in milliseconds
+        template <typename F>
+        static double MeasureBest(uint32_t repeats, F&& function) {
+            double best = 0.0;
+            for (uint32_t i = 0; i < repeats; ++i) {
+                auto start = std::chrono::steady_clock::now();
+                function();
+                double elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+                if (i == 0 || elapsed < best) best = elapsed;
+            }
+            return best;
+        }
+    };
+
+    // Suite entry points, one per module (benchmark/<Module>Benchmark.cpp)
+    void RunVertexPackingBenchmark(MicroBenchmarkContext& context);
+    void RunMeshOptimizerBenchmark(MicroBenchmarkContext& context);
+    void RunMeshWeldingBenchmark(MicroBenchmarkContext& context);
+    void RunMeshSimplifierBenchmark(MicroBenchmarkContext& context);
+    void RunMeshletBenchmark(MicroBenchmarkContext& context);
+    void RunTransformBenchmark(MicroBenchmarkContext& context);
+    void RunSceneGraphBenchmark(MicroBenchmarkContext& context);
+    void RunEcsBenchmark(MicroBenchmarkContext& context);
+    void RunJobBenchmark(MicroBenchmarkContext& context);
+    void RunFrustumCullingBenchmark(MicroBenchmarkContext& context);
+    void RunBvhBenchmark(MicroBenchmarkContext& context);
+    void RunGpuUploadBenchmark(MicroBenchmarkContext& context);
+    void RunPipelineCacheBenchmark(MicroBenchmarkContext& context);
+
+}
@@ -0,0 +1,132 @@
+#include "MicroBenchmarks.hpp"
+#include "HeadlessVulkanDevice.hpp"
+#include "PipelineCache.hpp"
+#include <filesystem>
+#include <random>
+#include <ng-log/logging.h>
+
+namespace Anito3D {
+
+    namespace {
+        constexpr uint32_t PipelineCount = 64;
+
+        // layout(local_size_x_id = 0) in; void main() {} as SPIR-V 1.0, assembled by hand so the
+        // suite needs no shader compiler. Every pipeline specializes a different workgroup
+        // width, so the driver has to compile (or find in the cache) a distinct pipeline.
+        const uint32_t ComputeShader[] = {
+            0x07230203, 0x00010000, 0, 10, 0,    // Magic, version 1.0, generator, id bound, schema
+            0x00020011, 1,                       // OpCapability Shader
+            0x0003000E, 0, 1,                    // OpMemoryModel Logical GLSL450
+            0x0005000F, 5, 1, 0x6E69616D, 0,     // OpEntryPoint GLCompute %1 "main"
+            0x00060010, 1, 17, 1, 1, 1,          // OpExecutionMode %1 LocalSize 1 1 1
+            0x00040047, 2, 1, 0,                 // OpDecorate %2 SpecId 0
+            0x00040047, 3, 11, 25,               // OpDecorate %3 BuiltIn WorkgroupSize
+            0x00020013, 4,                       // %4 = OpTypeVoid
+            0x00030021, 5, 4,                    // %5 = OpTypeFunction %4
+            0x00040015, 6, 32, 0,                // %6 = OpTypeInt 32 0
+            0x00040017, 7, 6, 3,                 // %7 = OpTypeVector %6 3
+            0x00040032, 6, 2, 1,                 // %2 = OpSpecConstant %6 1
+            0x0004002B, 6, 8, 1,                 // %8 = OpConstant %6 1
+            0x00060033, 7, 3, 2, 8, 8,           // %3 = OpSpecConstantComposite %7 %2 %8 %8
+            0x00050036, 4, 1, 0, 5,              // %1 = OpFunction %4 None %5
+            0x000200F8, 9,                       // %9 = OpLabel
+            0x000100FD,                          // OpReturn
+            0x00010038,                          // OpFunctionEnd
+        };
+
+        // Creates and destroys PipelineCount pipelines through the cache; false on the first failure
+        bool CreatePipelines(VkDevice device, PipelineCache& cache, VkShaderModule module, VkPipelineLayout layout) {
+            for (uint32_t i = 0; i < PipelineCount; ++i) {
+                const uint32_t workgroupWidth = i + 1;
+                const VkSpecializationMapEntry entry = { 0, 0, sizeof(uint32_t) };
+                VkSpecializationInfo specialization = {};
+                specialization.mapEntryCount = 1;
+                specialization.pMapEntries = &entry;
+                specialization.dataSize = sizeof(workgroupWidth);
+                specialization.pData = &workgroupWidth;
+
+                VkComputePipelineCreateInfo pipelineInfo = { VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO };
+                pipelineInfo.stage = { VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO };
+                pipelineInfo.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+                pipelineInfo.stage.module = module;
+                pipelineInfo.stage.pName = "main";
+                pipelineInfo.stage.pSpecializationInfo = &specialization;
+                pipelineInfo.layout = layout;
+
+                VkPipeline pipeline = VK_NULL_HANDLE;
+                const auto start = std::chrono::steady_clock::now();
+                const VkResult result = vkCreateComputePipelines(device, cache.get(), 1, &pipelineInfo, nullptr, &pipeline);
+                cache.addPipelineCreation(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+                if (result != VK_SUCCESS) {
+                    LOG(WARNING) << "Pipeline cache benchmark: vkCreateComputePipelines failed: " << result;
+                    return false;
+                }
+                vkDestroyPipeline(device, pipeline, nullptr);
+            }
+            return true;
+        }
+    }
+
+    void RunPipelineCacheBenchmark(MicroBenchmarkContext& context) {
+        const std::string suite = "pipelineCache";
+        BenchmarkReport& report = context.report;
+
+        HeadlessVulkanDevice headless;
+        const bool available = headless.Init(suite.c_str());
+        report.SetMetric(suite, "available", available);
+        if (!available) return;
+        report.SetMetric(suite, "device", headless.device.physical_device.name);
+        const VkDevice device = headless.device.device;
+
+        VkShaderModuleCreateInfo moduleInfo = { VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO };
+        moduleInfo.codeSize = sizeof(ComputeShader);
+        moduleInfo.pCode = ComputeShader;
+        VkShaderModule module = VK_NULL_HANDLE;
+        VkPipelineLayoutCreateInfo layoutInfo = { VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO };
+        VkPipelineLayout layout = VK_NULL_HANDLE;
+        if (vkCreateShaderModule(device, &moduleInfo, nullptr, &module) != VK_SUCCESS ||
+            vkCreatePipelineLayout(device, &layoutInfo, nullptr, &layout) != VK_SUCCESS) {
+            LOG(WARNING) << "Pipeline cache benchmark: failed to create the shader module or pipeline layout";
+            report.SetMetric(suite, "success", false);
+            if (module != VK_NULL_HANDLE) vkDestroyShaderModule(device, module, nullptr);
+            return;
+        }
+
+        // A private file, so the first pass starts cold whatever the app's own cache holds.
+        // Drivers with their own on-disk shader cache can still make the cold pass fast.
+        const std::filesystem::path cachePath = std::filesystem::temp_directory_path() /
+            ("Anito3DPipelineCacheBenchmark-" + std::to_string(std::random_device{}()) + ".bin");
+        std::error_code ec;
+        std::filesystem::remove(cachePath, ec);
+
+        bool success = true;
+        double passMilliseconds[2] = {};
+        const char* passNames[2] = { "cold", "warm" };
+        for (int pass = 0; pass < 2 && success; ++pass) {
+            PipelineCache cache;
+            success = cache.init(headless.device.physical_device.physical_device, device, cachePath.string());
+            if (!success) break;
+            success = CreatePipelines(device, cache, module, layout);
+
+            const std::string prefix = std::string(passNames[pass]) + ".";
+            passMilliseconds[pass] = cache.getPipelineMilliseconds();
+            report.SetMetric(suite, prefix + "status", std::string(PipelineCache::getStatusName(cache.getStatus())));
+            report.SetMetric(suite, prefix + "loadedBytes", cache.getLoadedBytes());
+            report.SetMetric(suite, prefix + "pipelines", static_cast<uint64_t>(cache.getPipelineCount()));
+            report.SetMetric(suite, prefix + "pipelineMs", cache.getPipelineMilliseconds());
+            report.SetMetric(suite, prefix + "msPerPipeline",
+                cache.getPipelineCount() > 0 ? cache.getPipelineMilliseconds() / cache.getPipelineCount() : 0.0);
+            cache.cleanup(); // Writes the file the warm pass loads
+        }
+        report.SetMetric(suite, "success", success);
+        if (success) {
+            report.SetMetric(suite, "warmSpeedup", passMilliseconds[1] > 0.0 ? passMilliseconds[0] / passMilliseconds[1] : 0.0);
+            LOG(INFO) << "Pipeline cache: " << PipelineCount << " compute pipelines in " << passMilliseconds[0] << " ms cold, "
+                << passMilliseconds[1] << " ms warm";
+        }
+
+        std::filesystem::remove(cachePath, ec);
+        vkDestroyPipelineLayout(device, layout, nullptr);
+        vkDestroyShaderModule(device, module, nullptr);
+    }
+}
@@ -0,0 +1,50 @@
+#include "ProcessMemory.hpp"
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#include <psapi.h>
+#elif defined(__linux__)
+#include <fstream>
+#include <string>
+#else
+#include <sys/resource.h>
+#endif
+
+namespace Anito3D {
+
+    ProcessMemoryStats QueryProcessMemory() {
+        ProcessMemoryStats stats;
+
+#if defined(_WIN32)
+        PROCESS_MEMORY_COUNTERS counters = {};
+        if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+            stats.currentResidentBytes = counters.WorkingSetSize;
+            stats.peakResidentBytes = counters.PeakWorkingSetSize;
+        }
+#elif defined(__linux__)
+        // VmRSS / VmHWM are reported in kB
+        std::ifstream status("/proc/self/status");
+        std::string line;
+        while (std::getline(status, line)) {
+            if (line.rfind("VmRSS:", 0) == 0) {
+                stats.currentResidentBytes = std::stoull(line.substr(6)) * 1024ull;
+            }
+            else if (line.rfind("VmHWM:", 0) == 0) {
+                stats.peakResidentBytes = std::stoull(line.substr(6)) * 1024ull;
+            }
+        }
+#else
+        // ru_maxrss is in bytes on macOS
+        struct rusage usage = {};
+        if (getrusage(RUSAGE_SELF, &usage) == 0) {
+            stats.peakResidentBytes = static_cast<uint64_t>(usage.ru_maxrss);
+            stats.currentResidentBytes = stats.peakResidentBytes;
+        }
+#endif
+
+        return stats;
+    }
+}
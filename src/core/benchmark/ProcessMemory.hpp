@@ -0,0 +1,15 @@
+#pragma once
+
+#include <cstdint>
+
+namespace Anito3D {
+
+    struct ProcessMemoryStats {
+        uint64_t currentResidentBytes = 0; // Current working set / RSS
+        uint64_t peakResidentBytes = 0;    // High-water mark of the working set / RSS
+    };
+
+    // Query resident memory of the current process (zeroes if unsupported on this platform)
+    ProcessMemoryStats QueryProcessMemory();
+
+}
@@ -0,0 +1,129 @@
+#include "MicroBenchmarks.hpp"
+#include "SceneGraph.hpp"
+#include "ThreadPool.hpp"
+#include <glm/gtc/matrix_transform.hpp>
+#include <ng-log/logging.h>
+#include <random>
+
+namespace Anito3D {
+
+    namespace {
+        constexpr uint32_t Repeats = 5;
+        constexpr uint32_t SingleNodeMoves = 1000;
+
+        glm::mat4 RandomLocal(std::mt19937& random) {
+            std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+            glm::mat4 local = glm::translate(glm::mat4(1.0f), glm::vec3(unit(random), unit(random), unit(random)));
+            return glm::rotate(local, unit(random) * 3.14159265f, glm::normalize(glm::vec3(unit(random), unit(random), 1.0f)));
+        }
+
+        // Balanced tree: every node has `fanout` children until count is reached
+        std::vector<MeshData::Node> BuildBroadHierarchy(uint32_t count, uint32_t fanout, std::mt19937& random) {
+            std::vector<MeshData::Node> nodes;
+            nodes.reserve(count);
+            nodes.push_back({ RandomLocal(random), MeshData::NoParent });
+            // Breadth-first construction, then re-sorted into pre-order by the graph
+            for (uint32_t i = 1; i < count; ++i) nodes.push_back({ RandomLocal(random), (i - 1) / fanout });
+            return nodes;
+        }
+
+        // Independent chains of `depth` nodes below one root (skinned/rigged style hierarchies)
+        std::vector<MeshData::Node> BuildDeepHierarchy(uint32_t chains, uint32_t depth, std::mt19937& random) {
+            std::vector<MeshData::Node> nodes;
+            nodes.reserve(1 + static_cast<size_t>(chains) * depth);
+            nodes.push_back({ glm::mat4(1.0f), MeshData::NoParent });
+            for (uint32_t c = 0; c < chains; ++c) {
+                uint32_t parent = 0;
+                for (uint32_t d = 0; d < depth; ++d) {
+                    nodes.push_back({ RandomLocal(random), parent });
+                    parent = static_cast<uint32_t>(nodes.size() - 1);
+                }
+            }
+            return nodes;
+        }
+
+        void MeasureHierarchy(BenchmarkReport& report, const std::string& suite, const std::string& name,
+            const std::vector<MeshData::Node>& source, ThreadPool& pool) {
+            SceneGraph graph;
+            std::vector<SceneNodeId> ids;
+            double sortMs = MicroBenchmarks::MeasureBest(1, [&]() {
+                ids = graph.AddHierarchy(source);
+                graph.Update();
+            });
+            const SceneNodeId root = ids.front();
+            const glm::mat4 rootLocal = graph.GetLocalTransform(root);
+
+            SceneGraphUpdateStatistics full;
+            double fullMs = MicroBenchmarks::MeasureBest(Repeats, [&]() {
+                graph.SetLocalTransform(root, rootLocal);
+                full = graph.Update();
+            });
+            SceneGraphUpdateStatistics parallel;
+            double parallelMs = MicroBenchmarks::MeasureBest(Repeats, [&]() {
+                graph.SetLocalTransform(root, rootLocal);
+                parallel = graph.Update(&pool);
+            });
+
+            // One random node per frame, the common editor/gameplay case
+            std::mt19937 random(42);
+            uint64_t movedNodes = 0;
+            double singleMs = MicroBenchmarks::MeasureBest(1, [&]() {
+                for (uint32_t i = 0; i < SingleNodeMoves; ++i) {
+                    const SceneNodeId node = ids[random() % ids.size()];
+                    graph.SetLocalTransform(node, graph.GetLocalTransform(node));
+                    movedNodes += graph.Update().nodesUpdated;
+                }
+            });
+
+            // Leaves only: should cost one matrix multiply plus bookkeeping
+            std::vector<uint8_t> hasChildren(source.size(), 0);
+            for (const auto& node : source) {
+                if (node.parent != MeshData::NoParent) hasChildren[node.parent] = 1;
+            }
+            std::vector<SceneNodeId> leaves;
+            for (size_t i = 0; i < source.size(); ++i) {
+                if (!hasChildren[i]) leaves.push_back(ids[i]);
+            }
+            double leafMs = MicroBenchmarks::MeasureBest(1, [&]() {
+                for (uint32_t i = 0; i < SingleNodeMoves; ++i) {
+                    const SceneNodeId node = leaves[random() % leaves.size()];
+                    graph.SetLocalTransform(node, graph.GetLocalTransform(node));
+                    graph.Update();
+                }
+            });
+
+            const std::string& prefix = name;
+            report.SetMetric(suite, prefix + ".nodes", static_cast<uint64_t>(graph.GetNodeCount()));
+            report.SetMetric(suite, prefix + ".maxDepth", static_cast<uint64_t>(graph.GetMaxDepth()));
+            report.SetMetric(suite, prefix + ".sortMs", sortMs);
+            report.SetMetric(suite, prefix + ".fullMs", fullMs);
+            report.SetMetric(suite, prefix + ".parallelMs", parallelMs);
+            report.SetMetric(suite, prefix + ".parallelTasks", parallel.tasks);
+            report.SetMetric(suite, prefix + ".singleNodeUs", 1000.0 * singleMs / SingleNodeMoves);
+            report.SetMetric(suite, prefix + ".singleNodeAverageUpdated", static_cast<double>(movedNodes) / SingleNodeMoves);
+            report.SetMetric(suite, prefix + ".leafUs", 1000.0 * leafMs / SingleNodeMoves);
+
+            LOG(INFO) << "Scene graph " << name << ": " << graph.GetNodeCount() << " nodes, depth " << graph.GetMaxDepth()
+                << ", full " << fullMs << " ms (" << parallelMs << " ms in " << parallel.tasks << " tasks), single node "
+                << 1000.0 * singleMs / SingleNodeMoves << " us (" << static_cast<double>(movedNodes) / SingleNodeMoves
+                << " nodes avg), leaf " << 1000.0 * leafMs / SingleNodeMoves << " us";
+        }
+    }
+
+    void RunSceneGraphBenchmark(MicroBenchmarkContext& context) {
+        const std::string suite = "sceneGraph";
+        BenchmarkReport& report = context.report;
+
+        ThreadPool pool;
+        report.SetMetric(suite, "threads", static_cast<uint64_t>(pool.GetThreadCount() + 1));
+
+        std::mt19937 random(1234);
+        MeasureHierarchy(report, suite, "broad", BuildBroadHierarchy(100000, 8, random), pool);
+        MeasureHierarchy(report, suite, "deep", BuildDeepHierarchy(100, 1000, random), pool);
+
+        // Imported node trees (cached meshes keep them as well)
+        for (const auto& mesh : context.GetMeshes()) {
+            if (mesh.meshData->nodes.size() > 1) MeasureHierarchy(report, suite, mesh.name, mesh.meshData->nodes, pool);
+        }
+    }
+}
@@ -0,0 +1,113 @@
+#include "MicroBenchmarks.hpp"
+#include "ThreadPool.hpp"
+#include "TransformStore.hpp"
+#include <glm/gtc/matrix_transform.hpp>
+#include <ng-log/logging.h>
+#include <random>
+
+namespace Anito3D {
+
+    namespace {
+        constexpr uint32_t Repeats = 5;
+        constexpr size_t EntityCounts[] = { 10000, 100000, 1000000 };
+        constexpr double SparseFraction = 0.1; // Share of transforms changed per frame in the sparse case
+
+        // The per-consumer path the store replaces: Euler angles rebuilt into a matrix every frame
+        struct EulerTransform {
+            glm::vec3 position;
+            glm::vec3 rotation; // Degrees
+            glm::vec3 scale;
+        };
+
+        glm::mat4 ComposeEuler(const EulerTransform& transform) {
+            glm::mat4 matrix = glm::translate(glm::mat4(1.0f), transform.position);
+            matrix = glm::rotate(matrix, glm::radians(transform.rotation.z), glm::vec3(0.0f, 0.0f, 1.0f));
+            matrix = glm::rotate(matrix, glm::radians(transform.rotation.y), glm::vec3(0.0f, 1.0f, 0.0f));
+            matrix = glm::rotate(matrix, glm::radians(transform.rotation.x), glm::vec3(1.0f, 0.0f, 0.0f));
+            return glm::scale(matrix, transform.scale);
+        }
+
+        double NanosecondsPer(double milliseconds, size_t count) {
+            return count ? milliseconds * 1.0e6 / static_cast<double>(count) : 0.0;
+        }
+    }
+
+    void RunTransformBenchmark(MicroBenchmarkContext& context) {
+        const std::string suite = "transforms";
+        BenchmarkReport& report = context.report;
+
+        ThreadPool pool;
+        const uint32_t threadCount = pool.GetThreadCount() + 1;
+        report.SetMetric(suite, "threads", static_cast<uint64_t>(threadCount));
+        report.SetMetric(suite, "sparseFraction", SparseFraction);
+
+        for (size_t count : EntityCounts) {
+            std::mt19937 random(1234);
+            std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+
+            std::vector<EulerTransform> euler(count);
+            TransformStore store;
+            store.Reserve(count);
+            std::vector<TransformHandle> handles(count);
+            for (size_t i = 0; i < count; ++i) {
+                euler[i] = { glm::vec3(unit(random), unit(random), unit(random)) * 100.0f,
+                    glm::vec3(unit(random), unit(random), unit(random)) * 180.0f, glm::vec3(1.0f + 0.5f * unit(random)) };
+                handles[i] = store.Create(euler[i].position, glm::quat(glm::radians(euler[i].rotation)), euler[i].scale);
+            }
+
+            std::vector<glm::mat4> eulerMatrices(count);
+            double eulerMs = MicroBenchmarks::MeasureBest(Repeats, [&]() {
+                for (size_t i = 0; i < count; ++i) eulerMatrices[i] = ComposeEuler(euler[i]);
+            });
+            double scalarMs = MicroBenchmarks::MeasureBest(Repeats, [&]() {
+                store.MarkAllDirty();
+                store.UpdateWorldMatrices(nullptr, false);
+            });
+            double simdMs = MicroBenchmarks::MeasureBest(Repeats, [&]() {
+                store.MarkAllDirty();
+                store.UpdateWorldMatrices();
+            });
+            double parallelMs = MicroBenchmarks::MeasureBest(Repeats, [&]() {
+                store.MarkAllDirty();
+                store.UpdateWorldMatrices(&pool);
+            });
+
+            // Frame where a random subset moved; only those matrices are rebuilt
+            const size_t sparseCount = static_cast<size_t>(count * SparseFraction);
+            std::vector<uint32_t> moved(sparseCount);
+            for (uint32_t& index : moved) index = static_cast<uint32_t>(random() % count);
+            double sparseMs = MicroBenchmarks::MeasureBest(Repeats, [&]() {
+                for (uint32_t index : moved) store.SetPosition(handles[index], store.GetPosition(handles[index]) + glm::vec3(0.01f));
+                store.UpdateWorldMatrices();
+            });
+            double idleMs = MicroBenchmarks::MeasureBest(Repeats, [&]() { store.UpdateWorldMatrices(); });
+
+            // Both paths must agree (Euler ZYX rotate chain vs quaternion from the same angles)
+            float maxError = 0.0f;
+            for (size_t i = 0; i < count; i += 97) {
+                const glm::mat4 reference = ComposeEuler(euler[i]);
+                const glm::mat4& cached = store.GetWorldMatrix(handles[i]);
+                for (int c = 0; c < 3; ++c) {
+                    for (int r = 0; r < 3; ++r) maxError = std::max(maxError, std::abs(reference[c][r] - cached[c][r]));
+                }
+            }
+
+            const std::string prefix = std::to_string(count);
+            report.SetMetric(suite, prefix + ".eulerNs", NanosecondsPer(eulerMs, count));
+            report.SetMetric(suite, prefix + ".scalarNs", NanosecondsPer(scalarMs, count));
+            report.SetMetric(suite, prefix + ".simdNs", NanosecondsPer(simdMs, count));
+            report.SetMetric(suite, prefix + ".parallelNs", NanosecondsPer(parallelMs, count));
+            report.SetMetric(suite, prefix + ".simdSpeedup", simdMs > 0.0 ? scalarMs / simdMs : 0.0);
+            report.SetMetric(suite, prefix + ".sparseMs", sparseMs);
+            report.SetMetric(suite, prefix + ".idleMs", idleMs);
+            report.SetMetric(suite, prefix + ".fullMs", simdMs);
+            report.SetMetric(suite, prefix + ".eulerMs", eulerMs);
+            report.SetMetric(suite, prefix + ".maxRotationError", static_cast<double>(maxError));
+
+            LOG(INFO) << "Transforms " << count << ": Euler " << NanosecondsPer(eulerMs, count) << " ns, scalar "
+                << NanosecondsPer(scalarMs, count) << " ns, SSE " << NanosecondsPer(simdMs, count) << " ns, parallel "
+                << NanosecondsPer(parallelMs, count) << " ns per matrix; " << SparseFraction * 100.0 << "% dirty " << sparseMs
+                << " ms, clean frame " << idleMs << " ms";
+        }
+    }
+}
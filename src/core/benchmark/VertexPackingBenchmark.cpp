@@ -0,0 +1,110 @@
+#include "MicroBenchmarks.hpp"
+#include "VertexPacking.hpp"
+#include <algorithm>
+#include <cmath>
+#include <ng-log/logging.h>
+
+namespace Anito3D {
+
+    namespace {
+        struct PackingErrors {
+            float position = 0.0f;
+            float normalRadians = 0.0f;
+            float texCoord = 0.0f;
+        };
+
+        PackingErrors MeasureErrors(const MeshData& original, const MeshData& decoded) {
+            PackingErrors errors;
+            for (size_t i = 0; i < original.vertices.size(); ++i) {
+                glm::vec3 delta = glm::abs(original.vertices[i] - decoded.vertices[i]);
+                errors.position = std::max({ errors.position, delta.x, delta.y, delta.z });
+            }
+            for (size_t i = 0; i < original.normals.size(); ++i) {
+                float length = glm::length(original.normals[i]);
+                if (length < 1e-6f) continue; // Degenerate normals have no direction to preserve
+                // atan2 stays accurate for tiny angles where acos(dot) saturates in float
+                glm::vec3 normal = original.normals[i] / length;
+                float angle = std::atan2(glm::length(glm::cross(normal, decoded.normals[i])), glm::dot(normal, decoded.normals[i]));
+                errors.normalRadians = std::max(errors.normalRadians, angle);
+            }
+            for (size_t i = 0; i < original.texCoords.size(); ++i) {
+                glm::vec2 delta = glm::abs(original.texCoords[i] - decoded.texCoords[i]);
+                errors.texCoord = std::max({ errors.texCoord, delta.x, delta.y });
+            }
+            return errors;
+        }
+
+        const char* GetFormatName(const PackedVertexFormat& format) {
+            if (format.position == PositionEncoding::Float32) {
+                return format.texCoord == TexCoordEncoding::Half ? "float32_halfUv" : "float32_unorm16Uv";
+            }
+            return format.texCoord == TexCoordEncoding::Half ? "unorm16_halfUv" : "unorm16_unorm16Uv";
+        }
+    }
+
+    void RunVertexPackingBenchmark(MicroBenchmarkContext& context) {
+        const std::string suite = "vertexPacking";
+        const uint32_t repeats = 5;
+        BenchmarkReport& report = context.report;
+
+        report.SetMetric(suite, "simd", VertexPacker::IsSimdEnabled());
+        report.SetMetric(suite, "sourceBytesPerVertex", static_cast<uint64_t>(sizeof(glm::vec3) * 2 + sizeof(glm::vec2)));
+
+        const PackedVertexFormat formats[] = {
+            { PositionEncoding::Float32, TexCoordEncoding::Half },
+            { PositionEncoding::Unorm16, TexCoordEncoding::Unorm16 },
+        };
+
+        std::vector<MicroBenchmarkMesh> meshes = context.GetMeshes();
+        for (const auto& format : formats) {
+            const std::string prefix = GetFormatName(format);
+            size_t vertexCount = 0;
+            size_t sourceBytes = 0;
+            size_t packedBytes = 0;
+            double packMs = 0.0;
+            double unpackMs = 0.0;
+            PackingErrors worst;
+            bool withinBounds = true;
+
+            for (const auto& mesh : meshes) {
+                const MeshData* meshData = mesh.meshData;
+                PackedMeshData packed;
+                packMs += MicroBenchmarks::MeasureBest(repeats, [&]() { packed = VertexPacker::Pack(*meshData, format); });
+
+                MeshData decoded;
+                unpackMs += MicroBenchmarks::MeasureBest(repeats, [&]() { VertexPacker::Unpack(packed, decoded); });
+
+                PackingErrors errors = MeasureErrors(*meshData, decoded);
+                PackingErrorBounds bounds = VertexPacker::GetErrorBounds(packed);
+                withinBounds &= errors.position <= bounds.position
+                    && errors.normalRadians <= bounds.normalRadians
+                    && errors.texCoord <= bounds.texCoord;
+
+                worst.position = std::max(worst.position, errors.position);
+                worst.normalRadians = std::max(worst.normalRadians, errors.normalRadians);
+                worst.texCoord = std::max(worst.texCoord, errors.texCoord);
+
+                vertexCount += meshData->vertices.size();
+                sourceBytes += meshData->vertices.size() * sizeof(glm::vec3)
+                    + meshData->normals.size() * sizeof(glm::vec3)
+                    + meshData->texCoords.size() * sizeof(glm::vec2);
+                packedBytes += packed.GetByteSize();
+            }
+
+            report.SetMetric(suite, prefix + ".bytesPerVertex", static_cast<uint64_t>(format.GetStride()));
+            report.SetMetric(suite, prefix + ".vertices", static_cast<uint64_t>(vertexCount));
+            report.SetMetric(suite, prefix + ".sizeRatio", sourceBytes > 0 ? static_cast<double>(packedBytes) / sourceBytes : 0.0);
+            report.SetMetric(suite, prefix + ".packMs", packMs);
+            report.SetMetric(suite, prefix + ".unpackMs", unpackMs);
+            report.SetMetric(suite, prefix + ".packMvertsPerSec", packMs > 0.0 ? vertexCount / (packMs * 1000.0) : 0.0);
+            report.SetMetric(suite, prefix + ".unpackMvertsPerSec", unpackMs > 0.0 ? vertexCount / (unpackMs * 1000.0) : 0.0);
+            report.SetMetric(suite, prefix + ".maxPositionError", static_cast<double>(worst.position));
+            report.SetMetric(suite, prefix + ".maxNormalErrorRadians", static_cast<double>(worst.normalRadians));
+            report.SetMetric(suite, prefix + ".maxTexCoordError", static_cast<double>(worst.texCoord));
+            report.SetMetric(suite, prefix + ".withinBounds", withinBounds);
+
+            LOG(INFO) << "Vertex packing " << prefix << ": " << format.GetStride() << " bytes/vertex, pack "
+                << packMs << " ms, unpack " << unpackMs << " ms, " << (withinBounds ? "within" : "OUTSIDE") << " error bounds";
+        }
+    }
+}
@@ -0,0 +1,50 @@
+#include "Components.hpp"
+#include "MeshEntity.hpp"
+#include "SystemScheduler.hpp"
+#include "TransformStore.hpp"
+#include <algorithm>
+
+namespace Anito3D {
+
+    MeshReference MeshReference::FromMeshData(const MeshData& meshData) {
+        MeshReference reference;
+        reference.meshData = &meshData;
+        reference.localCenter = meshData.bounds.center;
+        reference.localRadius = meshData.bounds.radius;
+        return reference;
+    }
+
+    MeshReference MeshReference::FromEntity(const MeshEntity& entity) {
+        MeshReference reference;
+        reference.entity = &entity;
+        reference.localCenter = entity.GetBounds().center;
+        reference.localRadius = entity.GetBounds().radius;
+        return reference;
+    }
+
+    void AddTransformSystems(SystemScheduler& scheduler) {
+        scheduler.Add<const Transform, WorldTransform>("localToWorld",
+            [](float, uint32_t count, const Transform* transforms, WorldTransform* worlds) {
+                for (uint32_t i = 0; i < count; ++i) {
+                    worlds[i].matrix = TransformStore::ComposeMatrix(transforms[i].position, transforms[i].rotation, transforms[i].scale);
+                }
+            });
+
+        scheduler.Add<const SceneNodeReference, WorldTransform>("sceneToWorld",
+            [](float, uint32_t count, const SceneNodeReference* nodes, WorldTransform* worlds) {
+                for (uint32_t i = 0; i < count; ++i) {
+                    if (nodes[i].graph && nodes[i].graph->IsValid(nodes[i].node)) worlds[i].matrix = nodes[i].graph->GetWorldTransform(nodes[i].node);
+                }
+            });
+
+        scheduler.Add<const WorldTransform, const MeshReference, WorldBounds>("worldBounds",
+            [](float, uint32_t count, const WorldTransform* worlds, const MeshReference* meshes, WorldBounds* bounds) {
+                for (uint32_t i = 0; i < count; ++i) {
+                    const glm::mat4& m = worlds[i].matrix;
+                    const float scale = std::max({ glm::length(glm::vec3(m[0])), glm::length(glm::vec3(m[1])), glm::length(glm::vec3(m[2])) });
+                    bounds[i].center = glm::vec3(m * glm::vec4(meshes[i].localCenter, 1.0f));
+                    bounds[i].radius = meshes[i].localRadius * scale;
+                }
+            });
+    }
+}
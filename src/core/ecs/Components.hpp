@@ -0,0 +1,52 @@
+#pragma once
+
+#include "MeshData.hpp"
+#include "SceneGraph.hpp"
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+namespace Anito3D {
+
+    class MeshEntity;
+    class SystemScheduler;
+
+    // Built-in components; any nothrow-movable type can be used as a custom component
+
+    struct Transform {
+        glm::vec3 position{ 0.0f };
+        glm::quat rotation{ 1.0f, 0.0f, 0.0f, 0.0f };
+        glm::vec3 scale{ 1.0f };
+    };
+
+    struct WorldTransform {
+        glm::mat4 matrix{ 1.0f };
+    };
+
+    // World transform owned by a scene graph node (hierarchical entities)
+    struct SceneNodeReference {
+        const SceneGraph* graph = nullptr;
+        SceneNodeId node = SceneGraph::InvalidNode;
+    };
+
+    // Either meshData (generated meshes) or entity (loaded files, possibly still read from
+    // a mapped cache file, see MeshEntity::GetMeshView) is set
+    struct MeshReference {
+        const MeshData* meshData = nullptr;
+        const MeshEntity* entity = nullptr;
+        glm::vec3 localCenter{ 0.0f }; // Sphere around every submesh instance
+        float localRadius = 0.0f;
+
+        static MeshReference FromMeshData(const MeshData& meshData);
+        static MeshReference FromEntity(const MeshEntity& entity);
+    };
+
+    // World-space bounding sphere
+    struct WorldBounds {
+        glm::vec3 center{ 0.0f };
+        float radius = 0.0f;
+    };
+
+    // Transform -> WorldTransform, SceneNodeReference -> WorldTransform, then WorldBounds
+    void AddTransformSystems(SystemScheduler& scheduler);
+
+}
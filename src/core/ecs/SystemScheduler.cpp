@@ -0,0 +1,43 @@
+#include "SystemScheduler.hpp"
+#include "ThreadPool.hpp"
+#include <algorithm>
+
+namespace Anito3D {
+
+    const std::vector<std::vector<size_t>>& SystemScheduler::GetPhases() {
+        if (!phases.empty() || systems.empty()) return phases;
+
+        // Each system runs one phase after the latest earlier system it conflicts with
+        std::vector<size_t> phaseOf(systems.size(), 0);
+        for (size_t i = 0; i < systems.size(); ++i) {
+            for (size_t j = 0; j < i; ++j) {
+                if (Conflicts(systems[i], systems[j])) phaseOf[i] = std::max(phaseOf[i], phaseOf[j] + 1);
+            }
+            if (phaseOf[i] >= phases.size()) phases.resize(phaseOf[i] + 1);
+            phases[phaseOf[i]].push_back(i);
+        }
+        return phases;
+    }
+
+    void SystemScheduler::Run(World& world, float deltaTime, ThreadPool* threadPool) {
+        for (const auto& phase : GetPhases()) {
+            tasks.clear();
+            for (size_t index : phase) {
+                const System& system = systems[index];
+                for (const auto& archetype : world.GetArchetypes()) {
+                    if (!archetype->Matches(system.required)) continue;
+                    for (size_t chunk = 0; chunk < archetype->GetChunkCount(); ++chunk) tasks.push_back({ &system, archetype.get(), chunk });
+                }
+            }
+
+            // Chunks of one system are disjoint and systems within a phase do not conflict
+            auto runTask = [&](size_t i) { tasks[i].system->run(*tasks[i].archetype, tasks[i].chunk, deltaTime); };
+            if (threadPool && tasks.size() > 1) {
+                threadPool->ParallelFor(tasks.size(), runTask);
+            }
+            else {
+                for (size_t i = 0; i < tasks.size(); ++i) runTask(i);
+            }
+        }
+    }
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "World.hpp"
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace Anito3D {
+
+    class ThreadPool;
+
+    // Ordered list of chunk systems. Each system declares its query through its template
+    // arguments: const components are reads, the others writes. Run() keeps registration
+    // order between conflicting systems and groups the rest into phases whose chunks are
+    // processed in parallel.
+    class SystemScheduler {
+    public:
+        // function(deltaTime, count, Components*...) once per matching chunk
+        template <typename... Components, typename Function>
+        void Add(const std::string& name, Function&& function) {
+            System system;
+            system.name = name;
+            system.required = (ComponentMask(0) | ... | ComponentRegistry::GetMask<Components>());
+            system.writes = (ComponentMask(0) | ... | (std::is_const_v<Components> ? 0 : ComponentRegistry::GetMask<Components>()));
+            system.reads = system.required & ~system.writes;
+            system.run = [function = std::forward<Function>(function)](const Archetype& archetype, size_t chunk, float deltaTime) {
+                function(deltaTime, archetype.GetChunkSize(chunk), archetype.template GetArray<Components>(chunk)...);
+            };
+            systems.push_back(std::move(system));
+            phases.clear();
+        }
+
+        void Run(World& world, float deltaTime, ThreadPool* threadPool = nullptr);
+
+        size_t GetSystemCount() const { return systems.size(); }
+        // System indices per phase, in execution order
+        const std::vector<std::vector<size_t>>& GetPhases();
+
+    private:
+        struct System {
+            std::string name;
+            ComponentMask required = 0;
+            ComponentMask reads = 0;
+            ComponentMask writes = 0;
+            std::function<void(const Archetype&, size_t, float)> run;
+        };
+        struct Task {
+            const System* system;
+            const Archetype* archetype;
+            size_t chunk;
+        };
+
+        std::vector<System> systems;
+        std::vector<std::vector<size_t>> phases;
+        std::vector<Task> tasks; // Reused between runs
+
+        static bool Conflicts(const System& a, const System& b) {
+            return (a.writes & (b.reads | b.writes)) || (b.writes & a.reads);
+        }
+    };
+
+}
@@ -0,0 +1,166 @@
+#include "World.hpp"
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <iostream>
+#include <mutex>
+
+namespace Anito3D {
+
+    namespace {
+        // Fixed storage so readers never race a reallocation; entries are written once
+        std::array<ComponentInfo, MaxComponentTypes> registeredComponents;
+        uint32_t registeredCount = 0;
+        std::mutex registryMutex;
+
+        size_t AlignUp(size_t value, size_t alignment) {
+            return (value + alignment - 1) / alignment * alignment;
+        }
+    }
+
+    ComponentTypeId ComponentRegistry::Register(const ComponentInfo& info) {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        if (registeredCount == MaxComponentTypes) {
+            std::cerr << "ComponentRegistry: more than " << MaxComponentTypes << " component types" << std::endl;
+            std::abort();
+        }
+        registeredComponents[registeredCount] = info;
+        return registeredCount++;
+    }
+
+    const ComponentInfo& ComponentRegistry::GetInfo(ComponentTypeId id) {
+        return registeredComponents[id];
+    }
+
+    Archetype::Archetype(ComponentMask mask) : mask(mask) {
+        std::fill(std::begin(offsets), std::end(offsets), NoColumn);
+        size_t rowBytes = sizeof(EntityId);
+        size_t padding = 0;
+        for (ComponentTypeId type = 0; type < MaxComponentTypes; ++type) {
+            if (!(mask & (ComponentMask(1) << type))) continue;
+            types.push_back(type);
+            rowBytes += ComponentRegistry::GetInfo(type).size;
+            padding += ComponentRegistry::GetInfo(type).alignment;
+        }
+
+        // Oversized rows get a bigger chunk rather than an empty one
+        capacity = static_cast<uint32_t>((ChunkBytes - std::min(ChunkBytes, padding)) / rowBytes);
+        if (capacity == 0) {
+            capacity = 1;
+            chunkBytes = rowBytes + padding;
+        }
+
+        size_t offset = AlignUp(sizeof(EntityId) * capacity, 16);
+        for (ComponentTypeId type : types) {
+            const ComponentInfo& info = ComponentRegistry::GetInfo(type);
+            offset = AlignUp(offset, info.alignment);
+            offsets[type] = static_cast<uint32_t>(offset);
+            offset += info.size * capacity;
+        }
+        chunkBytes = std::max(chunkBytes, offset);
+    }
+
+    std::pair<uint32_t, uint32_t> Archetype::AllocateRow(EntityId entity) {
+        // Removal back-fills from the last row, so only the last chunk can have room
+        if (chunks.empty() || chunks.back().count == capacity) {
+            Chunk chunk;
+            chunk.data.reset(static_cast<std::byte*>(::operator new[](chunkBytes, std::align_val_t(64))));
+            chunks.push_back(std::move(chunk));
+        }
+        const uint32_t chunk = static_cast<uint32_t>(chunks.size() - 1);
+        const uint32_t row = chunks[chunk].count++;
+        GetEntity(chunk, row) = entity;
+        entityCount++;
+        return { chunk, row };
+    }
+
+    World::~World() {
+        for (const auto& archetype : archetypes) {
+            for (uint32_t chunk = 0; chunk < archetype->chunks.size(); ++chunk) {
+                for (uint32_t row = 0; row < archetype->chunks[chunk].count; ++row) {
+                    for (ComponentTypeId type : archetype->types) {
+                        ComponentRegistry::GetInfo(type).destroy(archetype->GetComponent(type, chunk, row));
+                    }
+                }
+            }
+        }
+    }
+
+    Archetype& World::GetArchetype(ComponentMask mask) {
+        auto found = archetypesByMask.find(mask);
+        if (found != archetypesByMask.end()) return *found->second;
+
+        archetypes.push_back(std::unique_ptr<Archetype>(new Archetype(mask)));
+        archetypesByMask.emplace(mask, archetypes.back().get());
+        return *archetypes.back();
+    }
+
+    EntityId World::AllocateEntity() {
+        uint32_t index;
+        if (!freeIndices.empty()) {
+            index = freeIndices.back();
+            freeIndices.pop_back();
+        }
+        else {
+            index = static_cast<uint32_t>(records.size());
+            records.emplace_back();
+            generations.push_back(0);
+        }
+        entityCount++;
+        return { index, generations[index] };
+    }
+
+    void World::Destroy(EntityId entity) {
+        if (!IsAlive(entity)) return;
+        Record& record = records[entity.index];
+        for (ComponentTypeId type : record.archetype->types) {
+            ComponentRegistry::GetInfo(type).destroy(record.archetype->GetComponent(type, record.chunk, record.row));
+        }
+        RemoveRow(*record.archetype, record.chunk, record.row);
+
+        record = {};
+        generations[entity.index]++;
+        freeIndices.push_back(entity.index);
+        entityCount--;
+    }
+
+    const World::Record& World::MoveEntity(EntityId entity, ComponentMask targetMask) {
+        Record& record = records[entity.index];
+        Archetype& source = *record.archetype;
+        Archetype& target = GetArchetype(targetMask);
+        auto [chunk, row] = target.AllocateRow(entity);
+
+        for (ComponentTypeId type : source.types) {
+            const ComponentInfo& info = ComponentRegistry::GetInfo(type);
+            void* from = source.GetComponent(type, record.chunk, record.row);
+            if (targetMask & (ComponentMask(1) << type)) info.moveConstruct(target.GetComponent(type, chunk, row), from);
+            info.destroy(from);
+        }
+        RemoveRow(source, record.chunk, record.row);
+
+        record = { &target, chunk, row };
+        return record;
+    }
+
+    void World::RemoveRow(Archetype& archetype, uint32_t chunk, uint32_t row) {
+        const uint32_t lastChunk = static_cast<uint32_t>(archetype.chunks.size() - 1);
+        const uint32_t lastRow = archetype.chunks[lastChunk].count - 1;
+
+        if (chunk != lastChunk || row != lastRow) {
+            const EntityId moved = archetype.GetEntity(lastChunk, lastRow);
+            for (ComponentTypeId type : archetype.types) {
+                const ComponentInfo& info = ComponentRegistry::GetInfo(type);
+                void* from = archetype.GetComponent(type, lastChunk, lastRow);
+                info.moveConstruct(archetype.GetComponent(type, chunk, row), from);
+                info.destroy(from);
+            }
+            archetype.GetEntity(chunk, row) = moved;
+            records[moved.index].chunk = chunk;
+            records[moved.index].row = row;
+        }
+
+        archetype.chunks[lastChunk].count--;
+        archetype.entityCount--;
+        if (archetype.chunks[lastChunk].count == 0) archetype.chunks.pop_back();
+    }
+}
@@ -0,0 +1,221 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace Anito3D {
+
+    using ComponentTypeId = uint32_t;
+    using ComponentMask = uint64_t; // One bit per ComponentTypeId
+    constexpr uint32_t MaxComponentTypes = 64;
+
+    struct ComponentInfo {
+        size_t size;
+        size_t alignment;
+        void (*moveConstruct)(void* destination, void* source);
+        void (*destroy)(void* object);
+    };
+
+    // Process-wide component type ids, assigned on first use of each type
+    class ComponentRegistry {
+    public:
+        template <typename T>
+        static ComponentTypeId GetId() {
+            using Type = std::remove_cv_t<T>;
+            if constexpr (!std::is_same_v<T, Type>) {
+                return GetId<Type>(); // const T shares the id of T instead of registering its own
+            }
+            else {
+                static_assert(std::is_nothrow_move_constructible_v<Type>, "Components are relocated between chunks");
+                static const ComponentTypeId id = Register({ sizeof(Type), alignof(Type),
+                    [](void* destination, void* source) { new (destination) Type(std::move(*static_cast<Type*>(source))); },
+                    [](void* object) { static_cast<Type*>(object)->~Type(); } });
+                return id;
+            }
+        }
+
+        template <typename T>
+        static ComponentMask GetMask() { return ComponentMask(1) << GetId<T>(); }
+
+        static const ComponentInfo& GetInfo(ComponentTypeId id);
+
+    private:
+        static ComponentTypeId Register(const ComponentInfo& info);
+    };
+
+    struct EntityId {
+        uint32_t index = std::numeric_limits<uint32_t>::max();
+        uint32_t generation = 0;
+
+        bool IsNull() const { return index == std::numeric_limits<uint32_t>::max(); }
+        bool operator==(const EntityId&) const = default;
+    };
+
+    // All entities with exactly one set of component types. Entities live in fixed-size
+    // chunks with one contiguous array per component (plus the owning EntityId), so a
+    // query touches only the arrays it asks for.
+    class Archetype {
+    public:
+        static constexpr size_t ChunkBytes = 16 * 1024;
+
+        ComponentMask GetMask() const { return mask; }
+        bool Matches(ComponentMask required) const { return (mask & required) == required; }
+        uint32_t GetChunkCapacity() const { return capacity; }
+        size_t GetChunkCount() const { return chunks.size(); }
+        uint32_t GetChunkSize(size_t chunk) const { return chunks[chunk].count; }
+        size_t GetEntityCount() const { return entityCount; }
+
+        const EntityId* GetEntities(size_t chunk) const { return reinterpret_cast<const EntityId*>(chunks[chunk].data.get()); }
+
+        // Component array of a chunk; T may be const-qualified. The archetype must contain T.
+        template <typename T>
+        T* GetArray(size_t chunk) const {
+            return reinterpret_cast<T*>(chunks[chunk].data.get() + offsets[ComponentRegistry::GetId<T>()]);
+        }
+
+    private:
+        friend class World;
+
+        struct ChunkDeleter {
+            void operator()(std::byte* data) const { ::operator delete[](data, std::align_val_t(64)); }
+        };
+        struct Chunk {
+            std::unique_ptr<std::byte[], ChunkDeleter> data;
+            uint32_t count = 0;
+        };
+
+        static constexpr uint32_t NoColumn = std::numeric_limits<uint32_t>::max();
+
+        ComponentMask mask = 0;
+        std::vector<ComponentTypeId> types;
+        uint32_t offsets[MaxComponentTypes]; // Byte offset of each component array, NoColumn if absent
+        uint32_t capacity = 0;
+        size_t chunkBytes = ChunkBytes;
+        std::vector<Chunk> chunks;
+        size_t entityCount = 0;
+
+        explicit Archetype(ComponentMask mask);
+
+        void* GetComponent(ComponentTypeId type, uint32_t chunk, uint32_t row) const {
+            return chunks[chunk].data.get() + offsets[type] + static_cast<size_t>(row) * ComponentRegistry::GetInfo(type).size;
+        }
+        EntityId& GetEntity(uint32_t chunk, uint32_t row) {
+            return reinterpret_cast<EntityId*>(chunks[chunk].data.get())[row];
+        }
+        // Reserves a row (components left unconstructed)
+        std::pair<uint32_t, uint32_t> AllocateRow(EntityId entity);
+    };
+
+    // Archetype-based entity/component storage. Structural changes (create, destroy,
+    // add/remove component) must not happen while a query is iterating.
+    class World {
+    public:
+        World() = default;
+        ~World();
+
+        World(const World&) = delete;
+        World& operator=(const World&) = delete;
+
+        template <typename... Components>
+        EntityId Create(Components&&... components) {
+            const ComponentMask mask = (ComponentMask(0) | ... | ComponentRegistry::GetMask<std::decay_t<Components>>());
+            Archetype& archetype = GetArchetype(mask);
+            const EntityId entity = AllocateEntity();
+            auto [chunk, row] = archetype.AllocateRow(entity);
+            (new (archetype.GetComponent(ComponentRegistry::GetId<std::decay_t<Components>>(), chunk, row))
+                std::decay_t<Components>(std::forward<Components>(components)), ...);
+            records[entity.index] = { &archetype, chunk, row };
+            return entity;
+        }
+
+        void Destroy(EntityId entity);
+        bool IsAlive(EntityId entity) const {
+            return entity.index < generations.size() && generations[entity.index] == entity.generation && records[entity.index].archetype;
+        }
+        size_t GetEntityCount() const { return entityCount; }
+        const std::vector<std::unique_ptr<Archetype>>& GetArchetypes() const { return archetypes; }
+
+        template <typename T>
+        bool Has(EntityId entity) const {
+            return IsAlive(entity) && (records[entity.index].archetype->GetMask() & ComponentRegistry::GetMask<T>());
+        }
+
+        // nullptr when the entity is dead or lacks T
+        template <typename T>
+        T* Get(EntityId entity) const {
+            if (!Has<T>(entity)) return nullptr;
+            const Record& record = records[entity.index];
+            return static_cast<T*>(record.archetype->GetComponent(ComponentRegistry::GetId<T>(), record.chunk, record.row));
+        }
+
+        // Adds or replaces a component; adding moves the entity to another archetype
+        template <typename T>
+        void Add(EntityId entity, T component) {
+            if (!IsAlive(entity)) return;
+            if (T* existing = Get<T>(entity)) {
+                *existing = std::move(component);
+                return;
+            }
+            const Record& record = MoveEntity(entity, records[entity.index].archetype->GetMask() | ComponentRegistry::GetMask<T>());
+            new (record.archetype->GetComponent(ComponentRegistry::GetId<T>(), record.chunk, record.row)) T(std::move(component));
+        }
+
+        template <typename T>
+        void Remove(EntityId entity) {
+            if (!Has<T>(entity)) return;
+            MoveEntity(entity, records[entity.index].archetype->GetMask() & ~ComponentRegistry::GetMask<T>());
+        }
+
+        // function(count, entities, Components*...) for every chunk holding all Components;
+        // const-qualified components are handed out as const pointers
+        template <typename... Components, typename Function>
+        void ForEachChunk(Function&& function) const {
+            const ComponentMask required = (ComponentMask(0) | ... | ComponentRegistry::GetMask<Components>());
+            for (const auto& archetype : archetypes) {
+                if (!archetype->Matches(required)) continue;
+                for (size_t chunk = 0; chunk < archetype->GetChunkCount(); ++chunk) {
+                    const uint32_t count = archetype->GetChunkSize(chunk);
+                    if (count == 0) continue;
+                    function(count, archetype->GetEntities(chunk), archetype->template GetArray<Components>(chunk)...);
+                }
+            }
+        }
+
+        // function(Components&...) for every entity holding all Components
+        template <typename... Components, typename Function>
+        void ForEach(Function&& function) const {
+            ForEachChunk<Components...>([&](uint32_t count, const EntityId*, Components*... arrays) {
+                for (uint32_t i = 0; i < count; ++i) function(arrays[i]...);
+            });
+        }
+
+    private:
+        struct Record {
+            Archetype* archetype = nullptr;
+            uint32_t chunk = 0;
+            uint32_t row = 0;
+        };
+
+        std::vector<std::unique_ptr<Archetype>> archetypes;
+        std::unordered_map<ComponentMask, Archetype*> archetypesByMask;
+        std::vector<Record> records; // Indexed by EntityId::index
+        std::vector<uint32_t> generations;
+        std::vector<uint32_t> freeIndices;
+        size_t entityCount = 0;
+
+        Archetype& GetArchetype(ComponentMask mask);
+        EntityId AllocateEntity();
+        // Relocates the entity, keeping shared components; components only in the target stay unconstructed
+        const Record& MoveEntity(EntityId entity, ComponentMask targetMask);
+        // Fills the (already destroyed) row with the archetype's last row
+        void RemoveRow(Archetype& archetype, uint32_t chunk, uint32_t row);
+    };
+
+}
@@ -0,0 +1,85 @@
+#include "FrameStatsOverlay.hpp"
+#include "AnitoImGuiStyle.hpp"
+#include <algorithm>
+#include <cfloat>
+
+namespace Anito3D {
+
+    void FrameStatsOverlay::refresh(const FrameProfiler& profiler, size_t windowFrames) {
+        statistics = profiler.ComputeStatistics(windowFrames);
+
+        profiler.Snapshot(records, windowFrames);
+        frameTimes.resize(records.size());
+        std::transform(records.begin(), records.end(), frameTimes.begin(), [](const FrameProfiler::FrameRecord& record) { return record.totalMs; });
+
+        histogram.assign(statistics.histogram.begin(), statistics.histogram.end());
+    }
+
+    void FrameStatsOverlay::render(const FrameProfiler& profiler, size_t windowFrames) {
+        if (!profiler.IsEnabled()) return;
+
+        const double now = ImGui::GetTime();
+        if (lastRefresh < 0.0 || now - lastRefresh >= RefreshSeconds) {
+            refresh(profiler, windowFrames);
+            lastRefresh = now;
+        }
+
+        // Top-right corner, above the menu
+        const ImVec2 displaySize = ImGui::GetIO().DisplaySize;
+        ImGui::SetNextWindowPos(ImVec2(displaySize.x - 10.0f, 10.0f), ImGuiCond_Always, ImVec2(1.0f, 0.0f));
+        ImGui::SetNextWindowBgAlpha(0.8f);
+        const ImGuiWindowFlags flags = ImGuiWindowFlags_NoDecoration | ImGuiWindowFlags_AlwaysAutoResize | ImGuiWindowFlags_NoSavedSettings |
+            ImGuiWindowFlags_NoFocusOnAppearing | ImGuiWindowFlags_NoNav | ImGuiWindowFlags_NoMove;
+        if (!ImGui::Begin("Frame Statistics", nullptr, flags)) {
+            ImGui::End();
+            return;
+        }
+
+        const FramePhaseStatistics& total = statistics.total;
+        ImGui::PushStyleColor(ImGuiCol_Text, AnitoImGuiStyle::getAccentGreen());
+        ImGui::Text("%.1f FPS  %.2f ms", total.mean > 0.0 ? 1000.0 / total.mean : 0.0, total.mean);
+        ImGui::PopStyleColor();
+        ImGui::Text("%zu frames, %u stutters (%llu total)", statistics.frames, statistics.stutters, static_cast<unsigned long long>(statistics.totalStutters));
+
+        if (!frameTimes.empty()) {
+            const float scaleMax = static_cast<float>(std::max(total.max, 1000.0 / 60.0));
+            ImGui::PlotLines("##FrameTimes", frameTimes.data(), static_cast<int>(frameTimes.size()), 0, "frame ms", 0.0f, scaleMax, ImVec2(360.0f, 60.0f));
+        }
+
+        if (ImGui::BeginTable("Phases", 6, ImGuiTableFlags_SizingFixedFit | ImGuiTableFlags_RowBg)) {
+            for (const char* header : { "ms", "mean", "p50", "p95", "p99", "max" }) ImGui::TableSetupColumn(header);
+            ImGui::TableHeadersRow();
+            auto row = [](const FramePhaseStatistics& phase) {
+                ImGui::TableNextRow();
+                ImGui::TableNextColumn();
+                ImGui::TextUnformatted(phase.name.c_str());
+                for (double value : { phase.mean, phase.p50, phase.p95, phase.p99, phase.max }) {
+                    ImGui::TableNextColumn();
+                    ImGui::Text("%.3f", value);
+                }
+            };
+            for (const auto& phase : statistics.phases) row(phase);
+            row(total);
+            if (statistics.gpuFrames > 0) row(statistics.gpu);
+            ImGui::EndTable();
+        }
+
+        ImGui::PlotHistogram("##Histogram", histogram.data(), static_cast<int>(histogram.size()), 0, "frames per bucket", 0.0f, FLT_MAX, ImVec2(360.0f, 50.0f));
+        if (ImGui::IsItemHovered()) {
+            ImGui::BeginTooltip();
+            for (size_t bucket = 0; bucket < histogram.size(); ++bucket) {
+                const double lower = bucket == 0 ? 0.0 : FrameStatistics::HistogramBounds[bucket - 1];
+                if (bucket < FrameStatistics::HistogramBounds.size()) {
+                    ImGui::Text("%6.2f - %6.2f ms: %u", lower, FrameStatistics::HistogramBounds[bucket], statistics.histogram[bucket]);
+                }
+                else {
+                    ImGui::Text("%6.2f+ ms: %u", lower, statistics.histogram[bucket]);
+                }
+            }
+            ImGui::EndTooltip();
+        }
+
+        ImGui::End();
+    }
+
+}
@@ -0,0 +1,32 @@
+#pragma once
+#include <imgui.h>
+#include <vector>
+
+#include "FrameProfiler.hpp"
+
+namespace Anito3D {
+
+    // Corner window showing a FrameProfiler's rolling statistics: frame time graph,
+    // per-phase mean/p50/p95/p99/max, the frame-time histogram and the stutter count.
+    // Statistics are recomputed a few times per second, not every frame.
+    class FrameStatsOverlay {
+    public:
+        FrameStatsOverlay() = default;
+        ~FrameStatsOverlay() = default;
+
+        // Draw inside the current ImGui frame; windowFrames limits the statistics to the most recent frames
+        void render(const FrameProfiler& profiler, size_t windowFrames = 600);
+
+    private:
+        static constexpr double RefreshSeconds = 0.25;
+
+        FrameStatistics statistics;
+        std::vector<FrameProfiler::FrameRecord> records;
+        std::vector<float> frameTimes;
+        std::vector<float> histogram;
+        double lastRefresh = -1.0;
+
+        void refresh(const FrameProfiler& profiler, size_t windowFrames);
+    };
+
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+namespace Anito3D {
+
+    // Fast non-cryptographic 64-bit hash (8 bytes per step, murmur-style finalizer).
+    // Used for cache keys and content validation, not for security.
+    inline uint64_t HashBytes(const void* data, size_t size, uint64_t seed = 0x9E3779B97F4A7C15ull) {
+        constexpr uint64_t multiplier = 0xFF51AFD7ED558CCDull;
+        const uint8_t* bytes = static_cast<const uint8_t*>(data);
+        uint64_t hash = seed ^ (size * multiplier);
+
+        size_t i = 0;
+        for (; i + 8 <= size; i += 8) {
+            uint64_t word;
+            std::memcpy(&word, bytes + i, sizeof(word));
+            word *= multiplier;
+            word ^= word >> 33;
+            hash = (hash ^ word) * 0xC4CEB9FE1A85EC53ull;
+            hash ^= hash >> 29;
+        }
+
+        uint64_t tail = 0;
+        for (size_t shift = 0; i < size; ++i, shift += 8) {
+            tail |= static_cast<uint64_t>(bytes[i]) << shift;
+        }
+        hash = (hash ^ (tail * multiplier)) * 0xC4CEB9FE1A85EC53ull;
+
+        hash ^= hash >> 33;
+        hash *= multiplier;
+        hash ^= hash >> 33;
+        hash *= 0xC4CEB9FE1A85EC53ull;
+        hash ^= hash >> 33;
+        return hash;
+    }
+
+    inline uint64_t HashString(const std::string& text, uint64_t seed = 0x9E3779B97F4A7C15ull) {
+        return HashBytes(text.data(), text.size(), seed);
+    }
+
+}
@@ -0,0 +1,64 @@
+#include "ImageWriter.hpp"
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <fstream>
+
+namespace Anito3D {
+
+    namespace {
+        uint8_t EncodeSrgb(float value) {
+            value = value / (1.0f + value);
+            value = value <= 0.0031308f ? value * 12.92f : 1.055f * std::pow(value, 1.0f / 2.4f) - 0.055f;
+            return static_cast<uint8_t>(std::clamp(value, 0.0f, 1.0f) * 255.0f + 0.5f);
+        }
+
+        bool HasExtension(const std::string& path, const std::string& extension) {
+            if (path.size() < extension.size()) return false;
+            return std::equal(extension.rbegin(), extension.rend(), path.rbegin(),
+                [](char a, char b) { return std::tolower(static_cast<unsigned char>(a)) == std::tolower(static_cast<unsigned char>(b)); });
+        }
+    }
+
+    bool ImageWriter::Write(const std::string& path, uint32_t width, uint32_t height, const std::vector<glm::vec3>& linear) {
+        if (HasExtension(path, ".pfm")) return WritePfm(path, width, height, linear);
+        return WritePpm(path, width, height, ToSrgb8(linear));
+    }
+
+    bool ImageWriter::Write(const std::string& path, uint32_t width, uint32_t height, const std::vector<uint8_t>& rgb) {
+        if (!HasExtension(path, ".pfm")) return WritePpm(path, width, height, rgb);
+        std::vector<glm::vec3> values(rgb.size() / 3);
+        for (size_t i = 0; i < values.size(); ++i) values[i] = glm::vec3(rgb[i * 3], rgb[i * 3 + 1], rgb[i * 3 + 2]) * (1.0f / 255.0f);
+        return WritePfm(path, width, height, values);
+    }
+
+    bool ImageWriter::WritePpm(const std::string& path, uint32_t width, uint32_t height, const std::vector<uint8_t>& rgb) {
+        if (rgb.size() != static_cast<size_t>(width) * height * 3) return false;
+        std::ofstream file(path, std::ios::binary);
+        if (!file) return false;
+        file << "P6\n" << width << " " << height << "\n255\n";
+        file.write(reinterpret_cast<const char*>(rgb.data()), static_cast<std::streamsize>(rgb.size()));
+        return static_cast<bool>(file);
+    }
+
+    bool ImageWriter::WritePfm(const std::string& path, uint32_t width, uint32_t height, const std::vector<glm::vec3>& linear) {
+        if (linear.size() != static_cast<size_t>(width) * height) return false;
+        std::ofstream file(path, std::ios::binary);
+        if (!file) return false;
+        file << "PF\n" << width << " " << height << "\n-1.0\n"; // Negative scale: little endian
+        for (uint32_t y = height; y-- > 0;) {
+            file.write(reinterpret_cast<const char*>(linear.data() + static_cast<size_t>(y) * width), static_cast<std::streamsize>(width * sizeof(glm::vec3)));
+        }
+        return static_cast<bool>(file);
+    }
+
+    std::vector<uint8_t> ImageWriter::ToSrgb8(const std::vector<glm::vec3>& linear) {
+        std::vector<uint8_t> rgb(linear.size() * 3);
+        for (size_t i = 0; i < linear.size(); ++i) {
+            rgb[i * 3 + 0] = EncodeSrgb(linear[i].x);
+            rgb[i * 3 + 1] = EncodeSrgb(linear[i].y);
+            rgb[i * 3 + 2] = EncodeSrgb(linear[i].z);
+        }
+        return rgb;
+    }
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+
+namespace Anito3D {
+
+    // Uncompressed image files for renderer output. Pixels are RGB, rows top to bottom.
+    class ImageWriter {
+    public:
+        // Picks the format from the extension: ".pfm" keeps linear floats, anything else is
+        // tone mapped to an 8-bit PPM
+        static bool Write(const std::string& path, uint32_t width, uint32_t height, const std::vector<glm::vec3>& linear);
+        // 8-bit display values, stored as floats in [0, 1] for ".pfm"
+        static bool Write(const std::string& path, uint32_t width, uint32_t height, const std::vector<uint8_t>& rgb);
+
+        // Binary PPM (P6)
+        static bool WritePpm(const std::string& path, uint32_t width, uint32_t height, const std::vector<uint8_t>& rgb);
+        // Portable float map, little endian (the format stores rows bottom to top)
+        static bool WritePfm(const std::string& path, uint32_t width, uint32_t height, const std::vector<glm::vec3>& linear);
+
+        // Reinhard tone mapping followed by sRGB encoding
+        static std::vector<uint8_t> ToSrgb8(const std::vector<glm::vec3>& linear);
+    };
+
+}
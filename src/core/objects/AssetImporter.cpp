@@ -0,0 +1,64 @@
+#include "AssetImporter.hpp"
+#include "ThreadPool.hpp"
+#include <chrono>
+#include <optional>
+
+namespace Anito3D {
+
+    namespace {
+        using Clock = std::chrono::steady_clock;
+
+        void ImportOne(const std::string& path, const MeshLoadOptions& options, AssetImportResult& result) {
+            auto start = Clock::now();
+            result.path = path;
+            result.entity = std::make_unique<MeshEntity>();
+            result.success = result.entity->LoadMesh(path, options);
+            result.fromCache = result.entity->WasLoadedFromCache();
+            result.milliseconds = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+            if (!result.success) result.entity.reset();
+        }
+    }
+
+    size_t AssetImportSummary::GetSuccessCount() const {
+        size_t count = 0;
+        for (const auto& result : results) {
+            if (result.success) ++count;
+        }
+        return count;
+    }
+
+    AssetImportSummary AssetImporter::ImportBatch(const std::vector<std::string>& paths,
+        const MeshLoadOptions& options, uint32_t threadCount) {
+        AssetImportSummary summary;
+        summary.results.resize(paths.size());
+
+        auto start = Clock::now();
+        if (threadCount == 1) {
+            for (size_t i = 0; i < paths.size(); ++i) {
+                ImportOne(paths[i], options, summary.results[i]);
+            }
+        }
+        else {
+            // Caller's pool if given, otherwise one for this batch (calling thread helps as well)
+            std::optional<ThreadPool> ownedPool;
+            ThreadPool* pool = options.threadPool;
+            if (!pool) {
+                ownedPool.emplace(threadCount == 0 ? 0 : threadCount - 1);
+                pool = &*ownedPool;
+            }
+            summary.threadCount = pool->GetThreadCount() + 1;
+
+            MeshLoadOptions fileOptions = options;
+            fileOptions.threadPool = pool;
+            pool->ParallelFor(paths.size(), [&](size_t i) {
+                ImportOne(paths[i], fileOptions, summary.results[i]);
+            });
+        }
+        summary.wallMilliseconds = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+        for (const auto& result : summary.results) {
+            summary.serialMilliseconds += result.milliseconds;
+        }
+        return summary;
+    }
+}
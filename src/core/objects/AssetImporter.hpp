@@ -0,0 +1,36 @@
+#pragma once
+
+#include "MeshEntity.hpp"
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace Anito3D {
+
+    struct AssetImportResult {
+        std::string path;
+        bool success = false;
+        bool fromCache = false;
+        double milliseconds = 0.0; // Wall time of this file's import
+        std::unique_ptr<MeshEntity> entity;
+    };
+
+    struct AssetImportSummary {
+        std::vector<AssetImportResult> results; // Same order as the requested paths
+        double wallMilliseconds = 0.0;          // Whole batch
+        double serialMilliseconds = 0.0;        // Sum of per-file times
+        uint32_t threadCount = 1;
+
+        size_t GetSuccessCount() const;
+    };
+
+    // Imports several files concurrently. Each file gets its own Assimp importer and
+    // the meshes inside a file are converted in parallel on the same pool.
+    class AssetImporter {
+    public:
+        // threadCount == 0 uses all hardware threads; 1 imports serially on the caller
+        static AssetImportSummary ImportBatch(const std::vector<std::string>& paths,
+            const MeshLoadOptions& options = {}, uint32_t threadCount = 0);
+    };
+
+}
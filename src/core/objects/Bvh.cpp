@@ -0,0 +1,737 @@
+#include "Bvh.hpp"
+#include "ThreadPool.hpp"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define ANITO3D_BVH_SSE2 1
+#include <emmintrin.h>
+#endif
+
+namespace Anito3D {
+
+    namespace {
+        constexpr uint32_t MaxDepth = 64;                 // Deeper ranges become leaves; bounds the traversal stacks
+        constexpr uint32_t TaskThreshold = 4096;          // Subtrees above this many triangles become jobs
+        constexpr uint32_t ParallelBinThreshold = 65536;  // Ranges above this are binned by several threads
+        constexpr uint32_t BinChunkSize = 16384;
+        constexpr uint32_t MaxBins = 32;
+
+        struct Aabb {
+            glm::vec3 min{ std::numeric_limits<float>::max() };
+            glm::vec3 max{ -std::numeric_limits<float>::max() };
+
+            void Grow(const glm::vec3& point) {
+                min = glm::min(min, point);
+                max = glm::max(max, point);
+            }
+            void Grow(const Aabb& box) {
+                min = glm::min(min, box.min);
+                max = glm::max(max, box.max);
+            }
+            float Area() const {
+                const glm::vec3 extent = max - min;
+                return extent.x < 0.0f ? 0.0f : 2.0f * (extent.x * extent.y + extent.y * extent.z + extent.z * extent.x);
+            }
+        };
+
+        float Area(const glm::vec3& min, const glm::vec3& max) {
+            return Aabb{ min, max }.Area();
+        }
+
+        // Triangle box plus its index in the unsorted triangle list; partitioned in place
+        struct PrimitiveRef {
+            glm::vec3 min;
+            uint32_t triangle;
+            glm::vec3 max;
+
+            glm::vec3 Centroid() const { return (min + max) * 0.5f; }
+        };
+
+        struct Bin {
+            Aabb bounds;
+            uint32_t count = 0;
+        };
+
+        // Slab test against boxes with near/far planes picked by the ray direction's sign, so
+        // an inverted (empty) box always misses. Returns the entry distance or infinity.
+        struct RayBoxTest {
+            glm::vec3 origin;
+            glm::vec3 inverseDirection;
+            bool negative[3];
+
+            explicit RayBoxTest(const Ray& ray) : origin(ray.origin), inverseDirection(1.0f / ray.direction) {
+                for (int axis = 0; axis < 3; ++axis) negative[axis] = inverseDirection[axis] < 0.0f;
+            }
+
+            float Intersect(const glm::vec3& min, const glm::vec3& max, float tMin, float tMax) const {
+                for (int axis = 0; axis < 3; ++axis) {
+                    const float nearPlane = negative[axis] ? max[axis] : min[axis];
+                    const float farPlane = negative[axis] ? min[axis] : max[axis];
+                    const float tNear = (nearPlane - origin[axis]) * inverseDirection[axis];
+                    const float tFar = (farPlane - origin[axis]) * inverseDirection[axis];
+                    // NaN (0 * inf on a slab plane) leaves the interval unchanged
+                    tMin = tNear > tMin ? tNear : tMin;
+                    tMax = tFar < tMax ? tFar : tMax;
+                }
+                return tMin <= tMax ? tMin : std::numeric_limits<float>::infinity();
+            }
+        };
+    }
+
+    class BvhBuilder {
+    public:
+        BvhBuilder(const BvhBuildOptions& options, ThreadPool* threadPool, std::vector<BvhNode>& nodes, std::vector<PrimitiveRef>& refs)
+            : options(options), threadPool(threadPool && threadPool->GetThreadCount() > 0 ? threadPool : nullptr), nodes(nodes), refs(refs) {
+            binCount = std::clamp<uint32_t>(options.binCount, 2, MaxBins);
+        }
+
+        void Build(const Aabb& rootBounds) {
+            nodeCount = 1;
+            nodes[0].boundsMin = rootBounds.min;
+            nodes[0].boundsMax = rootBounds.max;
+            BuildSubtree({ 0, 0, static_cast<uint32_t>(refs.size()), 0 });
+            if (threadPool) threadPool->Wait(jobs);
+        }
+
+        uint32_t GetNodeCount() const { return nodeCount.load(); }
+        uint32_t GetMaxDepth() const { return maxDepth.load(); }
+        uint64_t GetTaskCount() const { return taskCount.load(); }
+
+    private:
+        struct Task {
+            uint32_t node;
+            uint32_t begin;
+            uint32_t end;
+            uint32_t depth;
+        };
+
+        struct Split {
+            int axis = -1;
+            uint32_t bin = 0; // Refs in bins [0, bin) go left
+            float cost = std::numeric_limits<float>::infinity();
+            Aabb leftBounds, rightBounds;
+        };
+
+        const BvhBuildOptions& options;
+        ThreadPool* threadPool;
+        std::vector<BvhNode>& nodes;
+        std::vector<PrimitiveRef>& refs;
+        uint32_t binCount;
+
+        std::atomic<uint32_t> nodeCount{ 0 };
+        std::atomic<uint32_t> maxDepth{ 0 };
+        std::atomic<uint64_t> taskCount{ 0 };
+        JobCounter jobs;
+
+        // Serial loop over a subtree; large child ranges are handed to the pool instead
+        void BuildSubtree(Task root) {
+            std::vector<Task> stack{ root };
+            while (!stack.empty()) {
+                const Task task = stack.back();
+                stack.pop_back();
+
+                uint32_t depth = maxDepth.load(std::memory_order_relaxed);
+                while (task.depth > depth && !maxDepth.compare_exchange_weak(depth, task.depth, std::memory_order_relaxed)) {}
+
+                Task left, right;
+                if (!SplitNode(task, left, right)) continue;
+                for (const Task& child : { right, left }) {
+                    if (threadPool && child.end - child.begin > TaskThreshold) {
+                        taskCount.fetch_add(1, std::memory_order_relaxed);
+                        threadPool->Schedule([this, child]() { BuildSubtree(child); }, &jobs);
+                    }
+                    else {
+                        stack.push_back(child);
+                    }
+                }
+            }
+        }
+
+        void MakeLeaf(const Task& task) {
+            nodes[task.node].index = task.begin;
+            nodes[task.node].count = task.end - task.begin;
+        }
+
+        // Either turns the node into a leaf (returns false) or partitions its range and
+        // allocates the two children
+        bool SplitNode(const Task& task, Task& left, Task& right) {
+            const uint32_t count = task.end - task.begin;
+            if (count <= 1 || task.depth + 1 >= MaxDepth) {
+                MakeLeaf(task);
+                return false;
+            }
+
+            Aabb centroidBounds;
+            ForChunks(task, [&](uint32_t begin, uint32_t end, Aabb& bounds) {
+                for (uint32_t i = begin; i < end; ++i) bounds.Grow(refs[i].Centroid());
+            }, centroidBounds);
+
+            Split split = FindSplit(task, centroidBounds);
+            BvhNode& node = nodes[task.node];
+            const float leafCost = options.intersectionCost * count;
+            if (count <= options.maxLeafSize && (split.axis < 0 || leafCost <= split.cost)) {
+                MakeLeaf(task);
+                return false;
+            }
+
+            uint32_t middle;
+            if (split.axis >= 0) {
+                const int axis = split.axis;
+                const float minimum = centroidBounds.min[axis];
+                const float scale = binCount / (centroidBounds.max[axis] - centroidBounds.min[axis]);
+                auto first = refs.begin() + task.begin;
+                middle = static_cast<uint32_t>(std::partition(first, refs.begin() + task.end, [&](const PrimitiveRef& ref) {
+                    return BinIndex(ref.Centroid()[axis], minimum, scale) < split.bin;
+                }) - refs.begin());
+            }
+            else {
+                // Every centroid in one spot: no plane separates them, halve the range
+                middle = task.begin + count / 2;
+                for (uint32_t i = task.begin; i < middle; ++i) split.leftBounds.Grow(Aabb{ refs[i].min, refs[i].max });
+                for (uint32_t i = middle; i < task.end; ++i) split.rightBounds.Grow(Aabb{ refs[i].min, refs[i].max });
+            }
+
+            const uint32_t children = nodeCount.fetch_add(2, std::memory_order_relaxed);
+            node.index = children;
+            node.count = 0;
+            nodes[children].boundsMin = split.leftBounds.min;
+            nodes[children].boundsMax = split.leftBounds.max;
+            nodes[children + 1].boundsMin = split.rightBounds.min;
+            nodes[children + 1].boundsMax = split.rightBounds.max;
+
+            left = { children, task.begin, middle, task.depth + 1 };
+            right = { children + 1, middle, task.end, task.depth + 1 };
+            return true;
+        }
+
+        uint32_t BinIndex(float centroid, float minimum, float scale) const {
+            const int bin = static_cast<int>((centroid - minimum) * scale);
+            return static_cast<uint32_t>(std::clamp(bin, 0, static_cast<int>(binCount) - 1));
+        }
+
+        // Runs function(begin, end, partial) over the task's range, in parallel chunks for
+        // large ranges, and merges the partial results with Merge(result, partial)
+        template <typename Result, typename Function>
+        void ForChunks(const Task& task, Function&& function, Result& result) {
+            const uint32_t count = task.end - task.begin;
+            if (!threadPool || count <= ParallelBinThreshold) {
+                function(task.begin, task.end, result);
+                return;
+            }
+            const uint32_t chunkCount = (count + BinChunkSize - 1) / BinChunkSize;
+            std::vector<Result> partials(chunkCount, result);
+            threadPool->ParallelFor(chunkCount, [&](size_t chunk) {
+                const uint32_t begin = task.begin + static_cast<uint32_t>(chunk) * BinChunkSize;
+                function(begin, std::min(task.end, begin + BinChunkSize), partials[chunk]);
+            });
+            for (const Result& partial : partials) Merge(result, partial);
+        }
+
+        static void Merge(Aabb& result, const Aabb& partial) { result.Grow(partial); }
+
+        using AxisBins = std::array<std::array<Bin, MaxBins>, 3>;
+        static void Merge(AxisBins& result, const AxisBins& partial) {
+            for (int axis = 0; axis < 3; ++axis) {
+                for (uint32_t b = 0; b < MaxBins; ++b) {
+                    result[axis][b].bounds.Grow(partial[axis][b].bounds);
+                    result[axis][b].count += partial[axis][b].count;
+                }
+            }
+        }
+
+        Split FindSplit(const Task& task, const Aabb& centroidBounds) {
+            Split best;
+            float scale[3];
+            bool usable[3];
+            for (int axis = 0; axis < 3; ++axis) {
+                const float extent = centroidBounds.max[axis] - centroidBounds.min[axis];
+                usable[axis] = extent > 0.0f;
+                scale[axis] = usable[axis] ? binCount / extent : 0.0f;
+            }
+            if (!usable[0] && !usable[1] && !usable[2]) return best;
+
+            // Each ref lands in one bin per axis
+            AxisBins bins{};
+            ForChunks(task, [&](uint32_t begin, uint32_t end, AxisBins& partial) {
+                for (uint32_t i = begin; i < end; ++i) {
+                    const glm::vec3 centroid = refs[i].Centroid();
+                    const Aabb box{ refs[i].min, refs[i].max };
+                    for (int axis = 0; axis < 3; ++axis) {
+                        if (!usable[axis]) continue;
+                        Bin& bin = partial[axis][BinIndex(centroid[axis], centroidBounds.min[axis], scale[axis])];
+                        bin.bounds.Grow(box);
+                        bin.count++;
+                    }
+                }
+            }, bins);
+
+            const float parentArea = Area(nodes[task.node].boundsMin, nodes[task.node].boundsMax);
+            const float inverseArea = parentArea > 0.0f ? 1.0f / parentArea : 0.0f;
+            for (int axis = 0; axis < 3; ++axis) {
+                if (!usable[axis]) continue;
+
+                // Right-to-left sweep stores the right side of every plane, left-to-right finishes
+                float rightCost[MaxBins];
+                Aabb rightBounds[MaxBins];
+                Aabb accumulated;
+                uint32_t accumulatedCount = 0;
+                for (uint32_t b = binCount - 1; b > 0; --b) {
+                    accumulated.Grow(bins[axis][b].bounds);
+                    accumulatedCount += bins[axis][b].count;
+                    rightCost[b] = accumulated.Area() * accumulatedCount;
+                    rightBounds[b] = accumulated;
+                }
+
+                accumulated = {};
+                accumulatedCount = 0;
+                for (uint32_t b = 1; b < binCount; ++b) {
+                    accumulated.Grow(bins[axis][b - 1].bounds);
+                    accumulatedCount += bins[axis][b - 1].count;
+                    if (accumulatedCount == 0 || accumulatedCount == task.end - task.begin) continue;
+                    const float cost = options.traversalCost +
+                        options.intersectionCost * (accumulated.Area() * accumulatedCount + rightCost[b]) * inverseArea;
+                    if (cost < best.cost) {
+                        best.axis = axis;
+                        best.bin = b;
+                        best.cost = cost;
+                        best.leftBounds = accumulated;
+                        best.rightBounds = rightBounds[b];
+                    }
+                }
+            }
+            return best;
+        }
+    };
+
+    Bvh Bvh::Build(const MeshData& meshData, const BvhBuildOptions& options, ThreadPool* threadPool, BvhBuildStatistics* statistics) {
+        auto start = std::chrono::steady_clock::now();
+        Bvh bvh;
+
+        // Every instance contributes its own scene-space copy of the range's triangles
+        std::vector<uint32_t> firstTriangle(meshData.subMeshes.size() + 1, 0);
+        for (size_t s = 0; s < meshData.subMeshes.size(); ++s) {
+            const MeshData::SubMesh& subMesh = meshData.subMeshes[s];
+            const size_t indexArraySize = subMesh.indexType == MeshData::IndexType::Uint16 ? meshData.indices16.size() : meshData.indices.size();
+            const bool valid = static_cast<size_t>(subMesh.firstIndex) + subMesh.indexCount <= indexArraySize &&
+                static_cast<size_t>(subMesh.vertexOffset) + subMesh.vertexCount <= meshData.vertices.size();
+            firstTriangle[s + 1] = firstTriangle[s] + (valid ? subMesh.indexCount / 3 : 0);
+        }
+        const uint32_t triangleCount = firstTriangle.back();
+
+        std::vector<BvhTriangle> source(triangleCount);
+        std::vector<PrimitiveRef> refs(triangleCount);
+        auto prepare = [&](size_t begin, size_t end) {
+            size_t s = std::upper_bound(firstTriangle.begin(), firstTriangle.end(), static_cast<uint32_t>(begin)) - firstTriangle.begin() - 1;
+            for (size_t t = begin; t < end; ++t) {
+                while (t >= firstTriangle[s + 1]) ++s;
+                const MeshData::SubMesh& subMesh = meshData.subMeshes[s];
+                const uint32_t primitive = static_cast<uint32_t>(t - firstTriangle[s]);
+                glm::vec3 p[3];
+                for (int corner = 0; corner < 3; ++corner) {
+                    const uint32_t vertex = subMesh.vertexOffset + meshData.GetIndex(subMesh, primitive * 3 + corner);
+                    p[corner] = glm::vec3(subMesh.transform * glm::vec4(meshData.vertices[vertex], 1.0f));
+                }
+                source[t] = { p[0], p[1] - p[0], p[2] - p[0], static_cast<uint32_t>(s), primitive };
+                refs[t] = { glm::min(p[0], glm::min(p[1], p[2])), static_cast<uint32_t>(t), glm::max(p[0], glm::max(p[1], p[2])) };
+            }
+        };
+        if (threadPool) {
+            threadPool->ParallelForRange(triangleCount, prepare, 1024);
+        }
+        else {
+            prepare(0, triangleCount);
+        }
+
+        BvhBuildStatistics result;
+        result.triangles = triangleCount;
+        if (triangleCount > 0) {
+            Aabb rootBounds;
+            for (const PrimitiveRef& ref : refs) rootBounds.Grow(Aabb{ ref.min, ref.max });
+
+            // A binary tree with one triangle per leaf at most has 2n - 1 nodes
+            bvh.nodes.resize(2 * static_cast<size_t>(triangleCount));
+            BvhBuilder builder(options, threadPool, bvh.nodes, refs);
+            builder.Build(rootBounds);
+            bvh.nodes.resize(builder.GetNodeCount());
+            bvh.nodes.shrink_to_fit();
+            result.maxDepth = builder.GetMaxDepth();
+            result.tasks = builder.GetTaskCount();
+
+            // Triangles in leaf order, so a leaf reads one contiguous run
+            bvh.triangles.resize(triangleCount);
+            auto gather = [&](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; ++i) bvh.triangles[i] = source[refs[i].triangle];
+            };
+            if (threadPool) {
+                threadPool->ParallelForRange(triangleCount, gather, 4096);
+            }
+            else {
+                gather(0, triangleCount);
+            }
+        }
+
+        result.nodes = bvh.nodes.size();
+        result.leaves = std::count_if(bvh.nodes.begin(), bvh.nodes.end(), [](const BvhNode& node) { return node.IsLeaf(); });
+        result.sahCost = bvh.ComputeSahCost(options.traversalCost, options.intersectionCost);
+        result.buildMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        if (statistics) *statistics = result;
+        return bvh;
+    }
+
+    float Bvh::ComputeSahCost(float traversalCost, float intersectionCost) const {
+        if (nodes.empty()) return 0.0f;
+        const float rootArea = Area(nodes[0].boundsMin, nodes[0].boundsMax);
+        if (rootArea <= 0.0f) return intersectionCost * nodes[0].count;
+
+        double cost = 0.0;
+        for (const BvhNode& node : nodes) {
+            const double area = Area(node.boundsMin, node.boundsMax);
+            cost += node.IsLeaf() ? intersectionCost * node.count * area : traversalCost * area;
+        }
+        return static_cast<float>(cost / rootArea);
+    }
+
+    bool Bvh::IntersectTriangle(const Ray& ray, const BvhTriangle& triangle, uint32_t index, RayHit& hit) {
+        const glm::vec3 p = glm::cross(ray.direction, triangle.edge2);
+        const float determinant = glm::dot(triangle.edge1, p);
+        if (std::fabs(determinant) < 1e-12f) return false;
+
+        const float inverse = 1.0f / determinant;
+        const glm::vec3 s = ray.origin - triangle.v0;
+        const float u = glm::dot(s, p) * inverse;
+        if (u < 0.0f || u > 1.0f) return false;
+
+        const glm::vec3 q = glm::cross(s, triangle.edge1);
+        const float v = glm::dot(ray.direction, q) * inverse;
+        if (v < 0.0f || u + v > 1.0f) return false;
+
+        const float t = glm::dot(triangle.edge2, q) * inverse;
+        if (t < ray.tMin || t > ray.tMax || t >= hit.t) return false;
+        hit = { t, u, v, index };
+        return true;
+    }
+
+    namespace {
+        // Shared by the closest-hit and any-hit walks of the binary tree
+        template <bool AnyHit>
+        bool TraverseBinary(const std::vector<BvhNode>& nodes, const std::vector<BvhTriangle>& triangles, const Ray& ray, RayHit& hit) {
+            if (nodes.empty()) return false;
+            const RayBoxTest boxTest(ray);
+            if (boxTest.Intersect(nodes[0].boundsMin, nodes[0].boundsMax, ray.tMin, ray.tMax) == std::numeric_limits<float>::infinity()) return false;
+
+            struct Entry {
+                uint32_t node;
+                float t;
+            };
+            Entry stack[MaxDepth + 1];
+            uint32_t stackSize = 0;
+            stack[stackSize++] = { 0, ray.tMin };
+            bool found = false;
+
+            while (stackSize > 0) {
+                const Entry entry = stack[--stackSize];
+                if (entry.t > hit.t) continue; // A closer hit was found since this was pushed
+                const BvhNode& node = nodes[entry.node];
+
+                if (node.IsLeaf()) {
+                    for (uint32_t i = node.index; i < node.index + node.count; ++i) {
+                        if (Bvh::IntersectTriangle(ray, triangles[i], i, hit)) {
+                            found = true;
+                            if (AnyHit) return true;
+                        }
+                    }
+                    continue;
+                }
+
+                const float tMax = std::min(ray.tMax, hit.t);
+                float tLeft = boxTest.Intersect(nodes[node.index].boundsMin, nodes[node.index].boundsMax, ray.tMin, tMax);
+                float tRight = boxTest.Intersect(nodes[node.index + 1].boundsMin, nodes[node.index + 1].boundsMax, ray.tMin, tMax);
+                uint32_t nearChild = node.index;
+                uint32_t farChild = node.index + 1;
+                if (tRight < tLeft) {
+                    std::swap(tLeft, tRight);
+                    std::swap(nearChild, farChild);
+                }
+                // Far child first so the near one is popped next
+                if (tRight != std::numeric_limits<float>::infinity()) stack[stackSize++] = { farChild, tRight };
+                if (tLeft != std::numeric_limits<float>::infinity()) stack[stackSize++] = { nearChild, tLeft };
+            }
+            return found;
+        }
+    }
+
+    bool Bvh::Intersect(const Ray& ray, RayHit& hit) const {
+        return TraverseBinary<false>(nodes, triangles, ray, hit);
+    }
+
+    bool Bvh::Occluded(const Ray& ray) const {
+        RayHit hit;
+        return TraverseBinary<true>(nodes, triangles, ray, hit);
+    }
+
+    void Bvh::Intersect(const RayPacket& packet, RayHit (&hits)[RayPacket::Size]) const {
+#if defined(ANITO3D_BVH_SSE2)
+        if (nodes.empty()) return;
+        const __m128 originX = _mm_load_ps(packet.originX), originY = _mm_load_ps(packet.originY), originZ = _mm_load_ps(packet.originZ);
+        const __m128 directionX = _mm_load_ps(packet.directionX), directionY = _mm_load_ps(packet.directionY), directionZ = _mm_load_ps(packet.directionZ);
+        const __m128 one = _mm_set1_ps(1.0f);
+        const __m128 inverseX = _mm_div_ps(one, directionX), inverseY = _mm_div_ps(one, directionY), inverseZ = _mm_div_ps(one, directionZ);
+        const __m128 tMin = _mm_load_ps(packet.tMin);
+        const __m128 tMax = _mm_load_ps(packet.tMax);
+
+        __m128 hitT = _mm_setr_ps(hits[0].t, hits[1].t, hits[2].t, hits[3].t);
+        __m128 hitU = _mm_setr_ps(hits[0].u, hits[1].u, hits[2].u, hits[3].u);
+        __m128 hitV = _mm_setr_ps(hits[0].v, hits[1].v, hits[2].v, hits[3].v);
+        __m128i hitTriangle = _mm_setr_epi32(static_cast<int>(hits[0].triangle), static_cast<int>(hits[1].triangle),
+            static_cast<int>(hits[2].triangle), static_cast<int>(hits[3].triangle));
+
+        // Children are ordered along the packet's average direction
+        glm::vec3 packetDirection(0.0f);
+        for (uint32_t lane = 0; lane < RayPacket::Size; ++lane) {
+            if (packet.IsActive(lane)) packetDirection += glm::vec3(packet.directionX[lane], packet.directionY[lane], packet.directionZ[lane]);
+        }
+
+        const __m128 determinantEpsilon = _mm_set1_ps(1e-12f);
+        const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+        const __m128 zero = _mm_setzero_ps();
+
+        uint32_t stack[MaxDepth + 1];
+        uint32_t stackSize = 0;
+        stack[stackSize++] = 0;
+        while (stackSize > 0) {
+            const BvhNode& node = nodes[stack[--stackSize]];
+
+            // Slab test for all lanes against the closest hit so far
+            const __m128 t0x = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(node.boundsMin.x), originX), inverseX);
+            const __m128 t1x = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(node.boundsMax.x), originX), inverseX);
+            const __m128 t0y = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(node.boundsMin.y), originY), inverseY);
+            const __m128 t1y = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(node.boundsMax.y), originY), inverseY);
+            const __m128 t0z = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(node.boundsMin.z), originZ), inverseZ);
+            const __m128 t1z = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(node.boundsMax.z), originZ), inverseZ);
+            const __m128 tNear = _mm_max_ps(_mm_max_ps(_mm_min_ps(t0x, t1x), _mm_min_ps(t0y, t1y)), _mm_max_ps(_mm_min_ps(t0z, t1z), tMin));
+            const __m128 tFar = _mm_min_ps(_mm_min_ps(_mm_max_ps(t0x, t1x), _mm_max_ps(t0y, t1y)), _mm_min_ps(_mm_max_ps(t0z, t1z), _mm_min_ps(tMax, hitT)));
+            if (_mm_movemask_ps(_mm_cmple_ps(tNear, tFar)) == 0) continue;
+
+            if (!node.IsLeaf()) {
+                const BvhNode& left = nodes[node.index];
+                const BvhNode& right = nodes[node.index + 1];
+                const glm::vec3 separation = (right.boundsMin + right.boundsMax) - (left.boundsMin + left.boundsMax);
+                const bool leftFirst = glm::dot(separation, packetDirection) >= 0.0f;
+                stack[stackSize++] = leftFirst ? node.index + 1 : node.index;
+                stack[stackSize++] = leftFirst ? node.index : node.index + 1;
+                continue;
+            }
+
+            // Moller-Trumbore for four rays against one triangle, same operation order as IntersectTriangle
+            for (uint32_t i = node.index; i < node.index + node.count; ++i) {
+                const BvhTriangle& triangle = triangles[i];
+                const __m128 e1x = _mm_set1_ps(triangle.edge1.x), e1y = _mm_set1_ps(triangle.edge1.y), e1z = _mm_set1_ps(triangle.edge1.z);
+                const __m128 e2x = _mm_set1_ps(triangle.edge2.x), e2y = _mm_set1_ps(triangle.edge2.y), e2z = _mm_set1_ps(triangle.edge2.z);
+
+                const __m128 px = _mm_sub_ps(_mm_mul_ps(directionY, e2z), _mm_mul_ps(e2y, directionZ));
+                const __m128 py = _mm_sub_ps(_mm_mul_ps(directionZ, e2x), _mm_mul_ps(e2z, directionX));
+                const __m128 pz = _mm_sub_ps(_mm_mul_ps(directionX, e2y), _mm_mul_ps(e2x, directionY));
+                const __m128 determinant = _mm_add_ps(_mm_add_ps(_mm_mul_ps(e1x, px), _mm_mul_ps(e1y, py)), _mm_mul_ps(e1z, pz));
+                const __m128 inverse = _mm_div_ps(one, determinant);
+
+                const __m128 sx = _mm_sub_ps(originX, _mm_set1_ps(triangle.v0.x));
+                const __m128 sy = _mm_sub_ps(originY, _mm_set1_ps(triangle.v0.y));
+                const __m128 sz = _mm_sub_ps(originZ, _mm_set1_ps(triangle.v0.z));
+                const __m128 u = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(sx, px), _mm_mul_ps(sy, py)), _mm_mul_ps(sz, pz)), inverse);
+
+                const __m128 qx = _mm_sub_ps(_mm_mul_ps(sy, e1z), _mm_mul_ps(e1y, sz));
+                const __m128 qy = _mm_sub_ps(_mm_mul_ps(sz, e1x), _mm_mul_ps(e1z, sx));
+                const __m128 qz = _mm_sub_ps(_mm_mul_ps(sx, e1y), _mm_mul_ps(e1x, sy));
+                const __m128 v = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(directionX, qx), _mm_mul_ps(directionY, qy)), _mm_mul_ps(directionZ, qz)), inverse);
+                const __m128 t = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(e2x, qx), _mm_mul_ps(e2y, qy)), _mm_mul_ps(e2z, qz)), inverse);
+
+                __m128 mask = _mm_cmpge_ps(_mm_and_ps(determinant, absMask), determinantEpsilon);
+                mask = _mm_and_ps(mask, _mm_and_ps(_mm_cmpge_ps(u, zero), _mm_cmple_ps(u, one)));
+                mask = _mm_and_ps(mask, _mm_and_ps(_mm_cmpge_ps(v, zero), _mm_cmple_ps(_mm_add_ps(u, v), one)));
+                mask = _mm_and_ps(mask, _mm_and_ps(_mm_cmpge_ps(t, tMin), _mm_cmple_ps(t, tMax)));
+                mask = _mm_and_ps(mask, _mm_cmplt_ps(t, hitT));
+                if (_mm_movemask_ps(mask) == 0) continue;
+
+                hitT = _mm_or_ps(_mm_and_ps(mask, t), _mm_andnot_ps(mask, hitT));
+                hitU = _mm_or_ps(_mm_and_ps(mask, u), _mm_andnot_ps(mask, hitU));
+                hitV = _mm_or_ps(_mm_and_ps(mask, v), _mm_andnot_ps(mask, hitV));
+                const __m128i maskInt = _mm_castps_si128(mask);
+                hitTriangle = _mm_or_si128(_mm_and_si128(maskInt, _mm_set1_epi32(static_cast<int>(i))), _mm_andnot_si128(maskInt, hitTriangle));
+            }
+        }
+
+        alignas(16) float t[RayPacket::Size], u[RayPacket::Size], v[RayPacket::Size];
+        alignas(16) uint32_t triangle[RayPacket::Size];
+        _mm_store_ps(t, hitT);
+        _mm_store_ps(u, hitU);
+        _mm_store_ps(v, hitV);
+        _mm_store_si128(reinterpret_cast<__m128i*>(triangle), hitTriangle);
+        for (uint32_t lane = 0; lane < RayPacket::Size; ++lane) hits[lane] = { t[lane], u[lane], v[lane], triangle[lane] };
+#else
+        for (uint32_t lane = 0; lane < RayPacket::Size; ++lane) {
+            if (packet.IsActive(lane)) Intersect(packet.Get(lane), hits[lane]);
+        }
+#endif
+    }
+
+    template <uint32_t Width>
+    WideBvh<Width> WideBvh<Width>::Collapse(const Bvh& bvh) {
+        WideBvh wide;
+        wide.bvh = &bvh;
+        const std::vector<BvhNode>& binary = bvh.GetNodes();
+        if (binary.empty()) return wide;
+        if (binary[0].IsLeaf()) {
+            wide.rootChild = binary[0].index;
+            wide.rootCount = binary[0].count;
+            return wide;
+        }
+        wide.rootChild = 0;
+
+        std::vector<std::pair<uint32_t, uint32_t>> pending{ { 0, 0 } }; // Binary inner node, wide node
+        wide.nodes.emplace_back();
+        while (!pending.empty()) {
+            const auto [source, target] = pending.back();
+            pending.pop_back();
+
+            uint32_t slots[Width];
+            uint32_t slotCount = 0;
+            slots[slotCount++] = binary[source].index;
+            slots[slotCount++] = binary[source].index + 1;
+            while (slotCount < Width) {
+                // Open the inner child with the largest surface area
+                int largest = -1;
+                float largestArea = -1.0f;
+                for (uint32_t s = 0; s < slotCount; ++s) {
+                    const BvhNode& child = binary[slots[s]];
+                    const float area = Area(child.boundsMin, child.boundsMax);
+                    if (!child.IsLeaf() && area > largestArea) {
+                        largest = static_cast<int>(s);
+                        largestArea = area;
+                    }
+                }
+                if (largest < 0) break;
+                const uint32_t opened = binary[slots[largest]].index;
+                slots[largest] = opened;
+                slots[slotCount++] = opened + 1;
+            }
+
+            WideBvhNode<Width> node;
+            for (uint32_t s = 0; s < Width; ++s) {
+                if (s >= slotCount) {
+                    node.minX[s] = node.minY[s] = node.minZ[s] = std::numeric_limits<float>::infinity();
+                    node.maxX[s] = node.maxY[s] = node.maxZ[s] = -std::numeric_limits<float>::infinity();
+                    node.children[s] = WideBvhNode<Width>::EmptySlot;
+                    node.counts[s] = 0;
+                    continue;
+                }
+                const BvhNode& child = binary[slots[s]];
+                node.minX[s] = child.boundsMin.x;
+                node.minY[s] = child.boundsMin.y;
+                node.minZ[s] = child.boundsMin.z;
+                node.maxX[s] = child.boundsMax.x;
+                node.maxY[s] = child.boundsMax.y;
+                node.maxZ[s] = child.boundsMax.z;
+                if (child.IsLeaf()) {
+                    node.children[s] = child.index;
+                    node.counts[s] = child.count;
+                }
+                else {
+                    node.children[s] = static_cast<uint32_t>(wide.nodes.size());
+                    node.counts[s] = 0;
+                    pending.emplace_back(slots[s], node.children[s]);
+                    wide.nodes.emplace_back();
+                }
+            }
+            wide.nodes[target] = node;
+        }
+        return wide;
+    }
+
+    template <uint32_t Width>
+    bool WideBvh<Width>::Intersect(const Ray& ray, RayHit& hit) const {
+        if (rootChild == WideBvhNode<Width>::EmptySlot) return false;
+        const std::vector<BvhTriangle>& triangles = bvh->GetTriangles();
+
+        struct Entry {
+            uint32_t child;
+            uint32_t count;
+            float t;
+        };
+        Entry stack[MaxDepth * (Width - 1) + 1];
+        uint32_t stackSize = 0;
+        stack[stackSize++] = { rootChild, rootCount, ray.tMin };
+        bool found = false;
+
+        const RayBoxTest boxTest(ray);
+#if defined(ANITO3D_BVH_SSE2)
+        // Near/far plane arrays per axis, picked once from the direction's signs
+        const __m128 originX = _mm_set1_ps(ray.origin.x), originY = _mm_set1_ps(ray.origin.y), originZ = _mm_set1_ps(ray.origin.z);
+        const __m128 inverseX = _mm_set1_ps(boxTest.inverseDirection.x);
+        const __m128 inverseY = _mm_set1_ps(boxTest.inverseDirection.y);
+        const __m128 inverseZ = _mm_set1_ps(boxTest.inverseDirection.z);
+#endif
+
+        while (stackSize > 0) {
+            const Entry entry = stack[--stackSize];
+            if (entry.t > hit.t) continue;
+
+            if (entry.count > 0) {
+                for (uint32_t i = entry.child; i < entry.child + entry.count; ++i) {
+                    if (Bvh::IntersectTriangle(ray, triangles[i], i, hit)) found = true;
+                }
+                continue;
+            }
+
+            const WideBvhNode<Width>& node = nodes[entry.child];
+            const float tMax = std::min(ray.tMax, hit.t);
+            float distances[Width];
+#if defined(ANITO3D_BVH_SSE2)
+            for (uint32_t group = 0; group < Width; group += 4) {
+                const __m128 nearX = _mm_loadu_ps((boxTest.negative[0] ? node.maxX : node.minX) + group);
+                const __m128 farX = _mm_loadu_ps((boxTest.negative[0] ? node.minX : node.maxX) + group);
+                const __m128 nearY = _mm_loadu_ps((boxTest.negative[1] ? node.maxY : node.minY) + group);
+                const __m128 farY = _mm_loadu_ps((boxTest.negative[1] ? node.minY : node.maxY) + group);
+                const __m128 nearZ = _mm_loadu_ps((boxTest.negative[2] ? node.maxZ : node.minZ) + group);
+                const __m128 farZ = _mm_loadu_ps((boxTest.negative[2] ? node.minZ : node.maxZ) + group);
+
+                // max/min return the second operand for NaN, which keeps the running interval
+                __m128 tNear = _mm_set1_ps(ray.tMin);
+                __m128 tFar = _mm_set1_ps(tMax);
+                tNear = _mm_max_ps(_mm_mul_ps(_mm_sub_ps(nearX, originX), inverseX), tNear);
+                tNear = _mm_max_ps(_mm_mul_ps(_mm_sub_ps(nearY, originY), inverseY), tNear);
+                tNear = _mm_max_ps(_mm_mul_ps(_mm_sub_ps(nearZ, originZ), inverseZ), tNear);
+                tFar = _mm_min_ps(_mm_mul_ps(_mm_sub_ps(farX, originX), inverseX), tFar);
+                tFar = _mm_min_ps(_mm_mul_ps(_mm_sub_ps(farY, originY), inverseY), tFar);
+                tFar = _mm_min_ps(_mm_mul_ps(_mm_sub_ps(farZ, originZ), inverseZ), tFar);
+                const __m128 missed = _mm_cmpgt_ps(tNear, tFar);
+                _mm_storeu_ps(distances + group, _mm_or_ps(_mm_and_ps(missed, _mm_set1_ps(std::numeric_limits<float>::infinity())), _mm_andnot_ps(missed, tNear)));
+            }
+#else
+            for (uint32_t s = 0; s < Width; ++s) {
+                distances[s] = boxTest.Intersect(glm::vec3(node.minX[s], node.minY[s], node.minZ[s]),
+                    glm::vec3(node.maxX[s], node.maxY[s], node.maxZ[s]), ray.tMin, tMax);
+            }
+#endif
+
+            // Push hit children farthest first (insertion sort of at most Width entries)
+            const uint32_t stackBase = stackSize;
+            for (uint32_t s = 0; s < Width; ++s) {
+                if (distances[s] == std::numeric_limits<float>::infinity() || node.children[s] == WideBvhNode<Width>::EmptySlot) continue;
+                uint32_t position = stackSize++;
+                while (position > stackBase && stack[position - 1].t < distances[s]) {
+                    stack[position] = stack[position - 1];
+                    --position;
+                }
+                stack[position] = { node.children[s], node.counts[s], distances[s] };
+            }
+        }
+        return found;
+    }
+
+    template class WideBvh<4>;
+    template class WideBvh<8>;
+}
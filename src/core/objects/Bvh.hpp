@@ -0,0 +1,166 @@
+#pragma once
+
+#include "MeshData.hpp"
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace Anito3D {
+
+    class ThreadPool;
+
+    struct Ray {
+        glm::vec3 origin{ 0.0f };
+        glm::vec3 direction{ 0.0f, 0.0f, -1.0f };
+        float tMin = 0.0f;
+        float tMax = std::numeric_limits<float>::infinity();
+    };
+
+    struct RayHit {
+        static constexpr uint32_t NoHit = std::numeric_limits<uint32_t>::max();
+
+        float t = std::numeric_limits<float>::infinity();
+        float u = 0.0f; // Barycentrics of v1 and v2
+        float v = 0.0f;
+        uint32_t triangle = NoHit; // Index into Bvh::GetTriangles()
+
+        bool IsHit() const { return triangle != NoHit; }
+    };
+
+    // Four rays in SoA layout for packet traversal. Lanes with tMax < tMin are inactive.
+    struct RayPacket {
+        static constexpr uint32_t Size = 4;
+
+        alignas(16) float originX[Size], originY[Size], originZ[Size];
+        alignas(16) float directionX[Size], directionY[Size], directionZ[Size];
+        alignas(16) float tMin[Size], tMax[Size];
+
+        void Set(uint32_t lane, const Ray& ray) {
+            originX[lane] = ray.origin.x;
+            originY[lane] = ray.origin.y;
+            originZ[lane] = ray.origin.z;
+            directionX[lane] = ray.direction.x;
+            directionY[lane] = ray.direction.y;
+            directionZ[lane] = ray.direction.z;
+            tMin[lane] = ray.tMin;
+            tMax[lane] = ray.tMax;
+        }
+        void Disable(uint32_t lane) { Set(lane, Ray{ glm::vec3(0.0f), glm::vec3(0.0f, 0.0f, 1.0f), 1.0f, 0.0f }); }
+        bool IsActive(uint32_t lane) const { return tMin[lane] <= tMax[lane]; }
+        Ray Get(uint32_t lane) const {
+            return { glm::vec3(originX[lane], originY[lane], originZ[lane]), glm::vec3(directionX[lane], directionY[lane], directionZ[lane]),
+                tMin[lane], tMax[lane] };
+        }
+    };
+
+    // Scene-space triangle in leaf order, prepared for Moller-Trumbore
+    struct BvhTriangle {
+        glm::vec3 v0;
+        glm::vec3 edge1; // v1 - v0
+        glm::vec3 edge2; // v2 - v0
+        uint32_t subMesh;   // Index into MeshData::subMeshes (instance)
+        uint32_t primitive; // Triangle within the submesh range
+    };
+
+    // 32 bytes, two per cache line. Siblings are stored next to each other, so an inner
+    // node's children are nodes[index] and nodes[index + 1].
+    struct BvhNode {
+        glm::vec3 boundsMin;
+        uint32_t index; // Inner: left child; leaf: first triangle
+        glm::vec3 boundsMax;
+        uint32_t count; // Triangles in the leaf, 0 for inner nodes
+
+        bool IsLeaf() const { return count > 0; }
+    };
+
+    // Collapsed node with up to Width children whose boxes are stored per axis for SIMD
+    // slab tests. Unused slots have an empty (inverted) box and count 0.
+    template <uint32_t Width>
+    struct WideBvhNode {
+        static constexpr uint32_t EmptySlot = std::numeric_limits<uint32_t>::max();
+
+        float minX[Width], minY[Width], minZ[Width];
+        float maxX[Width], maxY[Width], maxZ[Width];
+        uint32_t children[Width]; // Inner: wide node index; leaf: first triangle; EmptySlot if unused
+        uint32_t counts[Width];   // Triangles for leaf slots, 0 for inner and empty slots
+    };
+
+    struct BvhBuildOptions {
+        uint32_t binCount = 16;       // SAH candidate planes per axis
+        uint32_t maxLeafSize = 8;     // Larger ranges are always split
+        float traversalCost = 1.0f;   // SAH cost of visiting an inner node...
+        float intersectionCost = 1.0f; // ...relative to one ray/triangle test
+    };
+
+    struct BvhBuildStatistics {
+        double buildMs = 0.0;
+        uint64_t triangles = 0;
+        uint64_t nodes = 0;
+        uint64_t leaves = 0;
+        uint32_t maxDepth = 0;
+        uint64_t tasks = 0; // Subtrees built as separate jobs
+        float sahCost = 0.0f;
+    };
+
+    // Bounding volume hierarchy over every submesh instance's triangles in scene space.
+    // Built top-down with binned SAH: the top levels bin in parallel and both halves of a
+    // large split are built as separate jobs, so the pool is busy from the root down.
+    class Bvh {
+    public:
+        static Bvh Build(const MeshData& meshData, const BvhBuildOptions& options = {}, ThreadPool* threadPool = nullptr,
+            BvhBuildStatistics* statistics = nullptr);
+
+        const std::vector<BvhNode>& GetNodes() const { return nodes; }
+        const std::vector<BvhTriangle>& GetTriangles() const { return triangles; }
+        bool IsEmpty() const { return triangles.empty(); }
+
+        // Expected ray cost relative to the root's surface area, with the build's cost constants
+        float ComputeSahCost(float traversalCost = 1.0f, float intersectionCost = 1.0f) const;
+
+        // Closest hit along the ray within [tMin, tMax]
+        bool Intersect(const Ray& ray, RayHit& hit) const;
+        // Any hit within [tMin, tMax] (shadow rays)
+        bool Occluded(const Ray& ray) const;
+        // Closest hits of a coherent packet (e.g. neighbouring primary rays): every node is
+        // fetched once for all lanes and tested against them together with SSE2. Like the
+        // single-ray version, a lane's hit is only replaced by a closer one.
+        void Intersect(const RayPacket& packet, RayHit (&hits)[RayPacket::Size]) const;
+
+        // Moller-Trumbore; updates hit when closer than hit.t
+        static bool IntersectTriangle(const Ray& ray, const BvhTriangle& triangle, uint32_t index, RayHit& hit);
+
+    private:
+        friend class BvhBuilder;
+
+        std::vector<BvhNode> nodes; // nodes[0] is the root
+        std::vector<BvhTriangle> triangles;
+    };
+
+    // Bvh collapsed to Width (4 or 8) children per node. Shares the binary tree's triangles.
+    template <uint32_t Width>
+    class WideBvh {
+    public:
+        static_assert(Width == 4 || Width == 8, "4- or 8-wide nodes");
+
+        // Greedy collapse: repeatedly opens the child with the largest surface area until
+        // a node has Width children or only leaves left
+        static WideBvh Collapse(const Bvh& bvh);
+
+        const std::vector<WideBvhNode<Width>>& GetNodes() const { return nodes; }
+        const Bvh& GetBinary() const { return *bvh; }
+
+        // Same results as Bvh::Intersect; child boxes are tested four at a time with SSE2
+        bool Intersect(const Ray& ray, RayHit& hit) const;
+
+    private:
+        const Bvh* bvh = nullptr;
+        std::vector<WideBvhNode<Width>> nodes;
+        // Root stored as a slot so a single-leaf tree needs no special case
+        uint32_t rootChild = WideBvhNode<Width>::EmptySlot;
+        uint32_t rootCount = 0;
+    };
+
+    using Bvh4 = WideBvh<4>;
+    using Bvh8 = WideBvh<8>;
+
+}
@@ -1 +1,56 @@
-#include "Entity.hpp"
\ No newline at end of file
+#include "Entity.hpp"
+
+namespace Anito3D {
+
+    Entity::~Entity() {
+        if (transformStore) transformStore->Destroy(transformHandle);
+        if (sceneGraph) sceneGraph->DestroyNode(sceneNode);
+    }
+
+    void Entity::SetPosition(const glm::vec3& pos) {
+        position = pos;
+        if (transformStore) transformStore->SetPosition(transformHandle, position);
+        if (sceneGraph) sceneGraph->SetLocalTransform(sceneNode, GetLocalMatrix());
+    }
+
+    void Entity::SetRotation(const glm::vec3& rot) {
+        rotation = rot;
+        if (transformStore) transformStore->SetRotation(transformHandle, GetRotationQuat());
+        if (sceneGraph) sceneGraph->SetLocalTransform(sceneNode, GetLocalMatrix());
+    }
+
+    void Entity::SetScale(const glm::vec3& scl) {
+        scale = scl;
+        if (transformStore) transformStore->SetScale(transformHandle, scale);
+        if (sceneGraph) sceneGraph->SetLocalTransform(sceneNode, GetLocalMatrix());
+    }
+
+    void Entity::AttachTransform(TransformStore& store) {
+        if (transformStore) transformStore->Destroy(transformHandle);
+        transformStore = &store;
+        transformHandle = store.Create(position, GetRotationQuat(), scale);
+    }
+
+    void Entity::AttachScene(SceneGraph& graph, Entity* parent) {
+        if (sceneGraph) sceneGraph->DestroyNode(sceneNode);
+        sceneGraph = &graph;
+        const SceneNodeId parentNode = parent && parent->sceneGraph == &graph ? parent->sceneNode : SceneGraph::InvalidNode;
+        sceneNode = graph.CreateNode(parentNode, GetLocalMatrix());
+    }
+
+    bool Entity::SetParent(Entity* parent) {
+        if (!sceneGraph) return false;
+        if (parent && parent->sceneGraph != sceneGraph) return false;
+        return sceneGraph->SetParent(sceneNode, parent ? parent->sceneNode : SceneGraph::InvalidNode);
+    }
+
+    glm::mat4 Entity::GetWorldMatrix() const {
+        if (sceneGraph) return sceneGraph->GetWorldTransform(sceneNode);
+        if (transformStore) return transformStore->GetWorldMatrix(transformHandle);
+        return GetLocalMatrix();
+    }
+
+    glm::mat4 Entity::GetLocalMatrix() const {
+        return TransformStore::ComposeMatrix(position, GetRotationQuat(), scale);
+    }
+}
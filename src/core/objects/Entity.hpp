@@ -1,26 +1,58 @@
 #pragma once
 
 #include <glm/glm.hpp>
+#include "SceneGraph.hpp"
+#include "TransformStore.hpp"
 
 namespace Anito3D {
     class Entity {
     public:
         Entity() : position(0.0f), rotation(0.0f), scale(1.0f) {}
-        virtual ~Entity() = default;
+        virtual ~Entity();
+
+        Entity(const Entity&) = delete;
+        Entity& operator=(const Entity&) = delete;
 
         // Getters/Setters for transform
-        glm::vec3 GetPosition() const { return position; }
-        void SetPosition(const glm::vec3& pos) { position = pos; }
-        glm::vec3 GetRotation() const { return rotation; }
-        void SetRotation(const glm::vec3& rot) { rotation = rot; }
-        glm::vec3 GetScale() const { return scale; }
-        void SetScale(const glm::vec3& scl) { scale = scl; }
+        const glm::vec3& GetPosition() const { return position; }
+        void SetPosition(const glm::vec3& pos);
+        const glm::vec3& GetRotation() const { return rotation; }
+        void SetRotation(const glm::vec3& rot);
+        const glm::vec3& GetScale() const { return scale; }
+        void SetScale(const glm::vec3& scl);
+
+        // Mirror the transform into store (which must outlive the entity) so the world matrix
+        // is cached there and only rebuilt by TransformStore::UpdateWorldMatrices() after a change
+        void AttachTransform(TransformStore& store);
+        TransformHandle GetTransformHandle() const { return transformHandle; }
+
+        // Add a node for the entity to graph (which must outlive it) below parent's node;
+        // the entity transform becomes the node's local transform
+        virtual void AttachScene(SceneGraph& graph, Entity* parent = nullptr);
+        // Re-parent within the same graph (nullptr makes the entity a root); false on cycles
+        bool SetParent(Entity* parent);
+        SceneGraph* GetSceneGraph() const { return sceneGraph; }
+        SceneNodeId GetSceneNode() const { return sceneNode; }
 
+        // Scene graph world transform, else the cached store matrix, else composed on the fly
+        glm::mat4 GetWorldMatrix() const;
+        glm::mat4 GetLocalMatrix() const;
+
+        // Per-object hook for interactive code; per-frame work over many entities runs as
+        // chunk systems over a World (ecs/SystemScheduler.hpp)
         virtual void Update(float deltaTime) {}
 
     protected:
         glm::vec3 position; // Position in 3D space
         glm::vec3 rotation; // Euler angles (degrees)
         glm::vec3 scale;    // Scale factor
+
+    private:
+        TransformStore* transformStore = nullptr;
+        TransformHandle transformHandle;
+        SceneGraph* sceneGraph = nullptr;
+        SceneNodeId sceneNode = SceneGraph::InvalidNode;
+
+        glm::quat GetRotationQuat() const { return glm::quat(glm::radians(rotation)); }
     };
-}
\ No newline at end of file
+}
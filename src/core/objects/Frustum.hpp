@@ -0,0 +1,55 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+namespace Anito3D {
+
+    // Six normalized planes (xyz = inward normal, w = distance); a point p is inside when
+    // dot(plane.xyz, p) + plane.w >= 0 for every plane
+    struct Frustum {
+        enum Plane { Left, Right, Bottom, Top, Near, Far, PlaneCount };
+        glm::vec4 planes[PlaneCount];
+
+        // Gribb/Hartmann extraction from a column-major view-projection matrix. The near
+        // plane uses the -w..w depth range, which is also conservative for 0..w projections.
+        static Frustum FromMatrix(const glm::mat4& viewProjection) {
+            auto row = [&](int r) {
+                return glm::vec4(viewProjection[0][r], viewProjection[1][r], viewProjection[2][r], viewProjection[3][r]);
+            };
+            Frustum frustum;
+            frustum.planes[Left] = row(3) + row(0);
+            frustum.planes[Right] = row(3) - row(0);
+            frustum.planes[Bottom] = row(3) + row(1);
+            frustum.planes[Top] = row(3) - row(1);
+            frustum.planes[Near] = row(3) + row(2);
+            frustum.planes[Far] = row(3) - row(2);
+            frustum.Normalize();
+            return frustum;
+        }
+
+        // Same frustum expressed in the object space of objectToWorld (any affine transform)
+        Frustum Transform(const glm::mat4& objectToWorld) const {
+            const glm::mat4 transposed = glm::transpose(objectToWorld);
+            Frustum frustum;
+            for (int i = 0; i < PlaneCount; ++i) frustum.planes[i] = transposed * planes[i];
+            frustum.Normalize();
+            return frustum;
+        }
+
+        bool IntersectsSphere(const glm::vec3& center, float radius) const {
+            for (const glm::vec4& plane : planes) {
+                if (glm::dot(glm::vec3(plane), center) + plane.w < -radius) return false;
+            }
+            return true;
+        }
+
+    private:
+        void Normalize() {
+            for (glm::vec4& plane : planes) {
+                float length = glm::length(glm::vec3(plane));
+                if (length > 0.0f) plane /= length;
+            }
+        }
+    };
+
+}
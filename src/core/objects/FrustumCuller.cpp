@@ -0,0 +1,268 @@
+#include "FrustumCuller.hpp"
+#include "ThreadPool.hpp"
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define ANITO3D_FRUSTUM_CULLER_SSE2 1
+#include <emmintrin.h>
+// AVX2 code is compiled per function, so the rest of the build keeps its baseline ISA
+#define ANITO3D_FRUSTUM_CULLER_AVX2 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define ANITO3D_TARGET_AVX2
+#else
+#define ANITO3D_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+namespace Anito3D {
+
+    namespace {
+        constexpr size_t BlockSize = 16384; // Boxes per ParallelFor index
+
+        // Planes split into components, with |normal| for the box's projected radius
+        struct PlaneSet {
+            float nx[Frustum::PlaneCount], ny[Frustum::PlaneCount], nz[Frustum::PlaneCount], w[Frustum::PlaneCount];
+            float ax[Frustum::PlaneCount], ay[Frustum::PlaneCount], az[Frustum::PlaneCount];
+        };
+
+        PlaneSet PreparePlanes(const Frustum& frustum) {
+            PlaneSet set;
+            for (int p = 0; p < Frustum::PlaneCount; ++p) {
+                const glm::vec4& plane = frustum.planes[p];
+                set.nx[p] = plane.x;
+                set.ny[p] = plane.y;
+                set.nz[p] = plane.z;
+                set.w[p] = plane.w;
+                set.ax[p] = std::abs(plane.x);
+                set.ay[p] = std::abs(plane.y);
+                set.az[p] = std::abs(plane.z);
+            }
+            return set;
+        }
+
+        // Each path culls boxes [begin, end) and writes visible indices from out[0]; out has
+        // room for end - begin entries. Returns the visible count.
+        using CullRangeFunction = size_t(*)(const PlaneSet&, const BoundingBoxArray&, size_t, size_t, uint32_t*);
+
+        // Outside when the box lies entirely behind a plane: distance + projected radius < 0.
+        // The SIMD paths evaluate the same expressions in the same order, so all paths agree.
+        size_t CullScalar(const PlaneSet& planes, const BoundingBoxArray& boxes, size_t begin, size_t end, uint32_t* out) {
+            size_t count = 0;
+            for (size_t i = begin; i < end; ++i) {
+                const float cx = boxes.centerX[i], cy = boxes.centerY[i], cz = boxes.centerZ[i];
+                const float ex = boxes.extentX[i], ey = boxes.extentY[i], ez = boxes.extentZ[i];
+                bool inside = true;
+                for (int p = 0; p < Frustum::PlaneCount; ++p) {
+                    const float distance = planes.nx[p] * cx + planes.ny[p] * cy + planes.nz[p] * cz + planes.w[p];
+                    const float radius = planes.ax[p] * ex + planes.ay[p] * ey + planes.az[p] * ez;
+                    inside &= distance + radius >= 0.0f;
+                }
+                out[count] = static_cast<uint32_t>(i);
+                count += inside;
+            }
+            return count;
+        }
+
+#if defined(ANITO3D_FRUSTUM_CULLER_SSE2)
+        size_t CullSse2(const PlaneSet& planes, const BoundingBoxArray& boxes, size_t begin, size_t end, uint32_t* out) {
+            const __m128 zero = _mm_setzero_ps();
+            size_t count = 0;
+            size_t i = begin;
+            for (; i + 4 <= end; i += 4) {
+                const __m128 cx = _mm_loadu_ps(&boxes.centerX[i]);
+                const __m128 cy = _mm_loadu_ps(&boxes.centerY[i]);
+                const __m128 cz = _mm_loadu_ps(&boxes.centerZ[i]);
+                const __m128 ex = _mm_loadu_ps(&boxes.extentX[i]);
+                const __m128 ey = _mm_loadu_ps(&boxes.extentY[i]);
+                const __m128 ez = _mm_loadu_ps(&boxes.extentZ[i]);
+
+                __m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+                for (int p = 0; p < Frustum::PlaneCount; ++p) {
+                    const __m128 distance = _mm_add_ps(_mm_add_ps(_mm_add_ps(
+                        _mm_mul_ps(_mm_set1_ps(planes.nx[p]), cx), _mm_mul_ps(_mm_set1_ps(planes.ny[p]), cy)),
+                        _mm_mul_ps(_mm_set1_ps(planes.nz[p]), cz)), _mm_set1_ps(planes.w[p]));
+                    const __m128 radius = _mm_add_ps(_mm_add_ps(
+                        _mm_mul_ps(_mm_set1_ps(planes.ax[p]), ex), _mm_mul_ps(_mm_set1_ps(planes.ay[p]), ey)),
+                        _mm_mul_ps(_mm_set1_ps(planes.az[p]), ez));
+                    inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(distance, radius), zero));
+                }
+
+                // Branchless compaction: every lane writes, only visible lanes advance
+                const int mask = _mm_movemask_ps(inside);
+                for (int lane = 0; lane < 4; ++lane) {
+                    out[count] = static_cast<uint32_t>(i + lane);
+                    count += (mask >> lane) & 1;
+                }
+            }
+            return count + CullScalar(planes, boxes, i, end, out + count);
+        }
+#endif
+
+#if defined(ANITO3D_FRUSTUM_CULLER_AVX2)
+        // Lane indices of the set bits of every 8-bit mask, packed to the front
+        struct CompactTable {
+            alignas(32) uint32_t lanes[256][8];
+
+            constexpr CompactTable() : lanes{} {
+                for (uint32_t mask = 0; mask < 256; ++mask) {
+                    uint32_t count = 0;
+                    for (uint32_t lane = 0; lane < 8; ++lane) {
+                        if (mask & (1u << lane)) lanes[mask][count++] = lane;
+                    }
+                }
+            }
+        };
+        constexpr CompactTable compactTable;
+
+        ANITO3D_TARGET_AVX2 size_t CullAvx2(const PlaneSet& planes, const BoundingBoxArray& boxes, size_t begin, size_t end, uint32_t* out) {
+            const __m256 zero = _mm256_setzero_ps();
+            const __m256i laneOffsets = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+            size_t count = 0;
+            size_t i = begin;
+            for (; i + 8 <= end; i += 8) {
+                const __m256 cx = _mm256_loadu_ps(&boxes.centerX[i]);
+                const __m256 cy = _mm256_loadu_ps(&boxes.centerY[i]);
+                const __m256 cz = _mm256_loadu_ps(&boxes.centerZ[i]);
+                const __m256 ex = _mm256_loadu_ps(&boxes.extentX[i]);
+                const __m256 ey = _mm256_loadu_ps(&boxes.extentY[i]);
+                const __m256 ez = _mm256_loadu_ps(&boxes.extentZ[i]);
+
+                __m256 inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+                for (int p = 0; p < Frustum::PlaneCount; ++p) {
+                    const __m256 distance = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(
+                        _mm256_mul_ps(_mm256_set1_ps(planes.nx[p]), cx), _mm256_mul_ps(_mm256_set1_ps(planes.ny[p]), cy)),
+                        _mm256_mul_ps(_mm256_set1_ps(planes.nz[p]), cz)), _mm256_set1_ps(planes.w[p]));
+                    const __m256 radius = _mm256_add_ps(_mm256_add_ps(
+                        _mm256_mul_ps(_mm256_set1_ps(planes.ax[p]), ex), _mm256_mul_ps(_mm256_set1_ps(planes.ay[p]), ey)),
+                        _mm256_mul_ps(_mm256_set1_ps(planes.az[p]), ez));
+                    inside = _mm256_and_ps(inside, _mm256_cmp_ps(_mm256_add_ps(distance, radius), zero, _CMP_GE_OQ));
+                }
+
+                // Permute the visible lanes' indices to the front and store all eight; the
+                // unused tail is overwritten by the next step (out has room for every box)
+                const int mask = _mm256_movemask_ps(inside);
+                const __m256i indices = _mm256_add_epi32(_mm256_set1_epi32(static_cast<int>(i)), laneOffsets);
+                const __m256i permute = _mm256_load_si256(reinterpret_cast<const __m256i*>(compactTable.lanes[mask]));
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + count), _mm256_permutevar8x32_epi32(indices, permute));
+                count += static_cast<size_t>(std::popcount(static_cast<unsigned int>(mask)));
+            }
+            return count + CullScalar(planes, boxes, i, end, out + count);
+        }
+
+        bool CpuSupportsAvx2() {
+#if defined(_MSC_VER)
+            int info[4];
+            __cpuid(info, 0);
+            if (info[0] < 7) return false;
+            __cpuid(info, 1);
+            const bool osSavesYmm = (info[2] & (1 << 27)) && (info[2] & (1 << 28)) && (_xgetbv(0) & 0x6) == 0x6;
+            __cpuidex(info, 7, 0);
+            return osSavesYmm && (info[1] & (1 << 5));
+#else
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("avx2");
+#endif
+        }
+#endif
+
+        CullRangeFunction GetRangeFunction(CullPath path) {
+            switch (path) {
+#if defined(ANITO3D_FRUSTUM_CULLER_AVX2)
+            case CullPath::Avx2: return CullAvx2;
+#endif
+#if defined(ANITO3D_FRUSTUM_CULLER_SSE2)
+            case CullPath::Sse2: return CullSse2;
+#endif
+            default: return CullScalar;
+            }
+        }
+    }
+
+    void BoundingBoxArray::Reserve(size_t count) {
+        for (auto* array : { &centerX, &centerY, &centerZ, &extentX, &extentY, &extentZ }) array->reserve(count);
+    }
+
+    void BoundingBoxArray::Clear() {
+        for (auto* array : { &centerX, &centerY, &centerZ, &extentX, &extentY, &extentZ }) array->clear();
+    }
+
+    void BoundingBoxArray::Add(const glm::vec3& min, const glm::vec3& max) {
+        for (auto* array : { &centerX, &centerY, &centerZ, &extentX, &extentY, &extentZ }) array->emplace_back();
+        Set(Size() - 1, min, max);
+    }
+
+    void BoundingBoxArray::Set(size_t index, const glm::vec3& min, const glm::vec3& max) {
+        const glm::vec3 center = (min + max) * 0.5f;
+        const glm::vec3 extent = (max - min) * 0.5f;
+        centerX[index] = center.x;
+        centerY[index] = center.y;
+        centerZ[index] = center.z;
+        extentX[index] = extent.x;
+        extentY[index] = extent.y;
+        extentZ[index] = extent.z;
+    }
+
+    bool FrustumCuller::IsSupported(CullPath path) {
+        switch (path) {
+        case CullPath::Scalar: return true;
+#if defined(ANITO3D_FRUSTUM_CULLER_SSE2)
+        case CullPath::Sse2: return true;
+#endif
+#if defined(ANITO3D_FRUSTUM_CULLER_AVX2)
+        case CullPath::Avx2: {
+            static const bool supported = CpuSupportsAvx2();
+            return supported;
+        }
+#endif
+        default: return false;
+        }
+    }
+
+    CullPath FrustumCuller::GetBestPath() {
+        if (IsSupported(CullPath::Avx2)) return CullPath::Avx2;
+        if (IsSupported(CullPath::Sse2)) return CullPath::Sse2;
+        return CullPath::Scalar;
+    }
+
+    const char* FrustumCuller::ToString(CullPath path) {
+        switch (path) {
+        case CullPath::Scalar: return "scalar";
+        case CullPath::Sse2: return "sse2";
+        case CullPath::Avx2: return "avx2";
+        }
+        return "unknown";
+    }
+
+    size_t FrustumCuller::Cull(const Frustum& frustum, const BoundingBoxArray& boxes, std::vector<uint32_t>& visible,
+        CullPath path, ThreadPool* threadPool) {
+        const size_t count = boxes.Size();
+        if (visible.size() < count) visible.resize(count);
+        if (count == 0) return 0;
+
+        const CullRangeFunction cullRange = GetRangeFunction(IsSupported(path) ? path : GetBestPath());
+        const PlaneSet planes = PreparePlanes(frustum);
+        const size_t blockCount = (count + BlockSize - 1) / BlockSize;
+        if (!threadPool || blockCount == 1) {
+            return cullRange(planes, boxes, 0, count, visible.data());
+        }
+
+        // Each block compacts into its own slice, then the slices are moved together in order
+        std::vector<size_t> blockVisible(blockCount);
+        threadPool->ParallelFor(blockCount, [&](size_t block) {
+            const size_t begin = block * BlockSize;
+            blockVisible[block] = cullRange(planes, boxes, begin, std::min(count, begin + BlockSize), visible.data() + begin);
+        });
+
+        size_t total = blockVisible[0];
+        for (size_t block = 1; block < blockCount; ++block) {
+            const uint32_t* first = visible.data() + block * BlockSize;
+            std::copy(first, first + blockVisible[block], visible.data() + total);
+            total += blockVisible[block];
+        }
+        return total;
+    }
+}
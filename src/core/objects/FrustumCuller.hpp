@@ -0,0 +1,47 @@
+#pragma once
+
+#include "Frustum.hpp"
+#include "MeshData.hpp"
+#include <cstdint>
+#include <vector>
+
+namespace Anito3D {
+
+    class ThreadPool;
+
+    // World-space boxes as separate center / half-extent arrays, the layout FrustumCuller
+    // streams through (one register load per component for 4 or 8 boxes)
+    struct BoundingBoxArray {
+        std::vector<float> centerX, centerY, centerZ;
+        std::vector<float> extentX, extentY, extentZ;
+
+        size_t Size() const { return centerX.size(); }
+        void Reserve(size_t count);
+        void Clear();
+        void Add(const glm::vec3& min, const glm::vec3& max);
+        void Add(const MeshData::Bounds& bounds) { Add(bounds.min, bounds.max); }
+        void Set(size_t index, const glm::vec3& min, const glm::vec3& max);
+    };
+
+    enum class CullPath {
+        Scalar,
+        Sse2, // 4 boxes per step
+        Avx2  // 8 boxes per step, compacted with a permute table
+    };
+
+    // Bulk box-vs-frustum test producing a compact list of visible indices. The SIMD paths are
+    // compiled into every x86 build and selected at runtime from the CPU's features.
+    class FrustumCuller {
+    public:
+        static bool IsSupported(CullPath path);
+        static CullPath GetBestPath(); // Widest supported path (detected once)
+        static const char* ToString(CullPath path);
+
+        // Writes the indices of the boxes that intersect the frustum, in increasing order, to
+        // visible[0, count) and returns count. visible only grows (to boxes.Size()), so reusing
+        // it across frames avoids reallocating and clearing. Unsupported paths use the best one.
+        static size_t Cull(const Frustum& frustum, const BoundingBoxArray& boxes, std::vector<uint32_t>& visible,
+            CullPath path = GetBestPath(), ThreadPool* threadPool = nullptr);
+    };
+
+}
@@ -0,0 +1,189 @@
+#include "MeshBounds.hpp"
+#include "ThreadPool.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define ANITO3D_MESH_BOUNDS_SSE2 1
+#include <emmintrin.h>
+#endif
+
+namespace Anito3D {
+
+    namespace {
+        static_assert(sizeof(glm::vec3) == 3 * sizeof(float), "Positions are streamed as packed floats");
+
+        float MaxDistanceSquaredScalar(std::span<const glm::vec3> positions, const glm::vec3& center) {
+            float maxDistance = 0.0f;
+            for (const glm::vec3& position : positions) {
+                const glm::vec3 d = position - center;
+                maxDistance = std::max(maxDistance, glm::dot(d, d));
+            }
+            return maxDistance;
+        }
+
+#if defined(ANITO3D_MESH_BOUNDS_SSE2)
+        // Four packed vec3 (x0 y0 z0 x1 | y1 z1 x2 y2 | z2 x3 y3 z3) to x/y/z registers
+        void Deinterleave(__m128 a, __m128 b, __m128 c, __m128& x, __m128& y, __m128& z) {
+            x = _mm_shuffle_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 3, 3, 0)), _mm_shuffle_ps(b, c, _MM_SHUFFLE(1, 1, 2, 2)), _MM_SHUFFLE(2, 0, 1, 0));
+            y = _mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(0, 0, 1, 1)), _mm_shuffle_ps(b, c, _MM_SHUFFLE(2, 2, 3, 3)), _MM_SHUFFLE(2, 0, 2, 0));
+            z = _mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(1, 1, 2, 2)), _mm_shuffle_ps(c, c, _MM_SHUFFLE(3, 3, 0, 0)), _MM_SHUFFLE(2, 0, 2, 0));
+        }
+
+        float MaxDistanceSquared(std::span<const glm::vec3> positions, const glm::vec3& center) {
+            const float* data = reinterpret_cast<const float*>(positions.data());
+            const size_t count = positions.size();
+            const __m128 cx = _mm_set1_ps(center.x);
+            const __m128 cy = _mm_set1_ps(center.y);
+            const __m128 cz = _mm_set1_ps(center.z);
+            __m128 maxDistance = _mm_setzero_ps();
+
+            size_t i = 0;
+            for (; i + 4 <= count; i += 4) {
+                __m128 x, y, z;
+                Deinterleave(_mm_loadu_ps(data + i * 3), _mm_loadu_ps(data + i * 3 + 4), _mm_loadu_ps(data + i * 3 + 8), x, y, z);
+                x = _mm_sub_ps(x, cx);
+                y = _mm_sub_ps(y, cy);
+                z = _mm_sub_ps(z, cz);
+                const __m128 distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)), _mm_mul_ps(z, z));
+                maxDistance = _mm_max_ps(maxDistance, distance);
+            }
+
+            float lanes[4];
+            _mm_storeu_ps(lanes, maxDistance);
+            const float tail = MaxDistanceSquaredScalar(positions.subspan(i), center);
+            return std::max({ lanes[0], lanes[1], lanes[2], lanes[3], tail });
+        }
+#endif
+    }
+
+    void MeshBounds::ComputeMinMaxScalar(std::span<const glm::vec3> positions, glm::vec3& min, glm::vec3& max) {
+        min = glm::vec3(std::numeric_limits<float>::max());
+        max = glm::vec3(-std::numeric_limits<float>::max());
+        for (const glm::vec3& position : positions) {
+            min = glm::min(min, position);
+            max = glm::max(max, position);
+        }
+    }
+
+    void MeshBounds::ComputeMinMax(std::span<const glm::vec3> positions, glm::vec3& min, glm::vec3& max) {
+#if defined(ANITO3D_MESH_BOUNDS_SSE2)
+        // Twelve floats (four vertices) per step in three registers whose lanes repeat x y z;
+        // lane k of the concatenated registers always holds component k % 3
+        const float* data = reinterpret_cast<const float*>(positions.data());
+        const size_t count = positions.size();
+        __m128 minA = _mm_set1_ps(std::numeric_limits<float>::max());
+        __m128 minB = minA;
+        __m128 minC = minA;
+        __m128 maxA = _mm_set1_ps(-std::numeric_limits<float>::max());
+        __m128 maxB = maxA;
+        __m128 maxC = maxA;
+
+        size_t i = 0;
+        for (; i + 4 <= count; i += 4) {
+            const __m128 a = _mm_loadu_ps(data + i * 3);
+            const __m128 b = _mm_loadu_ps(data + i * 3 + 4);
+            const __m128 c = _mm_loadu_ps(data + i * 3 + 8);
+            minA = _mm_min_ps(minA, a);
+            minB = _mm_min_ps(minB, b);
+            minC = _mm_min_ps(minC, c);
+            maxA = _mm_max_ps(maxA, a);
+            maxB = _mm_max_ps(maxB, b);
+            maxC = _mm_max_ps(maxC, c);
+        }
+
+        float minLanes[12];
+        float maxLanes[12];
+        _mm_storeu_ps(minLanes, minA);
+        _mm_storeu_ps(minLanes + 4, minB);
+        _mm_storeu_ps(minLanes + 8, minC);
+        _mm_storeu_ps(maxLanes, maxA);
+        _mm_storeu_ps(maxLanes + 4, maxB);
+        _mm_storeu_ps(maxLanes + 8, maxC);
+
+        ComputeMinMaxScalar(positions.subspan(i), min, max);
+        for (int lane = 0; lane < 12; ++lane) {
+            min[lane % 3] = std::min(min[lane % 3], minLanes[lane]);
+            max[lane % 3] = std::max(max[lane % 3], maxLanes[lane]);
+        }
+#else
+        ComputeMinMaxScalar(positions, min, max);
+#endif
+    }
+
+    MeshData::Bounds MeshBounds::Compute(std::span<const glm::vec3> positions) {
+        MeshData::Bounds bounds;
+        if (positions.empty()) return bounds;
+
+        ComputeMinMax(positions, bounds.min, bounds.max);
+        bounds.center = (bounds.min + bounds.max) * 0.5f;
+#if defined(ANITO3D_MESH_BOUNDS_SSE2)
+        bounds.radius = std::sqrt(MaxDistanceSquared(positions, bounds.center));
+#else
+        bounds.radius = std::sqrt(MaxDistanceSquaredScalar(positions, bounds.center));
+#endif
+        return bounds;
+    }
+
+    MeshData::Bounds MeshBounds::Transform(const MeshData::Bounds& bounds, const glm::mat4& transform) {
+        // Center/extent form: the new half extent is |M| * extent (Arvo)
+        const glm::vec3 extent = (bounds.max - bounds.min) * 0.5f;
+        const glm::vec3 center = glm::vec3(transform * glm::vec4(bounds.center, 1.0f));
+        const glm::mat3 linear(transform);
+        const glm::vec3 newExtent = glm::abs(linear[0]) * extent.x + glm::abs(linear[1]) * extent.y + glm::abs(linear[2]) * extent.z;
+        const float scale = std::max({ glm::length(linear[0]), glm::length(linear[1]), glm::length(linear[2]) });
+
+        MeshData::Bounds result;
+        result.min = center - newExtent;
+        result.max = center + newExtent;
+        result.center = center;
+        result.radius = bounds.radius * scale;
+        return result;
+    }
+
+    MeshData::Bounds MeshBounds::Merge(const MeshData::Bounds& a, const MeshData::Bounds& b) {
+        MeshData::Bounds result;
+        result.min = glm::min(a.min, b.min);
+        result.max = glm::max(a.max, b.max);
+        result.center = (result.min + result.max) * 0.5f;
+        result.radius = std::max(glm::length(a.center - result.center) + a.radius, glm::length(b.center - result.center) + b.radius);
+        return result;
+    }
+
+    void MeshBounds::Update(MeshData& meshData, ThreadPool* threadPool) {
+        const std::vector<MeshData::SubMesh> ranges = meshData.GetUniqueRanges();
+        std::vector<MeshData::Bounds> rangeBounds(ranges.size());
+        auto computeRange = [&](size_t r) {
+            rangeBounds[r] = Compute(std::span<const glm::vec3>(meshData.vertices).subspan(ranges[r].vertexOffset, ranges[r].vertexCount));
+        };
+        if (threadPool) {
+            threadPool->ParallelFor(ranges.size(), computeRange);
+        }
+        else {
+            for (size_t r = 0; r < ranges.size(); ++r) computeRange(r);
+        }
+
+        for (auto& subMesh : meshData.subMeshes) {
+            const size_t range = MeshData::FindRange(ranges, subMesh);
+            subMesh.bounds = range < ranges.size() ? rangeBounds[range] : MeshData::Bounds{};
+        }
+        UpdateSceneBounds(meshData);
+    }
+
+    void MeshBounds::UpdateSceneBounds(MeshData& meshData) {
+        meshData.bounds = ComputeSceneBounds(meshData.subMeshes);
+    }
+
+    MeshData::Bounds MeshBounds::ComputeSceneBounds(std::span<const MeshData::SubMesh> subMeshes) {
+        MeshData::Bounds sceneBounds;
+        bool first = true;
+        for (const auto& subMesh : subMeshes) {
+            if (subMesh.vertexCount == 0) continue;
+            const MeshData::Bounds bounds = Transform(subMesh.bounds, subMesh.transform);
+            sceneBounds = first ? bounds : Merge(sceneBounds, bounds);
+            first = false;
+        }
+        return sceneBounds;
+    }
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include "MeshData.hpp"
+#include <span>
+
+namespace Anito3D {
+
+    class ThreadPool;
+
+    // Load-time bounds for MeshData: SubMesh::bounds per vertex range and MeshData::bounds
+    // for the whole file. The min/max reduction streams positions four at a time with SSE2.
+    class MeshBounds {
+    public:
+        // Box and enclosing sphere of positions (all zero when empty)
+        static MeshData::Bounds Compute(std::span<const glm::vec3> positions);
+
+        // Box around bounds under an affine transform, with the sphere transformed along
+        static MeshData::Bounds Transform(const MeshData::Bounds& bounds, const glm::mat4& transform);
+        static MeshData::Bounds Merge(const MeshData::Bounds& a, const MeshData::Bounds& b);
+
+        // Recomputes SubMesh::bounds for every unique range, then MeshData::bounds
+        static void Update(MeshData& meshData, ThreadPool* threadPool = nullptr);
+        // MeshData::bounds from the existing SubMesh::bounds (e.g. after loading a cache)
+        static void UpdateSceneBounds(MeshData& meshData);
+        static MeshData::Bounds ComputeSceneBounds(std::span<const MeshData::SubMesh> subMeshes);
+
+        // Scalar reference for the SIMD reduction
+        static void ComputeMinMaxScalar(std::span<const glm::vec3> positions, glm::vec3& min, glm::vec3& max);
+        static void ComputeMinMax(std::span<const glm::vec3> positions, glm::vec3& min, glm::vec3& max);
+    };
+
+}
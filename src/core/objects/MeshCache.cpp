@@ -0,0 +1,356 @@
+#include "MeshCache.hpp"
+#include "Hash.hpp"
+#include "MeshBounds.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <thread>
+#include <type_traits>
+
+namespace Anito3D {
+
+    namespace {
+        constexpr char CacheMagic[8] = { 'A', '3', 'D', 'M', 'E', 'S', 'H', '\0' };
+
+        static_assert(std::is_trivially_copyable_v<MeshCacheHeader>);
+        static_assert(std::is_trivially_copyable_v<MeshData::SubMesh>);
+        static_assert(std::is_trivially_copyable_v<MeshData::Material>);
+        static_assert(std::is_trivially_copyable_v<MeshData::Node>);
+        static_assert(sizeof(glm::vec3) == 12 && sizeof(glm::vec2) == 8);
+
+        uint64_t AlignUp(uint64_t value, uint64_t alignment) {
+            return (value + alignment - 1) & ~(alignment - 1);
+        }
+
+        template <typename T>
+        bool SectionInRange(const MappedFile& file, uint64_t offset, uint64_t count) {
+            if (count == 0) return true;
+            if (offset % alignof(T) != 0) return false;
+            if (count > (file.Size() / sizeof(T))) return false;
+            return offset <= file.Size() && count * sizeof(T) <= file.Size() - offset;
+        }
+
+        template <typename T>
+        std::span<const T> SectionSpan(const MappedFile& file, uint64_t offset, uint64_t count) {
+            if (count == 0) return {};
+            return { reinterpret_cast<const T*>(file.Data() + offset), static_cast<size_t>(count) };
+        }
+
+        // Every range of the submesh table and node tree must stay inside the arrays it indexes
+        bool RangesInBounds(const MeshDataView& view) {
+            const uint64_t vertexCount = view.vertices.size();
+            if (!view.normals.empty() && view.normals.size() != vertexCount) return false;
+            if (!view.texCoords.empty() && view.texCoords.size() != vertexCount) return false;
+
+            for (const auto& subMesh : view.subMeshes) {
+                if (subMesh.indexType != MeshData::IndexType::Uint16 && subMesh.indexType != MeshData::IndexType::Uint32) return false;
+                const uint64_t indexArraySize = subMesh.indexType == MeshData::IndexType::Uint16 ? view.indices16.size() : view.indices.size();
+                if (subMesh.indexCount % 3 != 0) return false;
+                if (uint64_t(subMesh.firstIndex) + subMesh.indexCount > indexArraySize) return false;
+                if (uint64_t(subMesh.vertexOffset) + subMesh.vertexCount > vertexCount) return false;
+                if (!view.nodes.empty() && subMesh.node >= view.nodes.size()) return false;
+            }
+            for (size_t i = 0; i < view.nodes.size(); ++i) {
+                // Pre-order: parents precede their children
+                if (view.nodes[i].parent != MeshData::NoParent && view.nodes[i].parent >= i) return false;
+            }
+            return true;
+        }
+
+        // Distinct per process, thread and call, so concurrent writers of one entry never share a temp file
+        std::string MakeTempSuffix() {
+            static const uint32_t processToken = std::random_device{}();
+            static std::atomic<uint64_t> counter{ 0 };
+            const size_t threadToken = std::hash<std::thread::id>{}(std::this_thread::get_id());
+
+            char suffix[64];
+            std::snprintf(suffix, sizeof(suffix), ".%08x-%08x-%llu.tmp", processToken, static_cast<uint32_t>(threadToken),
+                static_cast<unsigned long long>(counter.fetch_add(1)));
+            return suffix;
+        }
+    }
+
+    const char* ToString(MeshCacheStatus status) {
+        switch (status) {
+        case MeshCacheStatus::Valid: return "valid";
+        case MeshCacheStatus::Missing: return "missing";
+        case MeshCacheStatus::Corrupt: return "corrupt";
+        case MeshCacheStatus::VersionMismatch: return "version mismatch";
+        case MeshCacheStatus::KeyMismatch: return "key mismatch";
+        case MeshCacheStatus::SourceChanged: return "source changed";
+        case MeshCacheStatus::SourceMissing: return "source missing";
+        }
+        return "unknown";
+    }
+
+    MeshCache::MeshCache(const std::string& cacheDirectory) : directory(cacheDirectory) {}
+
+    MeshCache& MeshCache::Default() {
+        static MeshCache cache(ANITO3DSANDBOX_CACHE_PATH);
+        return cache;
+    }
+
+    std::string MeshCache::GetCachePath(const std::string& sourcePath, const MeshCacheKey& key) const {
+        std::error_code ec;
+        std::filesystem::path canonical = std::filesystem::weakly_canonical(sourcePath, ec);
+        std::string pathKey = (ec ? std::filesystem::path(sourcePath) : canonical).generic_string();
+
+        // <file name>-<path hash>-<import flags>[-<process flags>[-<settings hash>]].a3dmesh keeps the cache browsable
+        char suffix[80];
+        if (key.processSettingsHash != 0) {
+            std::snprintf(suffix, sizeof(suffix), "-%016llx-%08x-%08x-%016llx.a3dmesh",
+                static_cast<unsigned long long>(HashString(pathKey)), key.importFlags, key.processFlags,
+                static_cast<unsigned long long>(key.processSettingsHash));
+        }
+        else if (key.processFlags != 0) {
+            std::snprintf(suffix, sizeof(suffix), "-%016llx-%08x-%08x.a3dmesh",
+                static_cast<unsigned long long>(HashString(pathKey)), key.importFlags, key.processFlags);
+        }
+        else {
+            std::snprintf(suffix, sizeof(suffix), "-%016llx-%08x.a3dmesh",
+                static_cast<unsigned long long>(HashString(pathKey)), key.importFlags);
+        }
+        std::string fileName = std::filesystem::path(sourcePath).filename().string() + suffix;
+        return (std::filesystem::path(directory) / fileName).string();
+    }
+
+    bool MeshCache::QuerySource(const std::string& sourcePath, SourceInfo& info) {
+        std::error_code ec;
+        std::filesystem::path canonical = std::filesystem::weakly_canonical(sourcePath, ec);
+        info.canonicalPath = (ec ? std::filesystem::path(sourcePath) : canonical).generic_string();
+
+        info.size = std::filesystem::file_size(sourcePath, ec);
+        if (ec) return false;
+        auto modified = std::filesystem::last_write_time(sourcePath, ec);
+        if (ec) return false;
+        info.modifiedTime = static_cast<int64_t>(modified.time_since_epoch().count());
+        return true;
+    }
+
+    bool MeshCache::HashSourceContent(const std::string& sourcePath, uint64_t& hash) {
+        MappedFile source;
+        if (!source.Open(sourcePath)) return false;
+        hash = HashBytes(source.Data(), source.Size());
+        return true;
+    }
+
+    bool MeshCache::Store(const std::string& sourcePath, const MeshCacheKey& key, const MeshData& meshData) const {
+        SourceInfo source;
+        if (!QuerySource(sourcePath, source)) {
+            std::cerr << "MeshCache: source not found: " << sourcePath << std::endl;
+            return false;
+        }
+
+        MeshCacheHeader header = {};
+        std::memcpy(header.magic, CacheMagic, sizeof(CacheMagic));
+        header.version = Version;
+        header.importFlags = key.importFlags;
+        header.processFlags = key.processFlags;
+        header.processSettingsHash = key.processSettingsHash;
+        header.sourcePathHash = HashString(source.canonicalPath);
+        header.sourceSize = source.size;
+        header.sourceModifiedTime = source.modifiedTime;
+        if (!HashSourceContent(sourcePath, header.sourceContentHash)) {
+            std::cerr << "MeshCache: failed to hash source: " << sourcePath << std::endl;
+            return false;
+        }
+        header.subMeshStride = sizeof(MeshData::SubMesh);
+        header.materialStride = sizeof(MeshData::Material);
+        header.nodeStride = sizeof(MeshData::Node);
+
+        header.vertexCount = meshData.vertices.size();
+        header.normalCount = meshData.normals.size();
+        header.texCoordCount = meshData.texCoords.size();
+        header.indexCount = meshData.indices.size();
+        header.index16Count = meshData.indices16.size();
+        header.materialCount = meshData.materials.size();
+        header.subMeshCount = meshData.subMeshes.size();
+        header.nodeCount = meshData.nodes.size();
+
+        // Section layout
+        uint64_t offset = AlignUp(sizeof(MeshCacheHeader), SectionAlignment);
+        auto placeSection = [&](uint64_t& sectionOffset, uint64_t bytes) {
+            sectionOffset = offset;
+            offset = AlignUp(offset + bytes, SectionAlignment);
+        };
+        placeSection(header.verticesOffset, header.vertexCount * sizeof(glm::vec3));
+        placeSection(header.normalsOffset, header.normalCount * sizeof(glm::vec3));
+        placeSection(header.texCoordsOffset, header.texCoordCount * sizeof(glm::vec2));
+        placeSection(header.indicesOffset, header.indexCount * sizeof(uint32_t));
+        placeSection(header.indices16Offset, header.index16Count * sizeof(uint16_t));
+        placeSection(header.materialsOffset, header.materialCount * sizeof(MeshData::Material));
+        placeSection(header.subMeshesOffset, header.subMeshCount * sizeof(MeshData::SubMesh));
+        placeSection(header.nodesOffset, header.nodeCount * sizeof(MeshData::Node));
+        header.fileSize = offset;
+
+        std::error_code ec;
+        std::filesystem::create_directories(directory, ec);
+
+        // Write to a temporary file and rename so readers never map a partial cache
+        std::string cachePath = GetCachePath(sourcePath, key);
+        std::string tempPath = cachePath + MakeTempSuffix();
+        {
+            std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+            if (!file) {
+                std::cerr << "MeshCache: cannot write " << tempPath << std::endl;
+                return false;
+            }
+
+            uint64_t written = 0;
+            auto writeSection = [&](uint64_t sectionOffset, const void* data, uint64_t bytes) {
+                static const char zeros[SectionAlignment] = {};
+                while (written < sectionOffset) {
+                    uint64_t padding = std::min<uint64_t>(sectionOffset - written, SectionAlignment);
+                    file.write(zeros, static_cast<std::streamsize>(padding));
+                    written += padding;
+                }
+                if (bytes > 0) {
+                    file.write(static_cast<const char*>(data), static_cast<std::streamsize>(bytes));
+                    written += bytes;
+                }
+            };
+            writeSection(0, &header, sizeof(header));
+            writeSection(header.verticesOffset, meshData.vertices.data(), header.vertexCount * sizeof(glm::vec3));
+            writeSection(header.normalsOffset, meshData.normals.data(), header.normalCount * sizeof(glm::vec3));
+            writeSection(header.texCoordsOffset, meshData.texCoords.data(), header.texCoordCount * sizeof(glm::vec2));
+            writeSection(header.indicesOffset, meshData.indices.data(), header.indexCount * sizeof(uint32_t));
+            writeSection(header.indices16Offset, meshData.indices16.data(), header.index16Count * sizeof(uint16_t));
+            writeSection(header.materialsOffset, meshData.materials.data(), header.materialCount * sizeof(MeshData::Material));
+            writeSection(header.subMeshesOffset, meshData.subMeshes.data(), header.subMeshCount * sizeof(MeshData::SubMesh));
+            writeSection(header.nodesOffset, meshData.nodes.data(), header.nodeCount * sizeof(MeshData::Node));
+            writeSection(header.fileSize, nullptr, 0);
+
+            if (!file) {
+                std::cerr << "MeshCache: write failed for " << tempPath << std::endl;
+                file.close();
+                std::filesystem::remove(tempPath, ec);
+                return false;
+            }
+        }
+
+        std::filesystem::rename(tempPath, cachePath, ec);
+        if (ec) {
+            std::cerr << "MeshCache: failed to move cache into place: " << ec.message() << std::endl;
+            std::filesystem::remove(tempPath, ec);
+            return false;
+        }
+        return true;
+    }
+
+    MeshCacheStatus MeshCache::CheckHeader(const MappedFile& file, const SourceInfo& source, const MeshCacheKey& key) {
+        if (file.Size() < sizeof(MeshCacheHeader)) return MeshCacheStatus::Corrupt;
+
+        MeshCacheHeader header;
+        std::memcpy(&header, file.Data(), sizeof(header));
+        if (std::memcmp(header.magic, CacheMagic, sizeof(CacheMagic)) != 0) return MeshCacheStatus::Corrupt;
+        if (header.version != Version ||
+            header.subMeshStride != sizeof(MeshData::SubMesh) ||
+            header.materialStride != sizeof(MeshData::Material) ||
+            header.nodeStride != sizeof(MeshData::Node)) {
+            return MeshCacheStatus::VersionMismatch;
+        }
+        if (header.fileSize != file.Size()) return MeshCacheStatus::Corrupt;
+        if (header.importFlags != key.importFlags || header.processFlags != key.processFlags ||
+            header.processSettingsHash != key.processSettingsHash ||
+            header.sourcePathHash != HashString(source.canonicalPath)) {
+            return MeshCacheStatus::KeyMismatch;
+        }
+        if (header.sourceSize != source.size || header.sourceModifiedTime != source.modifiedTime) {
+            return MeshCacheStatus::SourceChanged;
+        }
+        return MeshCacheStatus::Valid;
+    }
+
+    bool MeshCache::BuildView(const MappedFile& file, MeshDataView& view) {
+        const MeshCacheHeader& header = *reinterpret_cast<const MeshCacheHeader*>(file.Data());
+
+        if (!SectionInRange<glm::vec3>(file, header.verticesOffset, header.vertexCount) ||
+            !SectionInRange<glm::vec3>(file, header.normalsOffset, header.normalCount) ||
+            !SectionInRange<glm::vec2>(file, header.texCoordsOffset, header.texCoordCount) ||
+            !SectionInRange<uint32_t>(file, header.indicesOffset, header.indexCount) ||
+            !SectionInRange<uint16_t>(file, header.indices16Offset, header.index16Count) ||
+            !SectionInRange<MeshData::Material>(file, header.materialsOffset, header.materialCount) ||
+            !SectionInRange<MeshData::SubMesh>(file, header.subMeshesOffset, header.subMeshCount) ||
+            !SectionInRange<MeshData::Node>(file, header.nodesOffset, header.nodeCount)) {
+            return false;
+        }
+
+        view.vertices = SectionSpan<glm::vec3>(file, header.verticesOffset, header.vertexCount);
+        view.normals = SectionSpan<glm::vec3>(file, header.normalsOffset, header.normalCount);
+        view.texCoords = SectionSpan<glm::vec2>(file, header.texCoordsOffset, header.texCoordCount);
+        view.indices = SectionSpan<uint32_t>(file, header.indicesOffset, header.indexCount);
+        view.indices16 = SectionSpan<uint16_t>(file, header.indices16Offset, header.index16Count);
+        view.materials = SectionSpan<MeshData::Material>(file, header.materialsOffset, header.materialCount);
+        view.subMeshes = SectionSpan<MeshData::SubMesh>(file, header.subMeshesOffset, header.subMeshCount);
+        view.nodes = SectionSpan<MeshData::Node>(file, header.nodesOffset, header.nodeCount);
+        return RangesInBounds(view);
+    }
+
+    std::unique_ptr<MappedMesh> MeshCache::Map(const std::string& sourcePath, const MeshCacheKey& key,
+        Validation validation, MeshCacheStatus* status) const {
+        auto setStatus = [&](MeshCacheStatus value) {
+            if (status) *status = value;
+        };
+
+        SourceInfo source;
+        if (!QuerySource(sourcePath, source)) {
+            setStatus(MeshCacheStatus::SourceMissing);
+            return nullptr;
+        }
+
+        auto mapped = std::make_unique<MappedMesh>();
+        if (!mapped->file.Open(GetCachePath(sourcePath, key))) {
+            setStatus(MeshCacheStatus::Missing);
+            return nullptr;
+        }
+
+        MeshCacheStatus headerStatus = CheckHeader(mapped->file, source, key);
+        if (headerStatus != MeshCacheStatus::Valid) {
+            setStatus(headerStatus);
+            return nullptr;
+        }
+
+        if (validation == Validation::ContentHash) {
+            uint64_t contentHash = 0;
+            if (!HashSourceContent(sourcePath, contentHash) || contentHash != mapped->GetHeader().sourceContentHash) {
+                setStatus(MeshCacheStatus::SourceChanged);
+                return nullptr;
+            }
+        }
+
+        if (!BuildView(mapped->file, mapped->view)) {
+            setStatus(MeshCacheStatus::Corrupt);
+            return nullptr;
+        }
+
+        setStatus(MeshCacheStatus::Valid);
+        return mapped;
+    }
+
+    bool MeshCache::Load(const std::string& sourcePath, const MeshCacheKey& key, MeshData& meshData,
+        Validation validation) const {
+        std::unique_ptr<MappedMesh> mapped = Map(sourcePath, key, validation);
+        if (!mapped) return false;
+
+        meshData.Assign(mapped->GetView());
+        MeshBounds::UpdateSceneBounds(meshData);
+        return true;
+    }
+
+    MeshCacheStatus MeshCache::Validate(const std::string& sourcePath, const MeshCacheKey& key, Validation validation) const {
+        MeshCacheStatus status = MeshCacheStatus::Missing;
+        Map(sourcePath, key, validation, &status);
+        return status;
+    }
+
+    bool MeshCache::Invalidate(const std::string& sourcePath, const MeshCacheKey& key) const {
+        std::error_code ec;
+        return std::filesystem::remove(GetCachePath(sourcePath, key), ec);
+    }
+}
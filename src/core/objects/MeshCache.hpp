@@ -0,0 +1,134 @@
+#pragma once
+
+#include "MeshData.hpp"
+#include "MappedFile.hpp"
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace Anito3D {
+
+    // On-disk header of a cached MeshData. Sections follow the header, each aligned to
+    // MeshCache::SectionAlignment, and are stored in host layout (little-endian).
+    struct MeshCacheHeader {
+        char magic[8];               // "A3DMESH\0"
+        uint32_t version;
+        uint32_t importFlags;        // Assimp post-process flags used to build the cache
+        uint32_t processFlags;       // MeshProcess flags applied after import
+        uint64_t processSettingsHash; // MeshProcessOptions::GetSettingsHash()
+        uint64_t sourcePathHash;
+        uint64_t sourceSize;
+        int64_t sourceModifiedTime;  // filesystem::file_time_type ticks
+        uint64_t sourceContentHash;
+        uint32_t subMeshStride;      // sizeof(MeshData::SubMesh) when written
+        uint32_t materialStride;     // sizeof(MeshData::Material) when written
+        uint32_t nodeStride;         // sizeof(MeshData::Node) when written
+        uint32_t reserved;
+        uint64_t fileSize;
+
+        uint64_t vertexCount;
+        uint64_t normalCount;
+        uint64_t texCoordCount;
+        uint64_t indexCount;
+        uint64_t index16Count;
+        uint64_t materialCount;
+        uint64_t subMeshCount;
+        uint64_t nodeCount;
+
+        uint64_t verticesOffset;
+        uint64_t normalsOffset;
+        uint64_t texCoordsOffset;
+        uint64_t indicesOffset;
+        uint64_t indices16Offset;
+        uint64_t materialsOffset;
+        uint64_t subMeshesOffset;
+        uint64_t nodesOffset;
+    };
+
+    enum class MeshCacheStatus {
+        Valid,
+        Missing,
+        Corrupt,         // Bad magic, truncated file, section or submesh/node range out of range
+        VersionMismatch, // Written by a different cache format version/layout
+        KeyMismatch,     // Different source path, import or process flags
+        SourceChanged,   // Source size/mtime (or content hash) differs
+        SourceMissing
+    };
+
+    const char* ToString(MeshCacheStatus status);
+
+    // What a cache entry was built with besides the source file itself
+    struct MeshCacheKey {
+        unsigned int importFlags = 0;     // Assimp post-process flags
+        uint32_t processFlags = 0;        // MeshProcess flags (post-import processing passes)
+        uint64_t processSettingsHash = 0; // Pass settings such as weld epsilons
+
+        MeshCacheKey(unsigned int importFlags, uint32_t processFlags = 0, uint64_t processSettingsHash = 0)
+            : importFlags(importFlags), processFlags(processFlags), processSettingsHash(processSettingsHash) {}
+    };
+
+    // Cache file mapped into memory; the view points straight into the mapping
+    class MappedMesh {
+    public:
+        const MeshDataView& GetView() const { return view; }
+        const MeshCacheHeader& GetHeader() const { return *reinterpret_cast<const MeshCacheHeader*>(file.Data()); }
+
+    private:
+        friend class MeshCache;
+        MappedFile file;
+        MeshDataView view;
+    };
+
+    // Versioned binary cache for imported meshes, keyed by source path, source
+    // size/mtime/content hash and import/process flags. Lets warm starts skip Assimp entirely.
+    class MeshCache {
+    public:
+        static constexpr uint32_t Version = 5;
+        static constexpr uint64_t SectionAlignment = 64;
+
+        enum class Validation {
+            Timestamp,  // Compare source size + mtime (cheap)
+            ContentHash // Additionally re-hash the source file
+        };
+
+        explicit MeshCache(const std::string& cacheDirectory);
+
+        // Cache in the build tree (ANITO3DSANDBOX_CACHE_PATH)
+        static MeshCache& Default();
+
+        const std::string& GetDirectory() const { return directory; }
+        std::string GetCachePath(const std::string& sourcePath, const MeshCacheKey& key) const;
+
+        bool Store(const std::string& sourcePath, const MeshCacheKey& key, const MeshData& meshData) const;
+
+        // Map a valid cache file (nullptr on miss); status receives the reason for a miss
+        std::unique_ptr<MappedMesh> Map(const std::string& sourcePath, const MeshCacheKey& key,
+            Validation validation = Validation::Timestamp, MeshCacheStatus* status = nullptr) const;
+
+        // Map, then copy every section into an owned MeshData (one bulk copy per array, no
+        // per-vertex work). MeshEntity keeps hits mapped instead (see MeshEntity::GetMeshView).
+        bool Load(const std::string& sourcePath, const MeshCacheKey& key, MeshData& meshData,
+            Validation validation = Validation::Timestamp) const;
+
+        MeshCacheStatus Validate(const std::string& sourcePath, const MeshCacheKey& key,
+            Validation validation = Validation::Timestamp) const;
+
+        // Remove the cache file for a source (returns true if a file was removed)
+        bool Invalidate(const std::string& sourcePath, const MeshCacheKey& key) const;
+
+    private:
+        std::string directory;
+
+        struct SourceInfo {
+            std::string canonicalPath;
+            uint64_t size = 0;
+            int64_t modifiedTime = 0;
+        };
+
+        static bool QuerySource(const std::string& sourcePath, SourceInfo& info);
+        static bool HashSourceContent(const std::string& sourcePath, uint64_t& hash);
+        static MeshCacheStatus CheckHeader(const MappedFile& file, const SourceInfo& source, const MeshCacheKey& key);
+        static bool BuildView(const MappedFile& file, MeshDataView& view);
+    };
+
+}
@@ -1 +1,89 @@
-#include "MeshData.hpp"
\ No newline at end of file
+#include "MeshData.hpp"
+#include <algorithm>
+
+namespace Anito3D {
+
+    namespace {
+        bool RangeLess(const MeshData::SubMesh& a, const MeshData::SubMesh& b) {
+            if (a.indexType != b.indexType) return a.indexType < b.indexType;
+            return a.firstIndex != b.firstIndex ? a.firstIndex < b.firstIndex : a.vertexOffset < b.vertexOffset;
+        }
+
+        // Indices are never range-checked against vertexCount, so a stray one may not fit
+        bool FitsUint16(const std::vector<uint32_t>& indices, const MeshData::SubMesh& range) {
+            return std::all_of(indices.begin() + range.firstIndex, indices.begin() + range.firstIndex + range.indexCount,
+                [](uint32_t index) { return index < 65536; });
+        }
+
+        bool SameRange(const MeshData::SubMesh& a, const MeshData::SubMesh& b) {
+            return a.indexType == b.indexType && a.firstIndex == b.firstIndex && a.vertexOffset == b.vertexOffset;
+        }
+    }
+
+    std::vector<MeshData::SubMesh> MeshData::GetUniqueRanges() const {
+        std::vector<SubMesh> ranges;
+        ranges.reserve(subMeshes.size());
+        for (const auto& subMesh : subMeshes) {
+            size_t indexArraySize = subMesh.indexType == IndexType::Uint16 ? indices16.size() : indices.size();
+            if (subMesh.indexCount == 0) continue;
+            if (static_cast<size_t>(subMesh.firstIndex) + subMesh.indexCount > indexArraySize ||
+                static_cast<size_t>(subMesh.vertexOffset) + subMesh.vertexCount > vertices.size()) {
+                continue;
+            }
+            ranges.push_back(subMesh);
+        }
+
+        std::sort(ranges.begin(), ranges.end(), RangeLess);
+        ranges.erase(std::unique(ranges.begin(), ranges.end(), SameRange), ranges.end());
+        return ranges;
+    }
+
+    size_t MeshData::FindRange(const std::vector<SubMesh>& ranges, const SubMesh& subMesh) {
+        auto found = std::lower_bound(ranges.begin(), ranges.end(), subMesh, RangeLess);
+        if (found == ranges.end() || !SameRange(*found, subMesh)) return ranges.size();
+        return static_cast<size_t>(found - ranges.begin());
+    }
+
+    void MeshData::NarrowIndices() {
+        std::vector<SubMesh> ranges = GetUniqueRanges();
+
+        std::vector<uint32_t> wide;
+        std::vector<uint16_t> narrow;
+        wide.reserve(indices.size());
+        narrow.reserve(indices16.size() + indices.size());
+
+        // New location of every range; all submeshes referencing it are patched afterwards
+        std::vector<SubMesh> relocated = ranges;
+        for (size_t r = 0; r < ranges.size(); ++r) {
+            const SubMesh& range = ranges[r];
+            if (range.indexType == IndexType::Uint16 || (range.vertexCount < 65536 && FitsUint16(indices, range))) {
+                relocated[r].indexType = IndexType::Uint16;
+                relocated[r].firstIndex = static_cast<uint32_t>(narrow.size());
+                for (uint32_t i = 0; i < range.indexCount; ++i) {
+                    narrow.push_back(static_cast<uint16_t>(GetIndex(range, i)));
+                }
+            }
+            else {
+                relocated[r].firstIndex = static_cast<uint32_t>(wide.size());
+                wide.insert(wide.end(), indices.begin() + range.firstIndex, indices.begin() + range.firstIndex + range.indexCount);
+            }
+        }
+
+        for (auto& subMesh : subMeshes) {
+            size_t found = FindRange(ranges, subMesh);
+            if (found == ranges.size()) {
+                // Out-of-bounds ranges were not copied; drop them rather than point into the new arrays
+                subMesh.indexCount = 0;
+                continue;
+            }
+            const SubMesh& target = relocated[found];
+            subMesh.indexType = target.indexType;
+            subMesh.firstIndex = target.firstIndex;
+        }
+
+        wide.shrink_to_fit();
+        narrow.shrink_to_fit();
+        indices = std::move(wide);
+        indices16 = std::move(narrow);
+    }
+}
@@ -1,20 +1,67 @@
 #pragma once
 #include <vector>
+#include <span>
+#include <cstdint>
 #include <glm/glm.hpp>
 
 namespace Anito3D {
+    struct MeshDataView;
+
     struct MeshData {
+        // All meshes of a file share these arrays (one allocation per attribute).
+        // normals/texCoords are either empty or the same size as vertices.
         std::vector<glm::vec3> vertices;  // Vertex positions
         std::vector<glm::vec3> normals;   // Vertex normals
         std::vector<glm::vec2> texCoords; // Texture coordinates
-        std::vector<uint32_t> indices;     // Triangle indices
+        std::vector<uint32_t> indices;     // Triangle indices, relative to the owning submesh's vertexOffset
+        std::vector<uint16_t> indices16;   // Same for submeshes narrowed to 16-bit indices
 
         // Add material properties for PBR (simplified)
         struct Material {
             glm::vec3 albedo{ 1.0f };    // Base color
             float metallic{ 0.0f };      // Metallic factor
             float roughness{ 0.5f };     // Roughness factor
-        } material;
+        };
+        std::vector<Material> materials;
+
+        // Axis-aligned box plus a sphere around the box center enclosing every vertex
+        struct Bounds {
+            glm::vec3 min{ 0.0f };
+            glm::vec3 max{ 0.0f };
+            glm::vec3 center{ 0.0f };
+            float radius{ 0.0f };
+        };
+
+        enum class IndexType : uint32_t {
+            Uint32, // Range lives in indices
+            Uint16  // Range lives in indices16 (fewer than 65536 vertices)
+        };
+
+        // Range table entry, one per (node, mesh) reference in the source scene.
+        // Instanced meshes share the same vertex/index range with different transforms.
+        struct SubMesh {
+            uint32_t firstIndex{ 0 };   // First entry in indices or indices16
+            uint32_t indexCount{ 0 };   // Number of indices (multiple of 3)
+            uint32_t vertexOffset{ 0 }; // Added to each index to address vertices
+            uint32_t vertexCount{ 0 };  // Number of vertices in the range
+            uint32_t materialId{ 0 };   // Index into materials
+            IndexType indexType{ IndexType::Uint32 };
+            uint32_t node{ 0 };          // Index into nodes (owner of the transform)
+            Bounds bounds;               // Of the vertex range, before transform
+            glm::mat4 transform{ 1.0f }; // Node to scene transform
+        };
+        std::vector<SubMesh> subMeshes;
+
+        // Source scene hierarchy (aiNode tree) in pre-order, so parents precede children.
+        // Empty for generated meshes; SubMesh::transform is the accumulated node transform.
+        static constexpr uint32_t NoParent = 0xFFFFFFFFu;
+        struct Node {
+            glm::mat4 localTransform{ 1.0f }; // Relative to the parent node
+            uint32_t parent{ NoParent };
+        };
+        std::vector<Node> nodes;
+
+        Bounds bounds; // Every submesh under its transform (see MeshBounds)
 
         MeshData() = default;
         void Clear() {
@@ -22,6 +69,74 @@ namespace Anito3D {
             normals.clear();
             texCoords.clear();
             indices.clear();
+            indices16.clear();
+            materials.clear();
+            subMeshes.clear();
+            nodes.clear();
+            bounds = {};
+        }
+
+        size_t GetVertexCount() const { return vertices.size(); }
+        size_t GetIndexCount() const { return indices.size() + indices16.size(); }
+        size_t GetTriangleCount() const { return GetIndexCount() / 3; }
+        size_t GetVertexMemory() const {
+            return vertices.size() * sizeof(glm::vec3) + normals.size() * sizeof(glm::vec3) + texCoords.size() * sizeof(glm::vec2);
+        }
+        size_t GetIndexMemory() const { return indices.size() * sizeof(uint32_t) + indices16.size() * sizeof(uint16_t); }
+
+        // Index i of a submesh range, whichever array it lives in
+        uint32_t GetIndex(const SubMesh& subMesh, size_t i) const {
+            return subMesh.indexType == IndexType::Uint16 ? indices16[subMesh.firstIndex + i] : indices[subMesh.firstIndex + i];
+        }
+
+        // Distinct vertex/index ranges in index order (instanced submeshes share one)
+        std::vector<SubMesh> GetUniqueRanges() const;
+        // Position of the range a submesh references in GetUniqueRanges() (ranges.size() if none)
+        static size_t FindRange(const std::vector<SubMesh>& ranges, const SubMesh& subMesh);
+
+        // Move every range with fewer than 65536 vertices (and no index above 65535) into
+        // indices16, compacting both arrays. Submeshes with out-of-bounds ranges get indexCount 0.
+        void NarrowIndices();
+
+        // Non-owning view of the arrays
+        MeshDataView GetView() const;
+        // Replace contents with a bulk copy of the view (e.g. from a mapped cache file)
+        void Assign(const MeshDataView& view);
+
+        // Material for a submesh (default material if the table is empty)
+        const Material& GetMaterial(uint32_t materialId) const {
+            static const Material defaultMaterial;
+            return materialId < materials.size() ? materials[materialId] : defaultMaterial;
         }
     };
-}
\ No newline at end of file
+
+    // Read-only spans over mesh arrays, either owned by a MeshData or pointing straight
+    // into a memory-mapped cache file (MeshCache::Map)
+    struct MeshDataView {
+        std::span<const glm::vec3> vertices;
+        std::span<const glm::vec3> normals;
+        std::span<const glm::vec2> texCoords;
+        std::span<const uint32_t> indices;
+        std::span<const uint16_t> indices16;
+        std::span<const MeshData::Material> materials;
+        std::span<const MeshData::SubMesh> subMeshes;
+        std::span<const MeshData::Node> nodes;
+
+        size_t GetIndexCount() const { return indices.size() + indices16.size(); }
+    };
+
+    inline MeshDataView MeshData::GetView() const {
+        return { vertices, normals, texCoords, indices, indices16, materials, subMeshes, nodes };
+    }
+
+    inline void MeshData::Assign(const MeshDataView& view) {
+        vertices.assign(view.vertices.begin(), view.vertices.end());
+        normals.assign(view.normals.begin(), view.normals.end());
+        texCoords.assign(view.texCoords.begin(), view.texCoords.end());
+        indices.assign(view.indices.begin(), view.indices.end());
+        indices16.assign(view.indices16.begin(), view.indices16.end());
+        materials.assign(view.materials.begin(), view.materials.end());
+        subMeshes.assign(view.subMeshes.begin(), view.subMeshes.end());
+        nodes.assign(view.nodes.begin(), view.nodes.end());
+    }
+}
@@ -1,58 +1,112 @@
 #include "MeshEntity.hpp"
-#include <iostream>
+#include "MeshBounds.hpp"
+#include "Trace.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
 
 namespace Anito3D {
-    bool MeshEntity::LoadMesh(const std::string& filePath) {
-        Assimp::Importer importer;
-        const aiScene* scene = importer.ReadFile(filePath,
-            aiProcess_Triangulate | aiProcess_FlipUVs | aiProcess_CalcTangentSpace);
+    const char* ToString(MeshStorage storage) {
+        switch (storage) {
+        case MeshStorage::Imported: return "imported";
+        case MeshStorage::CacheMapped: return "cacheMapped";
+        case MeshStorage::CacheCopied: return "cacheCopied";
+        }
+        return "unknown";
+    }
 
-        if (!scene || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !scene->mRootNode) {
-            std::cerr << "Assimp error: " << importer.GetErrorString() << std::endl;
-            return false;
+    MeshEntity::~MeshEntity() {
+        if (GetSceneGraph()) GetSceneGraph()->DestroyNodes(meshNodes);
+    }
+
+    bool MeshEntity::LoadMesh(const std::string& filePath, const MeshLoadOptions& options) {
+        ANITO3D_TRACE_ZONE("MeshEntity::LoadMesh");
+        lods.clear();
+        meshData.Clear();
+        mapped.reset();
+        storage = MeshStorage::Imported;
+        copied = false;
+        const MeshCacheKey cacheKey(options.importFlags, options.process.flags, options.process.GetSettingsHash());
+
+        if (options.cache) {
+            mapped = options.cache->Map(filePath, cacheKey);
+        }
+        if (mapped) {
+            storage = MeshStorage::CacheMapped;
+            bounds = MeshBounds::ComputeSceneBounds(mapped->GetView().subMeshes);
+            if (options.copyFromCache) GetMeshData();
+            if (options.lods) GenerateLods(*options.lods, options.threadPool);
+            return true;
         }
 
-        // Process the first mesh (extend for multiple meshes if needed)
-        if (scene->mNumMeshes > 0) {
-            ProcessMesh(scene->mMeshes[0], scene);
+        if (!SceneImporter::Import(filePath, meshData, options.importFlags, options.threadPool)) {
+            return false;
         }
+        MeshProcessor::Run(meshData, options.process, options.threadPool);
+        bounds = meshData.bounds;
 
+        if (options.cache) {
+            options.cache->Store(filePath, cacheKey, meshData);
+        }
+        if (options.lods) GenerateLods(*options.lods, options.threadPool);
         return true;
     }
 
-    void MeshEntity::ProcessMesh(aiMesh* mesh, const aiScene* scene) {
-        meshData.Clear();
+    MeshDataView MeshEntity::GetMeshView() const {
+        return mapped ? mapped->GetView() : meshData.GetView();
+    }
 
-        // Load vertices, normals, and texture coordinates
-        for (unsigned int i = 0; i < mesh->mNumVertices; ++i) {
-            meshData.vertices.emplace_back(
-                mesh->mVertices[i].x, mesh->mVertices[i].y, mesh->mVertices[i].z);
-            if (mesh->mNormals) {
-                meshData.normals.emplace_back(
-                    mesh->mNormals[i].x, mesh->mNormals[i].y, mesh->mNormals[i].z);
-            }
-            if (mesh->mTextureCoords[0]) {
-                meshData.texCoords.emplace_back(
-                    mesh->mTextureCoords[0][i].x, mesh->mTextureCoords[0][i].y);
-            }
+    const MeshData& MeshEntity::GetMeshData() const {
+        if (!mapped || copied.load()) return meshData;
+        std::lock_guard<std::mutex> lock(copyMutex);
+        if (!copied.load()) {
+            ANITO3D_TRACE_ZONE("MeshEntity::CopyFromCache");
+            meshData.Assign(mapped->GetView());
+            meshData.bounds = bounds;
+            copied = true;
         }
+        return meshData;
+    }
 
-        // Load indices
-        for (unsigned int i = 0; i < mesh->mNumFaces; ++i) {
-            aiFace face = mesh->mFaces[i];
-            for (unsigned int j = 0; j < face.mNumIndices; ++j) {
-                meshData.indices.push_back(face.mIndices[j]);
-            }
-        }
+    void MeshEntity::GenerateLods(const LodChainOptions& options, ThreadPool* threadPool) {
+        ANITO3D_TRACE_ZONE("MeshEntity::GenerateLods");
+        lods = MeshSimplifier::BuildLodChain(GetMeshData(), options, threadPool);
+    }
+
+    const MeshData& MeshEntity::GetLodMeshData(size_t level) const {
+        if (level == 0 || lods.empty()) return GetMeshData();
+        return lods[std::min(level, lods.size()) - 1].meshData;
+    }
+
+    float MeshEntity::GetLodError(size_t level) const {
+        if (level == 0 || lods.empty()) return 0.0f;
+        return lods[std::min(level, lods.size()) - 1].error;
+    }
 
-        // Load basic PBR material properties (simplified)
-        if (mesh->mMaterialIndex >= 0) {
-            aiMaterial* material = scene->mMaterials[mesh->mMaterialIndex];
-            aiColor3D color;
-            if (material->Get(AI_MATKEY_COLOR_DIFFUSE, color) == AI_SUCCESS) {
-                meshData.material.albedo = glm::vec3(color.r, color.g, color.b);
-            }
-            // Add metallic/roughness loading if needed
+    size_t MeshEntity::SelectLod(float distance, float viewportHeight, float verticalFov, float maxPixelError) const {
+        const float entityScale = std::max({ std::fabs(scale.x), std::fabs(scale.y), std::fabs(scale.z) });
+        size_t selected = 0;
+        for (size_t level = 1; level < GetLodCount(); ++level) {
+            if (ProjectError(GetLodError(level) * entityScale, distance, viewportHeight, verticalFov) > maxPixelError) break;
+            selected = level;
         }
+        return selected;
+    }
+
+    float MeshEntity::ProjectError(float error, float distance, float viewportHeight, float verticalFov) {
+        if (distance <= 0.0f) return std::numeric_limits<float>::infinity();
+        return error * viewportHeight / (2.0f * distance * std::tan(verticalFov * 0.5f));
+    }
+
+    void MeshEntity::AttachScene(SceneGraph& graph, Entity* parent) {
+        if (GetSceneGraph()) GetSceneGraph()->DestroyNodes(meshNodes);
+        Entity::AttachScene(graph, parent);
+        meshNodes = graph.AddHierarchy(GetMeshView().nodes, GetSceneNode());
+    }
+
+    glm::mat4 MeshEntity::GetSubMeshWorldMatrix(size_t subMesh) const {
+        const MeshData::SubMesh& entry = GetMeshView().subMeshes[subMesh];
+        if (GetSceneGraph() && entry.node < meshNodes.size()) return GetSceneGraph()->GetWorldTransform(meshNodes[entry.node]);
+        return GetWorldMatrix() * entry.transform;
     }
-}
\ No newline at end of file
+}
@@ -2,24 +2,87 @@
 
 #include "Entity.hpp"
 #include "MeshData.hpp"
+#include "MeshCache.hpp"
+#include "MeshProcessing.hpp"
+#include "MeshSimplifier.hpp"
+#include "SceneImporter.hpp"
+#include <atomic>
+#include <memory>
+#include <mutex>
 #include <string>
-#include <assimp/Importer.hpp>
-#include <assimp/scene.h>
-#include <assimp/postprocess.h>
+#include <vector>
 
 namespace Anito3D {
+    class ThreadPool;
+
+    struct MeshLoadOptions {
+        unsigned int importFlags = SceneImporter::DefaultImportFlags;
+        const MeshCache* cache = &MeshCache::Default(); // nullptr disables the binary cache
+        ThreadPool* threadPool = nullptr;               // Convert the meshes of a file in parallel
+        MeshProcessOptions process;                     // Passes run after import (narrow indices by default)
+        const LodChainOptions* lods = nullptr;          // Build an LOD chain after loading (not cached)
+        bool copyFromCache = false;                     // Copy a cache hit into the owned MeshData right away
+    };
+
+    // Where a loaded entity's mesh arrays live
+    enum class MeshStorage {
+        Imported,    // Owned MeshData filled by Assimp
+        CacheMapped, // Spans into the mapped cache file, nothing copied
+        CacheCopied  // Owned MeshData bulk-copied out of the cache file
+    };
+
+    const char* ToString(MeshStorage storage);
+
     class MeshEntity : public Entity {
     public:
         MeshEntity() = default;
-        ~MeshEntity() override = default;
+        ~MeshEntity() override;
 
-        bool LoadMesh(const std::string& filePath);
+        // Load every mesh of the file (full node hierarchy) into one flattened MeshData.
+        // A valid cache entry skips Assimp and stays mapped: GetMeshView() reads the file in
+        // place. A miss imports, runs the requested processing passes and refreshes the cache.
+        bool LoadMesh(const std::string& filePath, const MeshLoadOptions& options = {});
 
-        const MeshData& GetMeshData() const { return meshData; }
+        // Read-only arrays, straight from the mapping on a cache hit
+        MeshDataView GetMeshView() const;
+        const MeshData::Bounds& GetBounds() const { return bounds; }
 
-    private:
-        MeshData meshData;
+        // Owned copy for code that needs a MeshData. On a mapped cache hit the first call
+        // copies every section out of the mapping (once, thread-safe).
+        const MeshData& GetMeshData() const;
+
+        bool WasLoadedFromCache() const { return storage != MeshStorage::Imported; }
+        MeshStorage GetStorage() const { return copied.load() ? MeshStorage::CacheCopied : storage; }
 
-        void ProcessMesh(aiMesh* mesh, const aiScene* scene);
+        // Replace the LOD chain with simplified levels of the loaded mesh
+        void GenerateLods(const LodChainOptions& options = {}, ThreadPool* threadPool = nullptr);
+
+        // Level 0 is the full mesh, higher levels are coarser
+        size_t GetLodCount() const { return 1 + lods.size(); }
+        const MeshData& GetLodMeshData(size_t level) const;
+        float GetLodError(size_t level) const; // Object-space error bound, 0 for level 0
+
+        // Coarsest level whose error, scaled by the entity scale and projected at distance,
+        // stays within maxPixelError on a viewport of viewportHeight pixels
+        size_t SelectLod(float distance, float viewportHeight, float verticalFov, float maxPixelError = 1.0f) const;
+
+        // Screen-space size in pixels of an object-space error seen at distance
+        static float ProjectError(float error, float distance, float viewportHeight, float verticalFov);
+
+        // Also instantiates the loaded node hierarchy below the entity's node (attach after LoadMesh)
+        void AttachScene(SceneGraph& graph, Entity* parent = nullptr) override;
+
+        // Submesh to world: entity transform times the (scene graph) node transform
+        glm::mat4 GetSubMeshWorldMatrix(size_t subMesh) const;
+
+    private:
+        mutable MeshData meshData;            // Empty while a mapped cache hit was not copied
+        std::unique_ptr<MappedMesh> mapped;   // Kept alive for GetMeshView()
+        MeshData::Bounds bounds;
+        MeshStorage storage = MeshStorage::Imported;
+        mutable std::atomic<bool> copied{ false };
+        mutable std::mutex copyMutex;
+        std::vector<SceneNodeId> meshNodes; // Scene graph id of each MeshData::nodes entry
+        std::vector<MeshLod> lods;
     };
-}
\ No newline at end of file
+}
@@ -0,0 +1,433 @@
+#include "MeshOptimizer.hpp"
+#include "ThreadPool.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+
+namespace Anito3D {
+
+    namespace {
+        constexpr uint32_t InvalidIndex = std::numeric_limits<uint32_t>::max();
+
+        // FIFO post-transform cache modelled with insertion timestamps: a vertex is cached
+        // while fewer than cacheSize vertices were inserted after it.
+        class FifoCache {
+        public:
+            FifoCache(size_t vertexCount, uint32_t cacheSize)
+                : insertedAt(vertexCount, 0), cacheSize(cacheSize), time(cacheSize + 1) {}
+
+            // Returns true on a miss (vertex gets transformed and inserted)
+            bool Access(uint32_t vertex) {
+                if (time - insertedAt[vertex] <= cacheSize) return false;
+                insertedAt[vertex] = time++;
+                return true;
+            }
+
+            uint32_t Misses(const uint32_t* triangle) {
+                return Access(triangle[0]) + Access(triangle[1]) + Access(triangle[2]);
+            }
+
+            void Flush() { time += cacheSize + 1; }
+
+            bool WasReferenced(uint32_t vertex) const { return insertedAt[vertex] != 0; }
+
+        private:
+            std::vector<uint32_t> insertedAt;
+            uint32_t cacheSize;
+            uint32_t time;
+        };
+
+        bool IndicesInRange(std::span<const uint32_t> indices, size_t vertexCount) {
+            return std::all_of(indices.begin(), indices.end(), [&](uint32_t index) { return index < vertexCount; });
+        }
+
+        // 32-bit indices of one range; 16-bit ranges are widened into a copy and written back on Commit
+        class RangeIndices {
+        public:
+            RangeIndices(MeshData& meshData, const MeshData::SubMesh& range) : meshData(meshData), range(range) {
+                if (range.indexType == MeshData::IndexType::Uint16) {
+                    widened.assign(meshData.indices16.begin() + range.firstIndex, meshData.indices16.begin() + range.firstIndex + range.indexCount);
+                }
+            }
+
+            std::span<uint32_t> Get() {
+                if (range.indexType == MeshData::IndexType::Uint16) return widened;
+                return { meshData.indices.data() + range.firstIndex, range.indexCount };
+            }
+
+            void Commit() {
+                if (range.indexType != MeshData::IndexType::Uint16) return;
+                std::transform(widened.begin(), widened.end(), meshData.indices16.begin() + range.firstIndex,
+                    [](uint32_t index) { return static_cast<uint16_t>(index); });
+            }
+
+        private:
+            MeshData& meshData;
+            const MeshData::SubMesh& range;
+            std::vector<uint32_t> widened;
+        };
+
+        std::vector<uint32_t> GetRangeIndices(const MeshData& meshData, const MeshData::SubMesh& range, uint32_t base = 0) {
+            std::vector<uint32_t> indices(range.indexCount);
+            for (uint32_t i = 0; i < range.indexCount; ++i) indices[i] = meshData.GetIndex(range, i) + base;
+            return indices;
+        }
+    }
+
+    void MeshOptimizer::Optimize(MeshData& meshData, uint32_t processFlags, ThreadPool* threadPool) {
+        if (!(processFlags & MeshProcess::Optimize)) return;
+
+        // Source meshes occupy disjoint ranges, so each one can be optimized independently
+        std::vector<MeshData::SubMesh> ranges = meshData.GetUniqueRanges();
+        auto optimizeRange = [&](size_t i) {
+            const MeshData::SubMesh& range = ranges[i];
+            std::span<const glm::vec3> positions(meshData.vertices.data() + range.vertexOffset, range.vertexCount);
+            {
+                RangeIndices rangeIndices(meshData, range);
+                std::span<uint32_t> indices = rangeIndices.Get();
+                if (!IndicesInRange(indices, range.vertexCount)) return;
+
+                if (processFlags & MeshProcess::OptimizeVertexCache) {
+                    OptimizeVertexCache(indices, range.vertexCount);
+                }
+                if (processFlags & MeshProcess::OptimizeOverdraw) {
+                    OptimizeOverdraw(indices, positions);
+                }
+                rangeIndices.Commit();
+            }
+            if (processFlags & MeshProcess::OptimizeVertexFetch) {
+                OptimizeVertexFetch(meshData, range);
+            }
+        };
+
+        if (threadPool) {
+            threadPool->ParallelFor(ranges.size(), optimizeRange);
+        }
+        else {
+            for (size_t i = 0; i < ranges.size(); ++i) optimizeRange(i);
+        }
+    }
+
+    void MeshOptimizer::OptimizeVertexCache(std::span<uint32_t> indices, size_t vertexCount, uint32_t cacheSize) {
+        const size_t triangleCount = indices.size() / 3;
+        if (triangleCount == 0 || !IndicesInRange(indices, vertexCount)) return;
+
+        // Vertex -> triangle adjacency
+        std::vector<uint32_t> liveTriangles(vertexCount, 0);
+        for (size_t i = 0; i < triangleCount * 3; ++i) ++liveTriangles[indices[i]];
+
+        std::vector<uint32_t> adjacencyOffsets(vertexCount + 1, 0);
+        for (size_t v = 0; v < vertexCount; ++v) {
+            adjacencyOffsets[v + 1] = adjacencyOffsets[v] + liveTriangles[v];
+        }
+        std::vector<uint32_t> adjacency(triangleCount * 3);
+        std::vector<uint32_t> fill(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+        for (size_t t = 0; t < triangleCount; ++t) {
+            for (size_t k = 0; k < 3; ++k) {
+                adjacency[fill[indices[t * 3 + k]]++] = static_cast<uint32_t>(t);
+            }
+        }
+
+        std::vector<uint32_t> cacheTime(vertexCount, 0);
+        std::vector<uint8_t> emitted(triangleCount, 0);
+        std::vector<uint32_t> deadEnd;
+        std::vector<uint32_t> candidates;
+        std::vector<uint32_t> output;
+        deadEnd.reserve(triangleCount * 3);
+        output.reserve(triangleCount * 3);
+
+        uint32_t time = cacheSize + 1;
+        size_t cursor = 0;
+        uint32_t fanning = indices[0];
+
+        while (fanning != InvalidIndex) {
+            // Emit every remaining triangle around the fanning vertex
+            candidates.clear();
+            for (uint32_t a = adjacencyOffsets[fanning]; a < adjacencyOffsets[fanning + 1]; ++a) {
+                uint32_t triangle = adjacency[a];
+                if (emitted[triangle]) continue;
+                emitted[triangle] = 1;
+
+                for (size_t k = 0; k < 3; ++k) {
+                    uint32_t vertex = indices[triangle * 3 + k];
+                    output.push_back(vertex);
+                    deadEnd.push_back(vertex);
+                    candidates.push_back(vertex);
+                    --liveTriangles[vertex];
+                    if (time - cacheTime[vertex] > cacheSize) {
+                        cacheTime[vertex] = time++;
+                    }
+                }
+            }
+
+            // Next fanning vertex: the oldest candidate that will still be cached after
+            // emitting its remaining triangles
+            uint32_t best = InvalidIndex;
+            int64_t bestPriority = -1;
+            for (uint32_t vertex : candidates) {
+                if (liveTriangles[vertex] == 0) continue;
+                int64_t priority = 0;
+                if (time - cacheTime[vertex] + 2 * liveTriangles[vertex] <= cacheSize) {
+                    priority = time - cacheTime[vertex];
+                }
+                if (priority > bestPriority) {
+                    bestPriority = priority;
+                    best = vertex;
+                }
+            }
+
+            // Dead end: most recently referenced vertex with live triangles, then a linear scan
+            while (best == InvalidIndex && !deadEnd.empty()) {
+                uint32_t vertex = deadEnd.back();
+                deadEnd.pop_back();
+                if (liveTriangles[vertex] > 0) best = vertex;
+            }
+            while (best == InvalidIndex && cursor < vertexCount) {
+                if (liveTriangles[cursor] > 0) best = static_cast<uint32_t>(cursor);
+                ++cursor;
+            }
+            fanning = best;
+        }
+
+        std::copy(output.begin(), output.end(), indices.begin());
+    }
+
+    void MeshOptimizer::OptimizeOverdraw(std::span<uint32_t> indices, std::span<const glm::vec3> positions,
+        float threshold, uint32_t cacheSize) {
+        const size_t triangleCount = indices.size() / 3;
+        if (triangleCount < 2 || !IndicesInRange(indices, positions.size())) return;
+
+        const double inputAcmr = AnalyzeVertexCache(indices, positions.size(), cacheSize).GetAcmr();
+
+        // Hard boundaries: triangles where the cache was effectively flushed (three misses)
+        std::vector<size_t> hardStarts;
+        {
+            FifoCache cache(positions.size(), cacheSize);
+            for (size_t t = 0; t < triangleCount; ++t) {
+                if (cache.Misses(&indices[t * 3]) == 3 || t == 0) hardStarts.push_back(t);
+            }
+            hardStarts.push_back(triangleCount);
+        }
+
+        // Soft boundaries: split a hard cluster wherever the prefix, drawn from a cold cache,
+        // is no worse than threshold times the cluster's own ACMR
+        std::vector<size_t> clusterStarts;
+        FifoCache cache(positions.size(), cacheSize);
+        for (size_t c = 0; c + 1 < hardStarts.size(); ++c) {
+            const size_t begin = hardStarts[c];
+            const size_t end = hardStarts[c + 1];
+
+            cache.Flush();
+            uint64_t clusterMisses = 0;
+            for (size_t t = begin; t < end; ++t) clusterMisses += cache.Misses(&indices[t * 3]);
+            const double clusterAcmr = static_cast<double>(clusterMisses) / (end - begin);
+
+            cache.Flush();
+            clusterStarts.push_back(begin);
+            size_t start = begin;
+            uint64_t misses = 0;
+            for (size_t t = begin; t < end; ++t) {
+                misses += cache.Misses(&indices[t * 3]);
+                if (t + 1 < end && static_cast<double>(misses) / (t + 1 - start) <= threshold * clusterAcmr) {
+                    clusterStarts.push_back(t + 1);
+                    start = t + 1;
+                    misses = 0;
+                    cache.Flush();
+                }
+            }
+        }
+        clusterStarts.push_back(triangleCount);
+        const size_t clusterCount = clusterStarts.size() - 1;
+        if (clusterCount < 2) return;
+
+        // Area-weighted centroids and normals per cluster
+        struct Cluster {
+            glm::vec3 centroid{ 0.0f };
+            glm::vec3 normal{ 0.0f };
+            float area = 0.0f;
+            float sortKey = 0.0f;
+        };
+        std::vector<Cluster> clusters(clusterCount);
+        glm::vec3 meshCentroid(0.0f);
+        float meshArea = 0.0f;
+
+        for (size_t c = 0; c < clusterCount; ++c) {
+            Cluster& cluster = clusters[c];
+            for (size_t t = clusterStarts[c]; t < clusterStarts[c + 1]; ++t) {
+                const glm::vec3& p0 = positions[indices[t * 3 + 0]];
+                const glm::vec3& p1 = positions[indices[t * 3 + 1]];
+                const glm::vec3& p2 = positions[indices[t * 3 + 2]];
+                glm::vec3 normal = glm::cross(p1 - p0, p2 - p0);
+                float area = glm::length(normal);
+
+                cluster.centroid += (p0 + p1 + p2) * (area / 3.0f);
+                cluster.normal += normal;
+                cluster.area += area;
+            }
+            meshCentroid += cluster.centroid;
+            meshArea += cluster.area;
+            if (cluster.area > 0.0f) cluster.centroid /= cluster.area;
+        }
+        if (meshArea > 0.0f) meshCentroid /= meshArea;
+
+        // Clusters facing away from the mesh centre are likely in front; draw them first
+        for (auto& cluster : clusters) {
+            float normalLength = glm::length(cluster.normal);
+            cluster.sortKey = normalLength > 0.0f ? glm::dot(cluster.centroid - meshCentroid, cluster.normal / normalLength) : 0.0f;
+        }
+
+        std::vector<uint32_t> order(clusterCount);
+        std::iota(order.begin(), order.end(), 0u);
+        std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) { return clusters[a].sortKey > clusters[b].sortKey; });
+
+        std::vector<uint32_t> reordered;
+        reordered.reserve(triangleCount * 3);
+        for (uint32_t c : order) {
+            reordered.insert(reordered.end(), indices.begin() + clusterStarts[c] * 3, indices.begin() + clusterStarts[c + 1] * 3);
+        }
+
+        const double outputAcmr = AnalyzeVertexCache(reordered, positions.size(), cacheSize).GetAcmr();
+        if (outputAcmr <= inputAcmr * threshold) {
+            std::copy(reordered.begin(), reordered.end(), indices.begin());
+        }
+    }
+
+    void MeshOptimizer::OptimizeVertexFetch(MeshData& meshData, const MeshData::SubMesh& range) {
+        RangeIndices rangeIndices(meshData, range);
+        std::span<uint32_t> indices = rangeIndices.Get();
+        if (range.vertexCount == 0 || !IndicesInRange(indices, range.vertexCount)) return;
+
+        std::vector<uint32_t> remap(range.vertexCount, InvalidIndex);
+        uint32_t next = 0;
+        for (uint32_t& index : indices) {
+            if (remap[index] == InvalidIndex) remap[index] = next++;
+            index = remap[index];
+        }
+        // Unreferenced vertices keep their relative order at the end of the range
+        for (uint32_t& target : remap) {
+            if (target == InvalidIndex) target = next++;
+        }
+        rangeIndices.Commit();
+
+        auto permute = [&](auto& attribute) {
+            if (attribute.empty()) return;
+            auto* first = attribute.data() + range.vertexOffset;
+            std::vector<std::remove_reference_t<decltype(*first)>> reordered(range.vertexCount);
+            for (uint32_t v = 0; v < range.vertexCount; ++v) reordered[remap[v]] = first[v];
+            std::copy(reordered.begin(), reordered.end(), first);
+        };
+        permute(meshData.vertices);
+        permute(meshData.normals);
+        permute(meshData.texCoords);
+    }
+
+    VertexCacheStatistics MeshOptimizer::AnalyzeVertexCache(std::span<const uint32_t> indices, size_t vertexCount, uint32_t cacheSize) {
+        VertexCacheStatistics statistics;
+        FifoCache cache(vertexCount, cacheSize);
+
+        const size_t triangleCount = indices.size() / 3;
+        for (size_t i = 0; i < triangleCount * 3; ++i) {
+            if (indices[i] >= vertexCount) continue;
+            statistics.transformedVertices += cache.Access(indices[i]);
+        }
+        statistics.triangleCount = triangleCount;
+        for (size_t v = 0; v < vertexCount; ++v) {
+            statistics.vertexCount += cache.WasReferenced(static_cast<uint32_t>(v));
+        }
+        return statistics;
+    }
+
+    VertexCacheStatistics MeshOptimizer::AnalyzeVertexCache(const MeshData& meshData, uint32_t cacheSize) {
+        // Every range is its own draw call and starts with a cold cache
+        VertexCacheStatistics statistics;
+        for (const auto& range : meshData.GetUniqueRanges()) {
+            statistics.Add(AnalyzeVertexCache(GetRangeIndices(meshData, range), range.vertexCount, cacheSize));
+        }
+        return statistics;
+    }
+
+    OverdrawStatistics MeshOptimizer::AnalyzeOverdraw(std::span<const uint32_t> indices, std::span<const glm::vec3> positions) {
+        constexpr int Resolution = 256;
+        OverdrawStatistics statistics;
+
+        const size_t triangleCount = indices.size() / 3;
+        if (triangleCount == 0 || positions.empty() || !IndicesInRange(indices, positions.size())) return statistics;
+
+        glm::vec3 minBounds = positions[indices[0]];
+        glm::vec3 maxBounds = minBounds;
+        for (size_t i = 0; i < triangleCount * 3; ++i) {
+            minBounds = glm::min(minBounds, positions[indices[i]]);
+            maxBounds = glm::max(maxBounds, positions[indices[i]]);
+        }
+        glm::vec3 extent = maxBounds - minBounds;
+        float scale = std::max({ extent.x, extent.y, extent.z });
+        if (scale <= 0.0f) return statistics;
+        scale = Resolution / scale;
+
+        std::vector<float> depthBuffer(Resolution * Resolution);
+
+        // Orthographic views along +-X, +-Y, +-Z; both windings are rasterized
+        for (int axis = 0; axis < 3; ++axis) {
+            const int uAxis = (axis + 1) % 3;
+            const int vAxis = (axis + 2) % 3;
+            for (float direction : { 1.0f, -1.0f }) {
+                std::fill(depthBuffer.begin(), depthBuffer.end(), std::numeric_limits<float>::infinity());
+
+                for (size_t t = 0; t < triangleCount; ++t) {
+                    float x[3], y[3], z[3];
+                    for (int k = 0; k < 3; ++k) {
+                        glm::vec3 p = (positions[indices[t * 3 + k]] - minBounds) * scale;
+                        x[k] = p[uAxis];
+                        y[k] = p[vAxis];
+                        z[k] = p[axis] * direction;
+                    }
+
+                    float area = (x[1] - x[0]) * (y[2] - y[0]) - (x[2] - x[0]) * (y[1] - y[0]);
+                    if (std::abs(area) < 1e-12f) continue;
+                    float sign = area > 0.0f ? 1.0f : -1.0f;
+                    float invArea = 1.0f / std::abs(area);
+
+                    int minX = std::max(0, static_cast<int>(std::floor(std::min({ x[0], x[1], x[2] }))));
+                    int maxX = std::min(Resolution - 1, static_cast<int>(std::ceil(std::max({ x[0], x[1], x[2] }))));
+                    int minY = std::max(0, static_cast<int>(std::floor(std::min({ y[0], y[1], y[2] }))));
+                    int maxY = std::min(Resolution - 1, static_cast<int>(std::ceil(std::max({ y[0], y[1], y[2] }))));
+
+                    for (int py = minY; py <= maxY; ++py) {
+                        float sy = py + 0.5f;
+                        for (int px = minX; px <= maxX; ++px) {
+                            float sx = px + 0.5f;
+                            float w0 = sign * ((x[2] - x[1]) * (sy - y[1]) - (y[2] - y[1]) * (sx - x[1]));
+                            float w1 = sign * ((x[0] - x[2]) * (sy - y[2]) - (y[0] - y[2]) * (sx - x[2]));
+                            float w2 = sign * ((x[1] - x[0]) * (sy - y[0]) - (y[1] - y[0]) * (sx - x[0]));
+                            if (w0 < 0.0f || w1 < 0.0f || w2 < 0.0f) continue;
+
+                            float depth = (w0 * z[0] + w1 * z[1] + w2 * z[2]) * invArea;
+                            float& stored = depthBuffer[py * Resolution + px];
+                            if (depth < stored) {
+                                stored = depth;
+                                ++statistics.pixelsShaded;
+                            }
+                        }
+                    }
+                }
+
+                for (float depth : depthBuffer) {
+                    statistics.pixelsCovered += depth != std::numeric_limits<float>::infinity();
+                }
+            }
+        }
+        return statistics;
+    }
+
+    OverdrawStatistics MeshOptimizer::AnalyzeOverdraw(const MeshData& meshData) {
+        // Draw every range into the same views, in submesh order
+        std::vector<uint32_t> indices;
+        indices.reserve(meshData.GetIndexCount());
+        for (const auto& range : meshData.GetUniqueRanges()) {
+            std::vector<uint32_t> rangeIndices = GetRangeIndices(meshData, range, range.vertexOffset);
+            indices.insert(indices.end(), rangeIndices.begin(), rangeIndices.end());
+        }
+        return AnalyzeOverdraw(indices, meshData.vertices);
+    }
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "MeshData.hpp"
+#include "MeshProcessing.hpp"
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace Anito3D {
+
+    class ThreadPool;
+
+    // Post-transform vertex cache efficiency of an index stream (FIFO cache model)
+    struct VertexCacheStatistics {
+        uint64_t triangleCount = 0;
+        uint64_t vertexCount = 0;         // Distinct vertices referenced
+        uint64_t transformedVertices = 0; // Cache misses
+
+        double GetAcmr() const { return triangleCount ? static_cast<double>(transformedVertices) / triangleCount : 0.0; } // Average cache miss ratio, 0.5 .. 3
+        double GetAtvr() const { return vertexCount ? static_cast<double>(transformedVertices) / vertexCount : 0.0; }     // Average transform to vertex ratio, 1 is ideal
+
+        void Add(const VertexCacheStatistics& other) {
+            triangleCount += other.triangleCount;
+            vertexCount += other.vertexCount;
+            transformedVertices += other.transformedVertices;
+        }
+    };
+
+    // Fragments shaded per covered pixel, averaged over six axis-aligned views
+    struct OverdrawStatistics {
+        uint64_t pixelsCovered = 0;
+        uint64_t pixelsShaded = 0;
+
+        double GetOverdraw() const { return pixelsCovered ? static_cast<double>(pixelsShaded) / pixelsCovered : 0.0; }
+
+        void Add(const OverdrawStatistics& other) {
+            pixelsCovered += other.pixelsCovered;
+            pixelsShaded += other.pixelsShaded;
+        }
+    };
+
+    // Reorders triangles and vertices for the GPU's post-transform cache, early depth
+    // rejection and vertex fetch locality. Index spans are local to one vertex range
+    // (MeshData indices are relative to the submesh's vertexOffset); 16-bit ranges are
+    // processed on a widened copy.
+    class MeshOptimizer {
+    public:
+        static constexpr uint32_t DefaultCacheSize = 16;
+        static constexpr float DefaultOverdrawThreshold = 1.05f; // Allowed ACMR increase for the overdraw pass
+
+        // Apply the MeshProcess passes to every distinct submesh range, in parallel with a pool
+        static void Optimize(MeshData& meshData, uint32_t processFlags, ThreadPool* threadPool = nullptr);
+
+        // Tipsify (Sander, Nehab, Barczak 2007): fans around the most recently cached vertex
+        static void OptimizeVertexCache(std::span<uint32_t> indices, size_t vertexCount,
+            uint32_t cacheSize = DefaultCacheSize);
+
+        // Splits a cache-optimized stream into clusters at cache flushes and draws outward-facing
+        // clusters first; keeps the input order if the ACMR would grow beyond the threshold
+        static void OptimizeOverdraw(std::span<uint32_t> indices, std::span<const glm::vec3> positions,
+            float threshold = DefaultOverdrawThreshold, uint32_t cacheSize = DefaultCacheSize);
+
+        // Renumbers the vertices of one range in first-use order and permutes its attributes
+        static void OptimizeVertexFetch(MeshData& meshData, const MeshData::SubMesh& range);
+
+        static VertexCacheStatistics AnalyzeVertexCache(std::span<const uint32_t> indices, size_t vertexCount,
+            uint32_t cacheSize = DefaultCacheSize);
+        static VertexCacheStatistics AnalyzeVertexCache(const MeshData& meshData, uint32_t cacheSize = DefaultCacheSize);
+
+        static OverdrawStatistics AnalyzeOverdraw(std::span<const uint32_t> indices, std::span<const glm::vec3> positions);
+        static OverdrawStatistics AnalyzeOverdraw(const MeshData& meshData);
+    };
+
+}
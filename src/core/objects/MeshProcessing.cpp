@@ -0,0 +1,24 @@
+#include "MeshProcessing.hpp"
+#include "MeshBounds.hpp"
+#include "MeshOptimizer.hpp"
+#include "Trace.hpp"
+
+namespace Anito3D {
+
+    uint64_t MeshProcessOptions::GetSettingsHash() const {
+        return (flags & MeshProcess::WeldVertices) ? weld.GetHash() : 0;
+    }
+
+    void MeshProcessor::Run(MeshData& meshData, const MeshProcessOptions& options, ThreadPool* threadPool) {
+        ANITO3D_TRACE_ZONE("MeshProcessor::Run");
+        if (options.flags & MeshProcess::WeldVertices) {
+            MeshWelder::Weld(meshData, options.weld, threadPool);
+            // Tolerance welds may move vertices to a neighbour's position
+            if (options.weld.positionEpsilon > 0.0f) MeshBounds::Update(meshData, threadPool);
+        }
+        MeshOptimizer::Optimize(meshData, options.flags, threadPool);
+        if (options.flags & MeshProcess::NarrowIndices) {
+            meshData.NarrowIndices();
+        }
+    }
+}
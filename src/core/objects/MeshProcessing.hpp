@@ -0,0 +1,38 @@
+#pragma once
+
+#include "MeshData.hpp"
+#include "MeshWelder.hpp"
+#include <cstdint>
+
+namespace Anito3D {
+
+    class ThreadPool;
+
+    // Post-import processing passes (part of the mesh cache key)
+    struct MeshProcess {
+        static constexpr uint32_t OptimizeVertexCache = 1u << 0;
+        static constexpr uint32_t OptimizeOverdraw = 1u << 1;
+        static constexpr uint32_t OptimizeVertexFetch = 1u << 2;
+        static constexpr uint32_t WeldVertices = 1u << 3;
+        static constexpr uint32_t NarrowIndices = 1u << 4;
+
+        static constexpr uint32_t Optimize = OptimizeVertexCache | OptimizeOverdraw | OptimizeVertexFetch;
+        // Welding rewrites the vertex arrays (and with epsilons moves vertices), so it is opt-in
+        static constexpr uint32_t Default = NarrowIndices;
+    };
+
+    struct MeshProcessOptions {
+        uint32_t flags = MeshProcess::Default;
+        WeldOptions weld;
+
+        // Hash of the pass settings that change the output beyond the flags
+        uint64_t GetSettingsHash() const;
+    };
+
+    // Runs the enabled passes in order: weld, optimize, narrow indices
+    class MeshProcessor {
+    public:
+        static void Run(MeshData& meshData, const MeshProcessOptions& options, ThreadPool* threadPool = nullptr);
+    };
+
+}
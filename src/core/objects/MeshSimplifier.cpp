@@ -0,0 +1,544 @@
+#include "MeshSimplifier.hpp"
+#include "MeshBounds.hpp"
+#include "ThreadPool.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <numeric>
+
+namespace Anito3D {
+
+    namespace {
+        constexpr uint32_t InvalidIndex = std::numeric_limits<uint32_t>::max();
+        constexpr double EdgeWeight = 10.0; // Boundary/seam plane weight relative to surface planes
+        constexpr float MinLevelReduction = 0.95f; // A level must drop at least 5% of the triangles
+
+        enum class VertexKind : uint8_t {
+            Manifold, // Interior vertex with a single attribute set
+            Border,   // On an open boundary, collapses along it
+            Seam,     // Two wedges on a uv/normal seam, collapses along it
+            Locked    // Corners, seam junctions and complex topology
+        };
+
+        struct Quadric {
+            double a00 = 0, a11 = 0, a22 = 0, a10 = 0, a20 = 0, a21 = 0;
+            double b0 = 0, b1 = 0, b2 = 0, c = 0, w = 0;
+
+            static Quadric FromPlane(const glm::dvec3& n, double d, double weight) {
+                Quadric q;
+                q.a00 = n.x * n.x * weight; q.a11 = n.y * n.y * weight; q.a22 = n.z * n.z * weight;
+                q.a10 = n.y * n.x * weight; q.a20 = n.z * n.x * weight; q.a21 = n.z * n.y * weight;
+                q.b0 = n.x * d * weight; q.b1 = n.y * d * weight; q.b2 = n.z * d * weight;
+                q.c = d * d * weight;
+                q.w = weight;
+                return q;
+            }
+
+            void Add(const Quadric& o) {
+                a00 += o.a00; a11 += o.a11; a22 += o.a22; a10 += o.a10; a20 += o.a20; a21 += o.a21;
+                b0 += o.b0; b1 += o.b1; b2 += o.b2; c += o.c; w += o.w;
+            }
+
+            // Weighted mean squared distance of p to the accumulated planes
+            double Error(const glm::vec3& p) const {
+                const double x = p.x, y = p.y, z = p.z;
+                const double rx = a00 * x + a10 * y + a20 * z;
+                const double ry = a10 * x + a11 * y + a21 * z;
+                const double rz = a20 * x + a21 * y + a22 * z;
+                const double r = rx * x + ry * y + rz * z + 2.0 * (b0 * x + b1 * y + b2 * z) + c;
+                return w > 0.0 ? std::fabs(r) / w : 0.0;
+            }
+        };
+
+        // Directed edges and incident triangles per vertex (CSR)
+        struct Adjacency {
+            std::vector<uint32_t> edgeOffsets;
+            std::vector<uint32_t> edgeTargets;
+            std::vector<uint32_t> triangleOffsets;
+            std::vector<uint32_t> triangles;
+
+            void Build(const std::vector<uint32_t>& indices, size_t vertexCount) {
+                const size_t triangleCount = indices.size() / 3;
+                edgeOffsets.assign(vertexCount + 1, 0);
+                for (uint32_t index : indices) ++edgeOffsets[index + 1];
+                std::partial_sum(edgeOffsets.begin(), edgeOffsets.end(), edgeOffsets.begin());
+                triangleOffsets = edgeOffsets; // One outgoing edge per triangle corner
+
+                edgeTargets.resize(indices.size());
+                triangles.resize(indices.size());
+                std::vector<uint32_t> edgeFill(edgeOffsets.begin(), edgeOffsets.end() - 1);
+                std::vector<uint32_t> triangleFill = edgeFill;
+                for (size_t t = 0; t < triangleCount; ++t) {
+                    for (int k = 0; k < 3; ++k) {
+                        const uint32_t a = indices[t * 3 + k];
+                        const uint32_t b = indices[t * 3 + (k + 1) % 3];
+                        edgeTargets[edgeFill[a]++] = b;
+                        triangles[triangleFill[a]++] = static_cast<uint32_t>(t);
+                    }
+                }
+            }
+
+            bool HasEdge(uint32_t a, uint32_t b) const {
+                for (uint32_t i = edgeOffsets[a]; i < edgeOffsets[a + 1]; ++i) {
+                    if (edgeTargets[i] == b) return true;
+                }
+                return false;
+            }
+
+            std::span<const uint32_t> GetEdges(uint32_t vertex) const {
+                return { edgeTargets.data() + edgeOffsets[vertex], edgeOffsets[vertex + 1] - edgeOffsets[vertex] };
+            }
+
+            std::span<const uint32_t> GetTriangles(uint32_t vertex) const {
+                return { triangles.data() + triangleOffsets[vertex], triangleOffsets[vertex + 1] - triangleOffsets[vertex] };
+            }
+        };
+
+        // Groups vertices with bitwise identical positions: positionClass is the lowest vertex
+        // of the group, nextWedge links the group into a ring
+        void BuildPositionClasses(std::span<const glm::vec3> positions, std::vector<uint32_t>& positionClass,
+            std::vector<uint32_t>& nextWedge) {
+            const size_t vertexCount = positions.size();
+            auto bits = [&](uint32_t v) {
+                uint32_t key[3];
+                std::memcpy(key, &positions[v], sizeof(key));
+                return std::make_tuple(key[0], key[1], key[2], v);
+            };
+
+            std::vector<uint32_t> order(vertexCount);
+            std::iota(order.begin(), order.end(), 0u);
+            std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) { return bits(a) < bits(b); });
+
+            positionClass.resize(vertexCount);
+            nextWedge.resize(vertexCount);
+            for (size_t begin = 0; begin < vertexCount;) {
+                size_t end = begin + 1;
+                while (end < vertexCount && std::memcmp(&positions[order[begin]], &positions[order[end]], sizeof(glm::vec3)) == 0) ++end;
+                for (size_t i = begin; i < end; ++i) {
+                    positionClass[order[i]] = order[begin];
+                    nextWedge[order[i]] = order[i + 1 < end ? i + 1 : begin];
+                }
+                begin = end;
+            }
+        }
+
+        struct RangeResult {
+            double quadricError = 0.0; // sqrt of the largest accepted collapse cost
+            double distanceBound = 0.0;
+        };
+
+        class RangeSimplifier {
+        public:
+            RangeSimplifier(std::vector<uint32_t>& indices, std::span<const glm::vec3> positions, bool lockBorders)
+                : indices(indices), positions(positions) {
+                BuildPositionClasses(positions, positionClass, nextWedge);
+                adjacency.Build(indices, positions.size());
+                ClassifyVertices(lockBorders);
+                ComputeQuadrics();
+            }
+
+            // Collapses edges until the index count reaches the target or every remaining
+            // collapse costs more than maxError
+            RangeResult Run(size_t targetIndexCount, double maxError) {
+                const double maxCost = maxError * maxError;
+                double resultCost = 0.0;
+                double distanceBound = 0.0;
+                travelled.assign(positions.size(), 0.0);
+
+                std::vector<uint32_t> remap(positions.size());
+                std::vector<uint8_t> locked(positions.size());
+                std::vector<Collapse> collapses;
+
+                while (indices.size() > targetIndexCount) {
+                    if (!first) adjacency.Build(indices, positions.size());
+                    first = false;
+
+                    CollectCollapses(collapses, maxCost);
+                    if (collapses.empty()) break;
+                    std::sort(collapses.begin(), collapses.end(), [](const Collapse& a, const Collapse& b) { return a.cost < b.cost; });
+
+                    std::iota(remap.begin(), remap.end(), 0u);
+                    std::fill(locked.begin(), locked.end(), uint8_t(0));
+                    const size_t trianglesToRemove = (indices.size() - targetIndexCount + 2) / 3;
+                    size_t trianglesRemoved = 0;
+                    size_t performed = 0;
+
+                    for (const Collapse& collapse : collapses) {
+                        if (locked[collapse.from] || locked[collapse.to]) continue;
+                        size_t removed = 0;
+                        if (!TryCollapse(collapse.from, collapse.to, remap, removed)) continue;
+
+                        // Both ends are settled for this pass; neighbours are re-evaluated next pass
+                        locked[collapse.from] = locked[collapse.to] = 1;
+                        quadrics[collapse.to].Add(quadrics[collapse.from]);
+                        resultCost = std::max(resultCost, collapse.cost);
+                        // Everything merged into from moves by at most its own travel plus the edge
+                        const double edgeLength = glm::length(glm::dvec3(positions[collapse.to]) - glm::dvec3(positions[collapse.from]));
+                        travelled[collapse.to] = std::max(travelled[collapse.to], travelled[collapse.from] + edgeLength);
+                        distanceBound = std::max(distanceBound, travelled[collapse.to]);
+                        trianglesRemoved += removed;
+                        ++performed;
+                        if (trianglesRemoved >= trianglesToRemove) break;
+                    }
+                    if (performed == 0) break;
+
+                    ApplyRemap(remap);
+                }
+                return { std::sqrt(resultCost), distanceBound };
+            }
+
+        private:
+            struct Collapse {
+                uint32_t from; // Position class removed
+                uint32_t to;   // Position class kept
+                double cost;
+            };
+
+            std::vector<uint32_t>& indices;
+            std::span<const glm::vec3> positions;
+            std::vector<uint32_t> positionClass;
+            std::vector<uint32_t> nextWedge;
+            std::vector<VertexKind> kinds; // Per position class
+            std::vector<Quadric> quadrics; // Per position class
+            std::vector<double> travelled; // Per position class: farthest any vertex merged into it started
+            Adjacency adjacency;
+            bool first = true;
+
+            template <typename F>
+            void ForEachWedge(uint32_t vertex, F&& function) const {
+                uint32_t wedge = vertex;
+                do {
+                    function(wedge);
+                    wedge = nextWedge[wedge];
+                } while (wedge != vertex);
+            }
+
+            void ClassifyVertices(bool lockBorders) {
+                const size_t vertexCount = positions.size();
+                // Open edges exist in one direction only (boundaries, or seams in vertex space)
+                std::vector<uint32_t> openIn(vertexCount, 0), openOut(vertexCount, 0);
+                std::vector<uint32_t> openInSource(vertexCount, InvalidIndex), openOutTarget(vertexCount, InvalidIndex);
+                for (uint32_t a = 0; a < vertexCount; ++a) {
+                    for (uint32_t b : adjacency.GetEdges(a)) {
+                        if (adjacency.HasEdge(b, a)) continue;
+                        ++openOut[a];
+                        ++openIn[b];
+                        openOutTarget[a] = b;
+                        openInSource[b] = a;
+                    }
+                }
+
+                kinds.assign(vertexCount, VertexKind::Locked);
+                for (uint32_t v = 0; v < vertexCount; ++v) {
+                    if (positionClass[v] != v) continue;
+
+                    VertexKind kind = VertexKind::Locked;
+                    const uint32_t w = nextWedge[v];
+                    if (w == v) {
+                        if (openIn[v] == 0 && openOut[v] == 0) kind = VertexKind::Manifold;
+                        else if (openIn[v] == 1 && openOut[v] == 1) kind = VertexKind::Border;
+                    }
+                    else if (nextWedge[w] == v) {
+                        // Two wedges whose open edges run along the same positions in opposite directions
+                        if (openIn[v] == 1 && openOut[v] == 1 && openIn[w] == 1 && openOut[w] == 1 &&
+                            positionClass[openOutTarget[v]] == positionClass[openInSource[w]] &&
+                            positionClass[openOutTarget[w]] == positionClass[openInSource[v]]) {
+                            kind = VertexKind::Seam;
+                        }
+                    }
+                    if (lockBorders && kind == VertexKind::Border) kind = VertexKind::Locked;
+                    kinds[v] = kind;
+                }
+            }
+
+            void ComputeQuadrics() {
+                quadrics.assign(positions.size(), Quadric{});
+                const size_t triangleCount = indices.size() / 3;
+                for (size_t t = 0; t < triangleCount; ++t) {
+                    const uint32_t corners[3] = { indices[t * 3 + 0], indices[t * 3 + 1], indices[t * 3 + 2] };
+                    const glm::dvec3 p0(positions[corners[0]]), p1(positions[corners[1]]), p2(positions[corners[2]]);
+                    glm::dvec3 normal = glm::cross(p1 - p0, p2 - p0);
+                    const double doubleArea = glm::length(normal);
+                    if (doubleArea <= 0.0) continue;
+                    normal /= doubleArea;
+
+                    Quadric plane = Quadric::FromPlane(normal, -glm::dot(normal, p0), doubleArea * 0.5);
+                    for (uint32_t corner : corners) quadrics[positionClass[corner]].Add(plane);
+
+                    // Planes through open edges, perpendicular to the surface, hold boundaries and seams in place
+                    for (int k = 0; k < 3; ++k) {
+                        const uint32_t a = corners[k];
+                        const uint32_t b = corners[(k + 1) % 3];
+                        if (adjacency.HasEdge(b, a)) continue;
+
+                        const glm::dvec3 pa(positions[a]), pb(positions[b]);
+                        const glm::dvec3 edge = pb - pa;
+                        const double length = glm::length(edge);
+                        glm::dvec3 edgeNormal = glm::cross(edge, normal);
+                        const double edgeNormalLength = glm::length(edgeNormal);
+                        if (edgeNormalLength <= 0.0) continue;
+                        edgeNormal /= edgeNormalLength;
+
+                        Quadric edgePlane = Quadric::FromPlane(edgeNormal, -glm::dot(edgeNormal, pa), length * length * EdgeWeight);
+                        quadrics[positionClass[a]].Add(edgePlane);
+                        quadrics[positionClass[b]].Add(edgePlane);
+                    }
+                }
+            }
+
+            // True if any wedge pair of the two classes is joined by a one-directional edge
+            bool IsOpenEdge(uint32_t from, uint32_t to) const {
+                bool open = false;
+                ForEachWedge(from, [&](uint32_t a) {
+                    ForEachWedge(to, [&](uint32_t b) {
+                        if (adjacency.HasEdge(a, b) != adjacency.HasEdge(b, a)) open = true;
+                    });
+                });
+                return open;
+            }
+
+            bool CanCollapse(uint32_t from, uint32_t to) const {
+                const VertexKind fromKind = kinds[from];
+                if (fromKind == VertexKind::Manifold) return true;
+                if (fromKind == VertexKind::Locked) return false;
+                // Border and seam vertices only slide along their own boundary
+                const VertexKind toKind = kinds[to];
+                return (toKind == fromKind || toKind == VertexKind::Locked) && IsOpenEdge(from, to);
+            }
+
+            void CollectCollapses(std::vector<Collapse>& collapses, double maxCost) const {
+                std::vector<uint64_t> edges;
+                edges.reserve(indices.size());
+                for (size_t i = 0; i < indices.size(); i += 3) {
+                    for (int k = 0; k < 3; ++k) {
+                        uint32_t a = positionClass[indices[i + k]];
+                        uint32_t b = positionClass[indices[i + (k + 1) % 3]];
+                        if (a == b) continue;
+                        if (a > b) std::swap(a, b);
+                        edges.push_back((static_cast<uint64_t>(a) << 32) | b);
+                    }
+                }
+                std::sort(edges.begin(), edges.end());
+                edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+
+                collapses.clear();
+                for (uint64_t edge : edges) {
+                    const uint32_t a = static_cast<uint32_t>(edge >> 32);
+                    const uint32_t b = static_cast<uint32_t>(edge);
+                    const double costAB = CanCollapse(a, b) ? quadrics[a].Error(positions[b]) : std::numeric_limits<double>::infinity();
+                    const double costBA = CanCollapse(b, a) ? quadrics[b].Error(positions[a]) : std::numeric_limits<double>::infinity();
+                    const Collapse collapse = costAB <= costBA ? Collapse{ a, b, costAB } : Collapse{ b, a, costBA };
+                    if (collapse.cost <= maxCost) collapses.push_back(collapse);
+                }
+            }
+
+            bool TryCollapse(uint32_t from, uint32_t to, std::vector<uint32_t>& remap, size_t& trianglesRemoved) const {
+                // Every wedge moves to the wedge of the target it shares an edge with, which keeps
+                // each side of a seam on its own attributes
+                bool valid = true;
+                ForEachWedge(from, [&](uint32_t a) {
+                    if (!valid || adjacency.GetTriangles(a).empty()) return;
+                    uint32_t target = InvalidIndex;
+                    ForEachWedge(to, [&](uint32_t b) {
+                        if (target == InvalidIndex && (adjacency.HasEdge(a, b) || adjacency.HasEdge(b, a))) target = b;
+                    });
+                    if (target == InvalidIndex) valid = false;
+                    else remap[a] = target;
+                });
+
+                // Reject collapses that flip a surviving triangle
+                const glm::vec3 destination = positions[to];
+                size_t removed = 0;
+                ForEachWedge(from, [&](uint32_t a) {
+                    if (!valid) return;
+                    for (uint32_t t : adjacency.GetTriangles(a)) {
+                        const uint32_t* corners = &indices[t * 3];
+                        bool vanishes = false;
+                        for (int k = 0; k < 3; ++k) vanishes |= positionClass[corners[k]] == to;
+                        if (vanishes) {
+                            ++removed;
+                            continue;
+                        }
+
+                        glm::vec3 before[3], after[3];
+                        for (int k = 0; k < 3; ++k) {
+                            before[k] = positions[corners[k]];
+                            after[k] = corners[k] == a ? destination : before[k];
+                        }
+                        const glm::vec3 normalBefore = glm::cross(before[1] - before[0], before[2] - before[0]);
+                        const glm::vec3 normalAfter = glm::cross(after[1] - after[0], after[2] - after[0]);
+                        if (glm::dot(normalBefore, normalAfter) <= 0.0f) {
+                            valid = false;
+                            return;
+                        }
+                    }
+                });
+
+                if (!valid) {
+                    ForEachWedge(from, [&](uint32_t a) { remap[a] = a; });
+                    return false;
+                }
+                trianglesRemoved = removed;
+                return true;
+            }
+
+            void ApplyRemap(const std::vector<uint32_t>& remap) {
+                size_t write = 0;
+                for (size_t i = 0; i < indices.size(); i += 3) {
+                    const uint32_t a = remap[indices[i + 0]];
+                    const uint32_t b = remap[indices[i + 1]];
+                    const uint32_t c = remap[indices[i + 2]];
+                    const uint32_t pa = positionClass[a], pb = positionClass[b], pc = positionClass[c];
+                    if (pa == pb || pb == pc || pc == pa) continue;
+                    indices[write++] = a;
+                    indices[write++] = b;
+                    indices[write++] = c;
+                }
+                indices.resize(write);
+            }
+        };
+    }
+
+    SimplifyStatistics MeshSimplifier::Simplify(std::vector<uint32_t>& indices, std::span<const glm::vec3> positions,
+        const SimplifyOptions& options, float extent) {
+        SimplifyStatistics statistics;
+        statistics.trianglesBefore = statistics.trianglesAfter = indices.size() / 3;
+        if (indices.size() < 3 || indices.size() % 3 != 0 ||
+            std::any_of(indices.begin(), indices.end(), [&](uint32_t index) { return index >= positions.size(); })) {
+            return statistics;
+        }
+
+        const size_t targetTriangles = static_cast<size_t>(std::max(0.0f, options.targetRatio) * statistics.trianglesBefore);
+        RangeSimplifier simplifier(indices, positions, options.lockBorders);
+        const RangeResult result = simplifier.Run(targetTriangles * 3, static_cast<double>(options.maxError) * extent);
+        statistics.quadricError = static_cast<float>(result.quadricError);
+        statistics.error = static_cast<float>(result.distanceBound);
+        statistics.trianglesAfter = indices.size() / 3;
+        return statistics;
+    }
+
+    MeshData MeshSimplifier::Simplify(const MeshData& meshData, const SimplifyOptions& options,
+        ThreadPool* threadPool, SimplifyStatistics* statistics) {
+        const float extent = GetExtent(meshData);
+        const std::vector<MeshData::SubMesh> ranges = meshData.GetUniqueRanges();
+
+        // Source meshes occupy disjoint ranges, so each one is simplified independently
+        std::vector<std::vector<uint32_t>> rangeIndices(ranges.size());
+        std::vector<SimplifyStatistics> rangeStatistics(ranges.size());
+        auto simplifyRange = [&](size_t r) {
+            const MeshData::SubMesh& range = ranges[r];
+            rangeIndices[r].resize(range.indexCount);
+            for (uint32_t i = 0; i < range.indexCount; ++i) rangeIndices[r][i] = meshData.GetIndex(range, i);
+            std::span<const glm::vec3> positions(meshData.vertices.data() + range.vertexOffset, range.vertexCount);
+            rangeStatistics[r] = Simplify(rangeIndices[r], positions, options, extent);
+        };
+        if (threadPool) {
+            threadPool->ParallelFor(ranges.size(), simplifyRange);
+        }
+        else {
+            for (size_t r = 0; r < ranges.size(); ++r) simplifyRange(r);
+        }
+
+        // Drop the vertices no triangle uses anymore; each range keeps its first-use order
+        MeshData simplified;
+        simplified.materials = meshData.materials;
+        simplified.nodes = meshData.nodes;
+        std::vector<MeshData::SubMesh> relocated = ranges;
+        SimplifyStatistics total;
+        for (size_t r = 0; r < ranges.size(); ++r) {
+            const MeshData::SubMesh& range = ranges[r];
+            MeshData::SubMesh& target = relocated[r];
+            target.indexType = MeshData::IndexType::Uint32;
+            target.firstIndex = static_cast<uint32_t>(simplified.indices.size());
+            target.vertexOffset = static_cast<uint32_t>(simplified.vertices.size());
+            target.indexCount = static_cast<uint32_t>(rangeIndices[r].size());
+
+            std::vector<uint32_t> remap(range.vertexCount, InvalidIndex);
+            uint32_t vertexCount = 0;
+            for (uint32_t index : rangeIndices[r]) {
+                if (remap[index] == InvalidIndex) {
+                    const size_t source = range.vertexOffset + index;
+                    remap[index] = vertexCount++;
+                    simplified.vertices.push_back(meshData.vertices[source]);
+                    if (!meshData.normals.empty()) simplified.normals.push_back(meshData.normals[source]);
+                    if (!meshData.texCoords.empty()) simplified.texCoords.push_back(meshData.texCoords[source]);
+                }
+                simplified.indices.push_back(remap[index]);
+            }
+            target.vertexCount = vertexCount;
+
+            total.trianglesBefore += rangeStatistics[r].trianglesBefore;
+            total.trianglesAfter += rangeStatistics[r].trianglesAfter;
+            total.quadricError = std::max(total.quadricError, rangeStatistics[r].quadricError);
+            total.error = std::max(total.error, rangeStatistics[r].error);
+        }
+
+        simplified.subMeshes.reserve(meshData.subMeshes.size());
+        for (const auto& subMesh : meshData.subMeshes) {
+            size_t found = MeshData::FindRange(ranges, subMesh);
+            if (found == ranges.size()) continue;
+            MeshData::SubMesh entry = relocated[found];
+            entry.materialId = subMesh.materialId;
+            entry.node = subMesh.node;
+            entry.transform = subMesh.transform;
+            simplified.subMeshes.push_back(entry);
+        }
+        // The source bounds would still enclose the level, but culling wants them tight
+        MeshBounds::Update(simplified, threadPool);
+
+        if (statistics) *statistics = total;
+        return simplified;
+    }
+
+    std::vector<MeshLod> MeshSimplifier::BuildLodChain(const MeshData& meshData, const LodChainOptions& options, ThreadPool* threadPool) {
+        std::vector<MeshLod> chain;
+        chain.reserve(options.levels.size());
+        const float extent = GetExtent(meshData);
+        const size_t baseTriangles = meshData.GetTriangleCount();
+        if (baseTriangles == 0 || extent <= 0.0f) return chain;
+
+        // Each level starts from the previous one. Distance bounds add up (triangle inequality)
+        // to a bound against the base mesh; quadric errors add up against the level budgets.
+        const MeshData* previous = &meshData;
+        float previousError = 0.0f;
+        float previousQuadricError = 0.0f;
+        for (const LodLevelOptions& level : options.levels) {
+            const size_t previousTriangles = previous->GetTriangleCount();
+            const float errorBudget = level.maxError * extent - previousQuadricError;
+            if (errorBudget <= 0.0f || previousTriangles == 0) break;
+
+            SimplifyOptions simplifyOptions;
+            simplifyOptions.targetRatio = level.targetRatio * baseTriangles / previousTriangles;
+            simplifyOptions.maxError = errorBudget / extent;
+            simplifyOptions.lockBorders = options.lockBorders;
+            if (simplifyOptions.targetRatio >= 1.0f) continue;
+
+            SimplifyStatistics statistics;
+            MeshLod lod;
+            lod.meshData = Simplify(*previous, simplifyOptions, threadPool, &statistics);
+            if (statistics.trianglesAfter >= previousTriangles * MinLevelReduction) break;
+
+            // Match the index format of the base mesh
+            if (!meshData.indices16.empty()) lod.meshData.NarrowIndices();
+            lod.error = previousError + statistics.error;
+            lod.quadricError = previousQuadricError + statistics.quadricError;
+            chain.push_back(std::move(lod));
+            previous = &chain.back().meshData;
+            previousError = chain.back().error;
+            previousQuadricError = chain.back().quadricError;
+        }
+        return chain;
+    }
+
+    float MeshSimplifier::GetExtent(const MeshData& meshData) {
+        if (meshData.vertices.empty()) return 0.0f;
+        glm::vec3 minBounds = meshData.vertices[0];
+        glm::vec3 maxBounds = minBounds;
+        for (const auto& vertex : meshData.vertices) {
+            minBounds = glm::min(minBounds, vertex);
+            maxBounds = glm::max(maxBounds, vertex);
+        }
+        return glm::length(maxBounds - minBounds);
+    }
+}
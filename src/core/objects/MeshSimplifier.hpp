@@ -0,0 +1,74 @@
+#pragma once
+
+#include "MeshData.hpp"
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace Anito3D {
+
+    class ThreadPool;
+
+    struct SimplifyOptions {
+        float targetRatio = 0.5f;  // Fraction of the triangles to keep
+        float maxError = 0.01f;    // Largest quadric error of a collapse, relative to the mesh extent
+        bool lockBorders = false;  // Keep open boundary vertices in place
+    };
+
+    struct SimplifyStatistics {
+        uint64_t trianglesBefore = 0;
+        uint64_t trianglesAfter = 0;
+        float quadricError = 0.0f; // Largest accepted sqrt(quadric cost): RMS distance to the merged planes, steers the collapses
+        float error = 0.0f;        // Distance bound: no vertex ended further than this from where it started (object units)
+    };
+
+    struct LodLevelOptions {
+        float targetRatio; // Triangle count relative to the base mesh
+        float maxError;    // Accumulated quadric error limit, relative to the mesh extent
+    };
+
+    struct LodChainOptions {
+        std::vector<LodLevelOptions> levels = {
+            { 0.5f, 0.002f },
+            { 0.25f, 0.005f },
+            { 0.125f, 0.01f },
+            { 0.0625f, 0.02f },
+        };
+        bool lockBorders = false;
+    };
+
+    // One simplified level. Every base vertex lies within error of the LOD vertex it collapsed
+    // into, so every point of a base triangle is within error of the matching point of its
+    // (possibly degenerate) image: a conservative object-space bound for LOD selection.
+    struct MeshLod {
+        MeshData meshData;
+        float error = 0.0f;
+        float quadricError = 0.0f; // Accumulated quadric error, what LodLevelOptions::maxError limits
+    };
+
+    // Quadric error metric (Garland & Heckbert 1997) edge collapse. Vertices only collapse
+    // onto existing vertices, so normals and uvs stay exact. Vertices sharing a position
+    // (attribute seams) collapse together along the seam, and boundary/seam edges add
+    // perpendicular plane quadrics so outlines and uv borders keep their shape. The quadric
+    // cost orders and limits the collapses; next to it every vertex tracks how far the
+    // vertices merged into it have travelled, which gives a true distance bound.
+    // Simplified MeshData comes with recomputed SubMesh and MeshData bounds.
+    class MeshSimplifier {
+    public:
+        // Simplifies the triangle list of one vertex range (indices local to positions)
+        static SimplifyStatistics Simplify(std::vector<uint32_t>& indices, std::span<const glm::vec3> positions,
+            const SimplifyOptions& options, float extent);
+
+        // Simplifies every distinct range (in parallel with a pool) into a compacted MeshData
+        static MeshData Simplify(const MeshData& meshData, const SimplifyOptions& options,
+            ThreadPool* threadPool = nullptr, SimplifyStatistics* statistics = nullptr);
+
+        // Successively simplified levels; stops early when a level no longer reduces the mesh
+        static std::vector<MeshLod> BuildLodChain(const MeshData& meshData, const LodChainOptions& options = {},
+            ThreadPool* threadPool = nullptr);
+
+        // Bounding box diagonal, the reference length for relative errors
+        static float GetExtent(const MeshData& meshData);
+    };
+
+}
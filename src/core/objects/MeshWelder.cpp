@@ -0,0 +1,326 @@
+#include "MeshWelder.hpp"
+#include "Hash.hpp"
+#include "ThreadPool.hpp"
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <limits>
+
+namespace Anito3D {
+
+    namespace {
+        constexpr uint32_t NoRange = std::numeric_limits<uint32_t>::max();
+        constexpr uint32_t InvalidVertex = std::numeric_limits<uint32_t>::max();
+        constexpr size_t ChunkSize = 1 << 16;
+        constexpr size_t BucketBits = 8;
+        constexpr size_t BucketCount = size_t(1) << BucketBits;
+        constexpr size_t MaxKeyComponents = 9; // range + position + normal + uv
+
+        // Hash kept next to the vertex id so probing does not touch the hash array
+        struct TableSlot {
+            uint64_t hash = 0;
+            uint32_t vertex = InvalidVertex;
+        };
+
+        // Grid cell of a component (nearest multiple of epsilon), or its bits when epsilon is 0.
+        // Values too large for the grid also fall back to their bits, which only costs welds.
+        int64_t QuantizeComponent(float value, double inverseEpsilon) {
+            const double scaled = std::floor(value * inverseEpsilon + 0.5);
+            if (inverseEpsilon == 0.0 || !(std::abs(scaled) < 0x1p62)) {
+                value += 0.0f; // -0 and +0 weld together
+                uint32_t bits;
+                std::memcpy(&bits, &value, sizeof(bits));
+                return bits;
+            }
+            return static_cast<int64_t>(scaled);
+        }
+
+        double InverseEpsilon(float epsilon) {
+            return epsilon > 0.0f ? 1.0 / epsilon : 0.0;
+        }
+
+        // Builds the comparable key of a vertex: owning range plus the bits of every attribute
+        class VertexKeys {
+        public:
+            VertexKeys(const MeshData& meshData, const std::vector<uint32_t>& vertexRange)
+                : meshData(meshData), vertexRange(vertexRange) {}
+
+            size_t Build(size_t vertex, int64_t key[MaxKeyComponents]) const {
+                size_t count = 0;
+                key[count++] = vertexRange[vertex];
+                for (int axis = 0; axis < 3; ++axis) key[count++] = QuantizeComponent(meshData.vertices[vertex][axis], 0.0);
+                if (!meshData.normals.empty()) {
+                    for (int axis = 0; axis < 3; ++axis) key[count++] = QuantizeComponent(meshData.normals[vertex][axis], 0.0);
+                }
+                if (!meshData.texCoords.empty()) {
+                    for (int axis = 0; axis < 2; ++axis) key[count++] = QuantizeComponent(meshData.texCoords[vertex][axis], 0.0);
+                }
+                return count;
+            }
+
+            uint64_t Hash(size_t vertex) const {
+                int64_t key[MaxKeyComponents];
+                size_t count = Build(vertex, key);
+                return HashBytes(key, count * sizeof(int64_t));
+            }
+
+            bool Equal(size_t a, size_t b) const {
+                int64_t keyA[MaxKeyComponents], keyB[MaxKeyComponents];
+                size_t count = Build(a, keyA);
+                Build(b, keyB);
+                return std::memcmp(keyA, keyB, count * sizeof(int64_t)) == 0;
+            }
+
+        private:
+            const MeshData& meshData;
+            const std::vector<uint32_t>& vertexRange;
+        };
+
+        // Distance test for tolerance welds; equal components count as zero apart, so -0 == +0
+        // and infinities match themselves. NaN never matches anything.
+        bool WithinEpsilon(const float* a, const float* b, int count, float epsilon) {
+            double squared = 0.0;
+            for (int i = 0; i < count; ++i) {
+                const double difference = a[i] == b[i] ? 0.0 : double(a[i]) - double(b[i]);
+                squared += difference * difference;
+            }
+            return squared <= double(epsilon) * double(epsilon);
+        }
+
+        // Kept vertices of one range, filed by position cell (a singly linked list per cell)
+        struct CellSlot {
+            int64_t cell[3] = {};
+            uint32_t head = InvalidVertex;
+        };
+
+        // Greedy tolerance weld of one range: each vertex joins the lowest kept vertex whose
+        // position, normal and uv are each within their epsilon, otherwise it is kept itself.
+        // Cells are positionEpsilon wide, so every candidate lies in the vertex's own cell or
+        // one of its 26 neighbours; the distance test then rejects same-cell vertices that are
+        // too far apart. Comparing against kept vertices only means welds never chain.
+        void WeldRangeWithTolerance(const MeshData& meshData, const MeshData::SubMesh& range, uint32_t rangeId,
+            const std::vector<uint32_t>& vertexRange, const WeldOptions& options, std::vector<uint32_t>& representative) {
+            const double inversePosition = InverseEpsilon(options.positionEpsilon);
+            const int reach = inversePosition > 0.0 ? 1 : 0; // Bitwise cells have no neighbours
+            const bool hasNormals = !meshData.normals.empty();
+            const bool hasTexCoords = !meshData.texCoords.empty();
+
+            size_t tableSize = 1;
+            while (tableSize < size_t(range.vertexCount) * 2) tableSize <<= 1;
+            const size_t mask = tableSize - 1;
+            std::vector<CellSlot> table(tableSize);
+            std::vector<uint32_t> next(range.vertexCount, InvalidVertex);
+
+            auto findSlot = [&](const int64_t cell[3]) {
+                size_t slot = HashBytes(cell, 3 * sizeof(int64_t)) & mask;
+                while (table[slot].head != InvalidVertex && std::memcmp(table[slot].cell, cell, 3 * sizeof(int64_t)) != 0) {
+                    slot = (slot + 1) & mask;
+                }
+                return slot;
+            };
+
+            auto matches = [&](uint32_t a, uint32_t b) {
+                return WithinEpsilon(&meshData.vertices[a][0], &meshData.vertices[b][0], 3, options.positionEpsilon) &&
+                    (!hasNormals || WithinEpsilon(&meshData.normals[a][0], &meshData.normals[b][0], 3, options.normalEpsilon)) &&
+                    (!hasTexCoords || WithinEpsilon(&meshData.texCoords[a][0], &meshData.texCoords[b][0], 2, options.texCoordEpsilon));
+            };
+
+            const uint32_t end = range.vertexOffset + range.vertexCount;
+            for (uint32_t vertex = range.vertexOffset; vertex < end; ++vertex) {
+                if (vertexRange[vertex] != rangeId) continue;
+
+                int64_t cell[3];
+                for (int axis = 0; axis < 3; ++axis) cell[axis] = QuantizeComponent(meshData.vertices[vertex][axis], inversePosition);
+
+                uint32_t best = InvalidVertex;
+                for (int dz = -reach; dz <= reach; ++dz) {
+                    for (int dy = -reach; dy <= reach; ++dy) {
+                        for (int dx = -reach; dx <= reach; ++dx) {
+                            const int64_t neighbour[3] = { cell[0] + dx, cell[1] + dy, cell[2] + dz };
+                            for (uint32_t kept = table[findSlot(neighbour)].head; kept != InvalidVertex; kept = next[kept - range.vertexOffset]) {
+                                if (kept < best && matches(kept, vertex)) best = kept;
+                            }
+                        }
+                    }
+                }
+
+                if (best != InvalidVertex) {
+                    representative[vertex] = best;
+                    continue;
+                }
+                CellSlot& slot = table[findSlot(cell)];
+                std::memcpy(slot.cell, cell, sizeof(cell));
+                next[vertex - range.vertexOffset] = slot.head;
+                slot.head = vertex;
+            }
+        }
+
+        // Exact weld: vertices with bitwise equal keys merge into the lowest of them. Vertices
+        // are hashed in parallel chunks, then each hash bucket is deduplicated independently.
+        void FindExactDuplicates(const MeshData& meshData, const std::vector<uint32_t>& vertexRange, size_t chunkCount,
+            const std::function<void(size_t, const std::function<void(size_t)>&)>& parallelFor, std::vector<uint32_t>& representative) {
+            const size_t vertexCount = meshData.vertices.size();
+            VertexKeys keys(meshData, vertexRange);
+
+            // Hash every vertex and count bucket sizes per chunk
+            std::vector<uint64_t> hashes(vertexCount);
+            std::vector<uint32_t> chunkBucketCounts(chunkCount * BucketCount, 0);
+            parallelFor(chunkCount, [&](size_t chunk) {
+                uint32_t* counts = &chunkBucketCounts[chunk * BucketCount];
+                size_t end = std::min(vertexCount, (chunk + 1) * ChunkSize);
+                for (size_t v = chunk * ChunkSize; v < end; ++v) {
+                    hashes[v] = keys.Hash(v);
+                    ++counts[hashes[v] >> (64 - BucketBits)];
+                }
+            });
+
+            // Scatter vertex ids by bucket; chunks write in order so buckets stay sorted by id
+            std::vector<size_t> bucketStart(BucketCount + 1, 0);
+            std::vector<size_t> chunkBucketOffsets(chunkCount * BucketCount);
+            size_t offset = 0;
+            for (size_t bucket = 0; bucket < BucketCount; ++bucket) {
+                bucketStart[bucket] = offset;
+                for (size_t chunk = 0; chunk < chunkCount; ++chunk) {
+                    chunkBucketOffsets[chunk * BucketCount + bucket] = offset;
+                    offset += chunkBucketCounts[chunk * BucketCount + bucket];
+                }
+            }
+            bucketStart[BucketCount] = offset;
+
+            std::vector<uint32_t> order(vertexCount);
+            parallelFor(chunkCount, [&](size_t chunk) {
+                size_t* offsets = &chunkBucketOffsets[chunk * BucketCount];
+                size_t end = std::min(vertexCount, (chunk + 1) * ChunkSize);
+                for (size_t v = chunk * ChunkSize; v < end; ++v) {
+                    order[offsets[hashes[v] >> (64 - BucketBits)]++] = static_cast<uint32_t>(v);
+                }
+            });
+
+            // Deduplicate each bucket with its own open-addressing table; the first (lowest)
+            // vertex of each key becomes the representative
+            parallelFor(BucketCount, [&](size_t bucket) {
+                const size_t begin = bucketStart[bucket];
+                const size_t end = bucketStart[bucket + 1];
+                if (begin == end) return;
+
+                size_t tableSize = 1;
+                while (tableSize < (end - begin) * 2) tableSize <<= 1;
+                const size_t mask = tableSize - 1;
+                std::vector<TableSlot> table(tableSize);
+
+                for (size_t i = begin; i < end; ++i) {
+                    const uint32_t vertex = order[i];
+                    representative[vertex] = vertex;
+                    if (vertexRange[vertex] == NoRange) continue;
+
+                    const uint64_t hash = hashes[vertex];
+                    size_t slot = hash & mask;
+                    while (table[slot].vertex != InvalidVertex) {
+                        if (table[slot].hash == hash && keys.Equal(table[slot].vertex, vertex)) {
+                            representative[vertex] = table[slot].vertex;
+                            break;
+                        }
+                        slot = (slot + 1) & mask;
+                    }
+                    if (representative[vertex] == vertex) table[slot] = { hash, vertex };
+                }
+            });
+        }
+
+        template <typename T>
+        void CompactAttribute(std::vector<T>& attribute, const std::vector<uint32_t>& representative,
+            const std::vector<uint32_t>& keptBefore, size_t chunkCount, const std::function<void(size_t, const std::function<void(size_t)>&)>& parallelFor) {
+            if (attribute.empty()) return;
+
+            const size_t vertexCount = attribute.size();
+            std::vector<T> compacted(keptBefore[vertexCount]);
+            parallelFor(chunkCount, [&](size_t chunk) {
+                size_t end = std::min(vertexCount, (chunk + 1) * ChunkSize);
+                for (size_t v = chunk * ChunkSize; v < end; ++v) {
+                    if (representative[v] == v) compacted[keptBefore[v]] = attribute[v];
+                }
+            });
+            attribute = std::move(compacted);
+        }
+    }
+
+    uint64_t WeldOptions::GetHash() const {
+        const float values[3] = { positionEpsilon, normalEpsilon, texCoordEpsilon };
+        return HashBytes(values, sizeof(values));
+    }
+
+    WeldStatistics MeshWelder::Weld(MeshData& meshData, const WeldOptions& options, ThreadPool* threadPool) {
+        WeldStatistics statistics;
+        const size_t vertexCount = meshData.vertices.size();
+        statistics.verticesBefore = statistics.verticesAfter = vertexCount;
+
+        std::vector<MeshData::SubMesh> ranges = meshData.GetUniqueRanges();
+        if (vertexCount == 0 || ranges.empty() || vertexCount >= InvalidVertex) return statistics;
+
+        auto parallelFor = [threadPool](size_t count, const std::function<void(size_t)>& function) {
+            if (threadPool) {
+                threadPool->ParallelFor(count, function);
+            }
+            else {
+                for (size_t i = 0; i < count; ++i) function(i);
+            }
+        };
+
+        // Vertices only weld within their own range; vertices outside every range are kept
+        std::vector<uint32_t> vertexRange(vertexCount, NoRange);
+        for (size_t r = 0; r < ranges.size(); ++r) {
+            std::fill_n(vertexRange.begin() + ranges[r].vertexOffset, ranges[r].vertexCount, static_cast<uint32_t>(r));
+        }
+
+        const size_t chunkCount = (vertexCount + ChunkSize - 1) / ChunkSize;
+        std::vector<uint32_t> representative(vertexCount);
+        const bool tolerant = options.positionEpsilon > 0.0f || options.normalEpsilon > 0.0f || options.texCoordEpsilon > 0.0f;
+        if (tolerant) {
+            // Order dependent, so each range is walked serially; ranges run in parallel
+            for (size_t v = 0; v < vertexCount; ++v) representative[v] = static_cast<uint32_t>(v);
+            parallelFor(ranges.size(), [&](size_t r) {
+                WeldRangeWithTolerance(meshData, ranges[r], static_cast<uint32_t>(r), vertexRange, options, representative);
+            });
+        }
+        else {
+            FindExactDuplicates(meshData, vertexRange, chunkCount, parallelFor, representative);
+        }
+
+        // Kept vertices keep their relative order, so every range stays contiguous
+        std::vector<uint32_t> keptBefore(vertexCount + 1, 0);
+        for (size_t v = 0; v < vertexCount; ++v) {
+            keptBefore[v + 1] = keptBefore[v] + (representative[v] == v ? 1 : 0);
+        }
+        statistics.verticesAfter = keptBefore[vertexCount];
+        if (statistics.verticesAfter == vertexCount) return statistics;
+
+        // Rewrite indices range by range (ranges never share index storage)
+        parallelFor(ranges.size(), [&](size_t r) {
+            const MeshData::SubMesh& range = ranges[r];
+            const uint32_t newOffset = keptBefore[range.vertexOffset];
+            for (uint32_t i = 0; i < range.indexCount; ++i) {
+                const uint32_t local = meshData.GetIndex(range, i);
+                if (local >= range.vertexCount) continue;
+                const uint32_t welded = keptBefore[representative[range.vertexOffset + local]] - newOffset;
+                if (range.indexType == MeshData::IndexType::Uint16) {
+                    meshData.indices16[range.firstIndex + i] = static_cast<uint16_t>(welded);
+                }
+                else {
+                    meshData.indices[range.firstIndex + i] = welded;
+                }
+            }
+        });
+
+        CompactAttribute(meshData.vertices, representative, keptBefore, chunkCount, parallelFor);
+        CompactAttribute(meshData.normals, representative, keptBefore, chunkCount, parallelFor);
+        CompactAttribute(meshData.texCoords, representative, keptBefore, chunkCount, parallelFor);
+
+        for (auto& subMesh : meshData.subMeshes) {
+            if (static_cast<size_t>(subMesh.vertexOffset) + subMesh.vertexCount > vertexCount) continue;
+            const uint32_t newOffset = keptBefore[subMesh.vertexOffset];
+            subMesh.vertexCount = keptBefore[subMesh.vertexOffset + subMesh.vertexCount] - newOffset;
+            subMesh.vertexOffset = newOffset;
+        }
+        return statistics;
+    }
+}
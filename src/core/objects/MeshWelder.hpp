@@ -0,0 +1,36 @@
+#pragma once
+
+#include "MeshData.hpp"
+#include <cstdint>
+
+namespace Anito3D {
+
+    class ThreadPool;
+
+    struct WeldOptions {
+        // Tolerance welding: a vertex merges into an earlier kept vertex of its range when the
+        // distances between their positions, normals and uvs are each at most the matching
+        // epsilon. Candidates are found by probing the vertex's position cell and its neighbours.
+        // All zero requires bitwise equality (with -0 == +0) and takes the parallel exact path.
+        float positionEpsilon = 0.0f;
+        float normalEpsilon = 0.0f;
+        float texCoordEpsilon = 0.0f;
+
+        uint64_t GetHash() const;
+    };
+
+    struct WeldStatistics {
+        uint64_t verticesBefore = 0;
+        uint64_t verticesAfter = 0;
+    };
+
+    // Merges duplicate vertices (same position, normal and uv) inside each submesh range and
+    // compacts the shared vertex arrays. Exact welds hash vertices in parallel chunks, then
+    // deduplicate each hash bucket independently, so the pass scales with the thread pool.
+    // Tolerance welds depend on vertex order and run one range per task.
+    class MeshWelder {
+    public:
+        static WeldStatistics Weld(MeshData& meshData, const WeldOptions& options = {}, ThreadPool* threadPool = nullptr);
+    };
+
+}
@@ -0,0 +1,195 @@
+#include "MeshletBuilder.hpp"
+#include "ThreadPool.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+
+namespace Anito3D {
+
+    namespace {
+        constexpr uint32_t InvalidIndex = std::numeric_limits<uint32_t>::max();
+        constexpr uint8_t NoSlot = 0xFF;
+        constexpr uint32_t MaxMeshletVertices = NoSlot; // Slots 0..254, 255 marks an unplaced vertex
+        constexpr float MinConeSpread = 0.1f; // Smallest normal/axis cosine that still allows a cone
+
+        // Builds the meshlets of one range; offsets are local to the returned arrays
+        MeshletData BuildRange(const MeshData& meshData, const MeshData::SubMesh& range, const MeshletBuildOptions& options) {
+            MeshletData result;
+            const size_t triangleCount = range.indexCount / 3;
+            const uint32_t vertexCount = range.vertexCount;
+
+            std::vector<uint32_t> indices(triangleCount * 3);
+            for (size_t i = 0; i < indices.size(); ++i) indices[i] = meshData.GetIndex(range, i);
+            if (std::any_of(indices.begin(), indices.end(), [&](uint32_t index) { return index >= vertexCount; })) {
+                return result;
+            }
+
+            // Triangles around each vertex (CSR) and how many of them are still unassigned
+            std::vector<uint32_t> liveTriangles(vertexCount, 0);
+            for (uint32_t index : indices) ++liveTriangles[index];
+            std::vector<uint32_t> adjacencyOffsets(vertexCount + 1, 0);
+            std::partial_sum(liveTriangles.begin(), liveTriangles.end(), adjacencyOffsets.begin() + 1);
+            std::vector<uint32_t> adjacency(indices.size());
+            std::vector<uint32_t> fill(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+            for (size_t i = 0; i < indices.size(); ++i) adjacency[fill[indices[i]]++] = static_cast<uint32_t>(i / 3);
+
+            std::vector<uint8_t> assigned(triangleCount, 0);
+            std::vector<uint8_t> slot(vertexCount, NoSlot);
+            const uint32_t maxVertices = std::clamp(options.maxVertices, 3u, MaxMeshletVertices);
+            const uint32_t maxTriangles = std::clamp(options.maxTriangles, 1u, 512u);
+            std::span<const glm::vec3> positions(meshData.vertices.data() + range.vertexOffset, vertexCount);
+
+            size_t seed = 0;
+            while (true) {
+                while (seed < triangleCount && assigned[seed]) ++seed;
+                if (seed == triangleCount) break;
+
+                Meshlet meshlet{ static_cast<uint32_t>(result.vertices.size()), static_cast<uint32_t>(result.triangles.size()), 0, 0 };
+                auto addTriangle = [&](size_t triangle) {
+                    for (int k = 0; k < 3; ++k) {
+                        const uint32_t vertex = indices[triangle * 3 + k];
+                        if (slot[vertex] == NoSlot) {
+                            slot[vertex] = static_cast<uint8_t>(meshlet.vertexCount++);
+                            result.vertices.push_back(vertex);
+                        }
+                        result.triangles.push_back(slot[vertex]);
+                        --liveTriangles[vertex];
+                    }
+                    assigned[triangle] = 1;
+                    ++meshlet.triangleCount;
+                };
+
+                addTriangle(seed);
+                while (meshlet.triangleCount < maxTriangles) {
+                    // Neighbour that adds the fewest vertices; ties go to triangles whose vertices
+                    // have few unassigned triangles left, which keeps the remaining surface compact
+                    size_t best = InvalidIndex;
+                    uint64_t bestScore = std::numeric_limits<uint64_t>::max();
+                    for (uint32_t i = 0; i < meshlet.vertexCount && bestScore > 0; ++i) {
+                        const uint32_t vertex = result.vertices[meshlet.vertexOffset + i];
+                        if (liveTriangles[vertex] == 0) continue;
+                        for (uint32_t a = adjacencyOffsets[vertex]; a < adjacencyOffsets[vertex + 1]; ++a) {
+                            const uint32_t triangle = adjacency[a];
+                            if (assigned[triangle]) continue;
+                            uint32_t extra = 0;
+                            uint32_t live = 0;
+                            for (int k = 0; k < 3; ++k) {
+                                const uint32_t corner = indices[triangle * 3 + k];
+                                extra += slot[corner] == NoSlot;
+                                live += liveTriangles[corner];
+                            }
+                            if (meshlet.vertexCount + extra > maxVertices) continue;
+                            const uint64_t score = (static_cast<uint64_t>(extra) << 32) | live;
+                            if (score < bestScore) {
+                                bestScore = score;
+                                best = triangle;
+                            }
+                        }
+                    }
+                    if (best == InvalidIndex) break;
+                    addTriangle(best);
+                }
+
+                for (uint32_t i = 0; i < meshlet.vertexCount; ++i) slot[result.vertices[meshlet.vertexOffset + i]] = NoSlot;
+                result.meshlets.push_back(meshlet);
+                result.bounds.push_back(MeshletBuilder::ComputeBounds(result, meshlet, positions));
+            }
+            return result;
+        }
+    }
+
+    MeshletData MeshletBuilder::Build(const MeshData& meshData, const MeshletBuildOptions& options, ThreadPool* threadPool) {
+        const std::vector<MeshData::SubMesh> ranges = meshData.GetUniqueRanges();
+
+        std::vector<MeshletData> perRange(ranges.size());
+        auto buildRange = [&](size_t r) { perRange[r] = BuildRange(meshData, ranges[r], options); };
+        if (threadPool) {
+            threadPool->ParallelFor(ranges.size(), buildRange);
+        }
+        else {
+            for (size_t r = 0; r < ranges.size(); ++r) buildRange(r);
+        }
+
+        MeshletData meshletData;
+        meshletData.ranges.resize(ranges.size());
+        for (size_t r = 0; r < ranges.size(); ++r) {
+            MeshletData& part = perRange[r];
+            const uint32_t vertexBase = static_cast<uint32_t>(meshletData.vertices.size());
+            const uint32_t triangleBase = static_cast<uint32_t>(meshletData.triangles.size());
+            meshletData.ranges[r] = { static_cast<uint32_t>(meshletData.meshlets.size()), static_cast<uint32_t>(part.meshlets.size()) };
+            for (Meshlet meshlet : part.meshlets) {
+                meshlet.vertexOffset += vertexBase;
+                meshlet.triangleOffset += triangleBase;
+                meshletData.meshlets.push_back(meshlet);
+            }
+            meshletData.bounds.insert(meshletData.bounds.end(), part.bounds.begin(), part.bounds.end());
+            meshletData.vertices.insert(meshletData.vertices.end(), part.vertices.begin(), part.vertices.end());
+            meshletData.triangles.insert(meshletData.triangles.end(), part.triangles.begin(), part.triangles.end());
+        }
+
+        meshletData.subMeshRanges.reserve(meshData.subMeshes.size());
+        for (const auto& subMesh : meshData.subMeshes) {
+            size_t found = MeshData::FindRange(ranges, subMesh);
+            meshletData.subMeshRanges.push_back(found == ranges.size() ? InvalidIndex : static_cast<uint32_t>(found));
+        }
+        return meshletData;
+    }
+
+    MeshletBounds MeshletBuilder::ComputeBounds(const MeshletData& meshletData, const Meshlet& meshlet,
+        std::span<const glm::vec3> positions) {
+        MeshletBounds bounds;
+        if (meshlet.vertexCount == 0) return bounds;
+
+        auto position = [&](uint32_t local) { return positions[meshletData.vertices[meshlet.vertexOffset + local]]; };
+
+        // Sphere around the box center
+        glm::vec3 minBounds = position(0);
+        glm::vec3 maxBounds = minBounds;
+        for (uint32_t i = 1; i < meshlet.vertexCount; ++i) {
+            minBounds = glm::min(minBounds, position(i));
+            maxBounds = glm::max(maxBounds, position(i));
+        }
+        bounds.center = (minBounds + maxBounds) * 0.5f;
+        for (uint32_t i = 0; i < meshlet.vertexCount; ++i) {
+            bounds.radius = std::max(bounds.radius, glm::length(position(i) - bounds.center));
+        }
+        bounds.coneApex = bounds.center;
+
+        // Normal cone: average direction and the widest deviation from it
+        std::vector<glm::vec3> normals;
+        normals.reserve(meshlet.triangleCount);
+        std::vector<glm::vec3> corners;
+        corners.reserve(meshlet.triangleCount);
+        glm::vec3 axis(0.0f);
+        for (uint32_t t = 0; t < meshlet.triangleCount; ++t) {
+            const uint8_t* triangle = &meshletData.triangles[meshlet.triangleOffset + t * 3];
+            const glm::vec3 p0 = position(triangle[0]);
+            glm::vec3 normal = glm::cross(position(triangle[1]) - p0, position(triangle[2]) - p0);
+            float length = glm::length(normal);
+            if (length <= 0.0f) continue;
+            normal /= length;
+            normals.push_back(normal);
+            corners.push_back(p0);
+            axis += normal;
+        }
+        const float axisLength = glm::length(axis);
+        if (normals.empty() || axisLength <= 1e-6f) return bounds;
+        axis /= axisLength;
+
+        float minCosine = 1.0f;
+        for (const glm::vec3& normal : normals) minCosine = std::min(minCosine, glm::dot(normal, axis));
+        bounds.coneAxis = axis;
+        if (minCosine <= MinConeSpread) return bounds;
+
+        // Move the apex back along the axis until it lies behind every triangle plane
+        float maxT = 0.0f;
+        for (size_t i = 0; i < normals.size(); ++i) {
+            const float distance = glm::dot(bounds.center - corners[i], normals[i]);
+            maxT = std::max(maxT, distance / glm::dot(axis, normals[i]));
+        }
+        bounds.coneApex = bounds.center - axis * maxT;
+        bounds.coneCutoff = std::sqrt(1.0f - minCosine * minCosine);
+        return bounds;
+    }
+}
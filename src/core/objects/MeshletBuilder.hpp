@@ -0,0 +1,67 @@
+#pragma once
+
+#include "MeshData.hpp"
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace Anito3D {
+
+    class ThreadPool;
+
+    struct Meshlet {
+        uint32_t vertexOffset;   // First entry in MeshletData::vertices
+        uint32_t triangleOffset; // First byte in MeshletData::triangles
+        uint32_t vertexCount;
+        uint32_t triangleCount;
+    };
+
+    // Culling bounds of one meshlet in the object space of its range
+    struct MeshletBounds {
+        glm::vec3 center{ 0.0f }; // Bounding sphere
+        float radius = 0.0f;
+        glm::vec3 coneApex{ 0.0f };            // Backface cone: the meshlet faces away from every camera with
+        glm::vec3 coneAxis{ 0.0f, 0.0f, 1.0f }; // dot(normalize(coneApex - camera), coneAxis) >= coneCutoff
+        float coneCutoff = 1.0f;               // 1 = normals too spread to cull
+    };
+
+    // Meshlets of every distinct range of a MeshData. Instanced submeshes share the
+    // meshlets of their range; bounds are culled per instance.
+    struct MeshletData {
+        struct Range {
+            uint32_t firstMeshlet = 0;
+            uint32_t meshletCount = 0;
+        };
+
+        std::vector<Meshlet> meshlets;
+        std::vector<MeshletBounds> bounds; // One per meshlet
+        std::vector<uint32_t> vertices;    // Range-local vertex indices (add the submesh's vertexOffset)
+        std::vector<uint8_t> triangles;    // Meshlet-local vertex indices, 3 per triangle
+        std::vector<Range> ranges;         // Parallel to MeshData::GetUniqueRanges()
+        std::vector<uint32_t> subMeshRanges; // Range of each MeshData submesh (UINT32_MAX if none)
+
+        size_t GetTriangleCount() const { return triangles.size() / 3; }
+        size_t GetMemory() const {
+            return meshlets.size() * sizeof(Meshlet) + bounds.size() * sizeof(MeshletBounds) +
+                vertices.size() * sizeof(uint32_t) + triangles.size();
+        }
+    };
+
+    struct MeshletBuildOptions {
+        uint32_t maxVertices = 64;   // At most 255 (local indices are 8-bit, 0xFF is reserved)
+        uint32_t maxTriangles = 124; // 124 keeps the primitive index block of a 64/124 meshlet under 512 bytes
+    };
+
+    // Greedy clustering: each meshlet starts at the next unassigned triangle (cache-ordered
+    // input gives compact seeds) and grows through neighbouring triangles, preferring the
+    // ones that add the fewest new vertices.
+    class MeshletBuilder {
+    public:
+        static MeshletData Build(const MeshData& meshData, const MeshletBuildOptions& options = {},
+            ThreadPool* threadPool = nullptr);
+
+        static MeshletBounds ComputeBounds(const MeshletData& meshletData, const Meshlet& meshlet,
+            std::span<const glm::vec3> positions);
+    };
+
+}
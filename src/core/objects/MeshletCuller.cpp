@@ -0,0 +1,53 @@
+#include "MeshletCuller.hpp"
+
+namespace Anito3D {
+
+    void MeshletCuller::Cull(const MeshData& meshData, const MeshletData& meshletData, const glm::mat4& model,
+        const Frustum& frustum, const glm::vec3& cameraPosition, std::vector<VisibleMeshlet>& visible,
+        MeshletCullStatistics* statistics) {
+        MeshletCullStatistics counts;
+
+        for (size_t s = 0; s < meshData.subMeshes.size() && s < meshletData.subMeshRanges.size(); ++s) {
+            const uint32_t rangeIndex = meshletData.subMeshRanges[s];
+            if (rangeIndex >= meshletData.ranges.size()) continue;
+            const MeshletData::Range& range = meshletData.ranges[rangeIndex];
+
+            const glm::mat4 objectToWorld = model * meshData.subMeshes[s].transform;
+            const Frustum objectFrustum = frustum.Transform(objectToWorld);
+            const glm::vec3 camera = glm::vec3(glm::inverse(objectToWorld) * glm::vec4(cameraPosition, 1.0f));
+
+            const uint32_t end = range.firstMeshlet + range.meshletCount;
+            for (uint32_t m = range.firstMeshlet; m < end; ++m) {
+                const MeshletBounds& bounds = meshletData.bounds[m];
+                const uint32_t triangles = meshletData.meshlets[m].triangleCount;
+                counts.meshlets++;
+                counts.triangles += triangles;
+
+                if (!objectFrustum.IntersectsSphere(bounds.center, bounds.radius)) {
+                    counts.meshletsFrustumCulled++;
+                    counts.trianglesFrustumCulled += triangles;
+                    continue;
+                }
+                if (bounds.coneCutoff < 1.0f) {
+                    const glm::vec3 toApex = bounds.coneApex - camera;
+                    const float distance = glm::length(toApex);
+                    if (distance > 0.0f && glm::dot(toApex, bounds.coneAxis) >= bounds.coneCutoff * distance) {
+                        counts.meshletsBackfaceCulled++;
+                        counts.trianglesBackfaceCulled += triangles;
+                        continue;
+                    }
+                }
+                visible.push_back({ static_cast<uint32_t>(s), m });
+            }
+        }
+
+        if (statistics) {
+            statistics->meshlets += counts.meshlets;
+            statistics->meshletsFrustumCulled += counts.meshletsFrustumCulled;
+            statistics->meshletsBackfaceCulled += counts.meshletsBackfaceCulled;
+            statistics->triangles += counts.triangles;
+            statistics->trianglesFrustumCulled += counts.trianglesFrustumCulled;
+            statistics->trianglesBackfaceCulled += counts.trianglesBackfaceCulled;
+        }
+    }
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include "Frustum.hpp"
+#include "MeshletBuilder.hpp"
+#include <cstdint>
+#include <vector>
+
+namespace Anito3D {
+
+    struct VisibleMeshlet {
+        uint32_t subMesh; // Index into MeshData::subMeshes (selects the instance transform)
+        uint32_t meshlet; // Index into MeshletData::meshlets
+    };
+
+    struct MeshletCullStatistics {
+        uint64_t meshlets = 0;
+        uint64_t meshletsFrustumCulled = 0;
+        uint64_t meshletsBackfaceCulled = 0;
+        uint64_t triangles = 0;
+        uint64_t trianglesFrustumCulled = 0;
+        uint64_t trianglesBackfaceCulled = 0;
+
+        double GetRejectedTriangleRatio() const {
+            return triangles ? static_cast<double>(trianglesFrustumCulled + trianglesBackfaceCulled) / triangles : 0.0;
+        }
+    };
+
+    // CPU cluster culling: bounding sphere against the frustum, then the normal cone against
+    // the camera position. Tests run in each submesh's object space, which is exact for rigid
+    // and uniformly scaled instances.
+    class MeshletCuller {
+    public:
+        // Appends the surviving meshlets of every submesh to visible (not cleared)
+        static void Cull(const MeshData& meshData, const MeshletData& meshletData, const glm::mat4& model,
+            const Frustum& frustum, const glm::vec3& cameraPosition, std::vector<VisibleMeshlet>& visible,
+            MeshletCullStatistics* statistics = nullptr);
+    };
+
+}
@@ -0,0 +1,253 @@
+#include "SceneGraph.hpp"
+#include "ThreadPool.hpp"
+#include <algorithm>
+#include <utility>
+
+namespace Anito3D {
+
+    SceneNodeId SceneGraph::CreateNode(SceneNodeId parent, const glm::mat4& localTransform) {
+        SceneNodeId id;
+        if (!freeIds.empty()) {
+            id = freeIds.back();
+            freeIds.pop_back();
+        }
+        else {
+            id = static_cast<SceneNodeId>(slots.size());
+            slots.push_back(InvalidSlot);
+            parents.push_back(InvalidNode);
+        }
+
+        // Appended out of order; the next Update() sorts it into its parent's subtree
+        const uint32_t slot = static_cast<uint32_t>(ids.size());
+        slots[id] = slot;
+        parents[id] = IsValid(parent) ? parent : InvalidNode;
+        ids.push_back(id);
+        parentSlots.push_back(InvalidSlot);
+        subtreeEnds.push_back(slot + 1);
+        localTransforms.push_back(localTransform);
+        worldTransforms.push_back(localTransform);
+        dirtyFlags.push_back(0);
+        nodeCount++;
+        orderDirty = true;
+        return id;
+    }
+
+    void SceneGraph::DestroyNode(SceneNodeId node) {
+        DestroyNodes(std::span<const SceneNodeId>(&node, 1));
+    }
+
+    void SceneGraph::DestroyNodes(std::span<const SceneNodeId> nodes) {
+        std::vector<uint8_t> destroyed(slots.size(), 0);
+        bool any = false;
+        for (SceneNodeId node : nodes) {
+            if (!IsValid(node)) continue;
+            ids[slots[node]] = InvalidNode;
+            slots[node] = InvalidSlot;
+            destroyed[node] = 1;
+            freeIds.push_back(node);
+            nodeCount--;
+            any = true;
+        }
+        if (!any) return;
+
+        // Re-link survivors whose parent went away, then forget the links of the dead
+        for (SceneNodeId id = 0; id < parents.size(); ++id) {
+            if (!IsValid(id)) continue;
+            SceneNodeId parent = parents[id];
+            while (parent != InvalidNode && destroyed[parent]) parent = parents[parent];
+            parents[id] = parent;
+        }
+        for (SceneNodeId id = 0; id < parents.size(); ++id) {
+            if (destroyed[id]) parents[id] = InvalidNode;
+        }
+        orderDirty = true;
+    }
+
+    void SceneGraph::Clear() {
+        slots.clear();
+        parents.clear();
+        freeIds.clear();
+        ids.clear();
+        parentSlots.clear();
+        subtreeEnds.clear();
+        localTransforms.clear();
+        worldTransforms.clear();
+        dirtyFlags.clear();
+        dirtySlots.clear();
+        nodeCount = 0;
+        maxDepth = 0;
+        orderDirty = false;
+    }
+
+    bool SceneGraph::SetParent(SceneNodeId node, SceneNodeId parent) {
+        if (!IsValid(node)) return false;
+        if (!IsValid(parent)) parent = InvalidNode;
+        for (SceneNodeId ancestor = parent; ancestor != InvalidNode; ancestor = parents[ancestor]) {
+            if (ancestor == node) return false;
+        }
+        if (parents[node] != parent) {
+            parents[node] = parent;
+            orderDirty = true;
+        }
+        return true;
+    }
+
+    void SceneGraph::SetLocalTransform(SceneNodeId node, const glm::mat4& localTransform) {
+        const uint32_t slot = slots[node];
+        localTransforms[slot] = localTransform;
+        MarkDirty(slot);
+    }
+
+    void SceneGraph::MarkDirty(uint32_t slot) {
+        if (!dirtyFlags[slot]) {
+            dirtyFlags[slot] = 1;
+            dirtySlots.push_back(slot);
+        }
+    }
+
+    std::vector<SceneNodeId> SceneGraph::AddHierarchy(std::span<const MeshData::Node> nodes, SceneNodeId parent) {
+        std::vector<SceneNodeId> created(nodes.size(), InvalidNode);
+        for (size_t i = 0; i < nodes.size(); ++i) {
+            const uint32_t source = nodes[i].parent;
+            const SceneNodeId nodeParent = source < i ? created[source] : parent;
+            created[i] = CreateNode(nodeParent, nodes[i].localTransform);
+        }
+        return created;
+    }
+
+    void SceneGraph::Sort() {
+        // Children per id in id order, so imported hierarchies keep their file order
+        std::vector<uint32_t> childOffsets(parents.size() + 1, 0);
+        std::vector<SceneNodeId> roots;
+        for (SceneNodeId id = 0; id < parents.size(); ++id) {
+            if (!IsValid(id)) continue;
+            if (parents[id] == InvalidNode) roots.push_back(id);
+            else childOffsets[parents[id] + 1]++;
+        }
+        for (size_t i = 1; i < childOffsets.size(); ++i) childOffsets[i] += childOffsets[i - 1];
+        std::vector<SceneNodeId> children(childOffsets.back());
+        std::vector<uint32_t> fill(childOffsets.begin(), childOffsets.end() - 1);
+        for (SceneNodeId id = 0; id < parents.size(); ++id) {
+            if (IsValid(id) && parents[id] != InvalidNode) children[fill[parents[id]]++] = id;
+        }
+
+        std::vector<SceneNodeId> sortedIds;
+        std::vector<uint32_t> sortedParents;
+        std::vector<glm::mat4> sortedLocals;
+        sortedIds.reserve(nodeCount);
+        sortedParents.reserve(nodeCount);
+        sortedLocals.reserve(nodeCount);
+        std::vector<uint32_t> newSlots(slots.size(), InvalidSlot);
+        std::vector<uint32_t> depths;
+        depths.reserve(nodeCount);
+
+        // Iterative pre-order walk (hierarchies can be far deeper than the call stack allows)
+        std::vector<std::pair<SceneNodeId, uint32_t>> stack;
+        for (size_t r = roots.size(); r > 0; --r) stack.emplace_back(roots[r - 1], 0);
+        maxDepth = 0;
+        while (!stack.empty()) {
+            auto [id, depth] = stack.back();
+            stack.pop_back();
+
+            const uint32_t slot = static_cast<uint32_t>(sortedIds.size());
+            newSlots[id] = slot;
+            sortedIds.push_back(id);
+            sortedParents.push_back(parents[id] == InvalidNode ? InvalidSlot : newSlots[parents[id]]);
+            sortedLocals.push_back(localTransforms[slots[id]]);
+            depths.push_back(depth);
+            maxDepth = std::max(maxDepth, depth);
+
+            for (uint32_t c = childOffsets[id + 1]; c > childOffsets[id]; --c) stack.emplace_back(children[c - 1], depth + 1);
+        }
+
+        const uint32_t count = static_cast<uint32_t>(sortedIds.size());
+        subtreeEnds.resize(count);
+        for (uint32_t slot = 0; slot < count; ++slot) subtreeEnds[slot] = slot + 1;
+        for (uint32_t slot = count; slot > 0; --slot) {
+            const uint32_t parent = sortedParents[slot - 1];
+            if (parent != InvalidSlot) subtreeEnds[parent] = std::max(subtreeEnds[parent], subtreeEnds[slot - 1]);
+        }
+
+        slots = std::move(newSlots);
+        ids = std::move(sortedIds);
+        parentSlots = std::move(sortedParents);
+        localTransforms = std::move(sortedLocals);
+        worldTransforms.resize(count);
+        dirtyFlags.assign(count, 0);
+        dirtySlots.clear();
+        orderDirty = false;
+    }
+
+    void SceneGraph::SplitSubtree(uint32_t slot, bool split, std::vector<uint32_t>& ranges) {
+        // Small subtrees become one range; large ones compute their root here and hand their
+        // child subtrees on. Adjacent siblings are merged back into ranges of useful size.
+        std::vector<uint32_t> pending{ slot };
+        while (!pending.empty()) {
+            const uint32_t first = pending.back();
+            pending.pop_back();
+            const uint32_t end = subtreeEnds[first];
+
+            if (!split || end - first <= SplitThreshold) {
+                if (!ranges.empty() && ranges.back() == first && end - ranges[ranges.size() - 2] <= SplitThreshold) {
+                    ranges.back() = end;
+                }
+                else {
+                    ranges.push_back(first);
+                    ranges.push_back(end);
+                }
+                continue;
+            }
+
+            UpdateRange(first, first + 1);
+            const size_t childrenStart = pending.size();
+            for (uint32_t child = first + 1; child < end; child = subtreeEnds[child]) pending.push_back(child);
+            std::reverse(pending.begin() + childrenStart, pending.end());
+        }
+    }
+
+    void SceneGraph::UpdateRange(uint32_t first, uint32_t end) {
+        for (uint32_t slot = first; slot < end; ++slot) {
+            const uint32_t parent = parentSlots[slot];
+            worldTransforms[slot] = parent == InvalidSlot ? localTransforms[slot] : worldTransforms[parent] * localTransforms[slot];
+        }
+    }
+
+    SceneGraphUpdateStatistics SceneGraph::Update(ThreadPool* threadPool) {
+        SceneGraphUpdateStatistics statistics;
+
+        // Topmost dirty slots; anything inside an earlier dirty subtree is covered by it
+        std::vector<uint32_t> roots;
+        if (orderDirty) {
+            Sort();
+            statistics.rebuilt = true;
+            for (uint32_t slot = 0; slot < ids.size(); slot = subtreeEnds[slot]) roots.push_back(slot);
+        }
+        else {
+            std::sort(dirtySlots.begin(), dirtySlots.end());
+            uint32_t coveredEnd = 0;
+            for (uint32_t slot : dirtySlots) {
+                dirtyFlags[slot] = 0;
+                if (slot < coveredEnd) continue;
+                roots.push_back(slot);
+                coveredEnd = subtreeEnds[slot];
+            }
+            dirtySlots.clear();
+        }
+
+        for (uint32_t root : roots) statistics.nodesUpdated += subtreeEnds[root] - root;
+        statistics.dirtySubtrees = roots.size();
+
+        const bool split = threadPool && threadPool->GetThreadCount() > 0 && statistics.nodesUpdated > SplitThreshold;
+        std::vector<uint32_t> ranges; // first/end pairs
+        for (uint32_t root : roots) SplitSubtree(root, split, ranges);
+        statistics.tasks = ranges.size() / 2;
+
+        if (split && statistics.tasks > 1) {
+            threadPool->ParallelFor(statistics.tasks, [&](size_t task) { UpdateRange(ranges[task * 2], ranges[task * 2 + 1]); });
+        }
+        else {
+            for (size_t task = 0; task < statistics.tasks; ++task) UpdateRange(ranges[task * 2], ranges[task * 2 + 1]);
+        }
+        return statistics;
+    }
+}
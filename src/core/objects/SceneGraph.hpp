@@ -0,0 +1,85 @@
+#pragma once
+
+#include "MeshData.hpp"
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <vector>
+
+namespace Anito3D {
+
+    class ThreadPool;
+
+    using SceneNodeId = uint32_t;
+
+    struct SceneGraphUpdateStatistics {
+        uint64_t nodesUpdated = 0;
+        uint64_t dirtySubtrees = 0; // Topmost changed nodes
+        uint64_t tasks = 0;         // Independent subtree ranges handed to the workers
+        bool rebuilt = false;       // Hierarchy changed, slots were re-sorted
+    };
+
+    // Parent/child hierarchy of local transforms. Nodes are addressed by stable ids while the
+    // transforms live in flat arrays sorted in pre-order: every subtree is the contiguous slot
+    // range [slot, subtreeEnd) and parents are always computed before their children.
+    // Update() only walks the subtrees below nodes whose local transform changed; with a pool
+    // large subtrees are split into their (independent) child subtrees.
+    class SceneGraph {
+    public:
+        static constexpr SceneNodeId InvalidNode = std::numeric_limits<SceneNodeId>::max();
+
+        SceneNodeId CreateNode(SceneNodeId parent = InvalidNode, const glm::mat4& localTransform = glm::mat4(1.0f));
+        // Children of destroyed nodes move up to the closest surviving ancestor
+        void DestroyNode(SceneNodeId node);
+        void DestroyNodes(std::span<const SceneNodeId> nodes);
+        bool IsValid(SceneNodeId node) const { return node < slots.size() && slots[node] != InvalidSlot; }
+        void Clear();
+
+        // Fails (returns false) when parent is the node itself or one of its descendants
+        bool SetParent(SceneNodeId node, SceneNodeId parent);
+        SceneNodeId GetParent(SceneNodeId node) const { return parents[node]; }
+
+        void SetLocalTransform(SceneNodeId node, const glm::mat4& localTransform);
+        const glm::mat4& GetLocalTransform(SceneNodeId node) const { return localTransforms[slots[node]]; }
+        // Current as of the last Update()
+        const glm::mat4& GetWorldTransform(SceneNodeId node) const { return worldTransforms[slots[node]]; }
+
+        // Adds an imported hierarchy (pre-order MeshData::nodes) below parent; returns the
+        // id assigned to each source node
+        std::vector<SceneNodeId> AddHierarchy(std::span<const MeshData::Node> nodes, SceneNodeId parent = InvalidNode);
+
+        size_t GetNodeCount() const { return nodeCount; }
+        uint32_t GetMaxDepth() const { return maxDepth; } // As of the last re-sort
+        size_t GetDirtyCount() const { return dirtySlots.size(); }
+
+        SceneGraphUpdateStatistics Update(ThreadPool* threadPool = nullptr);
+
+    private:
+        static constexpr uint32_t InvalidSlot = std::numeric_limits<uint32_t>::max();
+        static constexpr uint32_t SplitThreshold = 2048; // Subtrees above this size are split for the pool
+
+        // Per id
+        std::vector<uint32_t> slots; // InvalidSlot for free ids
+        std::vector<SceneNodeId> parents;
+        std::vector<SceneNodeId> freeIds;
+
+        // Per slot, in pre-order once sorted
+        std::vector<SceneNodeId> ids;
+        std::vector<uint32_t> parentSlots;
+        std::vector<uint32_t> subtreeEnds;
+        std::vector<glm::mat4> localTransforms;
+        std::vector<glm::mat4> worldTransforms;
+        std::vector<uint8_t> dirtyFlags;
+        std::vector<uint32_t> dirtySlots;
+
+        size_t nodeCount = 0;
+        uint32_t maxDepth = 0;
+        bool orderDirty = false;
+
+        void MarkDirty(uint32_t slot);
+        void Sort();
+        void SplitSubtree(uint32_t slot, bool split, std::vector<uint32_t>& ranges);
+        void UpdateRange(uint32_t first, uint32_t end);
+    };
+
+}
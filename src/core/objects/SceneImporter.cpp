@@ -0,0 +1,190 @@
+#include "SceneImporter.hpp"
+#include "MeshBounds.hpp"
+#include "ThreadPool.hpp"
+#include "Trace.hpp"
+#include <iostream>
+#include <utility>
+
+namespace Anito3D {
+
+    bool SceneImporter::Import(const std::string& filePath, MeshData& meshData, unsigned int importFlags, ThreadPool* threadPool) {
+        ANITO3D_TRACE_ZONE("SceneImporter::Import");
+        Assimp::Importer importer;
+        const aiScene* scene = nullptr;
+        {
+            ANITO3D_TRACE_ZONE("Assimp::ReadFile");
+            scene = importer.ReadFile(filePath, importFlags);
+        }
+
+        if (!scene || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !scene->mRootNode) {
+            std::cerr << "Assimp error: " << importer.GetErrorString() << std::endl;
+            return false;
+        }
+
+        ProcessScene(scene, meshData, threadPool);
+        return true;
+    }
+
+    void SceneImporter::ProcessScene(const aiScene* scene, MeshData& meshData, ThreadPool* threadPool) {
+        meshData.Clear();
+
+        // Lay out every source mesh once; instances reference the same range
+        std::vector<MeshRange> ranges(scene->mNumMeshes);
+        size_t totalVertices = 0;
+        size_t totalIndices = 0;
+        bool hasNormals = false;
+        bool hasTexCoords = false;
+        for (unsigned int i = 0; i < scene->mNumMeshes; ++i) {
+            const aiMesh* mesh = scene->mMeshes[i];
+            ranges[i].firstIndex = static_cast<uint32_t>(totalIndices);
+            ranges[i].indexCount = CountTriangles(mesh) * 3;
+            ranges[i].vertexOffset = static_cast<uint32_t>(totalVertices);
+            ranges[i].vertexCount = mesh->mNumVertices;
+            totalVertices += mesh->mNumVertices;
+            totalIndices += ranges[i].indexCount;
+            hasNormals |= mesh->mNormals != nullptr;
+            hasTexCoords |= mesh->mTextureCoords[0] != nullptr;
+        }
+
+        // One allocation per attribute for the whole file
+        meshData.vertices.resize(totalVertices);
+        meshData.normals.resize(hasNormals ? totalVertices : 0);
+        meshData.texCoords.resize(hasTexCoords ? totalVertices : 0);
+        meshData.indices.resize(totalIndices);
+
+        // Ranges are disjoint, so meshes can be written concurrently
+        if (threadPool) {
+            threadPool->ParallelFor(scene->mNumMeshes, [&](size_t i) {
+                ProcessMesh(scene->mMeshes[i], ranges[i], meshData);
+            });
+        }
+        else {
+            for (unsigned int i = 0; i < scene->mNumMeshes; ++i) {
+                ProcessMesh(scene->mMeshes[i], ranges[i], meshData);
+            }
+        }
+
+        std::vector<MeshInstance> instances;
+        CollectInstances(scene->mRootNode, meshData.nodes, instances);
+
+        meshData.subMeshes.reserve(instances.size());
+        for (const auto& instance : instances) {
+            if (instance.meshIndex >= scene->mNumMeshes) continue;
+            const MeshRange& range = ranges[instance.meshIndex];
+            if (range.indexCount == 0) continue; // Point/line only meshes
+
+            MeshData::SubMesh subMesh;
+            subMesh.firstIndex = range.firstIndex;
+            subMesh.indexCount = range.indexCount;
+            subMesh.vertexOffset = range.vertexOffset;
+            subMesh.vertexCount = range.vertexCount;
+            subMesh.materialId = scene->mMeshes[instance.meshIndex]->mMaterialIndex;
+            subMesh.node = instance.node;
+            subMesh.transform = instance.transform;
+            meshData.subMeshes.push_back(subMesh);
+        }
+
+        MeshBounds::Update(meshData, threadPool);
+        ProcessMaterials(scene, meshData);
+    }
+
+    void SceneImporter::CollectInstances(const aiNode* root, std::vector<MeshData::Node>& nodes, std::vector<MeshInstance>& instances) {
+        // Depth-first, pre-order walk so submeshes follow the file's node order and every
+        // node is recorded after its parent
+        struct Pending {
+            const aiNode* node;
+            uint32_t parent;
+            glm::mat4 parentTransform;
+        };
+        std::vector<Pending> stack;
+        stack.push_back({ root, MeshData::NoParent, glm::mat4(1.0f) });
+
+        while (!stack.empty()) {
+            auto [node, parent, parentTransform] = stack.back();
+            stack.pop_back();
+
+            const uint32_t nodeIndex = static_cast<uint32_t>(nodes.size());
+            const glm::mat4 localTransform = ToGlm(node->mTransformation);
+            nodes.push_back({ localTransform, parent });
+
+            glm::mat4 transform = parentTransform * localTransform;
+            for (unsigned int i = 0; i < node->mNumMeshes; ++i) {
+                instances.push_back({ node->mMeshes[i], nodeIndex, transform });
+            }
+
+            for (unsigned int i = node->mNumChildren; i > 0; --i) {
+                stack.push_back({ node->mChildren[i - 1], nodeIndex, transform });
+            }
+        }
+    }
+
+    void SceneImporter::ProcessMesh(const aiMesh* mesh, const MeshRange& range, MeshData& meshData) {
+        ANITO3D_TRACE_ZONE("SceneImporter::ProcessMesh");
+        glm::vec3* positions = meshData.vertices.data() + range.vertexOffset;
+        for (unsigned int i = 0; i < mesh->mNumVertices; ++i) {
+            positions[i] = glm::vec3(mesh->mVertices[i].x, mesh->mVertices[i].y, mesh->mVertices[i].z);
+        }
+
+        // Meshes without normals/UVs keep zeroes so the shared arrays stay aligned
+        if (!meshData.normals.empty() && mesh->mNormals) {
+            glm::vec3* normals = meshData.normals.data() + range.vertexOffset;
+            for (unsigned int i = 0; i < mesh->mNumVertices; ++i) {
+                normals[i] = glm::vec3(mesh->mNormals[i].x, mesh->mNormals[i].y, mesh->mNormals[i].z);
+            }
+        }
+        if (!meshData.texCoords.empty() && mesh->mTextureCoords[0]) {
+            glm::vec2* texCoords = meshData.texCoords.data() + range.vertexOffset;
+            for (unsigned int i = 0; i < mesh->mNumVertices; ++i) {
+                texCoords[i] = glm::vec2(mesh->mTextureCoords[0][i].x, mesh->mTextureCoords[0][i].y);
+            }
+        }
+
+        // Triangles only; points/lines left over after triangulation are skipped
+        uint32_t* indices = meshData.indices.data() + range.firstIndex;
+        for (unsigned int i = 0; i < mesh->mNumFaces; ++i) {
+            const aiFace& face = mesh->mFaces[i];
+            if (face.mNumIndices != 3) continue;
+            indices[0] = face.mIndices[0];
+            indices[1] = face.mIndices[1];
+            indices[2] = face.mIndices[2];
+            indices += 3;
+        }
+    }
+
+    void SceneImporter::ProcessMaterials(const aiScene* scene, MeshData& meshData) {
+        meshData.materials.resize(scene->mNumMaterials);
+        for (unsigned int i = 0; i < scene->mNumMaterials; ++i) {
+            const aiMaterial* material = scene->mMaterials[i];
+            MeshData::Material& out = meshData.materials[i];
+
+            aiColor3D color;
+            if (material->Get(AI_MATKEY_COLOR_DIFFUSE, color) == AI_SUCCESS) {
+                out.albedo = glm::vec3(color.r, color.g, color.b);
+            }
+            float factor = 0.0f;
+            if (material->Get(AI_MATKEY_METALLIC_FACTOR, factor) == AI_SUCCESS) {
+                out.metallic = factor;
+            }
+            if (material->Get(AI_MATKEY_ROUGHNESS_FACTOR, factor) == AI_SUCCESS) {
+                out.roughness = factor;
+            }
+        }
+    }
+
+    uint32_t SceneImporter::CountTriangles(const aiMesh* mesh) {
+        uint32_t triangles = 0;
+        for (unsigned int i = 0; i < mesh->mNumFaces; ++i) {
+            if (mesh->mFaces[i].mNumIndices == 3) ++triangles;
+        }
+        return triangles;
+    }
+
+    glm::mat4 SceneImporter::ToGlm(const aiMatrix4x4& m) {
+        // Assimp is row-major, glm is column-major
+        return glm::mat4(
+            m.a1, m.b1, m.c1, m.d1,
+            m.a2, m.b2, m.c2, m.d2,
+            m.a3, m.b3, m.c3, m.d3,
+            m.a4, m.b4, m.c4, m.d4);
+    }
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include "MeshData.hpp"
+#include <string>
+#include <vector>
+#include <assimp/Importer.hpp>
+#include <assimp/scene.h>
+#include <assimp/postprocess.h>
+
+namespace Anito3D {
+
+    class ThreadPool;
+
+    // Imports a whole file into a single flattened MeshData: every mesh referenced by the
+    // aiNode hierarchy is concatenated into the shared vertex/index arrays and described
+    // by a SubMesh range entry.
+    class SceneImporter {
+    public:
+        static constexpr unsigned int DefaultImportFlags =
+            aiProcess_Triangulate | aiProcess_FlipUVs | aiProcess_CalcTangentSpace;
+
+        // With a thread pool the meshes of the file are converted in parallel
+        static bool Import(const std::string& filePath, MeshData& meshData,
+            unsigned int importFlags = DefaultImportFlags, ThreadPool* threadPool = nullptr);
+
+        // Flatten an already imported Assimp scene
+        static void ProcessScene(const aiScene* scene, MeshData& meshData, ThreadPool* threadPool = nullptr);
+
+        static glm::mat4 ToGlm(const aiMatrix4x4& matrix);
+
+    private:
+        // Mesh referenced by a node, with the accumulated node transform
+        struct MeshInstance {
+            unsigned int meshIndex;
+            uint32_t node; // Index into MeshData::nodes
+            glm::mat4 transform;
+        };
+
+        // Location of a source mesh inside the flattened arrays
+        struct MeshRange {
+            uint32_t firstIndex;
+            uint32_t indexCount;
+            uint32_t vertexOffset;
+            uint32_t vertexCount;
+        };
+
+        static void CollectInstances(const aiNode* root, std::vector<MeshData::Node>& nodes, std::vector<MeshInstance>& instances);
+        static void ProcessMesh(const aiMesh* mesh, const MeshRange& range, MeshData& meshData);
+        static void ProcessMaterials(const aiScene* scene, MeshData& meshData);
+        static uint32_t CountTriangles(const aiMesh* mesh);
+    };
+
+}
@@ -0,0 +1,227 @@
+#include "TransformStore.hpp"
+#include "ThreadPool.hpp"
+#include <algorithm>
+#include <bit>
+#include <cassert>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define ANITO3D_TRANSFORM_SSE2 1
+#include <emmintrin.h>
+#endif
+
+namespace Anito3D {
+
+    namespace {
+        constexpr size_t WordsPerTask = 64; // 4096 transforms per ParallelFor index
+
+#if defined(ANITO3D_TRANSFORM_SSE2)
+        // Gathers one component of four slots into the lanes of a register
+        template <typename T, typename Get>
+        __m128 Gather(const T* values, const uint32_t* slots, Get get) {
+            return _mm_setr_ps(get(values[slots[0]]), get(values[slots[1]]), get(values[slots[2]]), get(values[slots[3]]));
+        }
+
+        // Transposes four lane registers and stores one column into each of four matrices
+        void StoreColumn(glm::mat4* matrices, const uint32_t* slots, int column, __m128 x, __m128 y, __m128 z, __m128 w) {
+            _MM_TRANSPOSE4_PS(x, y, z, w);
+            _mm_storeu_ps(&matrices[slots[0]][column][0], x);
+            _mm_storeu_ps(&matrices[slots[1]][column][0], y);
+            _mm_storeu_ps(&matrices[slots[2]][column][0], z);
+            _mm_storeu_ps(&matrices[slots[3]][column][0], w);
+        }
+
+        // ComposeMatrix for four slots at once, one transform per lane
+        void Compose4(const uint32_t* slots, const glm::vec3* positions, const glm::quat* rotations, const glm::vec3* scales, glm::mat4* matrices) {
+            const __m128 qx = Gather(rotations, slots, [](const glm::quat& q) { return q.x; });
+            const __m128 qy = Gather(rotations, slots, [](const glm::quat& q) { return q.y; });
+            const __m128 qz = Gather(rotations, slots, [](const glm::quat& q) { return q.z; });
+            const __m128 qw = Gather(rotations, slots, [](const glm::quat& q) { return q.w; });
+            const __m128 sx = Gather(scales, slots, [](const glm::vec3& s) { return s.x; });
+            const __m128 sy = Gather(scales, slots, [](const glm::vec3& s) { return s.y; });
+            const __m128 sz = Gather(scales, slots, [](const glm::vec3& s) { return s.z; });
+
+            const __m128 one = _mm_set1_ps(1.0f);
+            const __m128 two = _mm_set1_ps(2.0f);
+            const __m128 x2 = _mm_mul_ps(qx, two);
+            const __m128 y2 = _mm_mul_ps(qy, two);
+            const __m128 z2 = _mm_mul_ps(qz, two);
+            const __m128 xx = _mm_mul_ps(qx, x2), yy = _mm_mul_ps(qy, y2), zz = _mm_mul_ps(qz, z2);
+            const __m128 xy = _mm_mul_ps(qx, y2), xz = _mm_mul_ps(qx, z2), yz = _mm_mul_ps(qy, z2);
+            const __m128 wx = _mm_mul_ps(qw, x2), wy = _mm_mul_ps(qw, y2), wz = _mm_mul_ps(qw, z2);
+            const __m128 zero = _mm_setzero_ps();
+
+            StoreColumn(matrices, slots, 0,
+                _mm_mul_ps(_mm_sub_ps(one, _mm_add_ps(yy, zz)), sx),
+                _mm_mul_ps(_mm_add_ps(xy, wz), sx),
+                _mm_mul_ps(_mm_sub_ps(xz, wy), sx), zero);
+            StoreColumn(matrices, slots, 1,
+                _mm_mul_ps(_mm_sub_ps(xy, wz), sy),
+                _mm_mul_ps(_mm_sub_ps(one, _mm_add_ps(xx, zz)), sy),
+                _mm_mul_ps(_mm_add_ps(yz, wx), sy), zero);
+            StoreColumn(matrices, slots, 2,
+                _mm_mul_ps(_mm_add_ps(xz, wy), sz),
+                _mm_mul_ps(_mm_sub_ps(yz, wx), sz),
+                _mm_mul_ps(_mm_sub_ps(one, _mm_add_ps(xx, yy)), sz), zero);
+            StoreColumn(matrices, slots, 3,
+                Gather(positions, slots, [](const glm::vec3& p) { return p.x; }),
+                Gather(positions, slots, [](const glm::vec3& p) { return p.y; }),
+                Gather(positions, slots, [](const glm::vec3& p) { return p.z; }), one);
+        }
+#endif
+    }
+
+    TransformHandle TransformStore::Create(const glm::vec3& position, const glm::quat& rotation, const glm::vec3& scale) {
+        uint32_t index;
+        if (!freeSlots.empty()) {
+            index = freeSlots.back();
+            freeSlots.pop_back();
+        }
+        else {
+            index = static_cast<uint32_t>(positions.size());
+            positions.emplace_back();
+            rotations.emplace_back();
+            scales.emplace_back();
+            worldMatrices.emplace_back(1.0f);
+            generations.push_back(0);
+            if ((index & 63) == 0) dirty.push_back(0);
+        }
+        aliveCount++;
+
+        TransformHandle handle{ index, generations[index] };
+        SetTransform(handle, position, rotation, scale);
+        return handle;
+    }
+
+    void TransformStore::Destroy(TransformHandle handle) {
+        if (!IsAlive(handle)) return;
+        if (IsDirty(handle)) {
+            dirty[handle.index >> 6] &= ~(uint64_t(1) << (handle.index & 63));
+            dirtyCount--;
+        }
+        generations[handle.index]++;
+        freeSlots.push_back(handle.index);
+        aliveCount--;
+    }
+
+    bool TransformStore::IsAlive(TransformHandle handle) const {
+        // Destroy bumps the generation, so only handles issued since the last reuse match
+        return handle.index < generations.size() && generations[handle.index] == handle.generation;
+    }
+
+    void TransformStore::Reserve(size_t count) {
+        positions.reserve(count);
+        rotations.reserve(count);
+        scales.reserve(count);
+        worldMatrices.reserve(count);
+        generations.reserve(count);
+        dirty.reserve((count + 63) / 64);
+    }
+
+    void TransformStore::Clear() {
+        positions.clear();
+        rotations.clear();
+        scales.clear();
+        worldMatrices.clear();
+        generations.clear();
+        dirty.clear();
+        freeSlots.clear();
+        aliveCount = 0;
+        dirtyCount = 0;
+    }
+
+    void TransformStore::SetPosition(TransformHandle handle, const glm::vec3& position) {
+        assert(IsAlive(handle) && "Stale transform handle");
+        positions[handle.index] = position;
+        MarkDirty(handle.index);
+    }
+
+    void TransformStore::SetRotation(TransformHandle handle, const glm::quat& rotation) {
+        assert(IsAlive(handle) && "Stale transform handle");
+        rotations[handle.index] = glm::normalize(rotation);
+        MarkDirty(handle.index);
+    }
+
+    void TransformStore::SetScale(TransformHandle handle, const glm::vec3& scale) {
+        assert(IsAlive(handle) && "Stale transform handle");
+        scales[handle.index] = scale;
+        MarkDirty(handle.index);
+    }
+
+    void TransformStore::SetTransform(TransformHandle handle, const glm::vec3& position, const glm::quat& rotation, const glm::vec3& scale) {
+        assert(IsAlive(handle) && "Stale transform handle");
+        positions[handle.index] = position;
+        rotations[handle.index] = glm::normalize(rotation);
+        scales[handle.index] = scale;
+        MarkDirty(handle.index);
+    }
+
+    void TransformStore::MarkDirty(uint32_t index) {
+        uint64_t& word = dirty[index >> 6];
+        const uint64_t bit = uint64_t(1) << (index & 63);
+        if (!(word & bit)) {
+            word |= bit;
+            dirtyCount++;
+        }
+    }
+
+    void TransformStore::MarkAllDirty() {
+        std::fill(dirty.begin(), dirty.end(), ~uint64_t(0));
+        if (positions.size() & 63) dirty.back() = (uint64_t(1) << (positions.size() & 63)) - 1;
+        for (uint32_t index : freeSlots) dirty[index >> 6] &= ~(uint64_t(1) << (index & 63));
+        dirtyCount = aliveCount;
+    }
+
+    size_t TransformStore::UpdateWorldMatrices(ThreadPool* threadPool, bool allowSimd) {
+        const size_t updated = dirtyCount;
+        if (updated == 0) return 0;
+
+        const size_t taskCount = (dirty.size() + WordsPerTask - 1) / WordsPerTask;
+        if (threadPool && taskCount > 1) {
+            threadPool->ParallelFor(taskCount, [&](size_t task) {
+                UpdateWords(task * WordsPerTask, std::min(dirty.size(), (task + 1) * WordsPerTask), allowSimd);
+            });
+        }
+        else {
+            UpdateWords(0, dirty.size(), allowSimd);
+        }
+        dirtyCount = 0;
+        return updated;
+    }
+
+    void TransformStore::UpdateWords(size_t firstWord, size_t lastWord, bool allowSimd) {
+        uint32_t batch[4];
+        uint32_t batchSize = 0;
+        for (size_t w = firstWord; w < lastWord; ++w) {
+            uint64_t bits = dirty[w];
+            dirty[w] = 0;
+            while (bits) {
+                const uint32_t index = static_cast<uint32_t>(w * 64 + std::countr_zero(bits));
+                bits &= bits - 1;
+#if defined(ANITO3D_TRANSFORM_SSE2)
+                if (allowSimd) {
+                    batch[batchSize++] = index;
+                    if (batchSize == 4) {
+                        Compose4(batch, positions.data(), rotations.data(), scales.data(), worldMatrices.data());
+                        batchSize = 0;
+                    }
+                    continue;
+                }
+#endif
+                worldMatrices[index] = ComposeMatrix(positions[index], rotations[index], scales[index]);
+            }
+        }
+        for (uint32_t i = 0; i < batchSize; ++i) {
+            worldMatrices[batch[i]] = ComposeMatrix(positions[batch[i]], rotations[batch[i]], scales[batch[i]]);
+        }
+    }
+
+    glm::mat4 TransformStore::ComposeMatrix(const glm::vec3& position, const glm::quat& rotation, const glm::vec3& scale) {
+        const glm::mat3 basis = glm::mat3_cast(rotation);
+        glm::mat4 matrix(1.0f);
+        matrix[0] = glm::vec4(basis[0] * scale.x, 0.0f);
+        matrix[1] = glm::vec4(basis[1] * scale.y, 0.0f);
+        matrix[2] = glm::vec4(basis[2] * scale.z, 0.0f);
+        matrix[3] = glm::vec4(position, 1.0f);
+        return matrix;
+    }
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include <limits>
+#include <span>
+#include <vector>
+
+namespace Anito3D {
+
+    class ThreadPool;
+
+    // Slot index plus the generation it was created with; stale handles of destroyed
+    // transforms are rejected once the slot is reused
+    struct TransformHandle {
+        uint32_t index = std::numeric_limits<uint32_t>::max();
+        uint32_t generation = 0;
+
+        bool IsNull() const { return index == std::numeric_limits<uint32_t>::max(); }
+    };
+
+    // Structure-of-arrays transform storage. Position, rotation and scale live in separate
+    // contiguous arrays indexed by handle; setters flag the slot in a dirty bitset and
+    // UpdateWorldMatrices() rebuilds only the flagged matrices, four at a time with SSE2.
+    class TransformStore {
+    public:
+        TransformStore() = default;
+
+        TransformHandle Create(const glm::vec3& position = glm::vec3(0.0f), const glm::quat& rotation = glm::quat(1.0f, 0.0f, 0.0f, 0.0f),
+            const glm::vec3& scale = glm::vec3(1.0f));
+        void Destroy(TransformHandle handle);
+        bool IsAlive(TransformHandle handle) const;
+        void Reserve(size_t count);
+        void Clear();
+
+        size_t GetCount() const { return aliveCount; }
+        size_t GetCapacity() const { return positions.size(); } // Slots, including destroyed ones
+        size_t GetDirtyCount() const { return dirtyCount; }
+
+        const glm::vec3& GetPosition(TransformHandle handle) const { return positions[handle.index]; }
+        const glm::quat& GetRotation(TransformHandle handle) const { return rotations[handle.index]; }
+        const glm::vec3& GetScale(TransformHandle handle) const { return scales[handle.index]; }
+        void SetPosition(TransformHandle handle, const glm::vec3& position);
+        void SetRotation(TransformHandle handle, const glm::quat& rotation);
+        void SetScale(TransformHandle handle, const glm::vec3& scale);
+        void SetTransform(TransformHandle handle, const glm::vec3& position, const glm::quat& rotation, const glm::vec3& scale);
+
+        // Cached translate * rotate * scale; current as of the last UpdateWorldMatrices()
+        const glm::mat4& GetWorldMatrix(TransformHandle handle) const { return worldMatrices[handle.index]; }
+        bool IsDirty(TransformHandle handle) const { return (dirty[handle.index >> 6] >> (handle.index & 63)) & 1; }
+        void MarkAllDirty();
+
+        // Rebuilds the matrices of dirty transforms and clears their flags. Returns the number
+        // of matrices rebuilt. allowSimd = false forces the scalar path (for comparison).
+        size_t UpdateWorldMatrices(ThreadPool* threadPool = nullptr, bool allowSimd = true);
+
+        // Bulk read access, indexed by TransformHandle::index
+        std::span<const glm::vec3> GetPositions() const { return positions; }
+        std::span<const glm::quat> GetRotations() const { return rotations; }
+        std::span<const glm::vec3> GetScales() const { return scales; }
+        std::span<const glm::mat4> GetWorldMatrices() const { return worldMatrices; }
+
+        static glm::mat4 ComposeMatrix(const glm::vec3& position, const glm::quat& rotation, const glm::vec3& scale);
+
+    private:
+        std::vector<glm::vec3> positions;
+        std::vector<glm::quat> rotations;
+        std::vector<glm::vec3> scales;
+        std::vector<glm::mat4> worldMatrices;
+        std::vector<uint32_t> generations;
+        std::vector<uint64_t> dirty; // One bit per slot
+        std::vector<uint32_t> freeSlots;
+        size_t aliveCount = 0;
+        size_t dirtyCount = 0;
+
+        void MarkDirty(uint32_t index);
+        void UpdateWords(size_t firstWord, size_t lastWord, bool allowSimd);
+    };
+
+}
@@ -0,0 +1,573 @@
+#include "VertexPacking.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define ANITO3D_VERTEX_PACKING_SSE2 1
+#include <emmintrin.h>
+#if defined(__F16C__) || defined(__AVX2__)
+#define ANITO3D_VERTEX_PACKING_F16C 1
+#include <immintrin.h>
+#endif
+#endif
+
+namespace Anito3D {
+
+    namespace {
+        constexpr float Unorm16Max = 65535.0f;
+        constexpr float Snorm16Max = 32767.0f;
+
+        float InverseOrZero(float value) {
+            return value > 0.0f ? 1.0f / value : 0.0f;
+        }
+
+        uint16_t QuantizeUnorm16(float value, float min, float scale) {
+            // Round to nearest even, matching _mm_cvtps_epi32 in the SIMD path
+            float q = std::clamp((value - min) * scale, 0.0f, Unorm16Max);
+            return static_cast<uint16_t>(std::nearbyint(q));
+        }
+
+        void StoreU16(uint8_t* destination, uint16_t value) { std::memcpy(destination, &value, sizeof(value)); }
+        void StoreI16(uint8_t* destination, int16_t value) { std::memcpy(destination, &value, sizeof(value)); }
+        uint16_t LoadU16(const uint8_t* source) { uint16_t value; std::memcpy(&value, source, sizeof(value)); return value; }
+        int16_t LoadI16(const uint8_t* source) { int16_t value; std::memcpy(&value, source, sizeof(value)); return value; }
+
+        // Quantization parameters shared by the scalar and SIMD paths
+        struct PackParams {
+            glm::vec3 positionScale{ 0.0f };   // 65535 / extent
+            glm::vec2 texCoordScale{ 0.0f };
+            glm::vec3 positionDequant{ 0.0f }; // extent / 65535
+            glm::vec2 texCoordDequant{ 0.0f };
+        };
+
+        void EncodeVertexScalar(const MeshData& meshData, const PackedMeshData& packed, const PackParams& params,
+            size_t index, uint8_t* out) {
+            const PackedVertexFormat& format = packed.format;
+            const glm::vec3& position = meshData.vertices[index];
+
+            if (format.position == PositionEncoding::Float32) {
+                std::memcpy(out, &position, sizeof(glm::vec3));
+            }
+            else {
+                for (int axis = 0; axis < 3; ++axis) {
+                    StoreU16(out + axis * 2, QuantizeUnorm16(position[axis], packed.positionMin[axis], params.positionScale[axis]));
+                }
+                StoreU16(out + 6, 0);
+            }
+
+            int16_t octX = 0, octY = 0;
+            if (packed.hasNormals) {
+                VertexPacker::EncodeOctahedral(meshData.normals[index], octX, octY);
+            }
+            StoreI16(out + format.GetNormalOffset(), octX);
+            StoreI16(out + format.GetNormalOffset() + 2, octY);
+
+            glm::vec2 uv = packed.hasTexCoords ? meshData.texCoords[index] : glm::vec2(0.0f);
+            uint8_t* uvOut = out + format.GetTexCoordOffset();
+            if (format.texCoord == TexCoordEncoding::Half) {
+                StoreU16(uvOut, VertexPacker::FloatToHalf(uv.x));
+                StoreU16(uvOut + 2, VertexPacker::FloatToHalf(uv.y));
+            }
+            else {
+                StoreU16(uvOut, QuantizeUnorm16(uv.x, packed.texCoordMin.x, params.texCoordScale.x));
+                StoreU16(uvOut + 2, QuantizeUnorm16(uv.y, packed.texCoordMin.y, params.texCoordScale.y));
+            }
+        }
+
+        void DecodeVertexScalar(const PackedMeshData& packed, const PackParams& params, size_t index,
+            const uint8_t* in, MeshData& meshData) {
+            const PackedVertexFormat& format = packed.format;
+
+            if (format.position == PositionEncoding::Float32) {
+                std::memcpy(&meshData.vertices[index], in, sizeof(glm::vec3));
+            }
+            else {
+                glm::vec3& position = meshData.vertices[index];
+                for (int axis = 0; axis < 3; ++axis) {
+                    position[axis] = packed.positionMin[axis] + static_cast<float>(LoadU16(in + axis * 2)) * params.positionDequant[axis];
+                }
+            }
+
+            if (packed.hasNormals) {
+                meshData.normals[index] = VertexPacker::DecodeOctahedral(
+                    LoadI16(in + format.GetNormalOffset()), LoadI16(in + format.GetNormalOffset() + 2));
+            }
+
+            if (packed.hasTexCoords) {
+                const uint8_t* uvIn = in + format.GetTexCoordOffset();
+                if (format.texCoord == TexCoordEncoding::Half) {
+                    meshData.texCoords[index] = glm::vec2(VertexPacker::HalfToFloat(LoadU16(uvIn)), VertexPacker::HalfToFloat(LoadU16(uvIn + 2)));
+                }
+                else {
+                    meshData.texCoords[index] = glm::vec2(
+                        packed.texCoordMin.x + static_cast<float>(LoadU16(uvIn)) * params.texCoordDequant.x,
+                        packed.texCoordMin.y + static_cast<float>(LoadU16(uvIn + 2)) * params.texCoordDequant.y);
+                }
+            }
+        }
+
+#if defined(ANITO3D_VERTEX_PACKING_SSE2)
+        // Deinterleave four consecutive vec3 (12 floats) into x/y/z lanes
+        void Load4Vec3(const glm::vec3* source, __m128& x, __m128& y, __m128& z) {
+            const float* f = &source[0].x;
+            __m128 a = _mm_loadu_ps(f);     // x0 y0 z0 x1
+            __m128 b = _mm_loadu_ps(f + 4); // y1 z1 x2 y2
+            __m128 c = _mm_loadu_ps(f + 8); // z2 x3 y3 z3
+            x = _mm_shuffle_ps(a, _mm_shuffle_ps(b, c, _MM_SHUFFLE(1, 1, 2, 2)), _MM_SHUFFLE(2, 0, 3, 0));
+            y = _mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(0, 0, 1, 1)), _mm_shuffle_ps(b, c, _MM_SHUFFLE(2, 2, 3, 3)), _MM_SHUFFLE(2, 0, 2, 0));
+            z = _mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(1, 1, 2, 2)), _mm_shuffle_ps(c, c, _MM_SHUFFLE(3, 3, 0, 0)), _MM_SHUFFLE(2, 0, 2, 0));
+        }
+
+        void Load4Vec2(const glm::vec2* source, __m128& x, __m128& y) {
+            const float* f = &source[0].x;
+            __m128 a = _mm_loadu_ps(f);     // x0 y0 x1 y1
+            __m128 b = _mm_loadu_ps(f + 4); // x2 y2 x3 y3
+            x = _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0));
+            y = _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1));
+        }
+
+        __m128 Abs(__m128 v) {
+            return _mm_andnot_ps(_mm_set1_ps(-0.0f), v);
+        }
+
+        __m128 Select(__m128 mask, __m128 ifTrue, __m128 ifFalse) {
+            return _mm_or_ps(_mm_and_ps(mask, ifTrue), _mm_andnot_ps(mask, ifFalse));
+        }
+
+        // Rounded, clamped unorm16 quantization of four lanes
+        __m128i QuantizeUnorm16x4(__m128 value, __m128 min, __m128 scale) {
+            __m128 q = _mm_mul_ps(_mm_sub_ps(value, min), scale);
+            q = _mm_min_ps(_mm_max_ps(q, _mm_setzero_ps()), _mm_set1_ps(Unorm16Max));
+            return _mm_cvtps_epi32(q);
+        }
+
+        void EncodeOctahedralx4(__m128 nx, __m128 ny, __m128 nz, __m128i& outX, __m128i& outY) {
+            const __m128 one = _mm_set1_ps(1.0f);
+            const __m128 signMask = _mm_set1_ps(-0.0f);
+
+            __m128 l1 = _mm_add_ps(_mm_add_ps(Abs(nx), Abs(ny)), Abs(nz));
+            l1 = _mm_max_ps(l1, _mm_set1_ps(1e-20f));
+            __m128 inv = _mm_div_ps(one, l1);
+            __m128 ox = _mm_mul_ps(nx, inv);
+            __m128 oy = _mm_mul_ps(ny, inv);
+
+            // Lower hemisphere folds over the diagonals
+            __m128 signX = _mm_or_ps(_mm_and_ps(ox, signMask), one);
+            __m128 signY = _mm_or_ps(_mm_and_ps(oy, signMask), one);
+            __m128 foldX = _mm_mul_ps(_mm_sub_ps(one, Abs(oy)), signX);
+            __m128 foldY = _mm_mul_ps(_mm_sub_ps(one, Abs(ox)), signY);
+            __m128 lower = _mm_cmplt_ps(nz, _mm_setzero_ps());
+            ox = Select(lower, foldX, ox);
+            oy = Select(lower, foldY, oy);
+
+            const __m128 minusOne = _mm_set1_ps(-1.0f);
+            const __m128 snorm = _mm_set1_ps(Snorm16Max);
+            outX = _mm_cvtps_epi32(_mm_mul_ps(_mm_min_ps(_mm_max_ps(ox, minusOne), one), snorm));
+            outY = _mm_cvtps_epi32(_mm_mul_ps(_mm_min_ps(_mm_max_ps(oy, minusOne), one), snorm));
+        }
+
+        void DecodeOctahedralx4(__m128 ex, __m128 ey, __m128& nx, __m128& ny, __m128& nz) {
+            const __m128 one = _mm_set1_ps(1.0f);
+            const __m128 signMask = _mm_set1_ps(-0.0f);
+            const __m128 invSnorm = _mm_set1_ps(1.0f / Snorm16Max);
+
+            __m128 x = _mm_max_ps(_mm_mul_ps(ex, invSnorm), _mm_set1_ps(-1.0f));
+            __m128 y = _mm_max_ps(_mm_mul_ps(ey, invSnorm), _mm_set1_ps(-1.0f));
+            __m128 z = _mm_sub_ps(_mm_sub_ps(one, Abs(x)), Abs(y));
+            __m128 t = _mm_max_ps(_mm_sub_ps(_mm_setzero_ps(), z), _mm_setzero_ps());
+
+            // x += x >= 0 ? -t : t
+            __m128 negT = _mm_xor_ps(t, signMask);
+            x = _mm_add_ps(x, Select(_mm_cmpge_ps(x, _mm_setzero_ps()), negT, t));
+            y = _mm_add_ps(y, Select(_mm_cmpge_ps(y, _mm_setzero_ps()), negT, t));
+
+            __m128 length = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)), _mm_mul_ps(z, z)));
+            __m128 inv = _mm_div_ps(one, length);
+            nx = _mm_mul_ps(x, inv);
+            ny = _mm_mul_ps(y, inv);
+            nz = _mm_mul_ps(z, inv);
+        }
+
+        void HalfFromFloatx4(__m128 value, uint16_t out[4]) {
+#if defined(ANITO3D_VERTEX_PACKING_F16C)
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(out), _mm_cvtps_ph(value, _MM_FROUND_TO_NEAREST_INT));
+#else
+            alignas(16) float lanes[4];
+            _mm_store_ps(lanes, value);
+            for (int i = 0; i < 4; ++i) out[i] = VertexPacker::FloatToHalf(lanes[i]);
+#endif
+        }
+
+        __m128 FloatFromHalfx4(const uint16_t in[4]) {
+#if defined(ANITO3D_VERTEX_PACKING_F16C)
+            return _mm_cvtph_ps(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(in)));
+#else
+            return _mm_setr_ps(VertexPacker::HalfToFloat(in[0]), VertexPacker::HalfToFloat(in[1]),
+                VertexPacker::HalfToFloat(in[2]), VertexPacker::HalfToFloat(in[3]));
+#endif
+        }
+
+        // Pack vertices [0, count) in blocks of four, returns the number of vertices handled
+        size_t EncodeBlocksSimd(const MeshData& meshData, PackedMeshData& packed, const PackParams& params, size_t count) {
+            const PackedVertexFormat& format = packed.format;
+            const uint32_t stride = packed.stride;
+            const size_t blockCount = count / 4;
+
+            const __m128 posMinX = _mm_set1_ps(packed.positionMin.x), posMinY = _mm_set1_ps(packed.positionMin.y), posMinZ = _mm_set1_ps(packed.positionMin.z);
+            const __m128 posScaleX = _mm_set1_ps(params.positionScale.x), posScaleY = _mm_set1_ps(params.positionScale.y), posScaleZ = _mm_set1_ps(params.positionScale.z);
+            const __m128 uvMinX = _mm_set1_ps(packed.texCoordMin.x), uvMinY = _mm_set1_ps(packed.texCoordMin.y);
+            const __m128 uvScaleX = _mm_set1_ps(params.texCoordScale.x), uvScaleY = _mm_set1_ps(params.texCoordScale.y);
+
+            alignas(16) int32_t posQ[3][4];
+            alignas(16) int32_t octQ[2][4];
+            alignas(16) int32_t uvQ[2][4];
+            uint16_t uvHalf[2][4];
+
+            for (size_t block = 0; block < blockCount; ++block) {
+                const size_t first = block * 4;
+                uint8_t* out = packed.vertexData.data() + first * stride;
+
+                if (format.position == PositionEncoding::Unorm16) {
+                    __m128 px, py, pz;
+                    Load4Vec3(&meshData.vertices[first], px, py, pz);
+                    _mm_store_si128(reinterpret_cast<__m128i*>(posQ[0]), QuantizeUnorm16x4(px, posMinX, posScaleX));
+                    _mm_store_si128(reinterpret_cast<__m128i*>(posQ[1]), QuantizeUnorm16x4(py, posMinY, posScaleY));
+                    _mm_store_si128(reinterpret_cast<__m128i*>(posQ[2]), QuantizeUnorm16x4(pz, posMinZ, posScaleZ));
+                }
+
+                if (packed.hasNormals) {
+                    __m128 nx, ny, nz;
+                    Load4Vec3(&meshData.normals[first], nx, ny, nz);
+                    __m128i ox, oy;
+                    EncodeOctahedralx4(nx, ny, nz, ox, oy);
+                    _mm_store_si128(reinterpret_cast<__m128i*>(octQ[0]), ox);
+                    _mm_store_si128(reinterpret_cast<__m128i*>(octQ[1]), oy);
+                }
+
+                if (packed.hasTexCoords) {
+                    __m128 u, v;
+                    Load4Vec2(&meshData.texCoords[first], u, v);
+                    if (format.texCoord == TexCoordEncoding::Half) {
+                        HalfFromFloatx4(u, uvHalf[0]);
+                        HalfFromFloatx4(v, uvHalf[1]);
+                    }
+                    else {
+                        _mm_store_si128(reinterpret_cast<__m128i*>(uvQ[0]), QuantizeUnorm16x4(u, uvMinX, uvScaleX));
+                        _mm_store_si128(reinterpret_cast<__m128i*>(uvQ[1]), QuantizeUnorm16x4(v, uvMinY, uvScaleY));
+                    }
+                }
+
+                // Interleave the four encoded vertices
+                for (int lane = 0; lane < 4; ++lane, out += stride) {
+                    if (format.position == PositionEncoding::Float32) {
+                        std::memcpy(out, &meshData.vertices[first + lane], sizeof(glm::vec3));
+                    }
+                    else {
+                        StoreU16(out, static_cast<uint16_t>(posQ[0][lane]));
+                        StoreU16(out + 2, static_cast<uint16_t>(posQ[1][lane]));
+                        StoreU16(out + 4, static_cast<uint16_t>(posQ[2][lane]));
+                        StoreU16(out + 6, 0);
+                    }
+
+                    uint8_t* normalOut = out + format.GetNormalOffset();
+                    StoreI16(normalOut, packed.hasNormals ? static_cast<int16_t>(octQ[0][lane]) : int16_t(0));
+                    StoreI16(normalOut + 2, packed.hasNormals ? static_cast<int16_t>(octQ[1][lane]) : int16_t(0));
+
+                    uint8_t* uvOut = out + format.GetTexCoordOffset();
+                    if (!packed.hasTexCoords) {
+                        StoreU16(uvOut, 0);
+                        StoreU16(uvOut + 2, 0);
+                    }
+                    else if (format.texCoord == TexCoordEncoding::Half) {
+                        StoreU16(uvOut, uvHalf[0][lane]);
+                        StoreU16(uvOut + 2, uvHalf[1][lane]);
+                    }
+                    else {
+                        StoreU16(uvOut, static_cast<uint16_t>(uvQ[0][lane]));
+                        StoreU16(uvOut + 2, static_cast<uint16_t>(uvQ[1][lane]));
+                    }
+                }
+            }
+            return blockCount * 4;
+        }
+
+        size_t DecodeBlocksSimd(const PackedMeshData& packed, const PackParams& params, MeshData& meshData) {
+            const PackedVertexFormat& format = packed.format;
+            const uint32_t stride = packed.stride;
+            const size_t blockCount = packed.vertexCount / 4;
+
+            alignas(16) float lanes[3][4];
+            alignas(16) float normalLanes[3][4];
+            alignas(16) float uvLanes[2][4];
+            uint16_t halfs[2][4];
+
+            for (size_t block = 0; block < blockCount; ++block) {
+                const size_t first = block * 4;
+                const uint8_t* in = packed.vertexData.data() + first * stride;
+
+                // Gather the strided 16-bit fields into lanes
+                alignas(16) int32_t posQ[3][4], octQ[2][4], uvQ[2][4];
+                const uint8_t* vertex = in;
+                for (int lane = 0; lane < 4; ++lane, vertex += stride) {
+                    if (format.position == PositionEncoding::Unorm16) {
+                        posQ[0][lane] = LoadU16(vertex);
+                        posQ[1][lane] = LoadU16(vertex + 2);
+                        posQ[2][lane] = LoadU16(vertex + 4);
+                    }
+                    octQ[0][lane] = LoadI16(vertex + format.GetNormalOffset());
+                    octQ[1][lane] = LoadI16(vertex + format.GetNormalOffset() + 2);
+                    const uint8_t* uvIn = vertex + format.GetTexCoordOffset();
+                    halfs[0][lane] = LoadU16(uvIn);
+                    halfs[1][lane] = LoadU16(uvIn + 2);
+                    uvQ[0][lane] = halfs[0][lane];
+                    uvQ[1][lane] = halfs[1][lane];
+                }
+
+                if (format.position == PositionEncoding::Unorm16) {
+                    for (int axis = 0; axis < 3; ++axis) {
+                        __m128 q = _mm_cvtepi32_ps(_mm_load_si128(reinterpret_cast<const __m128i*>(posQ[axis])));
+                        __m128 p = _mm_add_ps(_mm_set1_ps(packed.positionMin[axis]), _mm_mul_ps(q, _mm_set1_ps(params.positionDequant[axis])));
+                        _mm_store_ps(lanes[axis], p);
+                    }
+                    for (int lane = 0; lane < 4; ++lane) {
+                        meshData.vertices[first + lane] = glm::vec3(lanes[0][lane], lanes[1][lane], lanes[2][lane]);
+                    }
+                }
+                else {
+                    vertex = in;
+                    for (int lane = 0; lane < 4; ++lane, vertex += stride) {
+                        std::memcpy(&meshData.vertices[first + lane], vertex, sizeof(glm::vec3));
+                    }
+                }
+
+                if (packed.hasNormals) {
+                    __m128 nx, ny, nz;
+                    DecodeOctahedralx4(_mm_cvtepi32_ps(_mm_load_si128(reinterpret_cast<const __m128i*>(octQ[0]))),
+                        _mm_cvtepi32_ps(_mm_load_si128(reinterpret_cast<const __m128i*>(octQ[1]))), nx, ny, nz);
+                    _mm_store_ps(normalLanes[0], nx);
+                    _mm_store_ps(normalLanes[1], ny);
+                    _mm_store_ps(normalLanes[2], nz);
+                    for (int lane = 0; lane < 4; ++lane) {
+                        meshData.normals[first + lane] = glm::vec3(normalLanes[0][lane], normalLanes[1][lane], normalLanes[2][lane]);
+                    }
+                }
+
+                if (packed.hasTexCoords) {
+                    if (format.texCoord == TexCoordEncoding::Half) {
+                        _mm_store_ps(uvLanes[0], FloatFromHalfx4(halfs[0]));
+                        _mm_store_ps(uvLanes[1], FloatFromHalfx4(halfs[1]));
+                    }
+                    else {
+                        for (int axis = 0; axis < 2; ++axis) {
+                            __m128 q = _mm_cvtepi32_ps(_mm_load_si128(reinterpret_cast<const __m128i*>(uvQ[axis])));
+                            _mm_store_ps(uvLanes[axis], _mm_add_ps(_mm_set1_ps(packed.texCoordMin[axis]),
+                                _mm_mul_ps(q, _mm_set1_ps(params.texCoordDequant[axis]))));
+                        }
+                    }
+                    for (int lane = 0; lane < 4; ++lane) {
+                        meshData.texCoords[first + lane] = glm::vec2(uvLanes[0][lane], uvLanes[1][lane]);
+                    }
+                }
+            }
+            return blockCount * 4;
+        }
+#endif
+
+        PackParams MakeParams(const PackedMeshData& packed) {
+            PackParams params;
+            for (int axis = 0; axis < 3; ++axis) {
+                params.positionScale[axis] = Unorm16Max * InverseOrZero(packed.positionExtent[axis]);
+                params.positionDequant[axis] = packed.positionExtent[axis] / Unorm16Max;
+            }
+            for (int axis = 0; axis < 2; ++axis) {
+                params.texCoordScale[axis] = Unorm16Max * InverseOrZero(packed.texCoordExtent[axis]);
+                params.texCoordDequant[axis] = packed.texCoordExtent[axis] / Unorm16Max;
+            }
+            return params;
+        }
+    }
+
+    PackedMeshData VertexPacker::Pack(const MeshData& meshData, const PackedVertexFormat& format) {
+        PackedMeshData packed;
+        packed.format = format;
+        packed.stride = format.GetStride();
+        packed.vertexCount = meshData.vertices.size();
+        packed.hasNormals = !meshData.normals.empty();
+        packed.hasTexCoords = !meshData.texCoords.empty();
+        packed.vertexData.resize(packed.vertexCount * packed.stride);
+
+        if (packed.vertexCount == 0) return packed;
+
+        // Quantization ranges
+        glm::vec3 positionMax = meshData.vertices[0];
+        packed.positionMin = meshData.vertices[0];
+        for (const auto& position : meshData.vertices) {
+            packed.positionMin = glm::min(packed.positionMin, position);
+            positionMax = glm::max(positionMax, position);
+        }
+        packed.positionExtent = positionMax - packed.positionMin;
+
+        if (packed.hasTexCoords) {
+            glm::vec2 texCoordMax = meshData.texCoords[0];
+            packed.texCoordMin = meshData.texCoords[0];
+            for (const auto& uv : meshData.texCoords) {
+                packed.texCoordMin = glm::vec2(std::min(packed.texCoordMin.x, uv.x), std::min(packed.texCoordMin.y, uv.y));
+                texCoordMax = glm::vec2(std::max(texCoordMax.x, uv.x), std::max(texCoordMax.y, uv.y));
+            }
+            packed.texCoordExtent = texCoordMax - packed.texCoordMin;
+        }
+
+        PackParams params = MakeParams(packed);
+
+        size_t first = 0;
+#if defined(ANITO3D_VERTEX_PACKING_SSE2)
+        first = EncodeBlocksSimd(meshData, packed, params, packed.vertexCount);
+#endif
+        for (size_t i = first; i < packed.vertexCount; ++i) {
+            EncodeVertexScalar(meshData, packed, params, i, packed.vertexData.data() + i * packed.stride);
+        }
+        return packed;
+    }
+
+    void VertexPacker::Unpack(const PackedMeshData& packed, MeshData& meshData) {
+        meshData.vertices.resize(packed.vertexCount);
+        meshData.normals.resize(packed.hasNormals ? packed.vertexCount : 0);
+        meshData.texCoords.resize(packed.hasTexCoords ? packed.vertexCount : 0);
+
+        PackParams params = MakeParams(packed);
+
+        size_t first = 0;
+#if defined(ANITO3D_VERTEX_PACKING_SSE2)
+        first = DecodeBlocksSimd(packed, params, meshData);
+#endif
+        for (size_t i = first; i < packed.vertexCount; ++i) {
+            DecodeVertexScalar(packed, params, i, packed.vertexData.data() + i * packed.stride, meshData);
+        }
+    }
+
+    PackingErrorBounds VertexPacker::GetErrorBounds(const PackedMeshData& packed) {
+        PackingErrorBounds bounds;
+
+        if (packed.format.position == PositionEncoding::Unorm16) {
+            // Half a quantization step plus float rounding of the dequantization
+            float extent = std::max({ packed.positionExtent.x, packed.positionExtent.y, packed.positionExtent.z });
+            float magnitude = std::max(glm::length(packed.positionMin), glm::length(packed.positionMin + packed.positionExtent));
+            bounds.position = 0.5f * extent / Unorm16Max + 4.0f * magnitude * 1.2e-7f;
+        }
+
+        if (packed.hasNormals) {
+            // Half a snorm16 step on each oct axis (diagonal sqrt(2)), stretched by at most 3x
+            // at the octant centres when projected back onto the sphere
+            bounds.normalRadians = 3.0f * std::sqrt(2.0f) * 0.5f / Snorm16Max + 2e-6f;
+        }
+
+        if (packed.hasTexCoords) {
+            if (packed.format.texCoord == TexCoordEncoding::Half) {
+                // 11 significant bits: relative error 2^-11, absolute floor from half subnormals
+                float magnitude = std::max(std::abs(packed.texCoordMin.x), std::abs(packed.texCoordMin.y));
+                magnitude = std::max({ magnitude, std::abs(packed.texCoordMin.x + packed.texCoordExtent.x),
+                    std::abs(packed.texCoordMin.y + packed.texCoordExtent.y) });
+                bounds.texCoord = magnitude * (1.0f / 2048.0f) + 3.0e-8f;
+            }
+            else {
+                float extent = std::max(packed.texCoordExtent.x, packed.texCoordExtent.y);
+                float magnitude = std::max(glm::length(packed.texCoordMin), glm::length(packed.texCoordMin + packed.texCoordExtent));
+                bounds.texCoord = 0.5f * extent / Unorm16Max + 4.0f * magnitude * 1.2e-7f;
+            }
+        }
+
+        return bounds;
+    }
+
+    bool VertexPacker::IsSimdEnabled() {
+#if defined(ANITO3D_VERTEX_PACKING_SSE2)
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    uint16_t VertexPacker::FloatToHalf(float value) {
+        // Round-to-nearest-even conversion
+        uint32_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        const uint32_t sign = bits & 0x80000000u;
+        bits ^= sign;
+
+        uint16_t half;
+        if (bits >= 0x47800000u) {
+            // Too large for half (or Inf/NaN)
+            half = bits > 0x7F800000u ? 0x7E00 : 0x7C00;
+        }
+        else if (bits < 0x38800000u) {
+            // Subnormal or zero: let the FPU do the rounding
+            float magnitude;
+            std::memcpy(&magnitude, &bits, sizeof(magnitude));
+            magnitude += 0.5f;
+            uint32_t rounded;
+            std::memcpy(&rounded, &magnitude, sizeof(rounded));
+            half = static_cast<uint16_t>(rounded - 0x3F000000u);
+        }
+        else {
+            const uint32_t mantissaOdd = (bits >> 13) & 1u;
+            bits += (static_cast<uint32_t>(15 - 127) << 23) + 0xFFFu;
+            bits += mantissaOdd;
+            half = static_cast<uint16_t>(bits >> 13);
+        }
+        return static_cast<uint16_t>(half | (sign >> 16));
+    }
+
+    float VertexPacker::HalfToFloat(uint16_t value) {
+        const uint32_t sign = static_cast<uint32_t>(value & 0x8000u) << 16;
+        const uint32_t exponent = (value >> 10) & 0x1Fu;
+        const uint32_t mantissa = value & 0x3FFu;
+
+        uint32_t bits;
+        if (exponent == 0) {
+            if (mantissa == 0) {
+                bits = sign;
+            }
+            else {
+                float subnormal = std::ldexp(static_cast<float>(mantissa), -24);
+                std::memcpy(&bits, &subnormal, sizeof(bits));
+                bits |= sign;
+            }
+        }
+        else if (exponent == 31) {
+            bits = sign | 0x7F800000u | (mantissa << 13);
+        }
+        else {
+            bits = sign | ((exponent + 112u) << 23) | (mantissa << 13);
+        }
+
+        float result;
+        std::memcpy(&result, &bits, sizeof(result));
+        return result;
+    }
+
+    void VertexPacker::EncodeOctahedral(const glm::vec3& normal, int16_t& x, int16_t& y) {
+        float l1 = std::max(std::abs(normal.x) + std::abs(normal.y) + std::abs(normal.z), 1e-20f);
+        float inv = 1.0f / l1;
+        float ox = normal.x * inv;
+        float oy = normal.y * inv;
+        if (normal.z < 0.0f) {
+            float foldX = (1.0f - std::abs(oy)) * (ox >= 0.0f ? 1.0f : -1.0f);
+            float foldY = (1.0f - std::abs(ox)) * (oy >= 0.0f ? 1.0f : -1.0f);
+            ox = foldX;
+            oy = foldY;
+        }
+        x = static_cast<int16_t>(std::nearbyint(std::clamp(ox, -1.0f, 1.0f) * Snorm16Max));
+        y = static_cast<int16_t>(std::nearbyint(std::clamp(oy, -1.0f, 1.0f) * Snorm16Max));
+    }
+
+    glm::vec3 VertexPacker::DecodeOctahedral(int16_t encodedX, int16_t encodedY) {
+        float x = std::max(static_cast<float>(encodedX) / Snorm16Max, -1.0f);
+        float y = std::max(static_cast<float>(encodedY) / Snorm16Max, -1.0f);
+        float z = 1.0f - std::abs(x) - std::abs(y);
+        float t = std::max(-z, 0.0f);
+        x += x >= 0.0f ? -t : t;
+        y += y >= 0.0f ? -t : t;
+        return glm::normalize(glm::vec3(x, y, z));
+    }
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include "MeshData.hpp"
+#include <cstdint>
+#include <vector>
+
+namespace Anito3D {
+
+    enum class PositionEncoding : uint8_t {
+        Float32, // 3 x float, lossless
+        Unorm16  // 3 x uint16 quantized against the mesh AABB (+2 bytes padding)
+    };
+
+    enum class TexCoordEncoding : uint8_t {
+        Half,   // 2 x IEEE half float, any range
+        Unorm16 // 2 x uint16 quantized against the UV bounds
+    };
+
+    // Interleaved vertex layout: position | oct normal (2 x snorm16) | uv
+    struct PackedVertexFormat {
+        PositionEncoding position = PositionEncoding::Float32;
+        TexCoordEncoding texCoord = TexCoordEncoding::Half;
+
+        uint32_t GetPositionSize() const { return position == PositionEncoding::Float32 ? 12u : 8u; }
+        uint32_t GetNormalOffset() const { return GetPositionSize(); }
+        uint32_t GetTexCoordOffset() const { return GetPositionSize() + 4u; }
+        uint32_t GetStride() const { return GetPositionSize() + 8u; } // 20 or 16 bytes
+    };
+
+    struct PackedMeshData {
+        PackedVertexFormat format;
+        uint32_t stride = 0;
+        size_t vertexCount = 0;
+        std::vector<uint8_t> vertexData; // vertexCount * stride bytes
+
+        // Dequantization ranges (value = min + q / 65535 * extent)
+        glm::vec3 positionMin{ 0.0f };
+        glm::vec3 positionExtent{ 0.0f };
+        glm::vec2 texCoordMin{ 0.0f };
+        glm::vec2 texCoordExtent{ 0.0f };
+
+        bool hasNormals = false;
+        bool hasTexCoords = false;
+
+        size_t GetByteSize() const { return vertexData.size(); }
+    };
+
+    // Worst-case reconstruction error of a packed mesh
+    struct PackingErrorBounds {
+        float position = 0.0f;      // Per axis, object units
+        float normalRadians = 0.0f; // Angle between original and decoded normal
+        float texCoord = 0.0f;      // Per component
+    };
+
+    // Converts between MeshData's separate float arrays and the packed interleaved layout.
+    // Both directions process four vertices per step with SSE2 where available.
+    class VertexPacker {
+    public:
+        static PackedMeshData Pack(const MeshData& meshData, const PackedVertexFormat& format = {});
+
+        // Overwrites vertices/normals/texCoords of meshData; indices and submeshes are untouched
+        static void Unpack(const PackedMeshData& packed, MeshData& meshData);
+
+        static PackingErrorBounds GetErrorBounds(const PackedMeshData& packed);
+
+        static bool IsSimdEnabled();
+
+        // Scalar building blocks (also used for tails and non-SSE builds)
+        static uint16_t FloatToHalf(float value);
+        static float HalfToFloat(uint16_t value);
+        static void EncodeOctahedral(const glm::vec3& normal, int16_t& x, int16_t& y);
+        static glm::vec3 DecodeOctahedral(int16_t x, int16_t y);
+    };
+
+}
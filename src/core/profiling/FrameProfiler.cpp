@@ -0,0 +1,139 @@
+#include "FrameProfiler.hpp"
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+#include <numeric>
+
+namespace Anito3D {
+
+    namespace {
+        constexpr uint64_t AverageWarmupFrames = 8; // Frames before stutter detection starts
+        constexpr double AverageWeight = 0.05;      // Exponential moving average of the frame time
+
+        // Linearly interpolated percentile over sorted samples (same definition as FrameTimeSummary)
+        double Percentile(const std::vector<double>& sortedSamples, double percentile) {
+            if (sortedSamples.empty()) return 0.0;
+            const double rank = percentile / 100.0 * static_cast<double>(sortedSamples.size() - 1);
+            const size_t lower = static_cast<size_t>(std::floor(rank));
+            const size_t upper = std::min(lower + 1, sortedSamples.size() - 1);
+            return sortedSamples[lower] + (sortedSamples[upper] - sortedSamples[lower]) * (rank - static_cast<double>(lower));
+        }
+
+        FramePhaseStatistics Summarize(const std::string& name, std::vector<double>& samples) {
+            FramePhaseStatistics statistics;
+            statistics.name = name;
+            if (samples.empty()) return statistics;
+            std::sort(samples.begin(), samples.end());
+            statistics.mean = std::accumulate(samples.begin(), samples.end(), 0.0) / static_cast<double>(samples.size());
+            statistics.p50 = Percentile(samples, 50.0);
+            statistics.p95 = Percentile(samples, 95.0);
+            statistics.p99 = Percentile(samples, 99.0);
+            statistics.max = samples.back();
+            return statistics;
+        }
+    }
+
+    size_t FrameStatistics::GetHistogramBucket(double milliseconds) {
+        return std::upper_bound(HistogramBounds.begin(), HistogramBounds.end(), milliseconds) - HistogramBounds.begin();
+    }
+
+    FrameProfiler::FrameProfiler(std::vector<std::string> phaseNames, uint32_t capacity, bool enabled) : phaseNames(std::move(phaseNames)), enabled(enabled) {
+        if (this->phaseNames.size() > MaxPhases) this->phaseNames.resize(MaxPhases);
+        const uint64_t slotCount = std::bit_ceil(capacity + 1); // One spare slot for the record being written
+        slots = std::make_unique<Slot[]>(slotCount);
+        mask = slotCount - 1;
+    }
+
+    void FrameProfiler::SetEnabled(bool enabled) {
+        this->enabled = enabled;
+    }
+
+    void FrameProfiler::Publish(Clock::time_point frameEnd) {
+        const uint64_t index = written.load(std::memory_order_relaxed);
+        current.frame = index;
+        current.totalMs = std::chrono::duration<float, std::milli>(frameEnd - frameStart).count();
+
+        const double totalMs = current.totalMs;
+        current.stutter = index >= AverageWarmupFrames && totalMs > averageMs * StutterFactor && totalMs - averageMs > StutterMinimumMs;
+        averageMs = index == 0 ? totalMs : averageMs + (totalMs - averageMs) * AverageWeight;
+        if (current.stutter) stutters.fetch_add(1, std::memory_order_relaxed);
+
+        uint32_t words[SlotWords] = {};
+        std::memcpy(words, &current, sizeof(FrameRecord));
+        Slot& slot = slots[index & mask];
+        for (size_t word = 0; word < SlotWords; ++word) slot[word].store(words[word], std::memory_order_relaxed);
+        written.store(index + 1, std::memory_order_release);
+    }
+
+    void FrameProfiler::SetGpuTime(uint64_t frame, float milliseconds) {
+        const uint64_t end = written.load(std::memory_order_relaxed);
+        if (!enabled || frame >= end || end - frame > mask) return;
+
+        uint32_t word = 0;
+        std::memcpy(&word, &milliseconds, sizeof(word));
+        slots[frame & mask][offsetof(FrameRecord, gpuMs) / sizeof(uint32_t)].store(word, std::memory_order_relaxed);
+    }
+
+    size_t FrameProfiler::Snapshot(std::vector<FrameRecord>& out, size_t maxFrames) const {
+        out.clear();
+        const uint64_t end = written.load(std::memory_order_acquire);
+        const uint64_t count = std::min<uint64_t>({ end, mask + 1, maxFrames });
+        const uint64_t begin = end - count;
+        out.resize(count);
+        for (uint64_t i = begin; i < end; ++i) {
+            uint32_t words[SlotWords];
+            const Slot& slot = slots[i & mask];
+            for (size_t word = 0; word < SlotWords; ++word) words[word] = slot[word].load(std::memory_order_relaxed);
+            std::memcpy(&out[i - begin], words, sizeof(FrameRecord));
+        }
+
+        // The writer may have published more frames during the copy; the slot of record r is
+        // reused by record r + capacity, so everything older than (newest + 1 - capacity) may
+        // be torn. Same validation as a sequence lock, on the ring's write counter.
+        std::atomic_thread_fence(std::memory_order_acquire);
+        const uint64_t after = written.load(std::memory_order_relaxed);
+        const uint64_t firstValid = after > mask ? after - mask : 0;
+        if (firstValid > begin) {
+            out.erase(out.begin(), out.begin() + static_cast<ptrdiff_t>(std::min(firstValid - begin, count)));
+        }
+        return out.size();
+    }
+
+    FrameStatistics FrameProfiler::ComputeStatistics(size_t maxFrames) const {
+        std::vector<FrameRecord> frames;
+        Snapshot(frames, maxFrames);
+
+        FrameStatistics statistics;
+        statistics.frames = frames.size();
+        statistics.totalStutters = stutters.load(std::memory_order_relaxed);
+
+        std::vector<double> samples(frames.size());
+        for (size_t i = 0; i < frames.size(); ++i) {
+            samples[i] = frames[i].totalMs;
+            statistics.histogram[FrameStatistics::GetHistogramBucket(samples[i])]++;
+            statistics.stutters += frames[i].stutter ? 1 : 0;
+        }
+        statistics.total = Summarize("frame", samples);
+
+        for (size_t phase = 0; phase < phaseNames.size(); ++phase) {
+            for (size_t i = 0; i < frames.size(); ++i) samples[i] = frames[i].phaseMs[phase];
+            statistics.phases.push_back(Summarize(phaseNames[phase], samples));
+        }
+
+        samples.clear();
+        for (const FrameRecord& frame : frames) {
+            if (frame.gpuMs >= 0.0f) samples.push_back(frame.gpuMs);
+        }
+        statistics.gpuFrames = samples.size();
+        statistics.gpu = Summarize("gpu", samples);
+        return statistics;
+    }
+
+    void FrameProfiler::Reset() {
+        written.store(0, std::memory_order_release);
+        stutters.store(0, std::memory_order_relaxed);
+        averageMs = 0.0;
+    }
+}
@@ -0,0 +1,151 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Trace.hpp"
+
+namespace Anito3D {
+
+    // Rolling statistics of one frame phase (or the whole frame), milliseconds
+    struct FramePhaseStatistics {
+        std::string name;
+        double mean = 0.0;
+        double p50 = 0.0;
+        double p95 = 0.0;
+        double p99 = 0.0;
+        double max = 0.0;
+    };
+
+    struct FrameStatistics {
+        // Upper bounds of the frame-time histogram buckets in milliseconds; the last bucket is open
+        static constexpr std::array<double, 9> HistogramBounds{ 1.0, 2.0, 4.0, 8.0, 1000.0 / 120.0, 1000.0 / 60.0, 1000.0 / 30.0, 50.0, 100.0 };
+        static constexpr size_t HistogramBucketCount = HistogramBounds.size() + 1;
+
+        size_t frames = 0; // Frames in the window
+        FramePhaseStatistics total;
+        std::vector<FramePhaseStatistics> phases;
+        size_t gpuFrames = 0; // Frames in the window with a GPU time
+        FramePhaseStatistics gpu;
+        std::array<uint32_t, HistogramBucketCount> histogram{};
+        uint32_t stutters = 0;      // Stutter frames in the window
+        uint64_t totalStutters = 0; // Since the last reset
+
+        static size_t GetHistogramBucket(double milliseconds);
+    };
+
+    // Per-frame CPU timing split into named phases. The frame loop calls BeginFrame, then
+    // EndPhase(i) after each phase (a phase may end several times per frame; the times add
+    // up) and EndFrame, which publishes the frame into a fixed-size ring. Readers on any
+    // thread take lock-free snapshots of the most recent frames; a record the writer may be
+    // overwriting during the copy is dropped from the snapshot instead of being locked.
+    // Slots are stored as relaxed atomic words, so the overlapping copy is not a data race.
+    //
+    // GPU times arrive a few frames late (see GpuProfiler) and are attached to their frame's
+    // record afterwards with SetGpuTime.
+    //
+    // A frame is a stutter when it takes StutterFactor times the running average and at
+    // least StutterMinimumMs more. The flag is decided when the frame ends, so it only
+    // needs the average and no window.
+    //
+    // While a Trace is recording, every phase and frame is also emitted as a trace zone, plus
+    // a "frameMs" counter, whether or not the profiler itself is enabled.
+    //
+    // Disabled profilers cost a branch and a relaxed load per call, so the calls can stay in
+    // release loops.
+    class FrameProfiler {
+    public:
+        using Clock = std::chrono::steady_clock;
+
+        static constexpr uint32_t MaxPhases = 8;
+        static constexpr double StutterFactor = 2.0;
+        static constexpr double StutterMinimumMs = 2.0;
+
+        struct FrameRecord {
+            uint64_t frame = 0;
+            float totalMs = 0.0f;
+            float phaseMs[MaxPhases] = {};
+            float gpuMs = -1.0f; // Negative until resolved
+            bool stutter = false;
+        };
+
+        // Keeps at least the last capacity frames readable
+        explicit FrameProfiler(std::vector<std::string> phaseNames, uint32_t capacity = 1024, bool enabled = true);
+
+        void SetEnabled(bool enabled);
+        bool IsEnabled() const { return enabled; }
+
+        const std::vector<std::string>& GetPhaseNames() const { return phaseNames; }
+        uint32_t GetCapacity() const { return static_cast<uint32_t>(mask + 1); }
+        uint64_t GetFrameCount() const { return written.load(std::memory_order_acquire); }
+
+        // Index the frame between BeginFrame and EndFrame will get; tags GPU work for SetGpuTime
+        uint64_t GetCurrentFrame() const { return written.load(std::memory_order_relaxed); }
+
+        void BeginFrame() {
+            tracing = ANITO3D_TRACING && Trace::IsRecording();
+            if (!enabled && !tracing) return;
+            current = FrameRecord{};
+            frameStart = phaseStart = Clock::now();
+        }
+
+        void EndPhase(uint32_t phase) {
+            if (!enabled && !tracing) return;
+            const Clock::time_point now = Clock::now();
+            current.phaseMs[phase] += std::chrono::duration<float, std::milli>(now - phaseStart).count();
+            if (tracing) Trace::Zone(phaseNames[phase].c_str(), Trace::ToTraceTime(phaseStart), Trace::ToTraceTime(now));
+            phaseStart = now;
+        }
+
+        void EndFrame() {
+            if (!enabled && !tracing) return;
+            const Clock::time_point now = Clock::now();
+            if (tracing) {
+                Trace::Zone("frame", Trace::ToTraceTime(frameStart), Trace::ToTraceTime(now));
+                Trace::Counter("frameMs", std::chrono::duration<double, std::milli>(now - frameStart).count());
+            }
+            if (enabled) Publish(now);
+        }
+
+        // GPU time of an already published frame; ignored once the frame left the ring.
+        // Frame loop thread only.
+        void SetGpuTime(uint64_t frame, float milliseconds);
+
+        // Copy up to maxFrames of the most recent frames, oldest first. Safe while the frame
+        // loop keeps writing; returns the number of records copied.
+        size_t Snapshot(std::vector<FrameRecord>& out, size_t maxFrames = std::numeric_limits<size_t>::max()) const;
+
+        // Statistics over the most recent maxFrames frames (the whole ring by default)
+        FrameStatistics ComputeStatistics(size_t maxFrames = std::numeric_limits<size_t>::max()) const;
+
+        // Forget every frame; call from the frame loop thread while no reader is active
+        void Reset();
+
+    private:
+        static constexpr size_t SlotWords = (sizeof(FrameRecord) + sizeof(uint32_t) - 1) / sizeof(uint32_t);
+        using Slot = std::array<std::atomic<uint32_t>, SlotWords>;
+
+        std::vector<std::string> phaseNames;
+        std::unique_ptr<Slot[]> slots;
+        uint64_t mask = 0;
+        std::atomic<uint64_t> written{ 0 };
+        std::atomic<uint64_t> stutters{ 0 };
+        bool enabled = true;
+        bool tracing = false; // Trace recording at BeginFrame
+
+        // Frame loop thread only
+        FrameRecord current;
+        Clock::time_point frameStart;
+        Clock::time_point phaseStart;
+        double averageMs = 0.0;
+
+        void Publish(Clock::time_point frameEnd);
+    };
+
+}
@@ -0,0 +1,209 @@
+#include "Trace.hpp"
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace Anito3D {
+
+    namespace {
+        using Clock = std::chrono::steady_clock;
+
+        constexpr size_t ChunkEvents = 4096;
+        constexpr size_t MaxChunks = 256; // About a million events per thread
+
+        enum class EventType : uint8_t {
+            Zone,
+            Counter
+        };
+
+        struct Event {
+            const char* name;
+            uint64_t timestamp;
+            uint64_t duration;
+            double value;
+            EventType type;
+        };
+
+        using Chunk = std::array<Event, ChunkEvents>;
+
+        // Written by its thread only; readers see events below the published count. Chunks
+        // never move, so a reader can walk them while the owner keeps appending.
+        struct ThreadBuffer {
+            uint32_t id = 0;
+            std::string name; // Guarded by the registry mutex
+            std::array<std::atomic<Chunk*>, MaxChunks> chunks{};
+            std::atomic<size_t> count{ 0 };
+            std::atomic<uint64_t> dropped{ 0 };
+
+            ~ThreadBuffer() {
+                for (auto& chunk : chunks) delete chunk.load(std::memory_order_relaxed);
+            }
+
+            void Append(const Event& event) {
+                const size_t index = count.load(std::memory_order_relaxed);
+                const size_t chunkIndex = index / ChunkEvents;
+                if (chunkIndex >= MaxChunks) {
+                    dropped.fetch_add(1, std::memory_order_relaxed);
+                    return;
+                }
+                Chunk* chunk = chunks[chunkIndex].load(std::memory_order_relaxed);
+                if (!chunk) {
+                    chunk = new Chunk;
+                    chunks[chunkIndex].store(chunk, std::memory_order_release);
+                }
+                (*chunk)[index % ChunkEvents] = event;
+                count.store(index + 1, std::memory_order_release);
+            }
+        };
+
+        // Buffers live until Clear, so events of finished threads are still exported
+        struct Registry {
+            std::mutex mutex;
+            std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+            Clock::time_point epoch = Clock::now();
+        };
+
+        Registry& GetRegistry() {
+            static Registry registry;
+            return registry;
+        }
+
+        thread_local ThreadBuffer* threadBuffer = nullptr;
+
+        ThreadBuffer& GetThreadBuffer() {
+            if (!threadBuffer) {
+                Registry& registry = GetRegistry();
+                std::lock_guard<std::mutex> lock(registry.mutex);
+                registry.buffers.push_back(std::make_unique<ThreadBuffer>());
+                threadBuffer = registry.buffers.back().get();
+                threadBuffer->id = static_cast<uint32_t>(registry.buffers.size());
+            }
+            return *threadBuffer;
+        }
+
+        void WriteEscaped(std::ostream& out, const std::string& text) {
+            out << '"';
+            for (char c : text) {
+                if (c == '"' || c == '\\') out << '\\' << c;
+                else if (static_cast<unsigned char>(c) < 0x20) out << ' ';
+                else out << c;
+            }
+            out << '"';
+        }
+
+        void WriteMicroseconds(std::ostream& out, uint64_t nanoseconds) {
+            char text[32];
+            std::snprintf(text, sizeof(text), "%llu.%03llu", static_cast<unsigned long long>(nanoseconds / 1000), static_cast<unsigned long long>(nanoseconds % 1000));
+            out << text;
+        }
+    }
+
+    void Trace::Start() {
+        GetRegistry();
+        recording.store(true, std::memory_order_relaxed);
+    }
+
+    void Trace::Stop() {
+        recording.store(false, std::memory_order_relaxed);
+    }
+
+    uint64_t Trace::Now() {
+        return ToTraceTime(Clock::now());
+    }
+
+    uint64_t Trace::ToTraceTime(Clock::time_point time) {
+        const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(time - GetRegistry().epoch).count();
+        return elapsed > 0 ? static_cast<uint64_t>(elapsed) : 0;
+    }
+
+    void Trace::Zone(const char* name, uint64_t startNanoseconds, uint64_t endNanoseconds) {
+        GetThreadBuffer().Append({ name, startNanoseconds, endNanoseconds - startNanoseconds, 0.0, EventType::Zone });
+    }
+
+    void Trace::Counter(const char* name, double value) {
+        GetThreadBuffer().Append({ name, Now(), 0, value, EventType::Counter });
+    }
+
+    void Trace::SetThreadName(const std::string& name) {
+        ThreadBuffer& buffer = GetThreadBuffer();
+        std::lock_guard<std::mutex> lock(GetRegistry().mutex);
+        buffer.name = name;
+    }
+
+    bool Trace::WriteChromeJson(const std::string& path) {
+        std::filesystem::path outputPath(path);
+        if (outputPath.has_parent_path()) {
+            std::error_code ec;
+            std::filesystem::create_directories(outputPath.parent_path(), ec);
+        }
+        std::ofstream file(outputPath);
+        if (!file) return false;
+
+        Registry& registry = GetRegistry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+        bool first = true;
+        auto separator = [&]() {
+            if (!first) file << ",\n";
+            first = false;
+        };
+        for (const auto& buffer : registry.buffers) {
+            if (!buffer->name.empty()) {
+                separator();
+                file << "{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":" << buffer->id << ",\"args\":{\"name\":";
+                WriteEscaped(file, buffer->name);
+                file << "}}";
+            }
+
+            const size_t count = buffer->count.load(std::memory_order_acquire);
+            for (size_t i = 0; i < count; ++i) {
+                const Event& event = (*buffer->chunks[i / ChunkEvents].load(std::memory_order_acquire))[i % ChunkEvents];
+                separator();
+                file << "{\"ph\":\"" << (event.type == EventType::Zone ? "X" : "C") << "\",\"name\":";
+                WriteEscaped(file, event.name);
+                file << ",\"pid\":1,\"tid\":" << buffer->id << ",\"ts\":";
+                WriteMicroseconds(file, event.timestamp);
+                if (event.type == EventType::Zone) {
+                    file << ",\"dur\":";
+                    WriteMicroseconds(file, event.duration);
+                }
+                else {
+                    file << ",\"args\":{\"value\":" << event.value << "}";
+                }
+                file << "}";
+            }
+        }
+        file << "\n]}\n";
+        return static_cast<bool>(file);
+    }
+
+    void Trace::Clear() {
+        Registry& registry = GetRegistry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        for (const auto& buffer : registry.buffers) {
+            buffer->count.store(0, std::memory_order_relaxed);
+            buffer->dropped.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    uint64_t Trace::GetEventCount() {
+        Registry& registry = GetRegistry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        uint64_t count = 0;
+        for (const auto& buffer : registry.buffers) count += buffer->count.load(std::memory_order_acquire);
+        return count;
+    }
+
+    uint64_t Trace::GetDroppedEventCount() {
+        Registry& registry = GetRegistry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        uint64_t dropped = 0;
+        for (const auto& buffer : registry.buffers) dropped += buffer->dropped.load(std::memory_order_relaxed);
+        return dropped;
+    }
+}
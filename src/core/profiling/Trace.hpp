@@ -0,0 +1,79 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+// Compile-time kill switch: with ANITO3D_TRACING=0 every ANITO3D_TRACE_* macro compiles to
+// nothing (set from the ANITO3D_ENABLE_TRACING CMake option)
+#ifndef ANITO3D_TRACING
+#define ANITO3D_TRACING 1
+#endif
+
+namespace Anito3D {
+
+    // Lightweight timeline tracing. Zones, counters and thread names go into a buffer per
+    // thread (append-only chunks, no locks after the thread's first event) while recording,
+    // and WriteChromeJson exports them as Chrome trace event JSON, which chrome://tracing
+    // and the Perfetto UI open directly. Outside Start/Stop a zone costs one relaxed load.
+    //
+    // Zone and counter names must outlive the trace (string literals); thread names are copied.
+    class Trace {
+    public:
+        static void Start();
+        static void Stop();
+        static bool IsRecording() { return recording.load(std::memory_order_relaxed); }
+
+        // Nanoseconds since the process started tracing
+        static uint64_t Now();
+        static uint64_t ToTraceTime(std::chrono::steady_clock::time_point time);
+
+        static void Zone(const char* name, uint64_t startNanoseconds, uint64_t endNanoseconds);
+        static void Counter(const char* name, double value);
+        static void SetThreadName(const std::string& name);
+
+        // Safe while other threads keep recording; events appended during the export may be missing
+        static bool WriteChromeJson(const std::string& path);
+
+        // Drop every event; only while no thread is recording
+        static void Clear();
+
+        static uint64_t GetEventCount();
+        static uint64_t GetDroppedEventCount(); // Threads that filled their buffer
+
+    private:
+        static inline std::atomic<bool> recording{ false };
+    };
+
+    class TraceZone {
+    public:
+        explicit TraceZone(const char* name) : name(name), start(Trace::IsRecording() ? Trace::Now() : NotRecording) {}
+        ~TraceZone() {
+            if (start != NotRecording) Trace::Zone(name, start, Trace::Now());
+        }
+
+        TraceZone(const TraceZone&) = delete;
+        TraceZone& operator=(const TraceZone&) = delete;
+
+    private:
+        static constexpr uint64_t NotRecording = ~0ull;
+
+        const char* name;
+        uint64_t start;
+    };
+
+}
+
+#define ANITO3D_TRACE_CONCAT_INNER(a, b) a##b
+#define ANITO3D_TRACE_CONCAT(a, b) ANITO3D_TRACE_CONCAT_INNER(a, b)
+
+#if ANITO3D_TRACING
+#define ANITO3D_TRACE_ZONE(name) ::Anito3D::TraceZone ANITO3D_TRACE_CONCAT(traceZone, __LINE__)(name)
+#define ANITO3D_TRACE_COUNTER(name, value) do { if (::Anito3D::Trace::IsRecording()) ::Anito3D::Trace::Counter(name, static_cast<double>(value)); } while (0)
+#define ANITO3D_TRACE_THREAD_NAME(name) ::Anito3D::Trace::SetThreadName(name)
+#else
+#define ANITO3D_TRACE_ZONE(name) do {} while (0)
+#define ANITO3D_TRACE_COUNTER(name, value) do {} while (0)
+#define ANITO3D_TRACE_THREAD_NAME(name) do {} while (0)
+#endif
@@ -0,0 +1,379 @@
+#include "CpuRayTracer.hpp"
+#include "BenchmarkOptions.hpp"
+#include "BenchmarkReport.hpp"
+#include "Hash.hpp"
+#include "ImageWriter.hpp"
+#include "MeshBounds.hpp"
+#include "Shading.hpp"
+#include "ThreadPool.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <glm/gtc/constants.hpp>
+#include <ng-log/logging.h>
+
+namespace Anito3D {
+
+    namespace {
+        using Clock = std::chrono::steady_clock;
+
+        constexpr float FieldOfView = 45.0f; // Vertical, degrees
+        constexpr float MirrorRoughness = 0.3f; // Smoother surfaces get traced reflections with --ray-tracing
+        constexpr uint32_t PacketWidth = 2;     // Primary packets cover 2x2 pixels
+
+        double ElapsedMilliseconds(Clock::time_point start, Clock::time_point end) {
+            return std::chrono::duration<double, std::milli>(end - start).count();
+        }
+
+        uint32_t HashUint(uint32_t value) {
+            value = value * 747796405u + 2891336453u;
+            value = ((value >> ((value >> 28u) + 4u)) ^ value) * 277803737u;
+            return (value >> 22u) ^ value;
+        }
+
+        // Cosine-weighted direction around normal
+        glm::vec3 SampleCosine(const glm::vec3& normal, float r1, float r2) {
+            const glm::vec3 helper = std::fabs(normal.x) > 0.9f ? glm::vec3(0.0f, 1.0f, 0.0f) : glm::vec3(1.0f, 0.0f, 0.0f);
+            const glm::vec3 tangent = glm::normalize(glm::cross(helper, normal));
+            const glm::vec3 bitangent = glm::cross(normal, tangent);
+            const float phi = 2.0f * glm::pi<float>() * r1;
+            const float radius = std::sqrt(r2);
+            return tangent * (std::cos(phi) * radius) + bitangent * (std::sin(phi) * radius) + normal * std::sqrt(std::max(0.0f, 1.0f - r2));
+        }
+    }
+
+    // PCG-style generator; seeded per pixel and sample, never shared between threads
+    struct CpuRayTracer::Random {
+        uint32_t state;
+
+        Random(uint32_t pixel = 0, uint32_t sample = 0) : state(HashUint(pixel ^ HashUint(sample))) {}
+
+        float Next() {
+            state = HashUint(state);
+            return static_cast<float>(state >> 8) * (1.0f / 16777216.0f);
+        }
+    };
+
+    struct CpuRayTracer::Surface {
+        glm::vec3 position;
+        glm::vec3 geometricNormal; // Facing the incoming ray
+        glm::vec3 normal;          // Interpolated shading normal, same side as geometricNormal
+        MeshData::Material material;
+    };
+
+    RayTracerSettings RayTracerSettings::FromOptions(const BenchmarkOptions& options) {
+        RayTracerSettings settings;
+        settings.rayTracing = options.rayTracing;
+        settings.pbr = options.pbr;
+        settings.globalIllumination = options.globalIllumination;
+        settings.samplesPerPixel = std::max(options.samplesPerPixel, 1u);
+        settings.imagePath = options.imagePath;
+        return settings;
+    }
+
+    CpuRayTracer::CpuRayTracer(const RayTracerSettings& settings, ThreadPool* threadPool) : settings(settings), threadPool(threadPool) {
+        this->settings.samplesPerPixel = std::max(settings.samplesPerPixel, 1u);
+        this->settings.tileSize = std::max(settings.tileSize, PacketWidth);
+    }
+
+    bool CpuRayTracer::Init(uint32_t width, uint32_t height, const std::vector<std::unique_ptr<MeshEntity>>& entities) {
+        this->width = width;
+        this->height = height;
+
+        auto buildStart = Clock::now();
+        scenes.clear();
+        buildStatistics = {};
+        wideNodes = 0;
+        double weightedSahCost = 0.0;
+        MeshData::Bounds bounds;
+        for (const auto& entity : entities) {
+            auto scene = std::make_unique<Scene>();
+            scene->meshData = &entity->GetMeshData();
+            BvhBuildStatistics statistics;
+            scene->bvh = Bvh::Build(*scene->meshData, {}, threadPool, &statistics);
+            if (scene->bvh.IsEmpty()) continue;
+            scene->wide = Bvh4::Collapse(scene->bvh);
+
+            buildStatistics.triangles += statistics.triangles;
+            buildStatistics.nodes += statistics.nodes;
+            buildStatistics.leaves += statistics.leaves;
+            buildStatistics.tasks += statistics.tasks;
+            buildStatistics.maxDepth = std::max(buildStatistics.maxDepth, statistics.maxDepth);
+            weightedSahCost += static_cast<double>(statistics.sahCost) * statistics.triangles;
+            wideNodes += scene->wide.GetNodes().size();
+            bounds = scenes.empty() ? scene->meshData->bounds : MeshBounds::Merge(bounds, scene->meshData->bounds);
+            scenes.push_back(std::move(scene));
+        }
+        buildStatistics.sahCost = buildStatistics.triangles > 0 ? static_cast<float>(weightedSahCost / buildStatistics.triangles) : 0.0f;
+        buildMilliseconds = ElapsedMilliseconds(buildStart, Clock::now());
+
+        // Fixed camera framing every loaded entity from the front, slightly above
+        const float radius = std::max(bounds.radius, 1e-3f);
+        const float tanHalfFov = std::tan(glm::radians(FieldOfView) * 0.5f);
+        const glm::vec3 toEye = glm::normalize(glm::vec3(0.35f, 0.3f, 1.0f));
+        camera.origin = bounds.center + toEye * (radius / std::sin(glm::radians(FieldOfView) * 0.5f));
+        camera.forward = -toEye;
+        const glm::vec3 right = glm::normalize(glm::cross(camera.forward, glm::vec3(0.0f, 1.0f, 0.0f)));
+        camera.up = glm::cross(right, camera.forward) * tanHalfFov;
+        camera.right = right * (tanHalfFov * static_cast<float>(width) / static_cast<float>(height));
+        rayEpsilon = radius * 1e-4f;
+
+        accumulation.assign(static_cast<size_t>(width) * height, glm::vec3(0.0f));
+        accumulatedSamples = 0;
+        framesRendered = 0;
+        renderMilliseconds = 0.0;
+        primaryRays = 0;
+        shadowRays = 0;
+        secondaryRays = 0;
+
+        LOG(INFO) << "CPU ray tracer: " << scenes.size() << " BVHs over " << buildStatistics.triangles << " triangles built in "
+            << buildMilliseconds << " ms (" << buildStatistics.nodes << " nodes, SAH cost " << buildStatistics.sahCost << "), ray tracing "
+            << (settings.rayTracing ? "on" : "off") << ", PBR " << (settings.pbr ? "on" : "off") << ", GI " << (settings.globalIllumination ? "on" : "off")
+            << ", " << settings.samplesPerPixel << " spp per frame";
+        return true;
+    }
+
+    void CpuRayTracer::RenderFrame(uint32_t frameIndex) {
+        auto start = Clock::now();
+        const uint32_t tilesX = (width + settings.tileSize - 1) / settings.tileSize;
+        const uint32_t tilesY = (height + settings.tileSize - 1) / settings.tileSize;
+        const uint32_t tileCount = tilesX * tilesY;
+
+        // Random sequences follow the accumulated frame count, not the caller's frame index,
+        // so the same number of frames always gives the same image
+        const uint32_t frame = framesRendered;
+        if (threadPool) {
+            threadPool->ParallelFor(tileCount, [&](size_t tile) { RenderTile(static_cast<uint32_t>(tile), frame); });
+        }
+        else {
+            for (uint32_t tile = 0; tile < tileCount; ++tile) RenderTile(tile, frame);
+        }
+
+        accumulatedSamples += settings.samplesPerPixel;
+        framesRendered++;
+        renderMilliseconds += ElapsedMilliseconds(start, Clock::now());
+    }
+
+    void CpuRayTracer::RenderTile(uint32_t tile, uint32_t frameIndex) {
+        const uint32_t tilesX = (width + settings.tileSize - 1) / settings.tileSize;
+        const uint32_t x0 = (tile % tilesX) * settings.tileSize;
+        const uint32_t y0 = (tile / tilesX) * settings.tileSize;
+        const uint32_t x1 = std::min(x0 + settings.tileSize, width);
+        const uint32_t y1 = std::min(y0 + settings.tileSize, height);
+
+        RayCounts counts;
+        for (uint32_t y = y0; y < y1; y += PacketWidth) {
+            for (uint32_t x = x0; x < x1; x += PacketWidth) {
+                for (uint32_t sample = 0; sample < settings.samplesPerPixel; ++sample) {
+                    const uint32_t sampleIndex = frameIndex * settings.samplesPerPixel + sample;
+                    RayPacket packet;
+                    Random random[RayPacket::Size];
+                    size_t pixels[RayPacket::Size] = {};
+                    for (uint32_t lane = 0; lane < RayPacket::Size; ++lane) {
+                        const uint32_t px = x + lane % PacketWidth;
+                        const uint32_t py = y + lane / PacketWidth;
+                        if (px >= x1 || py >= y1) {
+                            packet.Disable(lane);
+                            continue;
+                        }
+                        pixels[lane] = static_cast<size_t>(py) * width + px;
+                        random[lane] = Random(static_cast<uint32_t>(pixels[lane]), sampleIndex);
+                        const float jitterX = random[lane].Next();
+                        const float jitterY = random[lane].Next();
+                        packet.Set(lane, GetPrimaryRay(px + jitterX, py + jitterY));
+                    }
+
+                    RayHit hits[RayPacket::Size];
+                    uint32_t hitScenes[RayPacket::Size] = {};
+                    for (uint32_t scene = 0; scene < scenes.size(); ++scene) {
+                        float previous[RayPacket::Size];
+                        for (uint32_t lane = 0; lane < RayPacket::Size; ++lane) previous[lane] = hits[lane].t;
+                        scenes[scene]->bvh.Intersect(packet, hits);
+                        for (uint32_t lane = 0; lane < RayPacket::Size; ++lane) {
+                            if (hits[lane].t < previous[lane]) hitScenes[lane] = scene;
+                        }
+                    }
+
+                    for (uint32_t lane = 0; lane < RayPacket::Size; ++lane) {
+                        if (!packet.IsActive(lane)) continue;
+                        counts.primary++;
+                        accumulation[pixels[lane]] += Radiance(packet.Get(lane), hits[lane], hitScenes[lane], random[lane], counts);
+                    }
+                }
+            }
+        }
+        primaryRays.fetch_add(counts.primary, std::memory_order_relaxed);
+        shadowRays.fetch_add(counts.shadow, std::memory_order_relaxed);
+        secondaryRays.fetch_add(counts.secondary, std::memory_order_relaxed);
+    }
+
+    Ray CpuRayTracer::GetPrimaryRay(float x, float y) const {
+        const float ndcX = x / static_cast<float>(width) * 2.0f - 1.0f;
+        const float ndcY = 1.0f - y / static_cast<float>(height) * 2.0f;
+        return { camera.origin, glm::normalize(camera.forward + camera.right * ndcX + camera.up * ndcY) };
+    }
+
+    bool CpuRayTracer::Trace(const Ray& ray, RayHit& hit, uint32_t& scene) const {
+        bool found = false;
+        for (uint32_t i = 0; i < scenes.size(); ++i) {
+            if (scenes[i]->wide.Intersect(ray, hit)) {
+                scene = i;
+                found = true;
+            }
+        }
+        return found;
+    }
+
+    bool CpuRayTracer::Occluded(const Ray& ray) const {
+        for (const auto& scene : scenes) {
+            if (scene->bvh.Occluded(ray)) return true;
+        }
+        return false;
+    }
+
+    CpuRayTracer::Surface CpuRayTracer::GetSurface(const Ray& ray, const RayHit& hit, uint32_t sceneIndex) const {
+        const Scene& scene = *scenes[sceneIndex];
+        const BvhTriangle& triangle = scene.bvh.GetTriangles()[hit.triangle];
+        const MeshData& meshData = *scene.meshData;
+        const MeshData::SubMesh& subMesh = meshData.subMeshes[triangle.subMesh];
+
+        Surface surface;
+        surface.position = ray.origin + ray.direction * hit.t;
+        surface.geometricNormal = glm::normalize(glm::cross(triangle.edge1, triangle.edge2));
+        if (glm::dot(surface.geometricNormal, ray.direction) > 0.0f) surface.geometricNormal = -surface.geometricNormal;
+        surface.normal = surface.geometricNormal;
+
+        if (!meshData.normals.empty()) {
+            const size_t first = static_cast<size_t>(triangle.primitive) * 3;
+            const glm::vec3& n0 = meshData.normals[subMesh.vertexOffset + meshData.GetIndex(subMesh, first)];
+            const glm::vec3& n1 = meshData.normals[subMesh.vertexOffset + meshData.GetIndex(subMesh, first + 1)];
+            const glm::vec3& n2 = meshData.normals[subMesh.vertexOffset + meshData.GetIndex(subMesh, first + 2)];
+            const glm::vec3 interpolated = glm::mat3(subMesh.transform) * (n0 * (1.0f - hit.u - hit.v) + n1 * hit.u + n2 * hit.v);
+            if (glm::dot(interpolated, interpolated) > 1e-12f) {
+                surface.normal = glm::normalize(interpolated);
+                if (glm::dot(surface.normal, surface.geometricNormal) < 0.0f) surface.normal = -surface.normal;
+            }
+        }
+
+        surface.material = subMesh.materialId < meshData.materials.size() ? meshData.materials[subMesh.materialId] : MeshData::Material{};
+        return surface;
+    }
+
+    glm::vec3 CpuRayTracer::Radiance(Ray ray, RayHit hit, uint32_t scene, Random& random, RayCounts& counts) const {
+        glm::vec3 radiance(0.0f);
+        glm::vec3 throughput(1.0f);
+        for (uint32_t bounce = 0;; ++bounce) {
+            if (!hit.IsHit()) {
+                radiance += throughput * Shading::Sky(ray.direction);
+                break;
+            }
+
+            const Surface surface = GetSurface(ray, hit, scene);
+            const glm::vec3 view = -ray.direction;
+            const float metallic = settings.pbr ? std::clamp(surface.material.metallic, 0.0f, 1.0f) : 0.0f;
+            const float roughness = std::clamp(surface.material.roughness, 0.04f, 1.0f);
+            const glm::vec3 diffuseColor = Shading::DiffuseColor(surface.material.albedo, metallic);
+            const glm::vec3 specularColor = settings.pbr ? Shading::SpecularColor(surface.material.albedo, metallic) : glm::vec3(0.0f);
+            const glm::vec3 origin = surface.position + surface.geometricNormal * rayEpsilon;
+
+            // Sun, shadowed only when ray tracing is on
+            const float nDotL = glm::dot(surface.normal, Shading::SunDirection);
+            if (nDotL > 0.0f && glm::dot(surface.geometricNormal, Shading::SunDirection) > 0.0f) {
+                bool lit = true;
+                if (settings.rayTracing) {
+                    counts.shadow++;
+                    lit = !Occluded(Ray{ origin, Shading::SunDirection });
+                }
+                if (lit) {
+                    glm::vec3 brdf = diffuseColor * glm::one_over_pi<float>();
+                    if (settings.pbr) brdf += Shading::Ggx(surface.normal, view, Shading::SunDirection, roughness, specularColor);
+                    radiance += throughput * brdf * Shading::SunRadiance * nDotL;
+                }
+            }
+
+            glm::vec3 direction;
+            if (settings.globalIllumination) {
+                if (bounce == settings.maxBounces) break;
+                // One lobe per bounce: glossy reflection for metals, cosine-weighted diffuse otherwise
+                const float specularChance = settings.pbr ? glm::mix(0.1f, 0.9f, metallic) : 0.0f;
+                if (random.Next() < specularChance) {
+                    const glm::vec3 reflected = glm::reflect(ray.direction, surface.normal);
+                    direction = glm::normalize(glm::mix(reflected, SampleCosine(reflected, random.Next(), random.Next()), roughness * roughness));
+                    throughput *= specularColor / specularChance;
+                }
+                else {
+                    direction = SampleCosine(surface.normal, random.Next(), random.Next());
+                    throughput *= diffuseColor / (1.0f - specularChance);
+                }
+            }
+            else {
+                // Constant ambient, plus mirror reflections of smooth surfaces when ray tracing is on
+                const bool mirror = settings.rayTracing && settings.pbr && roughness <= MirrorRoughness;
+                radiance += throughput * Shading::AmbientRadiance * (diffuseColor + (mirror ? glm::vec3(0.0f) : specularColor));
+                if (!mirror || bounce == settings.maxBounces) break;
+                direction = glm::reflect(ray.direction, surface.normal);
+                throughput *= specularColor;
+            }
+
+            if (glm::dot(direction, surface.geometricNormal) <= 0.0f) break;
+            if (std::max(throughput.x, std::max(throughput.y, throughput.z)) < 1e-3f) break;
+            ray = Ray{ origin, direction };
+            hit = {};
+            counts.secondary++;
+            Trace(ray, hit, scene);
+        }
+        return radiance;
+    }
+
+    std::vector<glm::vec3> CpuRayTracer::GetImage() const {
+        std::vector<glm::vec3> image(accumulation.size(), glm::vec3(0.0f));
+        if (accumulatedSamples == 0) return image;
+        const float scale = 1.0f / static_cast<float>(accumulatedSamples);
+        for (size_t i = 0; i < image.size(); ++i) image[i] = accumulation[i] * scale;
+        return image;
+    }
+
+    void CpuRayTracer::Shutdown() {
+        if (!settings.imagePath.empty() && framesRendered > 0) {
+            if (ImageWriter::Write(settings.imagePath, width, height, GetImage())) {
+                LOG(INFO) << "CPU ray tracer image (" << accumulatedSamples << " spp) written to " << settings.imagePath;
+            }
+            else {
+                LOG(ERROR) << "Failed to write CPU ray tracer image to " << settings.imagePath;
+            }
+        }
+        scenes.clear();
+        accumulation.clear();
+        accumulation.shrink_to_fit();
+    }
+
+    void CpuRayTracer::ReportStats(BenchmarkReport& report) const {
+        const std::string section = "rayTracer";
+        const uint64_t primary = primaryRays.load();
+        const uint64_t shadow = shadowRays.load();
+        const uint64_t secondary = secondaryRays.load();
+        const uint64_t rays = primary + shadow + secondary;
+        const double mraysPerSecond = renderMilliseconds > 0.0 ? rays / (renderMilliseconds * 1000.0) : 0.0;
+        const std::vector<uint8_t> image = ImageWriter::ToSrgb8(GetImage());
+
+        report.SetMetric(section, "bvhs", static_cast<uint64_t>(scenes.size()));
+        report.SetMetric(section, "triangles", buildStatistics.triangles);
+        report.SetMetric(section, "bvhBuildMs", buildMilliseconds);
+        report.SetMetric(section, "bvhNodes", buildStatistics.nodes);
+        report.SetMetric(section, "bvh4Nodes", wideNodes);
+        report.SetMetric(section, "bvhMaxDepth", static_cast<uint64_t>(buildStatistics.maxDepth));
+        report.SetMetric(section, "sahCost", static_cast<double>(buildStatistics.sahCost));
+        report.SetMetric(section, "tileSize", static_cast<uint64_t>(settings.tileSize));
+        report.SetMetric(section, "frames", static_cast<uint64_t>(framesRendered));
+        report.SetMetric(section, "samplesPerPixel", static_cast<uint64_t>(accumulatedSamples));
+        report.SetMetric(section, "primaryRays", primary);
+        report.SetMetric(section, "shadowRays", shadow);
+        report.SetMetric(section, "secondaryRays", secondary);
+        report.SetMetric(section, "renderMs", renderMilliseconds);
+        report.SetMetric(section, "mraysPerSecond", mraysPerSecond);
+        report.SetMetric(section, "imageHash", HashBytes(image.data(), image.size()));
+        LOG(INFO) << "CPU ray tracer: " << framesRendered << " frames, " << accumulatedSamples << " spp, " << rays << " rays ("
+            << primary << " primary, " << shadow << " shadow, " << secondary << " secondary) in " << renderMilliseconds << " ms, "
+            << mraysPerSecond << " Mrays/s";
+    }
+}
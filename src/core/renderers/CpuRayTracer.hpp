@@ -0,0 +1,104 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Bvh.hpp"
+#include "HeadlessRenderer.hpp"
+
+namespace Anito3D {
+
+    class ThreadPool;
+    struct BenchmarkOptions;
+
+    struct RayTracerSettings {
+        bool rayTracing = false;         // Shadow rays and mirror reflections, otherwise local shading only
+        bool pbr = false;                // GGX specular from metallic/roughness, otherwise Lambert
+        bool globalIllumination = false; // Sampled indirect bounces instead of a constant ambient term
+        uint32_t samplesPerPixel = 1;    // Added to the accumulation every frame
+        uint32_t maxBounces = 3;         // Path length after the primary hit
+        uint32_t tileSize = 16;          // Tile side in pixels; tiles are the unit of work
+        std::string imagePath;           // Written at shutdown (see ImageWriter::Write), empty = none
+
+        static RayTracerSettings FromOptions(const BenchmarkOptions& options);
+    };
+
+    // CPU reference renderer: one BVH per loaded entity (in the file's scene space), primary
+    // rays traced as 2x2 packets, shadow and bounce rays one at a time through 4-wide BVHs.
+    // Tiles are spread over the job system and every frame adds samplesPerPixel jittered
+    // samples to a float accumulation buffer. Random numbers depend only on pixel, frame and
+    // sample, so the image is the same for any thread count.
+    class CpuRayTracer : public HeadlessRenderer {
+    public:
+        CpuRayTracer(const RayTracerSettings& settings, ThreadPool* threadPool = nullptr);
+
+        const char* GetName() const override { return "raytracer"; }
+
+        bool Init(uint32_t width, uint32_t height, const std::vector<std::unique_ptr<MeshEntity>>& entities) override;
+        void RenderFrame(uint32_t frameIndex) override;
+        void Shutdown() override;
+        void ReportStats(BenchmarkReport& report) const override;
+
+        // Accumulated radiance divided by the samples per pixel so far (linear RGB, rows top to bottom)
+        std::vector<glm::vec3> GetImage() const;
+        uint32_t GetWidth() const { return width; }
+        uint32_t GetHeight() const { return height; }
+
+    private:
+        struct Scene {
+            const MeshData* meshData;
+            Bvh bvh;
+            Bvh4 wide; // Refers to bvh, so scenes are not moved after the collapse
+        };
+
+        struct Camera {
+            glm::vec3 origin;
+            glm::vec3 forward;
+            glm::vec3 right; // Scaled to the image plane's half width at distance 1
+            glm::vec3 up;    // Scaled to the half height
+        };
+
+        struct RayCounts {
+            uint64_t primary = 0;
+            uint64_t shadow = 0;
+            uint64_t secondary = 0;
+        };
+
+        struct Random;
+        struct Surface;
+
+        RayTracerSettings settings;
+        ThreadPool* threadPool;
+        uint32_t width = 0;
+        uint32_t height = 0;
+        std::vector<std::unique_ptr<Scene>> scenes;
+        Camera camera{};
+        float rayEpsilon = 1e-4f; // Secondary ray offset, scaled with the scene
+
+        std::vector<glm::vec3> accumulation; // Radiance sums per pixel
+        uint32_t accumulatedSamples = 0;     // Per pixel
+        uint32_t framesRendered = 0;
+
+        double buildMilliseconds = 0.0;
+        BvhBuildStatistics buildStatistics; // Summed over scenes
+        uint64_t wideNodes = 0;
+
+        double renderMilliseconds = 0.0;
+        std::atomic<uint64_t> primaryRays{ 0 };
+        std::atomic<uint64_t> shadowRays{ 0 };
+        std::atomic<uint64_t> secondaryRays{ 0 };
+
+        void RenderTile(uint32_t tile, uint32_t frameIndex);
+        Ray GetPrimaryRay(float x, float y) const;
+
+        bool Trace(const Ray& ray, RayHit& hit, uint32_t& scene) const;
+        bool Occluded(const Ray& ray) const;
+        Surface GetSurface(const Ray& ray, const RayHit& hit, uint32_t scene) const;
+        // Radiance arriving along ray, continuing the path from its (primary) hit
+        glm::vec3 Radiance(Ray ray, RayHit hit, uint32_t scene, Random& random, RayCounts& counts) const;
+    };
+
+}
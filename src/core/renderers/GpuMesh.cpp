@@ -0,0 +1,60 @@
+#include "GpuMesh.hpp"
+#include "StagingRing.hpp"
+#include <ng-log/logging.h>
+#include <utility>
+
+namespace Anito3D {
+
+    namespace {
+        GpuMesh::Stream PlaceStream(VkDeviceSize& end, size_t bytes) {
+            GpuMesh::Stream stream;
+            stream.offset = (end + 15) & ~VkDeviceSize(15);
+            stream.size = bytes;
+            end = stream.offset + bytes;
+            return stream;
+        }
+    }
+
+    bool GpuMesh::Upload(const MeshData& meshData, GpuMemoryAllocator& allocator, StagingRing& stagingRing, GpuMesh& mesh) {
+        mesh = {};
+        VkDeviceSize end = 0;
+        mesh.positions = PlaceStream(end, meshData.vertices.size() * sizeof(glm::vec3));
+        mesh.normals = PlaceStream(end, meshData.normals.size() * sizeof(glm::vec3));
+        mesh.texCoords = PlaceStream(end, meshData.texCoords.size() * sizeof(glm::vec2));
+        mesh.indices = PlaceStream(end, meshData.indices.size() * sizeof(uint32_t));
+        mesh.indices16 = PlaceStream(end, meshData.indices16.size() * sizeof(uint16_t));
+        if (end == 0) return false;
+
+        const VkBufferUsageFlags usage = VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT |
+            VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+        if (!allocator.createBuffer(end, usage, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, 0, mesh.buffer)) {
+            LOG(ERROR) << "Failed to allocate " << end / 1024 << " KiB for a GPU mesh";
+            return false;
+        }
+
+        const std::pair<const void*, const Stream*> streams[] = {
+            { meshData.vertices.data(), &mesh.positions },
+            { meshData.normals.data(), &mesh.normals },
+            { meshData.texCoords.data(), &mesh.texCoords },
+            { meshData.indices.data(), &mesh.indices },
+            { meshData.indices16.data(), &mesh.indices16 },
+        };
+        for (const auto& [data, stream] : streams) {
+            if (stream->size == 0) continue;
+            if (!stagingRing.upload(mesh.buffer.buffer, stream->offset, data, stream->size)) {
+                LOG(ERROR) << "Failed to stage GPU mesh data";
+                // Earlier streams may be pending or in flight, nothing may write into the buffer once it is freed
+                stagingRing.cancel(mesh.buffer.buffer);
+                stagingRing.finish();
+                Destroy(allocator, mesh);
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void GpuMesh::Destroy(GpuMemoryAllocator& allocator, GpuMesh& mesh) {
+        allocator.destroyBuffer(mesh.buffer);
+        mesh = {};
+    }
+}
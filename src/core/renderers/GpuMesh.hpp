@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstdint>
+
+#include "GpuMemoryAllocator.hpp"
+#include "MeshData.hpp"
+
+namespace Anito3D {
+
+    class StagingRing;
+
+    // Device-local copy of a MeshData. Every stream lives in one buffer, back to back, so a
+    // whole file costs a single sub-allocation; submeshes address it through their
+    // firstIndex/vertexOffset ranges as on the CPU. Offsets are 16-byte aligned, and a
+    // stream missing from the source has size 0.
+    struct GpuMesh {
+        struct Stream {
+            VkDeviceSize offset = 0;
+            VkDeviceSize size = 0;
+        };
+
+        GpuBuffer buffer;
+        Stream positions; // glm::vec3
+        Stream normals;   // glm::vec3
+        Stream texCoords; // glm::vec2
+        Stream indices;   // uint32_t
+        Stream indices16; // uint16_t
+
+        // Queues the copies on the ring; the data is usable once the ring's batch completed
+        // (see StagingRing::finish). On failure nothing stays allocated: a failed staging
+        // copy waits for the ring's in-flight batches before the buffer is freed.
+        static bool Upload(const MeshData& meshData, GpuMemoryAllocator& allocator, StagingRing& stagingRing, GpuMesh& mesh);
+        static void Destroy(GpuMemoryAllocator& allocator, GpuMesh& mesh);
+    };
+
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <glm/glm.hpp>
+#include <glm/gtc/constants.hpp>
+
+namespace Anito3D {
+
+    // Lighting shared by the CPU renderers, so the ray tracer and the rasterizer light a scene
+    // the same way: one sun, a constant ambient term and a sky gradient.
+    class Shading {
+    public:
+        static inline const glm::vec3 SunDirection = glm::normalize(glm::vec3(0.35f, 0.8f, 0.45f)); // Towards the sun
+        static inline const glm::vec3 SunRadiance{ 3.0f, 2.9f, 2.7f };
+        static inline const glm::vec3 AmbientRadiance{ 0.25f, 0.28f, 0.32f };
+
+        static glm::vec3 Sky(const glm::vec3& direction) {
+            return glm::mix(glm::vec3(0.8f, 0.85f, 0.9f), glm::vec3(0.3f, 0.45f, 0.8f), std::clamp(direction.y, 0.0f, 1.0f));
+        }
+
+        // Diffuse and specular colors of the albedo/metallic/roughness model (Lambert only without PBR)
+        static glm::vec3 DiffuseColor(const glm::vec3& albedo, float metallic) { return albedo * (1.0f - metallic); }
+        static glm::vec3 SpecularColor(const glm::vec3& albedo, float metallic) { return glm::mix(glm::vec3(0.04f), albedo, metallic); }
+
+        // Cook-Torrance with GGX distribution, Smith-Schlick visibility and Schlick Fresnel
+        static glm::vec3 Ggx(const glm::vec3& normal, const glm::vec3& view, const glm::vec3& light, float roughness, const glm::vec3& f0) {
+            const glm::vec3 half = glm::normalize(view + light);
+            const float nDotL = std::max(glm::dot(normal, light), 0.0f);
+            const float nDotV = std::max(glm::dot(normal, view), 1e-4f);
+            const float nDotH = std::max(glm::dot(normal, half), 0.0f);
+            const float vDotH = std::max(glm::dot(view, half), 0.0f);
+
+            const float alpha = roughness * roughness;
+            const float alpha2 = alpha * alpha;
+            const float denominator = nDotH * nDotH * (alpha2 - 1.0f) + 1.0f;
+            const float distribution = alpha2 / (glm::pi<float>() * denominator * denominator);
+            const float k = (roughness + 1.0f) * (roughness + 1.0f) / 8.0f;
+            const float visibility = nDotV / (nDotV * (1.0f - k) + k) * nDotL / (nDotL * (1.0f - k) + k);
+            const glm::vec3 fresnel = f0 + (glm::vec3(1.0f) - f0) * std::pow(1.0f - vDotH, 5.0f);
+            return fresnel * (distribution * visibility / (4.0f * nDotV * std::max(nDotL, 1e-4f)));
+        }
+    };
+
+}
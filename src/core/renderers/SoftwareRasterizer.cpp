@@ -0,0 +1,461 @@
+#include "SoftwareRasterizer.hpp"
+#include "BenchmarkOptions.hpp"
+#include "BenchmarkReport.hpp"
+#include "Hash.hpp"
+#include "ImageWriter.hpp"
+#include "MeshBounds.hpp"
+#include "Shading.hpp"
+#include "ThreadPool.hpp"
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cmath>
+#include <glm/gtc/matrix_transform.hpp>
+#include <ng-log/logging.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define ANITO3D_RASTERIZER_SSE2 1
+#include <emmintrin.h>
+#endif
+
+namespace Anito3D {
+
+    namespace {
+        using Clock = std::chrono::steady_clock;
+
+        constexpr uint32_t BlockSize = 8;            // Hierarchical depth and coverage granularity
+        constexpr uint32_t MinChunkTriangles = 4096; // Binning chunk size floor
+        constexpr uint32_t ChunksPerThread = 4;
+        constexpr float FieldOfView = 45.0f;         // Vertical, degrees
+        constexpr float CameraElevation = 0.3f;      // Radians above the horizon
+        constexpr float SubpixelSteps = 16.0f;       // Vertex snapping
+
+        double ElapsedMilliseconds(Clock::time_point start, Clock::time_point end) {
+            return std::chrono::duration<double, std::milli>(end - start).count();
+        }
+
+        uint32_t PackColor(const glm::vec3& color) {
+            const auto channel = [](float value) { return static_cast<uint32_t>(std::clamp(value, 0.0f, 1.0f) * 255.0f + 0.5f); };
+            return channel(color.x) | channel(color.y) << 8 | channel(color.z) << 16 | 0xFF000000u;
+        }
+
+        float EncodeDisplay(float value) {
+            return std::pow(value / (1.0f + value), 1.0f / 2.2f);
+        }
+    }
+
+    RasterizerSettings RasterizerSettings::FromOptions(const BenchmarkOptions& options) {
+        RasterizerSettings settings;
+        settings.pbr = options.pbr;
+        settings.imagePath = options.imagePath;
+        return settings;
+    }
+
+    SoftwareRasterizer::SoftwareRasterizer(const RasterizerSettings& settings, ThreadPool* threadPool) : settings(settings), threadPool(threadPool) {
+        this->settings.tileSize = std::max<uint32_t>((settings.tileSize + BlockSize - 1) / BlockSize * BlockSize, BlockSize);
+        this->settings.orbitFrames = std::max(settings.orbitFrames, 1u);
+    }
+
+    bool SoftwareRasterizer::Init(uint32_t width, uint32_t height, const std::vector<std::unique_ptr<MeshEntity>>& entities) {
+        this->width = width;
+        this->height = height;
+        tilesX = (width + settings.tileSize - 1) / settings.tileSize;
+        tilesY = (height + settings.tileSize - 1) / settings.tileSize;
+        stride = tilesX * settings.tileSize;
+        const size_t paddedPixels = static_cast<size_t>(stride) * tilesY * settings.tileSize;
+        color.assign(paddedPixels, 0);
+        depth.assign(paddedPixels, 1.0f);
+        blockMaxDepth.assign(paddedPixels / (BlockSize * BlockSize), 1.0f);
+
+        // Every valid submesh range becomes one draw; instances transform the shared range again
+        ranges.clear();
+        vertexStarts.assign(1, 0);
+        triangleStarts.assign(1, 0);
+        MeshData::Bounds bounds;
+        bool hasBounds = false;
+        for (const auto& entity : entities) {
+            const MeshData& meshData = entity->GetMeshData();
+            for (uint32_t s = 0; s < meshData.subMeshes.size(); ++s) {
+                const MeshData::SubMesh& subMesh = meshData.subMeshes[s];
+                const size_t indexArraySize = subMesh.indexType == MeshData::IndexType::Uint16 ? meshData.indices16.size() : meshData.indices.size();
+                if (static_cast<size_t>(subMesh.firstIndex) + subMesh.indexCount > indexArraySize ||
+                    static_cast<size_t>(subMesh.vertexOffset) + subMesh.vertexCount > meshData.vertices.size() || subMesh.indexCount < 3) continue;
+                ranges.push_back({ &meshData, s, vertexStarts.back(), triangleStarts.back() });
+                vertexStarts.push_back(vertexStarts.back() + subMesh.vertexCount);
+                triangleStarts.push_back(triangleStarts.back() + subMesh.indexCount / 3);
+            }
+            if (!meshData.subMeshes.empty()) {
+                bounds = hasBounds ? MeshBounds::Merge(bounds, meshData.bounds) : meshData.bounds;
+                hasBounds = true;
+            }
+        }
+        projected.resize(vertexStarts.back());
+        sceneCenter = bounds.center;
+        sceneRadius = std::max(bounds.radius, 1e-3f);
+
+        const uint32_t triangleCount = triangleStarts.back();
+        const uint32_t threads = threadPool ? threadPool->GetThreadCount() + 1 : 1;
+        chunkTriangles = std::max(MinChunkTriangles, (triangleCount + threads * ChunksPerThread - 1) / (threads * ChunksPerThread));
+        chunks.clear();
+        chunks.resize((triangleCount + chunkTriangles - 1) / chunkTriangles);
+        for (Chunk& chunk : chunks) chunk.bins.resize(static_cast<size_t>(tilesX) * tilesY);
+
+        framesRendered = 0;
+        vertexMilliseconds = binMilliseconds = rasterMilliseconds = 0.0;
+        visibleTriangles = binEntries = rasterizedBlocks = culledBlocks = pixels = 0;
+
+        LOG(INFO) << "Software rasterizer: " << ranges.size() << " draws, " << triangleCount << " triangles, " << tilesX * tilesY << " tiles of "
+            << settings.tileSize << "x" << settings.tileSize << ", " << chunks.size() << " binning chunks, PBR " << (settings.pbr ? "on" : "off");
+        return true;
+    }
+
+    void SoftwareRasterizer::ForEach(size_t count, const std::function<void(size_t)>& body) {
+        if (threadPool) {
+            threadPool->ParallelFor(count, body);
+        }
+        else {
+            for (size_t i = 0; i < count; ++i) body(i);
+        }
+    }
+
+    void SoftwareRasterizer::RenderFrame(uint32_t frameIndex) {
+        UpdateCamera(frameIndex);
+
+        auto start = Clock::now();
+        if (threadPool) {
+            threadPool->ParallelForRange(projected.size(), [this](size_t begin, size_t end) { TransformVertices(begin, end); }, 1024);
+        }
+        else {
+            TransformVertices(0, projected.size());
+        }
+        auto transformed = Clock::now();
+
+        ForEach(chunks.size(), [this](size_t chunk) { BinChunk(static_cast<uint32_t>(chunk)); });
+        auto binned = Clock::now();
+
+        ForEach(static_cast<size_t>(tilesX) * tilesY, [this](size_t tile) { RasterizeTile(static_cast<uint32_t>(tile)); });
+        auto rasterized = Clock::now();
+
+        vertexMilliseconds += ElapsedMilliseconds(start, transformed);
+        binMilliseconds += ElapsedMilliseconds(transformed, binned);
+        rasterMilliseconds += ElapsedMilliseconds(binned, rasterized);
+        framesRendered++;
+    }
+
+    void SoftwareRasterizer::UpdateCamera(uint32_t frameIndex) {
+        const float angle = glm::two_pi<float>() * static_cast<float>(frameIndex % settings.orbitFrames) / static_cast<float>(settings.orbitFrames);
+        const float distance = sceneRadius / std::sin(glm::radians(FieldOfView) * 0.5f);
+        const glm::vec3 toEye(std::sin(angle) * std::cos(CameraElevation), std::sin(CameraElevation), std::cos(angle) * std::cos(CameraElevation));
+        eye = sceneCenter + toEye * distance;
+        // Near/far hug the bounding sphere; nothing inside it crosses the near plane
+        nearPlane = std::max(distance - sceneRadius * 1.01f, distance * 1e-3f);
+        const float farPlane = distance + sceneRadius * 1.01f;
+        viewProjection = glm::perspective(glm::radians(FieldOfView), static_cast<float>(width) / static_cast<float>(height), nearPlane, farPlane) *
+            glm::lookAt(eye, sceneCenter, glm::vec3(0.0f, 1.0f, 0.0f));
+    }
+
+    void SoftwareRasterizer::TransformVertices(size_t begin, size_t end) {
+        size_t r = std::upper_bound(vertexStarts.begin(), vertexStarts.end(), static_cast<uint32_t>(begin)) - vertexStarts.begin() - 1;
+        for (size_t v = begin; v < end; ++v) {
+            while (v >= vertexStarts[r + 1]) ++r;
+            const DrawRange& range = ranges[r];
+            const MeshData& meshData = *range.meshData;
+            const MeshData::SubMesh& subMesh = meshData.subMeshes[range.subMesh];
+            const uint32_t vertex = subMesh.vertexOffset + static_cast<uint32_t>(v - range.firstVertex);
+
+            const glm::vec4 world = subMesh.transform * glm::vec4(meshData.vertices[vertex], 1.0f);
+            const glm::vec4 clip = viewProjection * world;
+            ProjectedVertex& out = projected[v];
+            out.w = clip.w;
+            if (clip.w < nearPlane * 0.5f) continue; // Rejected in setup
+
+            const float inverseW = 1.0f / clip.w;
+            out.x = std::round((clip.x * inverseW * 0.5f + 0.5f) * static_cast<float>(width) * SubpixelSteps) / SubpixelSteps;
+            out.y = std::round((0.5f - clip.y * inverseW * 0.5f) * static_cast<float>(height) * SubpixelSteps) / SubpixelSteps;
+            out.z = clip.z * inverseW * 0.5f + 0.5f;
+
+            // Vertex lighting; meshes without normals are lit as if facing the camera
+            const glm::vec3 position(world);
+            const glm::vec3 view = glm::normalize(eye - position);
+            glm::vec3 normal = view;
+            if (!meshData.normals.empty()) {
+                const glm::vec3 transformed = glm::mat3(subMesh.transform) * meshData.normals[vertex];
+                if (glm::dot(transformed, transformed) > 1e-12f) normal = glm::normalize(transformed);
+            }
+            const MeshData::Material& material = meshData.GetMaterial(subMesh.materialId);
+            const float metallic = settings.pbr ? std::clamp(material.metallic, 0.0f, 1.0f) : 0.0f;
+            const glm::vec3 diffuseColor = Shading::DiffuseColor(material.albedo, metallic);
+            const float nDotL = std::max(glm::dot(normal, Shading::SunDirection), 0.0f);
+            glm::vec3 radiance = diffuseColor * (Shading::AmbientRadiance + Shading::SunRadiance * (nDotL * glm::one_over_pi<float>()));
+            if (settings.pbr) {
+                const glm::vec3 specularColor = Shading::SpecularColor(material.albedo, metallic);
+                const float roughness = std::clamp(material.roughness, 0.04f, 1.0f);
+                radiance += specularColor * Shading::AmbientRadiance;
+                if (nDotL > 0.0f) radiance += Shading::Ggx(normal, view, Shading::SunDirection, roughness, specularColor) * Shading::SunRadiance * nDotL;
+            }
+            out.color = glm::vec3(EncodeDisplay(radiance.x), EncodeDisplay(radiance.y), EncodeDisplay(radiance.z));
+        }
+    }
+
+    void SoftwareRasterizer::BinChunk(uint32_t chunkIndex) {
+        Chunk& chunk = chunks[chunkIndex];
+        chunk.setups.clear();
+        for (auto& bin : chunk.bins) bin.clear();
+
+        const uint32_t begin = chunkIndex * chunkTriangles;
+        const uint32_t end = std::min(begin + chunkTriangles, triangleStarts.back());
+        size_t r = std::upper_bound(triangleStarts.begin(), triangleStarts.end(), begin) - triangleStarts.begin() - 1;
+        FrameCounts counts;
+        for (uint32_t t = begin; t < end; ++t) {
+            while (t >= triangleStarts[r + 1]) ++r;
+            const DrawRange& range = ranges[r];
+            const MeshData& meshData = *range.meshData;
+            const MeshData::SubMesh& subMesh = meshData.subMeshes[range.subMesh];
+            const size_t first = static_cast<size_t>(t - range.firstTriangle) * 3;
+
+            const ProjectedVertex* v[3];
+            bool inFront = true;
+            for (int corner = 0; corner < 3; ++corner) {
+                v[corner] = &projected[range.firstVertex + meshData.GetIndex(subMesh, first + corner)];
+                inFront &= v[corner]->w >= nearPlane * 0.5f && v[corner]->z <= 1.0f;
+            }
+            if (!inFront) continue;
+
+            // Counter-clockwise front faces have negative area with y pointing down; reorder
+            // them to positive so "inside" is all edge functions >= 0
+            float area = (v[1]->x - v[0]->x) * (v[2]->y - v[0]->y) - (v[1]->y - v[0]->y) * (v[2]->x - v[0]->x);
+            if (area >= 0.0f) continue; // Back facing or degenerate
+            std::swap(v[1], v[2]);
+            area = -area;
+
+            TriangleSetup setup;
+            setup.minX = std::max(0, static_cast<int32_t>(std::floor(std::min({ v[0]->x, v[1]->x, v[2]->x }))));
+            setup.minY = std::max(0, static_cast<int32_t>(std::floor(std::min({ v[0]->y, v[1]->y, v[2]->y }))));
+            setup.maxX = std::min(static_cast<int32_t>(width) - 1, static_cast<int32_t>(std::ceil(std::max({ v[0]->x, v[1]->x, v[2]->x }))));
+            setup.maxY = std::min(static_cast<int32_t>(height) - 1, static_cast<int32_t>(std::ceil(std::max({ v[0]->y, v[1]->y, v[2]->y }))));
+            if (setup.minX > setup.maxX || setup.minY > setup.maxY) continue;
+
+            // Edge k is opposite vertex k, so edge k / area is vertex k's barycentric weight
+            const float inverseArea = 1.0f / area;
+            for (int k = 0; k < 3; ++k) {
+                const ProjectedVertex& a = *v[(k + 1) % 3];
+                const ProjectedVertex& b = *v[(k + 2) % 3];
+                setup.edgeA[k] = a.y - b.y;
+                setup.edgeB[k] = b.x - a.x;
+                setup.edgeC[k] = -(setup.edgeA[k] * a.x + setup.edgeB[k] * a.y);
+            }
+            const auto plane = [&](float a0, float a1, float a2, float& a, float& b, float& c) {
+                a = (setup.edgeA[0] * a0 + setup.edgeA[1] * a1 + setup.edgeA[2] * a2) * inverseArea;
+                b = (setup.edgeB[0] * a0 + setup.edgeB[1] * a1 + setup.edgeB[2] * a2) * inverseArea;
+                c = (setup.edgeC[0] * a0 + setup.edgeC[1] * a1 + setup.edgeC[2] * a2) * inverseArea;
+            };
+            plane(v[0]->z, v[1]->z, v[2]->z, setup.depthA, setup.depthB, setup.depthC);
+            for (int channel = 0; channel < 3; ++channel) {
+                plane(v[0]->color[channel], v[1]->color[channel], v[2]->color[channel], setup.colorA[channel], setup.colorB[channel], setup.colorC[channel]);
+            }
+            setup.minDepth = std::min({ v[0]->z, v[1]->z, v[2]->z });
+
+            const uint32_t index = static_cast<uint32_t>(chunk.setups.size());
+            chunk.setups.push_back(setup);
+            counts.visibleTriangles++;
+            for (int32_t ty = setup.minY / static_cast<int32_t>(settings.tileSize); ty <= setup.maxY / static_cast<int32_t>(settings.tileSize); ++ty) {
+                for (int32_t tx = setup.minX / static_cast<int32_t>(settings.tileSize); tx <= setup.maxX / static_cast<int32_t>(settings.tileSize); ++tx) {
+                    chunk.bins[static_cast<size_t>(ty) * tilesX + tx].push_back(index);
+                    counts.binEntries++;
+                }
+            }
+        }
+        visibleTriangles.fetch_add(counts.visibleTriangles, std::memory_order_relaxed);
+        binEntries.fetch_add(counts.binEntries, std::memory_order_relaxed);
+    }
+
+    void SoftwareRasterizer::RasterizeTile(uint32_t tile) {
+        const uint32_t x0 = (tile % tilesX) * settings.tileSize;
+        const uint32_t y0 = (tile / tilesX) * settings.tileSize;
+        const uint32_t blocksPerRow = stride / BlockSize;
+
+        // Clear the tile: sky color per row, far depth
+        for (uint32_t y = y0; y < y0 + settings.tileSize; ++y) {
+            const float up = 1.0f - static_cast<float>(y) / static_cast<float>(height);
+            const glm::vec3 sky = Shading::Sky(glm::vec3(0.0f, up, 0.0f));
+            const uint32_t background = PackColor(glm::vec3(EncodeDisplay(sky.x), EncodeDisplay(sky.y), EncodeDisplay(sky.z)));
+            std::fill_n(color.begin() + static_cast<size_t>(y) * stride + x0, settings.tileSize, background);
+            std::fill_n(depth.begin() + static_cast<size_t>(y) * stride + x0, settings.tileSize, 1.0f);
+        }
+        for (uint32_t by = y0 / BlockSize; by < (y0 + settings.tileSize) / BlockSize; ++by) {
+            std::fill_n(blockMaxDepth.begin() + static_cast<size_t>(by) * blocksPerRow + x0 / BlockSize, settings.tileSize / BlockSize, 1.0f);
+        }
+
+        FrameCounts counts;
+        const int32_t tileMaxX = static_cast<int32_t>(x0 + settings.tileSize) - 1;
+        const int32_t tileMaxY = static_cast<int32_t>(y0 + settings.tileSize) - 1;
+        for (const Chunk& chunk : chunks) {
+            for (uint32_t index : chunk.bins[tile]) {
+                const TriangleSetup& triangle = chunk.setups[index];
+                const uint32_t blockX0 = static_cast<uint32_t>(std::max<int32_t>(triangle.minX, x0)) / BlockSize;
+                const uint32_t blockY0 = static_cast<uint32_t>(std::max<int32_t>(triangle.minY, y0)) / BlockSize;
+                const uint32_t blockX1 = static_cast<uint32_t>(std::min(triangle.maxX, tileMaxX)) / BlockSize;
+                const uint32_t blockY1 = static_cast<uint32_t>(std::min(triangle.maxY, tileMaxY)) / BlockSize;
+
+                for (uint32_t by = blockY0; by <= blockY1; ++by) {
+                    for (uint32_t bx = blockX0; bx <= blockX1; ++bx) {
+                        float& maxDepth = blockMaxDepth[static_cast<size_t>(by) * blocksPerRow + bx];
+                        if (triangle.minDepth >= maxDepth) {
+                            counts.culledBlocks++;
+                            continue;
+                        }
+
+                        // Edge functions are linear, so the corner pixel centers bound the block
+                        const float left = bx * BlockSize + 0.5f, right = left + BlockSize - 1;
+                        const float top = by * BlockSize + 0.5f, bottom = top + BlockSize - 1;
+                        bool outside = false;
+                        bool covered = true;
+                        for (int k = 0; k < 3 && !outside; ++k) {
+                            const float e00 = triangle.edgeA[k] * left + triangle.edgeB[k] * top + triangle.edgeC[k];
+                            const float e10 = triangle.edgeA[k] * right + triangle.edgeB[k] * top + triangle.edgeC[k];
+                            const float e01 = triangle.edgeA[k] * left + triangle.edgeB[k] * bottom + triangle.edgeC[k];
+                            const float e11 = triangle.edgeA[k] * right + triangle.edgeB[k] * bottom + triangle.edgeC[k];
+                            outside = std::max({ e00, e10, e01, e11 }) < 0.0f;
+                            covered &= std::min({ e00, e10, e01, e11 }) >= 0.0f;
+                        }
+                        if (outside) continue;
+
+                        counts.rasterizedBlocks++;
+                        if (RasterizeBlock(triangle, bx * BlockSize, by * BlockSize, covered, counts)) {
+                            float blockMax = 0.0f;
+                            for (uint32_t y = 0; y < BlockSize; ++y) {
+                                const float* row = depth.data() + static_cast<size_t>(by * BlockSize + y) * stride + bx * BlockSize;
+                                blockMax = std::max(blockMax, *std::max_element(row, row + BlockSize));
+                            }
+                            maxDepth = blockMax;
+                        }
+                    }
+                }
+            }
+        }
+        rasterizedBlocks.fetch_add(counts.rasterizedBlocks, std::memory_order_relaxed);
+        culledBlocks.fetch_add(counts.culledBlocks, std::memory_order_relaxed);
+        pixels.fetch_add(counts.pixels, std::memory_order_relaxed);
+    }
+
+    bool SoftwareRasterizer::RasterizeBlock(const TriangleSetup& triangle, uint32_t blockX, uint32_t blockY, bool covered, FrameCounts& counts) {
+        bool written = false;
+#if defined(ANITO3D_RASTERIZER_SSE2)
+        const __m128 zero = _mm_setzero_ps();
+        const __m128 one = _mm_set1_ps(1.0f);
+        const __m128 scale = _mm_set1_ps(255.0f);
+        const __m128i alpha = _mm_set1_epi32(static_cast<int>(0xFF000000u));
+        const __m128 allLanes = _mm_castsi128_ps(_mm_set1_epi32(-1));
+        for (uint32_t y = 0; y < BlockSize; ++y) {
+            const float py = static_cast<float>(blockY + y) + 0.5f;
+            const size_t rowOffset = static_cast<size_t>(blockY + y) * stride;
+            for (uint32_t x = 0; x < BlockSize; x += 4) {
+                const __m128 px = _mm_add_ps(_mm_set1_ps(static_cast<float>(blockX + x)), _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f));
+                __m128 mask = allLanes;
+                if (!covered) {
+                    for (int k = 0; k < 3; ++k) {
+                        const __m128 edge = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(triangle.edgeA[k]), px), _mm_set1_ps(triangle.edgeB[k] * py + triangle.edgeC[k]));
+                        mask = _mm_and_ps(mask, _mm_cmpge_ps(edge, zero));
+                    }
+                }
+                float* depthRow = depth.data() + rowOffset + blockX + x;
+                const __m128 z = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(triangle.depthA), px), _mm_set1_ps(triangle.depthB * py + triangle.depthC));
+                const __m128 oldDepth = _mm_loadu_ps(depthRow);
+                mask = _mm_and_ps(mask, _mm_cmplt_ps(z, oldDepth));
+                const int bits = _mm_movemask_ps(mask);
+                if (bits == 0) continue;
+
+                _mm_storeu_ps(depthRow, _mm_or_ps(_mm_and_ps(mask, z), _mm_andnot_ps(mask, oldDepth)));
+                __m128i packed = alpha;
+                for (int channel = 0; channel < 3; ++channel) {
+                    __m128 value = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(triangle.colorA[channel]), px), _mm_set1_ps(triangle.colorB[channel] * py + triangle.colorC[channel]));
+                    value = _mm_mul_ps(_mm_min_ps(_mm_max_ps(value, zero), one), scale);
+                    packed = _mm_or_si128(packed, _mm_slli_epi32(_mm_cvtps_epi32(value), channel * 8));
+                }
+                __m128i* colorRow = reinterpret_cast<__m128i*>(color.data() + rowOffset + blockX + x);
+                const __m128i maskInt = _mm_castps_si128(mask);
+                _mm_storeu_si128(colorRow, _mm_or_si128(_mm_and_si128(maskInt, packed), _mm_andnot_si128(maskInt, _mm_loadu_si128(colorRow))));
+                counts.pixels += std::popcount(static_cast<uint32_t>(bits));
+                written = true;
+            }
+        }
+#else
+        for (uint32_t y = 0; y < BlockSize; ++y) {
+            const float py = static_cast<float>(blockY + y) + 0.5f;
+            for (uint32_t x = 0; x < BlockSize; ++x) {
+                const float px = static_cast<float>(blockX + x) + 0.5f;
+                bool inside = true;
+                for (int k = 0; k < 3 && !covered; ++k) inside &= triangle.edgeA[k] * px + (triangle.edgeB[k] * py + triangle.edgeC[k]) >= 0.0f;
+                const size_t pixel = static_cast<size_t>(blockY + y) * stride + blockX + x;
+                const float z = triangle.depthA * px + (triangle.depthB * py + triangle.depthC);
+                if (!inside || !(z < depth[pixel])) continue;
+                depth[pixel] = z;
+                glm::vec3 shaded;
+                for (int channel = 0; channel < 3; ++channel) {
+                    shaded[channel] = triangle.colorA[channel] * px + (triangle.colorB[channel] * py + triangle.colorC[channel]);
+                }
+                color[pixel] = PackColor(shaded);
+                counts.pixels++;
+                written = true;
+            }
+        }
+#endif
+        return written;
+    }
+
+    std::vector<uint8_t> SoftwareRasterizer::GetImage() const {
+        std::vector<uint8_t> rgb(static_cast<size_t>(width) * height * 3);
+        for (uint32_t y = 0; y < height; ++y) {
+            for (uint32_t x = 0; x < width; ++x) {
+                const uint32_t pixel = color[static_cast<size_t>(y) * stride + x];
+                uint8_t* out = rgb.data() + (static_cast<size_t>(y) * width + x) * 3;
+                out[0] = static_cast<uint8_t>(pixel);
+                out[1] = static_cast<uint8_t>(pixel >> 8);
+                out[2] = static_cast<uint8_t>(pixel >> 16);
+            }
+        }
+        return rgb;
+    }
+
+    void SoftwareRasterizer::Shutdown() {
+        if (!settings.imagePath.empty() && framesRendered > 0) {
+            if (ImageWriter::Write(settings.imagePath, width, height, GetImage())) {
+                LOG(INFO) << "Software rasterizer frame written to " << settings.imagePath;
+            }
+            else {
+                LOG(ERROR) << "Failed to write software rasterizer frame to " << settings.imagePath;
+            }
+        }
+        chunks.clear();
+        projected.clear();
+        color.clear();
+        depth.clear();
+        blockMaxDepth.clear();
+    }
+
+    void SoftwareRasterizer::ReportStats(BenchmarkReport& report) const {
+        const std::string section = "rasterizer";
+        const double frames = std::max(framesRendered, 1u);
+        const std::vector<uint8_t> image = GetImage();
+        const double overdraw = static_cast<double>(pixels.load()) / frames / (static_cast<double>(width) * height);
+
+        report.SetMetric(section, "draws", static_cast<uint64_t>(ranges.size()));
+        report.SetMetric(section, "triangles", static_cast<uint64_t>(triangleStarts.back()));
+        report.SetMetric(section, "tileSize", static_cast<uint64_t>(settings.tileSize));
+        report.SetMetric(section, "tiles", static_cast<uint64_t>(tilesX) * tilesY);
+        report.SetMetric(section, "binningChunks", static_cast<uint64_t>(chunks.size()));
+        report.SetMetric(section, "frames", static_cast<uint64_t>(framesRendered));
+        report.SetMetric(section, "visibleTriangles", visibleTriangles.load() / frames);
+        report.SetMetric(section, "binEntries", binEntries.load() / frames);
+        report.SetMetric(section, "rasterizedBlocks", rasterizedBlocks.load() / frames);
+        report.SetMetric(section, "hiZCulledBlocks", culledBlocks.load() / frames);
+        report.SetMetric(section, "overdraw", overdraw);
+        report.SetMetric(section, "vertexMs", vertexMilliseconds / frames);
+        report.SetMetric(section, "binMs", binMilliseconds / frames);
+        report.SetMetric(section, "rasterMs", rasterMilliseconds / frames);
+        report.SetMetric(section, "imageHash", HashBytes(image.data(), image.size()));
+        LOG(INFO) << "Software rasterizer: " << framesRendered << " frames, per frame " << visibleTriangles.load() / frames << " visible triangles, "
+            << culledBlocks.load() / frames << " blocks rejected by hierarchical depth, overdraw " << overdraw << ", vertex "
+            << vertexMilliseconds / frames << " ms, bin " << binMilliseconds / frames << " ms, raster " << rasterMilliseconds / frames << " ms";
+    }
+}
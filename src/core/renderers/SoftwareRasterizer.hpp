@@ -0,0 +1,132 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "HeadlessRenderer.hpp"
+
+namespace Anito3D {
+
+    class ThreadPool;
+    struct BenchmarkOptions;
+
+    struct RasterizerSettings {
+        bool pbr = false;           // GGX specular in the vertex lighting, otherwise Lambert
+        uint32_t tileSize = 64;     // Binning tile side in pixels (multiple of 8)
+        uint32_t orbitFrames = 360; // Frames per camera orbit around the scene
+        std::string imagePath;      // Last frame, written at shutdown (see ImageWriter::Write), empty = none
+
+        static RasterizerSettings FromOptions(const BenchmarkOptions& options);
+    };
+
+    // GPU-free renderer drawing every loaded MeshData into an offscreen RGBA8 + float depth
+    // framebuffer. Each frame runs three parallel stages on the job system:
+    //  1. vertex: transform and light (per vertex, Gouraud) every submesh range,
+    //  2. bin: set up edge/depth/color planes, cull back faces and append each triangle to
+    //     the screen tiles its bounds touch (per chunk of triangles, so no locking),
+    //  3. raster: one job per tile walks its bins in submission order over 8x8 blocks; a block
+    //     is skipped when the triangle's nearest depth is behind the block's farthest (the
+    //     hierarchical depth), fully covered blocks skip the edge tests, and pixels are
+    //     tested and shaded four at a time with SSE2.
+    // The camera orbits the scene at a fixed rate per frame, so frame timings compare across
+    // runs and commits.
+    class SoftwareRasterizer : public HeadlessRenderer {
+    public:
+        SoftwareRasterizer(const RasterizerSettings& settings, ThreadPool* threadPool = nullptr);
+
+        const char* GetName() const override { return "software"; }
+
+        bool Init(uint32_t width, uint32_t height, const std::vector<std::unique_ptr<MeshEntity>>& entities) override;
+        void RenderFrame(uint32_t frameIndex) override;
+        void Shutdown() override;
+        void ReportStats(BenchmarkReport& report) const override;
+
+        // Last frame as 8-bit RGB, rows top to bottom
+        std::vector<uint8_t> GetImage() const;
+
+    private:
+        struct DrawRange {
+            const MeshData* meshData;
+            uint32_t subMesh;
+            uint32_t firstVertex;   // Into projected
+            uint32_t firstTriangle; // Global triangle numbering across ranges
+        };
+
+        struct ProjectedVertex {
+            float x, y; // Pixels, snapped to 1/16
+            float z;    // Depth in [0, 1]
+            float w;    // Clip w (view depth)
+            glm::vec3 color; // Lit, tone mapped and sRGB encoded
+        };
+
+        // Screen-space plane equations value = a * x + b * y + c over pixel centers
+        struct TriangleSetup {
+            float edgeA[3], edgeB[3], edgeC[3]; // Inside where all three are >= 0
+            float depthA, depthB, depthC;
+            float colorA[3], colorB[3], colorC[3]; // Per channel
+            float minDepth;
+            int32_t minX, minY, maxX, maxY; // Pixel bounds, clipped to the screen
+        };
+
+        // Triangles of one contiguous chunk, binned per tile
+        struct Chunk {
+            std::vector<TriangleSetup> setups;
+            std::vector<std::vector<uint32_t>> bins; // Per tile, indices into setups
+        };
+
+        struct FrameCounts {
+            uint64_t visibleTriangles = 0;
+            uint64_t binEntries = 0;
+            uint64_t rasterizedBlocks = 0;
+            uint64_t culledBlocks = 0; // Rejected by the hierarchical depth
+            uint64_t pixels = 0;       // Depth test passes
+        };
+
+        RasterizerSettings settings;
+        ThreadPool* threadPool;
+        uint32_t width = 0;
+        uint32_t height = 0;
+        uint32_t stride = 0; // Framebuffer row length, padded to whole tiles
+        uint32_t tilesX = 0;
+        uint32_t tilesY = 0;
+
+        std::vector<DrawRange> ranges;
+        std::vector<uint32_t> vertexStarts;   // firstVertex per range plus the total
+        std::vector<uint32_t> triangleStarts; // firstTriangle per range plus the total
+        std::vector<ProjectedVertex> projected;
+        std::vector<Chunk> chunks;
+        uint32_t chunkTriangles = 0;
+
+        std::vector<uint32_t> color; // RGBA8, stride x padded height
+        std::vector<float> depth;
+        std::vector<float> blockMaxDepth; // Hierarchical depth, one per 8x8 block
+
+        glm::mat4 viewProjection{ 1.0f };
+        glm::vec3 eye{ 0.0f };
+        glm::vec3 sceneCenter{ 0.0f };
+        float sceneRadius = 1.0f;
+        float nearPlane = 0.1f;
+
+        uint32_t framesRendered = 0;
+        double vertexMilliseconds = 0.0;
+        double binMilliseconds = 0.0;
+        double rasterMilliseconds = 0.0;
+        std::atomic<uint64_t> visibleTriangles{ 0 };
+        std::atomic<uint64_t> binEntries{ 0 };
+        std::atomic<uint64_t> rasterizedBlocks{ 0 };
+        std::atomic<uint64_t> culledBlocks{ 0 };
+        std::atomic<uint64_t> pixels{ 0 };
+
+        void UpdateCamera(uint32_t frameIndex);
+        void TransformVertices(size_t begin, size_t end);
+        void BinChunk(uint32_t chunk);
+        void RasterizeTile(uint32_t tile);
+        bool RasterizeBlock(const TriangleSetup& triangle, uint32_t blockX, uint32_t blockY, bool covered, FrameCounts& counts);
+        void ForEach(size_t count, const std::function<void(size_t)>& body);
+    };
+
+}
@@ -0,0 +1,253 @@
+#include "ThreadPool.hpp"
+#include "Trace.hpp"
+#include <algorithm>
+#include <string>
+
+namespace Anito3D {
+
+    namespace {
+        // Set on worker threads so jobs they schedule land in their own deque
+        thread_local const ThreadPool* currentPool = nullptr;
+        thread_local uint32_t currentQueue = 0;
+        // Jobs run while helping inside another job; only the outermost one counts as busy time
+        thread_local uint32_t jobDepth = 0;
+    }
+
+    double ThreadPoolStatistics::GetAverageUtilization() const {
+        if (workers.empty()) return 0.0;
+        double total = 0.0;
+        for (const auto& worker : workers) total += worker.utilization;
+        return total / static_cast<double>(workers.size());
+    }
+
+    ThreadPool::ThreadPool(uint32_t threadCount) {
+        if (threadCount == 0) {
+            uint32_t hardwareThreads = std::thread::hardware_concurrency();
+            threadCount = hardwareThreads > 1 ? hardwareThreads - 1 : 1;
+        }
+
+        queueCount = threadCount + 1;
+        queues = std::make_unique<Queue[]>(queueCount);
+        workers.reserve(threadCount);
+        for (uint32_t i = 0; i < threadCount; ++i) {
+            workers.emplace_back([this, i]() { WorkerLoop(i); });
+        }
+    }
+
+    ThreadPool::~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex);
+            stopping = true;
+        }
+        wakeCondition.notify_all();
+        for (auto& worker : workers) {
+            worker.join();
+        }
+    }
+
+    uint32_t ThreadPool::GetQueueIndex() const {
+        return currentPool == this ? currentQueue : queueCount - 1;
+    }
+
+    void ThreadPool::Schedule(std::function<void()> function, JobCounter* counter, JobCounter* dependency) {
+        if (counter) counter->value.fetch_add(1);
+        if (dependency) {
+            // Checked under the dependency's lock so its last job cannot release the list in between
+            std::lock_guard<std::mutex> lock(dependency->mutex);
+            if (dependency->value.load() > 0) {
+                dependency->waiting.push_back({ std::move(function), counter });
+                return;
+            }
+        }
+        Push({ std::move(function), counter });
+    }
+
+    void ThreadPool::Push(Job job) {
+        Queue& queue = queues[GetQueueIndex()];
+        {
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            queue.jobs.push_back(std::move(job));
+            queue.size.store(queue.jobs.size());
+            queuedJobs.fetch_add(1);
+        }
+        WakeSleepers(false);
+    }
+
+    void ThreadPool::WakeSleepers(bool all) {
+        // Sleepers register before re-checking their condition, so a zero here means the
+        // change is already visible to anyone about to sleep
+        if (sleepers.load() == 0) return;
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex);
+        }
+        if (all) wakeCondition.notify_all();
+        else wakeCondition.notify_one();
+    }
+
+    bool ThreadPool::TryRunJob(uint32_t queueIndex) {
+        Job job;
+        bool found = false;
+        bool stolen = false;
+        {
+            Queue& own = queues[queueIndex];
+            std::lock_guard<std::mutex> lock(own.mutex);
+            if (!own.jobs.empty()) {
+                job = std::move(own.jobs.back());
+                own.jobs.pop_back();
+                own.size.store(own.jobs.size());
+                queuedJobs.fetch_sub(1);
+                found = true;
+            }
+        }
+        for (uint32_t offset = 1; !found && offset < queueCount; ++offset) {
+            Queue& victim = queues[(queueIndex + offset) % queueCount];
+            if (victim.size.load() == 0) continue;
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            if (!victim.jobs.empty()) {
+                job = std::move(victim.jobs.front());
+                victim.jobs.pop_front();
+                victim.size.store(victim.jobs.size());
+                queuedJobs.fetch_sub(1);
+                found = stolen = true;
+            }
+        }
+        if (!found) return false;
+
+        if (stolen) queues[queueIndex].stolen.fetch_add(1, std::memory_order_relaxed);
+        RunJob(job, queueIndex);
+        return true;
+    }
+
+    void ThreadPool::RunJob(Job& job, uint32_t queueIndex) {
+        const bool outermost = jobDepth++ == 0;
+        auto start = outermost ? Clock::now() : Clock::time_point();
+        {
+            ANITO3D_TRACE_ZONE("job");
+            job.function();
+        }
+        job.function = nullptr; // Release captures before the counter tells waiters we are done
+        jobDepth--;
+
+        Queue& queue = queues[queueIndex];
+        queue.executed.fetch_add(1, std::memory_order_relaxed);
+        if (outermost) {
+            auto busy = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+            queue.busyNanoseconds.fetch_add(static_cast<uint64_t>(busy), std::memory_order_relaxed);
+        }
+        if (job.counter) Finish(*job.counter);
+    }
+
+    void ThreadPool::Finish(JobCounter& counter) {
+        std::vector<JobCounter::Deferred> released;
+        bool done = false;
+        {
+            std::lock_guard<std::mutex> lock(counter.mutex);
+            if (counter.value.fetch_sub(1) == 1) {
+                released.swap(counter.waiting);
+                done = true;
+            }
+        }
+        // counter may already be gone here (Wait() returns once it can take the lock)
+        for (auto& deferred : released) Push({ std::move(deferred.function), deferred.counter });
+        if (done) WakeSleepers(true);
+    }
+
+    void ThreadPool::Wait(JobCounter& counter) {
+        const uint32_t queueIndex = GetQueueIndex();
+        while (!counter.IsDone()) {
+            if (TryRunJob(queueIndex)) continue;
+
+            std::unique_lock<std::mutex> lock(sleepMutex);
+            sleepers.fetch_add(1);
+            wakeCondition.wait(lock, [&]() { return counter.IsDone() || queuedJobs.load() > 0; });
+            sleepers.fetch_sub(1);
+        }
+        // The job that zeroed the counter still holds its lock until it stops touching it
+        std::lock_guard<std::mutex> lock(counter.mutex);
+    }
+
+    void ThreadPool::WorkerLoop(uint32_t queueIndex) {
+        currentPool = this;
+        currentQueue = queueIndex;
+        ANITO3D_TRACE_THREAD_NAME("Worker " + std::to_string(queueIndex));
+        while (true) {
+            if (TryRunJob(queueIndex)) continue;
+
+            std::unique_lock<std::mutex> lock(sleepMutex);
+            if (stopping && queuedJobs.load() == 0) return;
+            sleepers.fetch_add(1);
+            wakeCondition.wait(lock, [this]() { return stopping || queuedJobs.load() > 0; });
+            sleepers.fetch_sub(1);
+        }
+    }
+
+    void ThreadPool::ParallelFor(size_t count, const std::function<void(size_t)>& body) {
+        ParallelForRange(count, [&body](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) body(i);
+        });
+    }
+
+    void ThreadPool::ParallelForRange(size_t count, const std::function<void(size_t, size_t)>& body, size_t minGrain) {
+        if (count == 0) return;
+
+        // Enough pieces that a slow thread or an uneven range does not leave the others idle,
+        // few enough that scheduling stays negligible next to the work
+        const size_t targetRanges = (workers.size() + 1) * RangesPerThread;
+        const size_t grain = std::max(std::max<size_t>(minGrain, 1), (count + targetRanges - 1) / targetRanges);
+        if (workers.empty() || count <= grain) {
+            body(0, count);
+            return;
+        }
+
+        JobCounter counter;
+        std::mutex errorMutex;
+        std::exception_ptr error;
+
+        // Keep the lower half, publish the upper half: the oldest (largest) pieces sit at the
+        // front of the deque where thieves take from
+        std::function<void(size_t, size_t)> split = [&](size_t begin, size_t end) {
+            while (end - begin > grain) {
+                const size_t middle = begin + (end - begin) / 2;
+                Schedule([&split, middle, end]() { split(middle, end); }, &counter);
+                end = middle;
+            }
+            try {
+                body(begin, end);
+            }
+            catch (...) {
+                std::lock_guard<std::mutex> lock(errorMutex);
+                if (!error) error = std::current_exception();
+            }
+        };
+        split(0, count);
+        Wait(counter);
+
+        if (error) std::rethrow_exception(error);
+    }
+
+    ThreadPoolStatistics ThreadPool::GetStatistics() const {
+        ThreadPoolStatistics statistics;
+        statistics.wallMilliseconds = std::chrono::duration<double, std::milli>(Clock::now() - statisticsStart).count();
+
+        auto read = [&](const Queue& queue) {
+            WorkerStatistics worker;
+            worker.jobs = queue.executed.load(std::memory_order_relaxed);
+            worker.steals = queue.stolen.load(std::memory_order_relaxed);
+            worker.busyMilliseconds = static_cast<double>(queue.busyNanoseconds.load(std::memory_order_relaxed)) / 1.0e6;
+            worker.utilization = statistics.wallMilliseconds > 0.0 ? worker.busyMilliseconds / statistics.wallMilliseconds : 0.0;
+            return worker;
+        };
+        for (uint32_t i = 0; i + 1 < queueCount; ++i) statistics.workers.push_back(read(queues[i]));
+        statistics.external = read(queues[queueCount - 1]);
+        return statistics;
+    }
+
+    void ThreadPool::ResetStatistics() {
+        for (uint32_t i = 0; i < queueCount; ++i) {
+            queues[i].executed.store(0, std::memory_order_relaxed);
+            queues[i].stolen.store(0, std::memory_order_relaxed);
+            queues[i].busyNanoseconds.store(0, std::memory_order_relaxed);
+        }
+        statisticsStart = Clock::now();
+    }
+}
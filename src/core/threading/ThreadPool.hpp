@@ -0,0 +1,147 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace Anito3D {
+
+    // Counts unfinished jobs. Jobs scheduled with a counter keep it above zero until they
+    // return; a counter can also hold back other jobs (dependency) and be waited on.
+    // A counter must outlive its jobs and be idle (zero) when it is destroyed.
+    class JobCounter {
+    public:
+        JobCounter() = default;
+        JobCounter(const JobCounter&) = delete;
+        JobCounter& operator=(const JobCounter&) = delete;
+
+        bool IsDone() const { return value.load() == 0; }
+        uint32_t GetValue() const { return value.load(); }
+
+    private:
+        friend class ThreadPool;
+
+        struct Deferred {
+            std::function<void()> function;
+            JobCounter* counter;
+        };
+
+        std::atomic<uint32_t> value{ 0 };
+        std::mutex mutex;
+        std::vector<Deferred> waiting; // Jobs released when value drops to zero
+    };
+
+    struct WorkerStatistics {
+        uint64_t jobs = 0;          // Jobs executed by this thread
+        uint64_t steals = 0;        // Of those, taken from another thread's deque
+        double busyMilliseconds = 0.0;
+        double utilization = 0.0;   // Busy time / wall time since the last reset
+    };
+
+    struct ThreadPoolStatistics {
+        std::vector<WorkerStatistics> workers;
+        WorkerStatistics external; // Threads outside the pool, while they help in Wait()/ParallelFor
+        double wallMilliseconds = 0.0;
+
+        double GetAverageUtilization() const; // Over the workers
+    };
+
+    // Work-stealing job system. Every worker owns a deque: it pushes and pops its own jobs
+    // at the back (newest first, still warm in cache) while idle workers steal the oldest
+    // job from the front of someone else's. Threads outside the pool share one extra deque
+    // and help run jobs while they wait, so nested parallel calls cannot deadlock.
+    class ThreadPool {
+    public:
+        // threadCount == 0 uses one worker per hardware thread minus the calling thread
+        explicit ThreadPool(uint32_t threadCount = 0);
+        ~ThreadPool();
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        uint32_t GetThreadCount() const { return static_cast<uint32_t>(workers.size()); }
+
+        // Runs function on the pool. With a counter, the counter stays above zero until
+        // function returns; with a dependency, function only starts once the dependency's
+        // jobs have finished. function must not throw (use Submit for that).
+        void Schedule(std::function<void()> function, JobCounter* counter = nullptr, JobCounter* dependency = nullptr);
+
+        // Runs other jobs on the calling thread until counter reaches zero
+        void Wait(JobCounter& counter);
+
+        template <typename Function>
+        auto Submit(Function&& function) -> std::future<std::invoke_result_t<Function>> {
+            using Result = std::invoke_result_t<Function>;
+            auto task = std::make_shared<std::packaged_task<Result()>>(std::forward<Function>(function));
+            std::future<Result> future = task->get_future();
+            Schedule([task]() { (*task)(); });
+            return future;
+        }
+
+        // Run body(i) for i in [0, count). The calling thread takes part, so nested calls
+        // from inside a worker cannot deadlock. Returns after every index has finished and
+        // rethrows the first exception thrown by body.
+        void ParallelFor(size_t count, const std::function<void(size_t)>& body);
+
+        // Run body(begin, end) over disjoint ranges covering [0, count). The range is split
+        // in halves down to a grain derived from count and the thread count (never below
+        // minGrain); idle workers steal the largest halves still queued. Same waiting and
+        // exception rules as ParallelFor.
+        void ParallelForRange(size_t count, const std::function<void(size_t, size_t)>& body, size_t minGrain = 1);
+
+        ThreadPoolStatistics GetStatistics() const;
+        void ResetStatistics();
+
+    private:
+        using Clock = std::chrono::steady_clock;
+
+        static constexpr size_t RangesPerThread = 8; // Target split count per thread for ParallelForRange
+
+        struct Job {
+            std::function<void()> function;
+            JobCounter* counter = nullptr;
+        };
+
+        // Cache-line aligned so owners and thieves of neighbouring deques do not false-share
+        struct alignas(64) Queue {
+            std::mutex mutex;
+            std::deque<Job> jobs;
+            std::atomic<size_t> size{ 0 }; // Lets thieves skip empty deques without locking
+
+            std::atomic<uint64_t> executed{ 0 };
+            std::atomic<uint64_t> stolen{ 0 };
+            std::atomic<uint64_t> busyNanoseconds{ 0 };
+        };
+
+        std::vector<std::thread> workers;
+        std::unique_ptr<Queue[]> queues; // One per worker plus the shared external queue (last)
+        uint32_t queueCount = 0;
+
+        std::atomic<uint64_t> queuedJobs{ 0 }; // Jobs sitting in a deque (not deferred, not running)
+        std::atomic<uint32_t> sleepers{ 0 };
+        std::mutex sleepMutex;
+        std::condition_variable wakeCondition;
+        bool stopping = false;
+
+        Clock::time_point statisticsStart = Clock::now();
+
+        uint32_t GetQueueIndex() const; // The calling thread's own deque
+        void Push(Job job);
+        bool TryRunJob(uint32_t queueIndex);
+        void RunJob(Job& job, uint32_t queueIndex);
+        void Finish(JobCounter& counter);
+        void WakeSleepers(bool all);
+        void WorkerLoop(uint32_t queueIndex);
+    };
+
+}
@@ -0,0 +1,183 @@
+#include "FrameContext.hpp"
+#include "Trace.hpp"
+#include <ng-log/logging.h>
+#include <algorithm>
+#include <chrono>
+
+namespace Anito3D {
+
+    bool FrameAllocator::init(VkPhysicalDevice physicalDevice, VkDevice device, VkDeviceSize capacity) {
+        cleanup();
+        this->device = device;
+
+        VkPhysicalDeviceProperties properties;
+        vkGetPhysicalDeviceProperties(physicalDevice, &properties);
+        minAlignment = std::max({ properties.limits.minUniformBufferOffsetAlignment, properties.limits.minStorageBufferOffsetAlignment, VkDeviceSize(16) });
+
+        VkBufferCreateInfo bufferInfo = { VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO };
+        bufferInfo.size = capacity;
+        bufferInfo.usage = VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT |
+            VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+        bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+        VkResult result = vkCreateBuffer(device, &bufferInfo, nullptr, &buffer);
+        if (result != VK_SUCCESS) {
+            LOG(ERROR) << "Failed to create frame allocator buffer: " << result;
+            cleanup();
+            return false;
+        }
+
+        VkMemoryRequirements requirements;
+        vkGetBufferMemoryRequirements(device, buffer, &requirements);
+        VkPhysicalDeviceMemoryProperties memoryProperties;
+        vkGetPhysicalDeviceMemoryProperties(physicalDevice, &memoryProperties);
+
+        // Host-visible coherent memory always exists; prefer the device-local kind (resizable BAR, UMA)
+        const VkMemoryPropertyFlags required = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+        uint32_t memoryType = UINT32_MAX;
+        for (VkMemoryPropertyFlags preferred : { required | VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, required }) {
+            for (uint32_t i = 0; i < memoryProperties.memoryTypeCount && memoryType == UINT32_MAX; ++i) {
+                if ((requirements.memoryTypeBits & (1u << i)) && (memoryProperties.memoryTypes[i].propertyFlags & preferred) == preferred) memoryType = i;
+            }
+        }
+        if (memoryType == UINT32_MAX) {
+            LOG(ERROR) << "No host-visible coherent memory type for the frame allocator";
+            cleanup();
+            return false;
+        }
+
+        VkMemoryAllocateInfo allocInfo = { VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO };
+        allocInfo.allocationSize = requirements.size;
+        allocInfo.memoryTypeIndex = memoryType;
+        result = vkAllocateMemory(device, &allocInfo, nullptr, &memory);
+        if (result != VK_SUCCESS) {
+            LOG(ERROR) << "Failed to allocate frame allocator memory: " << result;
+            cleanup();
+            return false;
+        }
+        vkBindBufferMemory(device, buffer, memory, 0);
+
+        void* data = nullptr;
+        result = vkMapMemory(device, memory, 0, VK_WHOLE_SIZE, 0, &data);
+        if (result != VK_SUCCESS) {
+            LOG(ERROR) << "Failed to map frame allocator memory: " << result;
+            cleanup();
+            return false;
+        }
+        mapped = static_cast<uint8_t*>(data);
+        this->capacity = capacity;
+        return true;
+    }
+
+    void FrameAllocator::cleanup() {
+        if (device != VK_NULL_HANDLE) {
+            if (mapped) vkUnmapMemory(device, memory);
+            if (buffer) vkDestroyBuffer(device, buffer, nullptr);
+            if (memory) vkFreeMemory(device, memory, nullptr);
+        }
+        device = VK_NULL_HANDLE;
+        buffer = VK_NULL_HANDLE;
+        memory = VK_NULL_HANDLE;
+        mapped = nullptr;
+        capacity = offset = peakUsed = 0;
+        failedAllocations = 0;
+    }
+
+    FrameAllocator::Allocation FrameAllocator::allocate(VkDeviceSize size, VkDeviceSize alignment) {
+        if (alignment == 0) alignment = minAlignment;
+        const VkDeviceSize begin = (offset + alignment - 1) / alignment * alignment;
+        if (!mapped || size > capacity || begin > capacity - size) {
+            ++failedAllocations;
+            return {};
+        }
+        offset = begin + size;
+        peakUsed = std::max(peakUsed, offset);
+        return { buffer, begin, size, mapped + begin };
+    }
+
+    void FrameAllocator::reset() {
+        offset = 0;
+    }
+
+    bool FrameContextRing::init(VkPhysicalDevice physicalDevice, VkDevice device, uint32_t queueFamilyIndex, uint32_t framesInFlight, VkDeviceSize transientBytesPerFrame) {
+        cleanup();
+        this->device = device;
+        frames.resize(std::clamp(framesInFlight, 1u, MaxFramesInFlight));
+
+        VkCommandPoolCreateInfo poolInfo = { VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO };
+        poolInfo.queueFamilyIndex = queueFamilyIndex;
+        poolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT; // Reset as a whole every frame
+        VkSemaphoreCreateInfo semaphoreInfo = { VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO };
+        VkFenceCreateInfo fenceInfo = { VK_STRUCTURE_TYPE_FENCE_CREATE_INFO };
+        fenceInfo.flags = VK_FENCE_CREATE_SIGNALED_BIT;
+
+        for (size_t i = 0; i < frames.size(); ++i) {
+            FrameContext& frame = frames[i];
+            VkResult result = vkCreateCommandPool(device, &poolInfo, nullptr, &frame.commandPool);
+            if (result != VK_SUCCESS) {
+                LOG(ERROR) << "Failed to create command pool for frame " << i << ": " << result;
+                cleanup();
+                return false;
+            }
+            VkCommandBufferAllocateInfo allocInfo = { VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO };
+            allocInfo.commandPool = frame.commandPool;
+            allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+            allocInfo.commandBufferCount = 1;
+            result = vkAllocateCommandBuffers(device, &allocInfo, &frame.commandBuffer);
+            if (result != VK_SUCCESS) {
+                LOG(ERROR) << "Failed to allocate command buffer for frame " << i << ": " << result;
+                cleanup();
+                return false;
+            }
+            result = vkCreateSemaphore(device, &semaphoreInfo, nullptr, &frame.imageAvailable);
+            if (result != VK_SUCCESS) {
+                LOG(ERROR) << "Failed to create image available semaphore " << i << ": " << result;
+                cleanup();
+                return false;
+            }
+            result = vkCreateFence(device, &fenceInfo, nullptr, &frame.inFlight);
+            if (result != VK_SUCCESS) {
+                LOG(ERROR) << "Failed to create fence " << i << ": " << result;
+                cleanup();
+                return false;
+            }
+            if (!frame.allocator.init(physicalDevice, device, transientBytesPerFrame)) {
+                cleanup();
+                return false;
+            }
+        }
+
+        LOG(INFO) << "Created " << frames.size() << " frame contexts with " << transientBytesPerFrame / 1024 << " KiB transient memory each";
+        return true;
+    }
+
+    void FrameContextRing::cleanup() {
+        if (device != VK_NULL_HANDLE) {
+            for (auto& frame : frames) {
+                frame.allocator.cleanup();
+                if (frame.inFlight) vkDestroyFence(device, frame.inFlight, nullptr);
+                if (frame.imageAvailable) vkDestroySemaphore(device, frame.imageAvailable, nullptr);
+                if (frame.commandPool) vkDestroyCommandPool(device, frame.commandPool, nullptr); // Frees its command buffer
+            }
+        }
+        frames.clear();
+        device = VK_NULL_HANDLE;
+        slot = 0;
+    }
+
+    FrameContext& FrameContextRing::beginFrame() {
+        FrameContext& frame = frames[slot];
+        {
+            ANITO3D_TRACE_ZONE("FrameContext::waitForFence");
+            const auto waitStart = std::chrono::steady_clock::now();
+            vkWaitForFences(device, 1, &frame.inFlight, VK_TRUE, UINT64_MAX);
+            lastFenceWaitMs = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - waitStart).count();
+        }
+        vkResetCommandPool(device, frame.commandPool, 0);
+        frame.allocator.reset();
+        return frame;
+    }
+
+    void FrameContextRing::endFrame() {
+        slot = (slot + 1) % static_cast<uint32_t>(frames.size());
+    }
+}
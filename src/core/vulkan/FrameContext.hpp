@@ -0,0 +1,100 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+#include <cstdint>
+#include <vector>
+
+namespace Anito3D {
+
+    // Transient per-frame memory: one persistently mapped host-visible, host-coherent buffer
+    // that is handed out linearly and rewound when its frame slot comes around again. Meant
+    // for uniforms and small per-frame uploads whose lifetime is a single frame; anything
+    // that outlives the frame needs its own allocation.
+    class FrameAllocator {
+    public:
+        struct Allocation {
+            VkBuffer buffer = VK_NULL_HANDLE;
+            VkDeviceSize offset = 0;
+            VkDeviceSize size = 0;
+            void* data = nullptr; // Mapped, writes need no flush
+
+            explicit operator bool() const { return data != nullptr; }
+        };
+
+        FrameAllocator() = default;
+        ~FrameAllocator() = default;
+
+        bool init(VkPhysicalDevice physicalDevice, VkDevice device, VkDeviceSize capacity);
+        void cleanup();
+
+        // Empty allocation when the frame's budget is exhausted. alignment 0 uses the device's
+        // uniform/storage offset alignment, which also suits vertex and index data.
+        Allocation allocate(VkDeviceSize size, VkDeviceSize alignment = 0);
+        void reset();
+
+        VkDeviceSize getCapacity() const { return capacity; }
+        VkDeviceSize getUsed() const { return offset; }
+        VkDeviceSize getPeakUsed() const { return peakUsed; }
+        uint64_t getFailedAllocations() const { return failedAllocations; }
+
+    private:
+        VkDevice device = VK_NULL_HANDLE;
+        VkBuffer buffer = VK_NULL_HANDLE;
+        VkDeviceMemory memory = VK_NULL_HANDLE;
+        uint8_t* mapped = nullptr;
+        VkDeviceSize capacity = 0;
+        VkDeviceSize offset = 0;
+        VkDeviceSize minAlignment = 16;
+        VkDeviceSize peakUsed = 0;
+        uint64_t failedAllocations = 0;
+    };
+
+    // Everything a frame in flight owns. Its command pool is reset as a whole when the slot
+    // is reused instead of resetting command buffers one by one.
+    struct FrameContext {
+        VkCommandPool commandPool = VK_NULL_HANDLE;
+        VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+        VkSemaphore imageAvailable = VK_NULL_HANDLE;
+        VkFence inFlight = VK_NULL_HANDLE; // Signaled when the slot's last submission finished
+        FrameAllocator allocator;
+    };
+
+    // Ring of frame contexts, independent of the swapchain image count. With N frames in
+    // flight the CPU records frame i while the GPU may still run frames i-1 .. i-N+1: one
+    // frame gives the lowest latency, more frames give the GPU more queued work.
+    //
+    // The fence is only waited on in beginFrame; the caller resets it right before the
+    // submit that signals it again, so a frame dropped after beginFrame (for example on an
+    // out-of-date swapchain) leaves the fence signaled and the slot reusable.
+    class FrameContextRing {
+    public:
+        static constexpr uint32_t MaxFramesInFlight = 4;
+
+        FrameContextRing() = default;
+        ~FrameContextRing() = default;
+
+        // framesInFlight is clamped to 1..MaxFramesInFlight
+        bool init(VkPhysicalDevice physicalDevice, VkDevice device, uint32_t queueFamilyIndex, uint32_t framesInFlight, VkDeviceSize transientBytesPerFrame);
+        void cleanup();
+
+        // Waits until the GPU is done with the current slot, then resets its command pool and
+        // transient allocator. The command buffer is ready for vkBeginCommandBuffer.
+        FrameContext& beginFrame();
+        // After the frame's submit; moves on to the next slot
+        void endFrame();
+
+        uint32_t getFramesInFlight() const { return static_cast<uint32_t>(frames.size()); }
+        uint32_t getFrameSlot() const { return slot; }
+        FrameContext& getFrame(uint32_t frameSlot) { return frames[frameSlot]; }
+
+        // CPU time beginFrame spent blocked on the GPU
+        float getLastFenceWaitMs() const { return lastFenceWaitMs; }
+
+    private:
+        VkDevice device = VK_NULL_HANDLE;
+        std::vector<FrameContext> frames;
+        uint32_t slot = 0;
+        float lastFenceWaitMs = 0.0f;
+    };
+
+}
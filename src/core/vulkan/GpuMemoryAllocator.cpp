@@ -0,0 +1,451 @@
+#include "GpuMemoryAllocator.hpp"
+#include "Trace.hpp"
+#include <ng-log/logging.h>
+#include <algorithm>
+#include <bit>
+
+namespace Anito3D {
+
+    namespace {
+        VkDeviceSize AlignUp(VkDeviceSize value, VkDeviceSize alignment) {
+            return (value + alignment - 1) & ~(alignment - 1);
+        }
+    }
+
+    void TlsfHeap::init(VkDeviceSize size) {
+        this->size = size;
+        usedBytes = 0;
+        freeRegionCount = 0;
+        regions.clear();
+        unusedRegions.clear();
+        allocated.clear();
+        firstLevelBitmap = 0;
+        secondLevelBitmaps.fill(0);
+        freeLists.fill(None);
+
+        uint32_t index = newRegion();
+        regions[index].offset = 0;
+        regions[index].size = size;
+        insertFree(index);
+    }
+
+    void TlsfHeap::mapping(VkDeviceSize size, uint32_t& firstLevel, uint32_t& secondLevel) {
+        if (size < SmallSize) {
+            firstLevel = 0;
+            secondLevel = static_cast<uint32_t>(size / (SmallSize / SecondLevelCount));
+            return;
+        }
+        const uint32_t log2 = static_cast<uint32_t>(std::bit_width(size)) - 1;
+        firstLevel = log2 - SmallShift + 1;
+        secondLevel = static_cast<uint32_t>(size >> (log2 - SecondLevelBits)) ^ SecondLevelCount;
+    }
+
+    uint32_t TlsfHeap::findFree(VkDeviceSize size) const {
+        // Round up to the next class boundary so any region found is large enough (good fit)
+        if (size >= SmallSize) size += (VkDeviceSize(1) << (std::bit_width(size) - 1 - SecondLevelBits)) - 1;
+        else size += SmallSize / SecondLevelCount - 1;
+        uint32_t firstLevel, secondLevel;
+        mapping(size, firstLevel, secondLevel);
+        if (firstLevel >= FirstLevelCount) return None;
+
+        uint32_t secondLevelMap = secondLevelBitmaps[firstLevel] & (~0u << secondLevel);
+        if (!secondLevelMap) {
+            const uint64_t firstLevelMap = firstLevel + 1 < 64 ? firstLevelBitmap & (~uint64_t(0) << (firstLevel + 1)) : 0;
+            if (!firstLevelMap) return None;
+            firstLevel = static_cast<uint32_t>(std::countr_zero(firstLevelMap));
+            secondLevelMap = secondLevelBitmaps[firstLevel];
+        }
+        secondLevel = static_cast<uint32_t>(std::countr_zero(secondLevelMap));
+        return freeLists[firstLevel * SecondLevelCount + secondLevel];
+    }
+
+    uint32_t TlsfHeap::findFreeInClass(VkDeviceSize size, VkDeviceSize alignment) const {
+        // Regions in the request's own class may still fit; the rounded search skips them.
+        // This is what lets an allocation fill its block exactly.
+        uint32_t firstLevel, secondLevel;
+        mapping(size, firstLevel, secondLevel);
+        for (uint32_t index = freeLists[firstLevel * SecondLevelCount + secondLevel]; index != None; index = regions[index].nextFree) {
+            const Region& region = regions[index];
+            if (AlignUp(region.offset, alignment) + size <= region.offset + region.size) return index;
+        }
+        return None;
+    }
+
+    uint32_t TlsfHeap::newRegion() {
+        if (!unusedRegions.empty()) {
+            uint32_t index = unusedRegions.back();
+            unusedRegions.pop_back();
+            regions[index] = {};
+            return index;
+        }
+        regions.emplace_back();
+        return static_cast<uint32_t>(regions.size() - 1);
+    }
+
+    void TlsfHeap::insertFree(uint32_t index) {
+        Region& region = regions[index];
+        uint32_t firstLevel, secondLevel;
+        mapping(region.size, firstLevel, secondLevel);
+        uint32_t& head = freeLists[firstLevel * SecondLevelCount + secondLevel];
+        region.free = true;
+        region.prevFree = None;
+        region.nextFree = head;
+        if (head != None) regions[head].prevFree = index;
+        head = index;
+        firstLevelBitmap |= uint64_t(1) << firstLevel;
+        secondLevelBitmaps[firstLevel] |= 1u << secondLevel;
+        ++freeRegionCount;
+    }
+
+    void TlsfHeap::removeFree(uint32_t index) {
+        Region& region = regions[index];
+        uint32_t firstLevel, secondLevel;
+        mapping(region.size, firstLevel, secondLevel);
+        uint32_t& head = freeLists[firstLevel * SecondLevelCount + secondLevel];
+        if (region.prevFree != None) regions[region.prevFree].nextFree = region.nextFree;
+        else head = region.nextFree;
+        if (region.nextFree != None) regions[region.nextFree].prevFree = region.prevFree;
+        if (head == None) {
+            secondLevelBitmaps[firstLevel] &= ~(1u << secondLevel);
+            if (!secondLevelBitmaps[firstLevel]) firstLevelBitmap &= ~(uint64_t(1) << firstLevel);
+        }
+        region.free = false;
+        region.prevFree = region.nextFree = None;
+        --freeRegionCount;
+    }
+
+    void TlsfHeap::mergeInto(uint32_t keep, uint32_t absorbed) {
+        // absorbed directly follows keep in memory
+        Region& region = regions[keep];
+        const Region& next = regions[absorbed];
+        region.size += next.size;
+        region.nextPhysical = next.nextPhysical;
+        if (next.nextPhysical != None) regions[next.nextPhysical].prevPhysical = keep;
+        unusedRegions.push_back(absorbed);
+    }
+
+    VkDeviceSize TlsfHeap::allocate(VkDeviceSize size, VkDeviceSize alignment) {
+        if (size == 0 || size > this->size) return InvalidOffset;
+        alignment = std::max<VkDeviceSize>(alignment, 1);
+        uint32_t index = findFree(size + alignment - 1);
+        if (index == None) index = findFreeInClass(size, alignment);
+        if (index == None) return InvalidOffset;
+        removeFree(index);
+
+        // Leading padding becomes its own free region
+        const VkDeviceSize alignedOffset = AlignUp(regions[index].offset, alignment);
+        if (alignedOffset > regions[index].offset) {
+            uint32_t front = newRegion();
+            Region& region = regions[index];
+            regions[front].offset = region.offset;
+            regions[front].size = alignedOffset - region.offset;
+            regions[front].prevPhysical = region.prevPhysical;
+            regions[front].nextPhysical = index;
+            if (region.prevPhysical != None) regions[region.prevPhysical].nextPhysical = front;
+            region.prevPhysical = front;
+            region.size -= regions[front].size;
+            region.offset = alignedOffset;
+            insertFree(front);
+        }
+
+        // So does the tail, unless it is too small to be worth tracking
+        if (regions[index].size - size >= MinSplitSize) {
+            uint32_t tail = newRegion();
+            Region& region = regions[index];
+            regions[tail].offset = region.offset + size;
+            regions[tail].size = region.size - size;
+            regions[tail].prevPhysical = index;
+            regions[tail].nextPhysical = region.nextPhysical;
+            if (region.nextPhysical != None) regions[region.nextPhysical].prevPhysical = tail;
+            region.nextPhysical = tail;
+            region.size = size;
+            insertFree(tail);
+        }
+
+        usedBytes += regions[index].size;
+        allocated.emplace(regions[index].offset, index);
+        return regions[index].offset;
+    }
+
+    void TlsfHeap::free(VkDeviceSize offset) {
+        auto found = allocated.find(offset);
+        if (found == allocated.end()) {
+            LOG(ERROR) << "TlsfHeap::free: No allocation at offset " << offset;
+            return;
+        }
+        uint32_t index = found->second;
+        allocated.erase(found);
+        usedBytes -= regions[index].size;
+
+        const uint32_t next = regions[index].nextPhysical;
+        if (next != None && regions[next].free) {
+            removeFree(next);
+            mergeInto(index, next);
+        }
+        const uint32_t prev = regions[index].prevPhysical;
+        if (prev != None && regions[prev].free) {
+            removeFree(prev);
+            mergeInto(prev, index);
+            index = prev;
+        }
+        insertFree(index);
+    }
+
+    VkDeviceSize TlsfHeap::getLargestFreeRegion() const {
+        if (!firstLevelBitmap) return 0;
+        // The largest region is in the highest non-empty class, which is not sorted
+        const uint32_t firstLevel = 63 - static_cast<uint32_t>(std::countl_zero(firstLevelBitmap));
+        const uint32_t secondLevel = 31 - static_cast<uint32_t>(std::countl_zero(secondLevelBitmaps[firstLevel]));
+        VkDeviceSize largest = 0;
+        for (uint32_t index = freeLists[firstLevel * SecondLevelCount + secondLevel]; index != None; index = regions[index].nextFree) {
+            largest = std::max(largest, regions[index].size);
+        }
+        return largest;
+    }
+
+    bool GpuMemoryAllocator::init(VkPhysicalDevice physicalDevice, VkDevice device, VkDeviceSize blockSize) {
+        cleanup();
+        this->device = device;
+        this->blockSize = blockSize;
+        vkGetPhysicalDeviceMemoryProperties(physicalDevice, &memoryProperties);
+        VkPhysicalDeviceProperties properties;
+        vkGetPhysicalDeviceProperties(physicalDevice, &properties);
+        maxAllocationCount = properties.limits.maxMemoryAllocationCount;
+        LOG(INFO) << "GPU memory allocator: " << blockSize / (1024 * 1024) << " MiB blocks, device allows " << maxAllocationCount << " allocations";
+        return true;
+    }
+
+    void GpuMemoryAllocator::cleanup() {
+        if (device != VK_NULL_HANDLE) {
+            const GpuMemoryStats stats = getStats();
+            if (stats.allocationCount > 0) LOG(WARNING) << "GPU memory allocator destroyed with " << stats.allocationCount << " live allocations";
+            if (totalAllocations > 0) {
+                LOG(INFO) << "GPU memory allocator: " << totalAllocations << " allocations served from at most " << peakBlockCount
+                    << " device memory blocks, peak " << peakUsedBytes / 1024 << " KiB used";
+            }
+            for (auto& heap : heaps) {
+                for (auto& block : heap.blocks) releaseBlock(block);
+            }
+        }
+        heaps.clear();
+        device = VK_NULL_HANDLE;
+        peakBlockCount = 0;
+        usedBytes = peakUsedBytes = totalAllocations = failedAllocations = 0;
+    }
+
+    uint32_t GpuMemoryAllocator::findMemoryType(uint32_t typeBits, VkMemoryPropertyFlags required, VkMemoryPropertyFlags preferred) const {
+        for (VkMemoryPropertyFlags flags : { required | preferred, required }) {
+            for (uint32_t i = 0; i < memoryProperties.memoryTypeCount; ++i) {
+                if ((typeBits & (1u << i)) && (memoryProperties.memoryTypes[i].propertyFlags & flags) == flags) return i;
+            }
+        }
+        return UINT32_MAX;
+    }
+
+    uint32_t GpuMemoryAllocator::getHeap(uint32_t memoryType, bool image) {
+        for (uint32_t i = 0; i < heaps.size(); ++i) {
+            if (heaps[i].memoryType == memoryType && heaps[i].image == image) return i;
+        }
+        heaps.push_back({ memoryType, image, {} });
+        return static_cast<uint32_t>(heaps.size() - 1);
+    }
+
+    uint32_t GpuMemoryAllocator::createBlock(uint32_t heapIndex, VkDeviceSize size, bool dedicated) {
+        ANITO3D_TRACE_ZONE("GpuMemoryAllocator::createBlock");
+        Heap& heap = heaps[heapIndex];
+        VkMemoryAllocateInfo allocInfo = { VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO };
+        allocInfo.allocationSize = size;
+        allocInfo.memoryTypeIndex = heap.memoryType;
+        VkDeviceMemory memory = VK_NULL_HANDLE;
+        VkResult result = vkAllocateMemory(device, &allocInfo, nullptr, &memory);
+        if (result != VK_SUCCESS) {
+            LOG(ERROR) << "Failed to allocate " << size / 1024 << " KiB device memory block: " << result;
+            return UINT32_MAX;
+        }
+
+        void* mapped = nullptr;
+        if (memoryProperties.memoryTypes[heap.memoryType].propertyFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) {
+            result = vkMapMemory(device, memory, 0, VK_WHOLE_SIZE, 0, &mapped);
+            if (result != VK_SUCCESS) {
+                LOG(ERROR) << "Failed to map device memory block: " << result;
+                vkFreeMemory(device, memory, nullptr);
+                return UINT32_MAX;
+            }
+        }
+
+        auto unused = std::find_if(heap.blocks.begin(), heap.blocks.end(), [](const Block& block) { return block.memory == VK_NULL_HANDLE; });
+        if (unused == heap.blocks.end()) unused = heap.blocks.insert(heap.blocks.end(), Block{});
+        unused->memory = memory;
+        unused->mapped = static_cast<uint8_t*>(mapped);
+        unused->dedicated = dedicated;
+        unused->heap.init(size);
+        peakBlockCount = std::max(peakBlockCount, getBlockCount());
+        return static_cast<uint32_t>(unused - heap.blocks.begin());
+    }
+
+    void GpuMemoryAllocator::releaseBlock(Block& block) {
+        if (block.memory == VK_NULL_HANDLE) return;
+        if (block.mapped) vkUnmapMemory(device, block.memory);
+        vkFreeMemory(device, block.memory, nullptr);
+        block.memory = VK_NULL_HANDLE;
+        block.mapped = nullptr;
+        block.heap = TlsfHeap();
+    }
+
+    uint32_t GpuMemoryAllocator::getBlockCount() const {
+        uint32_t count = 0;
+        for (const auto& heap : heaps) {
+            for (const auto& block : heap.blocks) count += block.memory != VK_NULL_HANDLE;
+        }
+        return count;
+    }
+
+    bool GpuMemoryAllocator::allocate(const VkMemoryRequirements& requirements, VkMemoryPropertyFlags required, VkMemoryPropertyFlags preferred,
+        bool image, GpuAllocation& allocation) {
+        allocation = {};
+        const uint32_t memoryType = findMemoryType(requirements.memoryTypeBits, required, preferred);
+        if (memoryType == UINT32_MAX) {
+            LOG(ERROR) << "No memory type with properties " << required << " for a " << requirements.size << " byte allocation";
+            ++failedAllocations;
+            return false;
+        }
+        const uint32_t heapIndex = getHeap(memoryType, image);
+
+        // Large resources get a block of their own instead of fragmenting the shared ones
+        const bool dedicated = requirements.size > blockSize / 2;
+        uint32_t blockIndex = UINT32_MAX;
+        VkDeviceSize offset = TlsfHeap::InvalidOffset;
+        VkDeviceSize usedBefore = 0;
+        if (!dedicated) {
+            auto& blocks = heaps[heapIndex].blocks;
+            for (uint32_t i = 0; i < blocks.size() && offset == TlsfHeap::InvalidOffset; ++i) {
+                if (blocks[i].memory == VK_NULL_HANDLE || blocks[i].dedicated) continue;
+                usedBefore = blocks[i].heap.getUsedBytes();
+                offset = blocks[i].heap.allocate(requirements.size, requirements.alignment);
+                blockIndex = i;
+            }
+        }
+        if (offset == TlsfHeap::InvalidOffset) {
+            blockIndex = createBlock(heapIndex, dedicated ? requirements.size : blockSize, dedicated);
+            if (blockIndex == UINT32_MAX) {
+                ++failedAllocations;
+                return false;
+            }
+            usedBefore = 0;
+            offset = heaps[heapIndex].blocks[blockIndex].heap.allocate(requirements.size, requirements.alignment);
+            if (offset == TlsfHeap::InvalidOffset) {
+                LOG(ERROR) << "A new device memory block cannot hold a " << requirements.size << " byte allocation";
+                releaseBlock(heaps[heapIndex].blocks[blockIndex]);
+                ++failedAllocations;
+                return false;
+            }
+        }
+
+        const Block& block = heaps[heapIndex].blocks[blockIndex];
+        usedBytes += block.heap.getUsedBytes() - usedBefore;
+        peakUsedBytes = std::max(peakUsedBytes, usedBytes);
+        allocation.memory = block.memory;
+        allocation.offset = offset;
+        allocation.size = requirements.size;
+        allocation.mapped = block.mapped ? block.mapped + offset : nullptr;
+        allocation.heap = heapIndex;
+        allocation.block = blockIndex;
+        ++totalAllocations;
+        return true;
+    }
+
+    void GpuMemoryAllocator::free(GpuAllocation& allocation) {
+        if (!allocation) return;
+        Heap& heap = heaps[allocation.heap];
+        Block& block = heap.blocks[allocation.block];
+        const VkDeviceSize usedBefore = block.heap.getUsedBytes();
+        block.heap.free(allocation.offset);
+        usedBytes -= usedBefore - block.heap.getUsedBytes();
+        allocation = {};
+        if (!block.heap.isEmpty()) return;
+
+        // Keep one empty shared block per heap so alternating load/unload does not thrash vkAllocateMemory
+        const bool keep = !block.dedicated && std::none_of(heap.blocks.begin(), heap.blocks.end(), [&](const Block& other) {
+            return &other != &block && other.memory != VK_NULL_HANDLE && !other.dedicated && other.heap.isEmpty();
+        });
+        if (!keep) releaseBlock(block);
+    }
+
+    bool GpuMemoryAllocator::createBuffer(VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags required, VkMemoryPropertyFlags preferred,
+        GpuBuffer& buffer) {
+        VkBufferCreateInfo bufferInfo = { VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO };
+        bufferInfo.size = size;
+        bufferInfo.usage = usage;
+        bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+        VkResult result = vkCreateBuffer(device, &bufferInfo, nullptr, &buffer.buffer);
+        if (result != VK_SUCCESS) {
+            LOG(ERROR) << "Failed to create " << size << " byte buffer: " << result;
+            buffer = {};
+            return false;
+        }
+
+        VkMemoryRequirements requirements;
+        vkGetBufferMemoryRequirements(device, buffer.buffer, &requirements);
+        if (!allocate(requirements, required, preferred, false, buffer.allocation)) {
+            destroyBuffer(buffer);
+            return false;
+        }
+        vkBindBufferMemory(device, buffer.buffer, buffer.allocation.memory, buffer.allocation.offset);
+        return true;
+    }
+
+    void GpuMemoryAllocator::destroyBuffer(GpuBuffer& buffer) {
+        if (buffer.buffer) vkDestroyBuffer(device, buffer.buffer, nullptr);
+        free(buffer.allocation);
+        buffer = {};
+    }
+
+    bool GpuMemoryAllocator::createImage(const VkImageCreateInfo& imageInfo, VkMemoryPropertyFlags required, VkImage& image, GpuAllocation& allocation) {
+        VkResult result = vkCreateImage(device, &imageInfo, nullptr, &image);
+        if (result != VK_SUCCESS) {
+            LOG(ERROR) << "Failed to create image: " << result;
+            image = VK_NULL_HANDLE;
+            return false;
+        }
+
+        VkMemoryRequirements requirements;
+        vkGetImageMemoryRequirements(device, image, &requirements);
+        if (!allocate(requirements, required, 0, imageInfo.tiling == VK_IMAGE_TILING_OPTIMAL, allocation)) {
+            destroyImage(image, allocation);
+            return false;
+        }
+        vkBindImageMemory(device, image, allocation.memory, allocation.offset);
+        return true;
+    }
+
+    void GpuMemoryAllocator::destroyImage(VkImage& image, GpuAllocation& allocation) {
+        if (image) vkDestroyImage(device, image, nullptr);
+        free(allocation);
+        image = VK_NULL_HANDLE;
+    }
+
+    GpuMemoryStats GpuMemoryAllocator::getStats() const {
+        GpuMemoryStats stats;
+        uint64_t freeBytes = 0;
+        for (const auto& heap : heaps) {
+            for (const auto& block : heap.blocks) {
+                if (block.memory == VK_NULL_HANDLE) continue;
+                ++stats.blockCount;
+                stats.dedicatedBlockCount += block.dedicated;
+                stats.blockBytes += block.heap.getSize();
+                stats.usedBytes += block.heap.getUsedBytes();
+                stats.allocationCount += block.heap.getAllocationCount();
+                if (block.dedicated) continue; // Never shared, so their free space is not fragmentation
+                stats.freeRegionCount += block.heap.getFreeRegionCount();
+                stats.largestFreeRegion = std::max<uint64_t>(stats.largestFreeRegion, block.heap.getLargestFreeRegion());
+                freeBytes += block.heap.getSize() - block.heap.getUsedBytes();
+            }
+        }
+        stats.peakBlockCount = peakBlockCount;
+        stats.peakUsedBytes = peakUsedBytes;
+        stats.totalAllocations = totalAllocations;
+        stats.failedAllocations = failedAllocations;
+        stats.fragmentation = freeBytes > 0 ? 1.0 - static_cast<double>(stats.largestFreeRegion) / static_cast<double>(freeBytes) : 0.0;
+        return stats;
+    }
+}
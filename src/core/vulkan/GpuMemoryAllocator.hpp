@@ -0,0 +1,168 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+#include <array>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace Anito3D {
+
+    // Two-level segregated fit (TLSF) over one range of offsets: free regions are binned by
+    // size class (power of two, split into 16 linear steps), so allocate and free are O(1)
+    // bitmap lookups. Freed regions merge with free neighbours right away. Knows nothing
+    // about Vulkan memory, it only hands out offsets.
+    class TlsfHeap {
+    public:
+        static constexpr VkDeviceSize InvalidOffset = ~VkDeviceSize(0);
+
+        TlsfHeap() = default;
+        ~TlsfHeap() = default;
+
+        void init(VkDeviceSize size);
+
+        // InvalidOffset when no free region fits. alignment must be a power of two.
+        VkDeviceSize allocate(VkDeviceSize size, VkDeviceSize alignment);
+        void free(VkDeviceSize offset);
+
+        VkDeviceSize getSize() const { return size; }
+        VkDeviceSize getUsedBytes() const { return usedBytes; }
+        VkDeviceSize getLargestFreeRegion() const;
+        uint32_t getAllocationCount() const { return static_cast<uint32_t>(allocated.size()); }
+        uint32_t getFreeRegionCount() const { return freeRegionCount; }
+        bool isEmpty() const { return allocated.empty(); }
+
+    private:
+        static constexpr uint32_t SecondLevelBits = 4;
+        static constexpr uint32_t SecondLevelCount = 1u << SecondLevelBits;
+        static constexpr uint32_t SmallShift = 8; // Below 256 bytes the classes are linear (16 byte steps)
+        static constexpr VkDeviceSize SmallSize = VkDeviceSize(1) << SmallShift;
+        static constexpr uint32_t FirstLevelCount = 64 - SmallShift + 1;
+        static constexpr VkDeviceSize MinSplitSize = 16; // Smaller tails stay with the allocation
+        static constexpr uint32_t None = UINT32_MAX;
+
+        struct Region {
+            VkDeviceSize offset = 0;
+            VkDeviceSize size = 0;
+            uint32_t prevPhysical = None; // Neighbours in address order
+            uint32_t nextPhysical = None;
+            uint32_t prevFree = None;     // Links in the size class list while free
+            uint32_t nextFree = None;
+            bool free = false;
+        };
+
+        VkDeviceSize size = 0;
+        VkDeviceSize usedBytes = 0;
+        uint32_t freeRegionCount = 0;
+        std::vector<Region> regions;
+        std::vector<uint32_t> unusedRegions;                  // Recycled entries of regions
+        std::unordered_map<VkDeviceSize, uint32_t> allocated; // Offset to region
+        uint64_t firstLevelBitmap = 0;
+        std::array<uint32_t, FirstLevelCount> secondLevelBitmaps = {};
+        std::array<uint32_t, FirstLevelCount * SecondLevelCount> freeLists = {};
+
+        static void mapping(VkDeviceSize size, uint32_t& firstLevel, uint32_t& secondLevel);
+        uint32_t findFree(VkDeviceSize size) const;
+        uint32_t findFreeInClass(VkDeviceSize size, VkDeviceSize alignment) const;
+        uint32_t newRegion();
+        void insertFree(uint32_t index);
+        void removeFree(uint32_t index);
+        void mergeInto(uint32_t keep, uint32_t absorbed);
+    };
+
+    // A piece of a device memory block. Bind with vkBind*Memory(memory, offset).
+    struct GpuAllocation {
+        VkDeviceMemory memory = VK_NULL_HANDLE;
+        VkDeviceSize offset = 0;
+        VkDeviceSize size = 0;
+        uint8_t* mapped = nullptr; // Persistently mapped when the memory type is host-visible
+        uint32_t heap = UINT32_MAX;
+        uint32_t block = UINT32_MAX;
+
+        explicit operator bool() const { return memory != VK_NULL_HANDLE; }
+    };
+
+    struct GpuBuffer {
+        VkBuffer buffer = VK_NULL_HANDLE;
+        GpuAllocation allocation;
+    };
+
+    struct GpuMemoryStats {
+        uint32_t blockCount = 0;             // Live vkAllocateMemory calls
+        uint32_t peakBlockCount = 0;
+        uint32_t dedicatedBlockCount = 0;    // Allocations too large to share a block
+        uint64_t blockBytes = 0;
+        uint64_t usedBytes = 0;
+        uint64_t peakUsedBytes = 0;
+        uint32_t allocationCount = 0;        // Live sub-allocations
+        uint64_t totalAllocations = 0;       // Over the allocator's lifetime
+        uint64_t failedAllocations = 0;
+        uint32_t freeRegionCount = 0;
+        uint64_t largestFreeRegion = 0;
+        double fragmentation = 0.0;          // 1 - largest free region / free bytes, 0 when free space is one piece
+    };
+
+    // Sub-allocates buffers and images out of large device memory blocks instead of one
+    // vkAllocateMemory per resource, which runs into maxMemoryAllocationCount (often 4096)
+    // on scenes with thousands of meshes. Each memory type gets its own list of blocks,
+    // twice: buffers and optimal-tiling images never share a block, so bufferImageGranularity
+    // never applies. Host-visible blocks stay mapped for their whole lifetime.
+    //
+    // Not thread-safe; allocate and free from the thread that owns the device.
+    class GpuMemoryAllocator {
+    public:
+        static constexpr VkDeviceSize DefaultBlockSize = 64ull * 1024 * 1024;
+
+        GpuMemoryAllocator() = default;
+        ~GpuMemoryAllocator() = default;
+
+        bool init(VkPhysicalDevice physicalDevice, VkDevice device, VkDeviceSize blockSize = DefaultBlockSize);
+        void cleanup(); // Every allocation must have been freed
+
+        // Prefers a memory type with all of `preferred`, then falls back to `required` alone.
+        // image is true for optimal-tiling images.
+        bool allocate(const VkMemoryRequirements& requirements, VkMemoryPropertyFlags required, VkMemoryPropertyFlags preferred,
+            bool image, GpuAllocation& allocation);
+        void free(GpuAllocation& allocation);
+
+        bool createBuffer(VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags required, VkMemoryPropertyFlags preferred, GpuBuffer& buffer);
+        void destroyBuffer(GpuBuffer& buffer);
+        bool createImage(const VkImageCreateInfo& imageInfo, VkMemoryPropertyFlags required, VkImage& image, GpuAllocation& allocation);
+        void destroyImage(VkImage& image, GpuAllocation& allocation);
+
+        GpuMemoryStats getStats() const;
+        uint32_t getMaxAllocationCount() const { return maxAllocationCount; }
+        VkDevice getDevice() const { return device; }
+
+    private:
+        struct Block {
+            VkDeviceMemory memory = VK_NULL_HANDLE; // Null once released, the slot is reused
+            uint8_t* mapped = nullptr;
+            TlsfHeap heap;
+            bool dedicated = false;
+        };
+        struct Heap {
+            uint32_t memoryType = 0;
+            bool image = false;
+            std::vector<Block> blocks;
+        };
+
+        VkDevice device = VK_NULL_HANDLE;
+        VkPhysicalDeviceMemoryProperties memoryProperties = {};
+        VkDeviceSize blockSize = DefaultBlockSize;
+        uint32_t maxAllocationCount = 0;
+        std::vector<Heap> heaps; // Created on first use of a memory type
+        uint32_t peakBlockCount = 0;
+        uint64_t usedBytes = 0;
+        uint64_t peakUsedBytes = 0;
+        uint64_t totalAllocations = 0;
+        uint64_t failedAllocations = 0;
+
+        uint32_t findMemoryType(uint32_t typeBits, VkMemoryPropertyFlags required, VkMemoryPropertyFlags preferred) const;
+        uint32_t getHeap(uint32_t memoryType, bool image);
+        uint32_t createBlock(uint32_t heapIndex, VkDeviceSize size, bool dedicated);
+        void releaseBlock(Block& block);
+        uint32_t getBlockCount() const;
+    };
+
+}
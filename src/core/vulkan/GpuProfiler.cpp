@@ -0,0 +1,141 @@
+#include "GpuProfiler.hpp"
+#include <ng-log/logging.h>
+
+namespace Anito3D {
+
+    bool GpuProfiler::init(VkPhysicalDevice physicalDevice, VkDevice device, uint32_t queueFamilyIndex, uint32_t framesInFlight) {
+        cleanup();
+
+        VkPhysicalDeviceProperties properties;
+        vkGetPhysicalDeviceProperties(physicalDevice, &properties);
+        uint32_t queueFamilyCount = 0;
+        vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &queueFamilyCount, nullptr);
+        std::vector<VkQueueFamilyProperties> queueFamilies(queueFamilyCount);
+        vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &queueFamilyCount, queueFamilies.data());
+
+        const uint32_t validBits = queueFamilyIndex < queueFamilyCount ? queueFamilies[queueFamilyIndex].timestampValidBits : 0;
+        if (validBits == 0 || properties.limits.timestampPeriod <= 0.0f) {
+            LOG(WARNING) << "GPU profiler disabled: queue family " << queueFamilyIndex << " does not support timestamps";
+            return false;
+        }
+        validMask = validBits >= 64 ? ~0ull : (1ull << validBits) - 1;
+        timestampPeriod = properties.limits.timestampPeriod;
+        this->device = device;
+
+        VkQueryPoolCreateInfo poolInfo = { VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO };
+        poolInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+        poolInfo.queryCount = QueriesPerFrame;
+        frames.resize(framesInFlight);
+        for (auto& frame : frames) {
+            VkResult result = vkCreateQueryPool(device, &poolInfo, nullptr, &frame.queryPool);
+            if (result != VK_SUCCESS) {
+                LOG(ERROR) << "Failed to create GPU timestamp query pool: " << result;
+                cleanup();
+                return false;
+            }
+            frame.names.resize(MaxScopes);
+            frame.depths.resize(MaxScopes);
+        }
+        results.resize(QueriesPerFrame * 2);
+        openScopes.reserve(MaxScopes);
+        frameTimings.reserve(MaxScopes);
+        enabled = true;
+
+        LOG(INFO) << "GPU profiler: " << framesInFlight << " query pools, timestamp period " << timestampPeriod << " ns, " << validBits << " valid bits";
+        return true;
+    }
+
+    void GpuProfiler::cleanup() {
+        if (device != VK_NULL_HANDLE) {
+            for (auto& frame : frames) {
+                if (frame.queryPool) vkDestroyQueryPool(device, frame.queryPool, nullptr);
+            }
+        }
+        frames.clear();
+        device = VK_NULL_HANDLE;
+        recordingSlot = UINT32_MAX;
+        enabled = false;
+    }
+
+    void GpuProfiler::setEnabled(bool enabled) {
+        // Pending results would come back under tags of frames recorded while disabled
+        for (auto& frame : frames) frame.pending = false;
+        this->enabled = enabled && !frames.empty();
+    }
+
+    bool GpuProfiler::beginFrame(VkCommandBuffer commandBuffer, uint32_t frameSlot, uint64_t tag) {
+        recordingSlot = UINT32_MAX;
+        if (!enabled || frameSlot >= frames.size()) return false;
+
+        FrameQueries& frame = frames[frameSlot];
+        const bool resolved = frame.pending && resolve(frame);
+
+        vkCmdResetQueryPool(commandBuffer, frame.queryPool, 0, QueriesPerFrame);
+        vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, frame.queryPool, 0);
+        frame.scopeCount = 0;
+        frame.tag = tag;
+        frame.pending = false;
+        openScopes.clear();
+        recordingSlot = frameSlot;
+        return resolved;
+    }
+
+    void GpuProfiler::endFrame(VkCommandBuffer commandBuffer) {
+        if (recordingSlot == UINT32_MAX) return;
+        FrameQueries& frame = frames[recordingSlot];
+        while (!openScopes.empty()) endScope(commandBuffer);
+        vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, frame.queryPool, 1);
+        frame.pending = true;
+        recordingSlot = UINT32_MAX;
+    }
+
+    void GpuProfiler::beginScope(VkCommandBuffer commandBuffer, const char* name) {
+        if (recordingSlot == UINT32_MAX) return;
+        FrameQueries& frame = frames[recordingSlot];
+        if (frame.scopeCount >= MaxScopes) {
+            openScopes.push_back(UINT32_MAX); // Over budget: keep begin/end balanced, record nothing
+            return;
+        }
+        const uint32_t scope = frame.scopeCount++;
+        frame.names[scope] = name;
+        frame.depths[scope] = static_cast<uint32_t>(openScopes.size());
+        openScopes.push_back(scope);
+        vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, frame.queryPool, 2 + scope * 2);
+    }
+
+    void GpuProfiler::endScope(VkCommandBuffer commandBuffer) {
+        if (recordingSlot == UINT32_MAX || openScopes.empty()) return;
+        const uint32_t scope = openScopes.back();
+        openScopes.pop_back();
+        if (scope == UINT32_MAX) return;
+        vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, frames[recordingSlot].queryPool, 3 + scope * 2);
+    }
+
+    bool GpuProfiler::resolve(FrameQueries& frame) {
+        frame.pending = false;
+        const uint32_t queryCount = 2 + frame.scopeCount * 2;
+        VkResult result = vkGetQueryPoolResults(device, frame.queryPool, 0, queryCount, queryCount * 2 * sizeof(uint64_t), results.data(),
+            2 * sizeof(uint64_t), VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WITH_AVAILABILITY_BIT);
+        if (result != VK_SUCCESS && result != VK_NOT_READY) {
+            LOG(WARNING) << "Failed to read GPU timestamps: " << result;
+            return false;
+        }
+
+        // Unavailable queries (never written or still in flight) drop the frame
+        for (uint32_t query = 0; query < queryCount; ++query) {
+            if (results[query * 2 + 1] == 0) return false;
+        }
+        auto milliseconds = [&](uint32_t beginQuery, uint32_t endQuery) {
+            const uint64_t ticks = ((results[endQuery * 2] & validMask) - (results[beginQuery * 2] & validMask)) & validMask;
+            return static_cast<float>(static_cast<double>(ticks) * timestampPeriod * 1e-6);
+        };
+
+        lastFrameTag = frame.tag;
+        lastFrameMs = milliseconds(0, 1);
+        frameTimings.clear();
+        for (uint32_t scope = 0; scope < frame.scopeCount; ++scope) {
+            frameTimings.push_back({ frame.names[scope], frame.depths[scope], milliseconds(2 + scope * 2, 3 + scope * 2) });
+        }
+        return true;
+    }
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+#include <cstdint>
+#include <vector>
+
+namespace Anito3D {
+
+    struct GpuScopeTiming {
+        const char* name;   // As passed to beginScope
+        uint32_t depth;     // Nesting level, 0 = outermost
+        float milliseconds;
+    };
+
+    // GPU timestamps per frame in flight. Each frame slot owns a query pool that is reset in
+    // its command buffer, then a frame timestamp pair plus a pair per named scope is written.
+    // Results are read with vkGetQueryPoolResults only after the slot's fence has been
+    // waited on (at the next beginFrame of the same slot), so reading never stalls; the
+    // availability bits guard against implementations that finish late.
+    //
+    // Timestamps become milliseconds through VkPhysicalDeviceLimits::timestampPeriod and are
+    // masked to the queue's timestampValidBits. Queues without timestamps (validBits = 0)
+    // leave the profiler disabled instead of failing. Software implementations such as
+    // lavapipe report timestamps, so this works on GPU-less hosts too.
+    class GpuProfiler {
+    public:
+        static constexpr uint32_t MaxScopes = 31; // Per frame, plus the frame pair
+
+        GpuProfiler() = default;
+        ~GpuProfiler() = default;
+
+        // Returns false (and stays disabled) when the queue family cannot write timestamps
+        bool init(VkPhysicalDevice physicalDevice, VkDevice device, uint32_t queueFamilyIndex, uint32_t framesInFlight);
+        void cleanup();
+
+        void setEnabled(bool enabled);
+        bool isEnabled() const { return enabled; }
+
+        // Record into a command buffer outside any render pass. Returns true when the slot's
+        // previous frame was resolved; its results replace getFrameTimings/getLastFrameMs.
+        // tag identifies the frame being recorded and comes back through getLastFrameTag.
+        bool beginFrame(VkCommandBuffer commandBuffer, uint32_t frameSlot, uint64_t tag);
+        void endFrame(VkCommandBuffer commandBuffer);
+
+        // Named string literal scopes, may nest; endScope closes the innermost open one
+        void beginScope(VkCommandBuffer commandBuffer, const char* name);
+        void endScope(VkCommandBuffer commandBuffer);
+
+        // Most recently resolved frame
+        uint64_t getLastFrameTag() const { return lastFrameTag; }
+        float getLastFrameMs() const { return lastFrameMs; }
+        const std::vector<GpuScopeTiming>& getFrameTimings() const { return frameTimings; }
+
+    private:
+        static constexpr uint32_t QueriesPerFrame = (MaxScopes + 1) * 2;
+
+        struct FrameQueries {
+            VkQueryPool queryPool = VK_NULL_HANDLE;
+            std::vector<const char*> names;    // Per scope
+            std::vector<uint32_t> depths;      // Per scope
+            uint32_t scopeCount = 0;
+            uint64_t tag = 0;
+            bool pending = false; // Written and submitted, not resolved yet
+        };
+
+        VkDevice device = VK_NULL_HANDLE;
+        std::vector<FrameQueries> frames;
+        std::vector<uint32_t> openScopes; // Scope indices of the recording frame
+        std::vector<uint64_t> results;    // Value and availability per query
+        uint32_t recordingSlot = UINT32_MAX;
+        uint64_t validMask = 0;
+        double timestampPeriod = 1.0; // Nanoseconds per tick
+        bool enabled = false;
+
+        uint64_t lastFrameTag = 0;
+        float lastFrameMs = 0.0f;
+        std::vector<GpuScopeTiming> frameTimings;
+
+        bool resolve(FrameQueries& frame);
+    };
+
+}
@@ -0,0 +1,173 @@
+#include "PipelineCache.hpp"
+#include "Hash.hpp"
+#include "Trace.hpp"
+#include <ng-log/logging.h>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+
+namespace Anito3D {
+
+    namespace {
+        constexpr char CacheMagic[8] = { 'A', '3', 'D', 'P', 'S', 'O', '\0', '\0' };
+    }
+
+    const char* PipelineCache::getStatusName(Status status) {
+        switch (status) {
+        case Status::Missing: return "missing";
+        case Status::Corrupt: return "corrupt";
+        case Status::VersionMismatch: return "version mismatch";
+        case Status::DeviceMismatch: return "device mismatch";
+        case Status::Valid: return "valid";
+        }
+        return "unknown";
+    }
+
+    bool PipelineCache::init(VkPhysicalDevice physicalDevice, VkDevice device, const std::string& path) {
+        ANITO3D_TRACE_ZONE("PipelineCache::init");
+        cleanup();
+        this->device = device;
+        this->path = path;
+
+        VkPhysicalDeviceIDProperties idProperties = { VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_ID_PROPERTIES };
+        VkPhysicalDeviceProperties2 properties = { VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2 };
+        properties.pNext = &idProperties;
+        vkGetPhysicalDeviceProperties2(physicalDevice, &properties);
+        std::memcpy(expected.magic, CacheMagic, sizeof(CacheMagic));
+        expected.version = Version;
+        expected.vendorID = properties.properties.vendorID;
+        expected.deviceID = properties.properties.deviceID;
+        expected.driverVersion = properties.properties.driverVersion;
+        std::memcpy(expected.driverUUID, idProperties.driverUUID, VK_UUID_SIZE);
+        std::memcpy(expected.pipelineCacheUUID, properties.properties.pipelineCacheUUID, VK_UUID_SIZE);
+
+        std::string data;
+        status = load(data);
+
+        VkPipelineCacheCreateInfo cacheInfo = { VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO };
+        if (status == Status::Valid) {
+            cacheInfo.initialDataSize = data.size();
+            cacheInfo.pInitialData = data.data();
+        }
+        VkResult result = vkCreatePipelineCache(device, &cacheInfo, nullptr, &cache);
+        if (result != VK_SUCCESS && status == Status::Valid) {
+            LOG(WARNING) << "Driver rejected pipeline cache " << path << ": " << result;
+            status = Status::Corrupt;
+            cacheInfo.initialDataSize = 0;
+            cacheInfo.pInitialData = nullptr;
+            result = vkCreatePipelineCache(device, &cacheInfo, nullptr, &cache);
+        }
+        if (result != VK_SUCCESS) {
+            LOG(ERROR) << "Failed to create pipeline cache: " << result;
+            cache = VK_NULL_HANDLE;
+            return false;
+        }
+        if (status == Status::Valid) {
+            loadedBytes = data.size();
+            loadedHash = HashBytes(data.data(), data.size());
+        }
+
+        LOG(INFO) << "Pipeline cache " << path << ": " << getStatusName(status) << " (" << loadedBytes << " bytes loaded)";
+        return true;
+    }
+
+    void PipelineCache::cleanup() {
+        if (cache != VK_NULL_HANDLE) {
+            save();
+            if (pipelineCount > 0) {
+                LOG(INFO) << "Created " << pipelineCount << " pipelines in " << pipelineMilliseconds << " ms with a "
+                    << (isWarm() ? "warm" : "cold") << " pipeline cache";
+            }
+            vkDestroyPipelineCache(device, cache, nullptr);
+        }
+        device = VK_NULL_HANDLE;
+        cache = VK_NULL_HANDLE;
+        status = Status::Missing;
+        loadedBytes = loadedHash = 0;
+        pipelineCount = 0;
+        pipelineMilliseconds = 0.0;
+    }
+
+    bool PipelineCache::save() {
+        if (cache == VK_NULL_HANDLE) return false;
+
+        size_t size = 0;
+        VkResult result = vkGetPipelineCacheData(device, cache, &size, nullptr);
+        std::string data(size, '\0');
+        if (result == VK_SUCCESS) result = vkGetPipelineCacheData(device, cache, &size, data.data());
+        if (result != VK_SUCCESS) {
+            LOG(WARNING) << "Failed to read pipeline cache data: " << result;
+            return false;
+        }
+        data.resize(size);
+
+        PipelineCacheFileHeader header = expected;
+        header.dataSize = data.size();
+        header.dataHash = HashBytes(data.data(), data.size());
+        if (isWarm() && header.dataSize == loadedBytes && header.dataHash == loadedHash) return true; // Nothing new
+
+        std::error_code ec;
+        std::filesystem::path cachePath(path);
+        if (cachePath.has_parent_path()) std::filesystem::create_directories(cachePath.parent_path(), ec);
+
+        // Write to a temporary file and rename so a crash never leaves a partial cache
+        const std::string tempPath = path + ".tmp";
+        {
+            std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+            file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            file.write(data.data(), static_cast<std::streamsize>(data.size()));
+            if (!file) {
+                LOG(WARNING) << "Failed to write pipeline cache " << tempPath;
+                file.close();
+                std::filesystem::remove(tempPath, ec);
+                return false;
+            }
+        }
+        std::filesystem::rename(tempPath, path, ec);
+        if (ec) {
+            LOG(WARNING) << "Failed to move pipeline cache into place: " << ec.message();
+            std::filesystem::remove(tempPath, ec);
+            return false;
+        }
+        LOG(INFO) << "Pipeline cache saved to " << path << " (" << data.size() << " bytes)";
+        return true;
+    }
+
+    void PipelineCache::addPipelineCreation(double milliseconds) {
+        ++pipelineCount;
+        pipelineMilliseconds += milliseconds;
+    }
+
+    PipelineCache::Status PipelineCache::load(std::string& data) const {
+        std::ifstream file(path, std::ios::binary);
+        if (!file) return Status::Missing;
+
+        PipelineCacheFileHeader header;
+        if (!file.read(reinterpret_cast<char*>(&header), sizeof(header))) return Status::Corrupt;
+        if (std::memcmp(header.magic, CacheMagic, sizeof(CacheMagic)) != 0) return Status::Corrupt;
+        if (header.version != Version) return Status::VersionMismatch;
+        if (header.vendorID != expected.vendorID || header.deviceID != expected.deviceID || header.driverVersion != expected.driverVersion ||
+            std::memcmp(header.driverUUID, expected.driverUUID, VK_UUID_SIZE) != 0 ||
+            std::memcmp(header.pipelineCacheUUID, expected.pipelineCacheUUID, VK_UUID_SIZE) != 0) {
+            return Status::DeviceMismatch;
+        }
+
+        data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        if (data.size() != header.dataSize || HashBytes(data.data(), data.size()) != header.dataHash) return Status::Corrupt;
+
+        // The blob starts with VkPipelineCacheHeaderVersionOne; it must name this device too
+        VkPipelineCacheHeaderVersionOne blobHeader;
+        if (data.size() < sizeof(blobHeader)) return Status::Corrupt;
+        std::memcpy(&blobHeader, data.data(), sizeof(blobHeader));
+        if (blobHeader.headerVersion != VK_PIPELINE_CACHE_HEADER_VERSION_ONE || blobHeader.headerSize < sizeof(blobHeader) ||
+            blobHeader.headerSize > data.size()) {
+            return Status::Corrupt;
+        }
+        if (blobHeader.vendorID != expected.vendorID || blobHeader.deviceID != expected.deviceID ||
+            std::memcmp(blobHeader.pipelineCacheUUID, expected.pipelineCacheUUID, VK_UUID_SIZE) != 0) {
+            return Status::DeviceMismatch;
+        }
+        return Status::Valid;
+    }
+}
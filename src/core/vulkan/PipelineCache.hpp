@@ -0,0 +1,75 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+#include <cstdint>
+#include <string>
+
+namespace Anito3D {
+
+    // On-disk header in front of the driver's pipeline cache blob. The device identity is
+    // checked here before the blob reaches vkCreatePipelineCache, because some drivers
+    // crash instead of rejecting data written by another device or driver build.
+    struct PipelineCacheFileHeader {
+        char magic[8];                             // "A3DPSO\0\0"
+        uint32_t version;
+        uint32_t vendorID;
+        uint32_t deviceID;
+        uint32_t driverVersion;
+        uint8_t driverUUID[VK_UUID_SIZE];          // VkPhysicalDeviceIDProperties
+        uint8_t pipelineCacheUUID[VK_UUID_SIZE];   // VkPhysicalDeviceProperties
+        uint64_t dataSize;
+        uint64_t dataHash;                         // HashBytes of the blob
+    };
+
+    // Device-wide VkPipelineCache shared by ImGui and every pipeline, loaded from disk on
+    // init and written back on cleanup (only when the driver added something). A missing,
+    // corrupt or foreign file only means a cold start.
+    //
+    // Pipeline creation times are collected through addPipelineCreation so cold and warm
+    // runs can be compared.
+    class PipelineCache {
+    public:
+        enum class Status {
+            Missing,
+            Corrupt,        // Truncated, bad magic or hash, or rejected by the driver
+            VersionMismatch,
+            DeviceMismatch, // Written by another device or driver
+            Valid           // Warm start
+        };
+
+        static const char* getStatusName(Status status);
+
+        PipelineCache() = default;
+        ~PipelineCache() = default;
+
+        // Returns false only when no pipeline cache could be created at all
+        bool init(VkPhysicalDevice physicalDevice, VkDevice device, const std::string& path);
+        void cleanup(); // Saves, then destroys the cache
+        bool save();
+
+        VkPipelineCache get() const { return cache; }
+        Status getStatus() const { return status; }
+        bool isWarm() const { return status == Status::Valid; }
+        uint64_t getLoadedBytes() const { return loadedBytes; }
+
+        void addPipelineCreation(double milliseconds);
+        uint32_t getPipelineCount() const { return pipelineCount; }
+        double getPipelineMilliseconds() const { return pipelineMilliseconds; }
+
+    private:
+        static constexpr uint32_t Version = 1;
+
+        VkDevice device = VK_NULL_HANDLE;
+        VkPipelineCache cache = VK_NULL_HANDLE;
+        std::string path;
+        PipelineCacheFileHeader expected = {}; // Identity of this device, sizes left zero
+        Status status = Status::Missing;
+        uint64_t loadedBytes = 0;
+        uint64_t loadedHash = 0;
+        uint32_t pipelineCount = 0;
+        double pipelineMilliseconds = 0.0;
+
+        Status load(std::string& data) const;
+    };
+
+}
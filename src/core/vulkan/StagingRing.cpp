@@ -0,0 +1,213 @@
+#include "StagingRing.hpp"
+#include "Trace.hpp"
+#include <ng-log/logging.h>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+namespace Anito3D {
+
+    namespace {
+        constexpr VkDeviceSize RegionAlignment = 16;
+    }
+
+    bool StagingRing::init(GpuMemoryAllocator& allocator, VkQueue queue, uint32_t queueFamilyIndex, VkDeviceSize capacity) {
+        cleanup();
+        this->allocator = &allocator;
+        device = allocator.getDevice();
+        this->queue = queue;
+
+        if (!allocator.createBuffer(capacity, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, 0, ring)) {
+            LOG(ERROR) << "Failed to create staging ring buffer";
+            cleanup();
+            return false;
+        }
+
+        VkCommandPoolCreateInfo poolInfo = { VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO };
+        poolInfo.queueFamilyIndex = queueFamilyIndex;
+        poolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT | VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT; // Batches are recycled one by one
+        VkResult result = vkCreateCommandPool(device, &poolInfo, nullptr, &commandPool);
+        if (result != VK_SUCCESS) {
+            LOG(ERROR) << "Failed to create staging command pool: " << result;
+            cleanup();
+            return false;
+        }
+
+        this->capacity = capacity;
+        LOG(INFO) << "Staging ring created with " << capacity / 1024 << " KiB";
+        return true;
+    }
+
+    void StagingRing::cleanup() {
+        if (device != VK_NULL_HANDLE) {
+            finish();
+            if (stats.uploads > 0) {
+                LOG(INFO) << "Staging ring: " << stats.bytes / 1024 << " KiB in " << stats.uploads << " uploads, " << stats.copyCommands
+                    << " copy commands, " << stats.submits << " submits, " << stats.stalls << " stalls (" << stats.stallMilliseconds << " ms)";
+            }
+            for (auto& batch : idle) {
+                if (batch.fence) vkDestroyFence(device, batch.fence, nullptr);
+            }
+            if (commandPool) vkDestroyCommandPool(device, commandPool, nullptr); // Frees the command buffers
+            allocator->destroyBuffer(ring);
+        }
+        allocator = nullptr;
+        device = VK_NULL_HANDLE;
+        queue = VK_NULL_HANDLE;
+        commandPool = VK_NULL_HANDLE;
+        ring = {};
+        capacity = 0;
+        writeCursor = releasedCursor = 0;
+        pending.clear();
+        inFlight.clear();
+        idle.clear();
+        stats = {};
+    }
+
+    bool StagingRing::upload(VkBuffer destination, VkDeviceSize destinationOffset, const void* data, VkDeviceSize size) {
+        if (!ring.allocation.mapped) return false;
+        ++stats.uploads;
+
+        const uint8_t* source = static_cast<const uint8_t*>(data);
+        const VkDeviceSize maxChunk = capacity / 4;
+        while (size > 0) {
+            const VkDeviceSize chunk = std::min(size, maxChunk);
+            VkDeviceSize offset = 0;
+            if (!reserve(chunk, offset)) return false;
+            std::memcpy(ring.allocation.mapped + offset, source, chunk);
+
+            // Uploads usually arrive grouped by destination, so look from the back
+            auto copies = std::find_if(pending.rbegin(), pending.rend(), [&](const PendingCopies& entry) { return entry.destination == destination; });
+            if (copies == pending.rend()) {
+                pending.push_back({ destination, {} });
+                copies = pending.rbegin();
+            }
+            // Back-to-back streams of one mesh land next to each other in both buffers
+            VkBufferCopy* last = copies->regions.empty() ? nullptr : &copies->regions.back();
+            if (last && last->srcOffset + last->size == offset && last->dstOffset + last->size == destinationOffset) last->size += chunk;
+            else copies->regions.push_back({ offset, destinationOffset, chunk });
+
+            source += chunk;
+            destinationOffset += chunk;
+            size -= chunk;
+            stats.bytes += chunk;
+        }
+        return true;
+    }
+
+    bool StagingRing::flush() {
+        if (pending.empty()) return true;
+        ANITO3D_TRACE_ZONE("StagingRing::flush");
+
+        Batch batch;
+        if (!idle.empty()) {
+            batch = idle.back();
+            idle.pop_back();
+        }
+        else {
+            VkCommandBufferAllocateInfo allocInfo = { VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO };
+            allocInfo.commandPool = commandPool;
+            allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+            allocInfo.commandBufferCount = 1;
+            VkResult result = vkAllocateCommandBuffers(device, &allocInfo, &batch.commandBuffer);
+            if (result != VK_SUCCESS) {
+                LOG(ERROR) << "Failed to allocate staging command buffer: " << result;
+                return false;
+            }
+            VkFenceCreateInfo fenceInfo = { VK_STRUCTURE_TYPE_FENCE_CREATE_INFO };
+            result = vkCreateFence(device, &fenceInfo, nullptr, &batch.fence);
+            if (result != VK_SUCCESS) {
+                LOG(ERROR) << "Failed to create staging fence: " << result;
+                vkFreeCommandBuffers(device, commandPool, 1, &batch.commandBuffer);
+                return false;
+            }
+        }
+
+        VkCommandBufferBeginInfo beginInfo = { VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO };
+        beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+        vkBeginCommandBuffer(batch.commandBuffer, &beginInfo);
+        for (const auto& copies : pending) {
+            vkCmdCopyBuffer(batch.commandBuffer, ring.buffer, copies.destination, static_cast<uint32_t>(copies.regions.size()), copies.regions.data());
+            ++stats.copyCommands;
+            stats.copyRegions += copies.regions.size();
+        }
+
+        // Later submissions on this queue may read the data as vertices, indices or storage
+        // buffers, the latter from any shader stage that can bind one (culling, meshlets)
+        VkMemoryBarrier barrier = { VK_STRUCTURE_TYPE_MEMORY_BARRIER };
+        barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        barrier.dstAccessMask = VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT | VK_ACCESS_INDEX_READ_BIT | VK_ACCESS_SHADER_READ_BIT;
+        const VkPipelineStageFlags dstStages = VK_PIPELINE_STAGE_VERTEX_INPUT_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT |
+            VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+        vkCmdPipelineBarrier(batch.commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, dstStages, 0, 1, &barrier, 0, nullptr, 0, nullptr);
+        vkEndCommandBuffer(batch.commandBuffer);
+
+        VkSubmitInfo submitInfo = { VK_STRUCTURE_TYPE_SUBMIT_INFO };
+        submitInfo.commandBufferCount = 1;
+        submitInfo.pCommandBuffers = &batch.commandBuffer;
+        VkResult result = vkQueueSubmit(queue, 1, &submitInfo, batch.fence);
+        if (result != VK_SUCCESS) {
+            LOG(ERROR) << "Failed to submit staging copies: " << result;
+            idle.push_back(batch);
+            return false;
+        }
+
+        batch.end = writeCursor;
+        inFlight.push_back(batch);
+        pending.clear();
+        ++stats.submits;
+        return true;
+    }
+
+    bool StagingRing::finish() {
+        bool success = flush();
+        while (!inFlight.empty()) success = waitOldest() && success;
+        return success;
+    }
+
+    void StagingRing::cancel(VkBuffer destination) {
+        std::erase_if(pending, [&](const PendingCopies& copies) { return copies.destination == destination; });
+    }
+
+    bool StagingRing::reserve(VkDeviceSize size, VkDeviceSize& offset) {
+        for (;;) {
+            // Never split a region across the end of the ring; skip to the start instead
+            const VkDeviceSize position = writeCursor % capacity;
+            uint64_t begin = writeCursor - position + ((position + RegionAlignment - 1) & ~(RegionAlignment - 1));
+            if (begin % capacity + size > capacity) begin += capacity - begin % capacity;
+            if (begin + size - releasedCursor <= capacity) {
+                writeCursor = begin + size;
+                offset = begin % capacity;
+                return true;
+            }
+
+            if (inFlight.empty()) {
+                if (pending.empty()) {
+                    writeCursor = releasedCursor = 0; // Nothing outstanding, start over at the beginning
+                    continue;
+                }
+                if (!flush()) return false;
+            }
+            ANITO3D_TRACE_ZONE("StagingRing::stall");
+            const auto waitStart = std::chrono::steady_clock::now();
+            if (!waitOldest()) return false;
+            ++stats.stalls;
+            stats.stallMilliseconds += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - waitStart).count();
+        }
+    }
+
+    bool StagingRing::waitOldest() {
+        if (inFlight.empty()) return false;
+        Batch batch = inFlight.front();
+        inFlight.pop_front();
+        VkResult result = vkWaitForFences(device, 1, &batch.fence, VK_TRUE, UINT64_MAX);
+        vkResetFences(device, 1, &batch.fence);
+        releasedCursor = batch.end;
+        idle.push_back(batch);
+        if (result != VK_SUCCESS) {
+            LOG(ERROR) << "Failed to wait for staging copies: " << result;
+            return false;
+        }
+        return true;
+    }
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include "GpuMemoryAllocator.hpp"
+#include <vulkan/vulkan.h>
+#include <cstdint>
+#include <deque>
+#include <utility>
+#include <vector>
+
+namespace Anito3D {
+
+    struct StagingStats {
+        uint64_t bytes = 0;
+        uint64_t uploads = 0;       // upload() calls
+        uint64_t copyCommands = 0;  // vkCmdCopyBuffer calls, one per destination buffer and batch
+        uint64_t copyRegions = 0;
+        uint64_t submits = 0;
+        uint64_t stalls = 0;        // Waits for the GPU to release ring space
+        double stallMilliseconds = 0.0;
+    };
+
+    // Persistently mapped host-visible ring buffer for uploads to device-local buffers.
+    // upload() only copies into the ring and records a region; regions are grouped by
+    // destination and flushed as one vkCmdCopyBuffer per destination buffer, so a batch of
+    // meshes costs a handful of copy commands and a single submit. Ring space is reclaimed
+    // once the fence of the batch that used it has signaled; when the ring is full the
+    // oldest batch is waited for.
+    //
+    // Destinations are ready for vertex input and for vertex, fragment and compute shader
+    // reads once the batch's submit completed; finish() waits for everything.
+    class StagingRing {
+    public:
+        static constexpr VkDeviceSize DefaultCapacity = 16ull * 1024 * 1024;
+
+        StagingRing() = default;
+        ~StagingRing() = default;
+
+        bool init(GpuMemoryAllocator& allocator, VkQueue queue, uint32_t queueFamilyIndex, VkDeviceSize capacity = DefaultCapacity);
+        void cleanup(); // Waits for every batch
+
+        // Uploads larger than a quarter of the ring are split across batches
+        bool upload(VkBuffer destination, VkDeviceSize destinationOffset, const void* data, VkDeviceSize size);
+        bool flush();  // Submits the pending copies, does not wait
+        bool finish(); // flush, then wait for every batch
+        // Drops the copies into destination that were not submitted yet; submitted ones still
+        // land, so wait with finish() before freeing the buffer
+        void cancel(VkBuffer destination);
+
+        VkDeviceSize getCapacity() const { return capacity; }
+        const StagingStats& getStats() const { return stats; }
+
+    private:
+        struct Batch {
+            VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+            VkFence fence = VK_NULL_HANDLE;
+            uint64_t end = 0; // Ring cursor after the batch's last byte
+        };
+        struct PendingCopies {
+            VkBuffer destination = VK_NULL_HANDLE;
+            std::vector<VkBufferCopy> regions;
+        };
+
+        GpuMemoryAllocator* allocator = nullptr;
+        VkDevice device = VK_NULL_HANDLE;
+        VkQueue queue = VK_NULL_HANDLE;
+        VkCommandPool commandPool = VK_NULL_HANDLE;
+        GpuBuffer ring;
+        VkDeviceSize capacity = 0;
+        uint64_t writeCursor = 0;   // Monotonic, ring offset is cursor % capacity
+        uint64_t releasedCursor = 0; // Everything before it is free again
+        std::vector<PendingCopies> pending;
+        std::deque<Batch> inFlight;
+        std::vector<Batch> idle;
+        StagingStats stats;
+
+        bool reserve(VkDeviceSize size, VkDeviceSize& offset);
+        bool waitOldest();
+    };
+
+}
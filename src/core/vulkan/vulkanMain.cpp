@@ -1,26 +1,70 @@
 #include "vulkanMain.hpp"
+#include "Trace.hpp"
 #include <backends/imgui_impl_glfw.h>
 #include <backends/imgui_impl_vulkan.h>
 #include <IconsFontAwesome5.h>
 #include <ng-log/logging.h>
+#include <algorithm>
+#include <chrono>
 #include <filesystem>
+#include <sstream>
 
 namespace Anito3D {
 
-	VulkanMain::VulkanMain() : surface(VK_NULL_HANDLE), graphicsQueue(VK_NULL_HANDLE), renderPass(VK_NULL_HANDLE), imguiPool(VK_NULL_HANDLE), width(0), height(0), commandPool(VK_NULL_HANDLE) {}
+    bool VulkanSettings::parsePresentMode(const std::string& name, PresentMode& mode) {
+        for (PresentMode candidate : { PresentMode::Fifo, PresentMode::Mailbox, PresentMode::Immediate, PresentMode::Offscreen }) {
+            if (name == getPresentModeName(candidate)) {
+                mode = candidate;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    const char* VulkanSettings::getPresentModeName(PresentMode mode) {
+        switch (mode) {
+        case PresentMode::Mailbox: return "mailbox";
+        case PresentMode::Immediate: return "immediate";
+        case PresentMode::Offscreen: return "offscreen";
+        default: return "fifo";
+        }
+    }
+
+	VulkanMain::VulkanMain() : surface(VK_NULL_HANDLE), graphicsQueue(VK_NULL_HANDLE), renderPass(VK_NULL_HANDLE), offscreenRenderPass(VK_NULL_HANDLE), imguiPool(VK_NULL_HANDLE), width(0), height(0),
+        frameProfiler({ "poll", "imgui", "acquire", "record", "submit", "present" }, 1024, false) {}
 
 	VulkanMain::~VulkanMain() {
 		cleanup();
 	}
 
-    bool VulkanMain::init(GLFWwindow* window, uint32_t width, uint32_t height) {
+    bool VulkanMain::init(GLFWwindow* window, uint32_t width, uint32_t height, const VulkanSettings& settings) {
+        ANITO3D_TRACE_ZONE("VulkanMain::init");
+        initStart = std::chrono::steady_clock::now();
+        firstFramePending = true;
+        timeToFirstFrameMs = 0.0;
         this->width = width;
         this->height = height;
 
-        // Initialize Vulkan
+        VulkanSettings requested = settings;
+        requested.framesInFlight = std::clamp(settings.framesInFlight, 1u, FrameContextRing::MaxFramesInFlight);
+        // Frame contexts and the offscreen render pass are built for the settings
+        if (device.device != VK_NULL_HANDLE && (requested.framesInFlight != this->settings.framesInFlight ||
+            requested.presentMode != this->settings.presentMode)) {
+            cleanup();
+        }
+        this->settings = requested;
+
         try {
-            initVulkan(window);
-            initImGui(window);
+            coldStart = device.device == VK_NULL_HANDLE;
+            if (!coldStart && !attachWindow(window)) {
+                LOG(WARNING) << "New window is incompatible with the existing Vulkan device, recreating it";
+                cleanup();
+                coldStart = true;
+            }
+            if (coldStart) {
+                initVulkan(window);
+                initImGui(window);
+            }
         }
         catch (const std::exception& e) {
             LOG(ERROR) << "Vulkan initialization failed: " << e.what();
@@ -30,6 +74,7 @@ namespace Anito3D {
     }
 
     void VulkanMain::initVulkan(GLFWwindow* window) {
+        ANITO3D_TRACE_ZONE("VulkanMain::initVulkan");
         // Check required extensions
         uint32_t glfwExtensionCount = 0;
         const char** glfwExtensions = glfwGetRequiredInstanceExtensions(&glfwExtensionCount);
@@ -40,19 +85,26 @@ namespace Anito3D {
         std::vector<const char*> requiredExtensions(glfwExtensions, glfwExtensions + glfwExtensionCount);
         requiredExtensions.push_back(VK_EXT_DEBUG_UTILS_EXTENSION_NAME);
 
+        // Validation layers cost CPU time in every call, so release builds measure without them
+#ifdef NDEBUG
+        constexpr bool enableValidation = false;
+#else
+        constexpr bool enableValidation = true;
+#endif
+
         // Create Vulkan instance with vk-bootstrap
         vkb::InstanceBuilder instanceBuilder;
-        auto instRet = instanceBuilder.set_app_name("Anito3D Benchmark Sandbox")
-            .request_validation_layers(true)
-            .use_default_debug_messenger()
-            .require_api_version(1, 3, 0)
-            .build();
+        instanceBuilder.set_app_name("Anito3D Benchmark Sandbox")
+            .request_validation_layers(enableValidation)
+            .require_api_version(1, 3, 0);
+        if (enableValidation) instanceBuilder.use_default_debug_messenger();
+        auto instRet = instanceBuilder.build();
         if (!instRet) {
             LOG(ERROR) << "Failed to create Vulkan instance: " << instRet.error().message();
             throw std::runtime_error("Vulkan instance creation failed");
         }
         vkbInstance = instRet.value();
-        LOG(INFO) << "Vulkan instance created";
+        LOG(INFO) << "Vulkan instance created" << (enableValidation ? " with validation layers" : "");
 
         // Create surface
         VkResult result = glfwCreateWindowSurface(vkbInstance.instance, window, nullptr, &surface);
@@ -92,29 +144,25 @@ namespace Anito3D {
         }
         graphicsQueue = queueRet.value();
 
-        // Create swapchain
-        vkb::SwapchainBuilder swapchainBuilder(device);
-        auto swapRet = swapchainBuilder.set_desired_extent(width, height)
-            .set_desired_min_image_count(2)
-            .set_desired_format({ VK_FORMAT_B8G8R8A8_UNORM, VK_COLOR_SPACE_SRGB_NONLINEAR_KHR })
-            .build();
-        if (!swapRet) {
-            LOG(ERROR) << "Failed to create swapchain: " << swapRet.error().message();
-            throw std::runtime_error("Swapchain creation failed");
-        }
-        swapchain = swapRet.value();
-        swapchainImages = swapchain.get_images().value();
-        swapchainImageViews = swapchain.get_image_views().value();
-        LOG(INFO) << "Swapchain created with " << swapchainImages.size() << " images";
+        // Optional: without a cache every pipeline is compiled from scratch
+        pipelineCache.init(physicalDevice.physical_device, device.device, ANITO3DSANDBOX_PIPELINE_CACHE_PATH);
+        memoryAllocator.init(physicalDevice.physical_device, device.device);
 
+        createSwapchain();
         createRenderPass();
         createFramebuffers();
-        createCommandBuffers();
+        if (settings.presentMode == PresentMode::Offscreen) createOffscreenTargets();
+        createFrameContexts();
         createSyncObjects();
+
+        // Optional: runs without GPU timings when the graphics queue has no timestamps
+        gpuProfiler.init(physicalDevice.physical_device, device.device, getGraphicsQueueFamily(), frameContexts.getFramesInFlight());
+        gpuProfiler.setEnabled(frameProfiler.IsEnabled());
     }
 
 
     void VulkanMain::initImGui(GLFWwindow* window) {
+        ANITO3D_TRACE_ZONE("VulkanMain::initImGui");
         // Create descriptor pool for ImGui
         VkDescriptorPoolSize poolSizes[] = {
             { VK_DESCRIPTOR_TYPE_SAMPLER, 1000 },
@@ -182,26 +230,32 @@ namespace Anito3D {
             LOG(ERROR) << "Failed to initialize ImGui GLFW backend";
             throw std::runtime_error("ImGui GLFW initialization failed");
         }
+        attachedWindow = window;
 
         ImGui_ImplVulkan_InitInfo initInfo = {};
         initInfo.Instance = vkbInstance.instance;
         initInfo.PhysicalDevice = physicalDevice.physical_device;
         initInfo.Device = device.device;
-        initInfo.QueueFamily = device.get_queue_index(vkb::QueueType::graphics).value();
+        initInfo.QueueFamily = getGraphicsQueueFamily();
         initInfo.Queue = graphicsQueue;
-        initInfo.PipelineCache = VK_NULL_HANDLE;
+        initInfo.PipelineCache = pipelineCache.get();
         initInfo.DescriptorPool = imguiPool;
         initInfo.Subpass = 0;
-        initInfo.MinImageCount = 2;
+        initInfo.MinImageCount = std::max(2u, settings.framesInFlight);
         initInfo.ImageCount = swapchain.image_count;
         initInfo.MSAASamples = VK_SAMPLE_COUNT_1_BIT;
+        // Creates ImGui's pipeline, the one pipeline the menu has
+        const auto pipelineStart = std::chrono::steady_clock::now();
         if (!ImGui_ImplVulkan_Init(&initInfo, renderPass)) {
             LOG(ERROR) << "Failed to initialize ImGui Vulkan backend";
             throw std::runtime_error("ImGui Vulkan initialization failed");
         }
+        const double pipelineMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - pipelineStart).count();
+        pipelineCache.addPipelineCreation(pipelineMs);
+        LOG(INFO) << "ImGui pipeline created in " << pipelineMs << " ms (" << (pipelineCache.isWarm() ? "warm" : "cold") << " pipeline cache)";
 
-        // Upload ImGui fonts
-        VkCommandBuffer commandBuffer = commandBuffers[0];
+        // Upload ImGui fonts (the pool is reset when frame 0 begins)
+        VkCommandBuffer commandBuffer = frameContexts.getFrame(0).commandBuffer;
         VkCommandBufferBeginInfo beginInfo = { VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO };
         result = vkBeginCommandBuffer(commandBuffer, &beginInfo);
         if (result != VK_SUCCESS) {
@@ -220,7 +274,100 @@ namespace Anito3D {
         LOG(INFO) << "ImGui initialized successfully";
     }
 
+    bool VulkanMain::attachWindow(GLFWwindow* window) {
+        ANITO3D_TRACE_ZONE("VulkanMain::attachWindow");
+        VkResult result = glfwCreateWindowSurface(vkbInstance.instance, window, nullptr, &surface);
+        if (result != VK_SUCCESS) {
+            LOG(ERROR) << "Failed to create Vulkan surface: " << result;
+            throw std::runtime_error("Vulkan surface creation failed");
+        }
+        VkBool32 presentSupported = VK_FALSE;
+        vkGetPhysicalDeviceSurfaceSupportKHR(physicalDevice.physical_device, getGraphicsQueueFamily(), surface, &presentSupported);
+        if (!presentSupported) {
+            LOG(WARNING) << "Graphics queue cannot present to the new window";
+            return false;
+        }
+
+        createSwapchain();
+        // The render passes and ImGui's pipeline are built for the first window's format
+        if (swapchain.image_format != renderPassFormat) {
+            LOG(WARNING) << "New swapchain format " << swapchain.image_format << " differs from the render pass format " << renderPassFormat;
+            return false;
+        }
+        createFramebuffers();
+        if (settings.presentMode == PresentMode::Offscreen) createOffscreenTargets();
+        createSyncObjects();
+
+        if (!ImGui_ImplGlfw_InitForVulkan(window, true)) {
+            LOG(ERROR) << "Failed to initialize ImGui GLFW backend";
+            throw std::runtime_error("ImGui GLFW initialization failed");
+        }
+        attachedWindow = window;
+        ImGui::GetIO().DisplaySize = ImVec2(static_cast<float>(width), static_cast<float>(height));
+
+        // Frames of the previous window would mix into the new window's statistics
+        frameProfiler.Reset();
+        LOG(INFO) << "Attached window to the existing Vulkan device";
+        return true;
+    }
+
+    void VulkanMain::releaseWindow() {
+        if (device.device == VK_NULL_HANDLE) return;
+        vkDeviceWaitIdle(device.device);
+
+        if (attachedWindow) {
+            ImGui_ImplGlfw_Shutdown();
+            attachedWindow = nullptr;
+        }
+        for (auto semaphore : renderFinishedSemaphores) if (semaphore) vkDestroySemaphore(device.device, semaphore, nullptr);
+        renderFinishedSemaphores.clear();
+        destroySwapchainResources();
+        swapchainImages.clear();
+        if (swapchain.swapchain) vkb::destroy_swapchain(swapchain);
+        swapchain.swapchain = VK_NULL_HANDLE;
+        if (surface) vkb::destroy_surface(vkbInstance.instance, surface);
+        surface = VK_NULL_HANDLE;
+    }
+
+    void VulkanMain::createSwapchain() {
+        ANITO3D_TRACE_ZONE("VulkanMain::createSwapchain");
+        // Offscreen mode only presents previews, which may as well wait for vsync
+        VkPresentModeKHR presentMode = VK_PRESENT_MODE_FIFO_KHR;
+        if (settings.presentMode == PresentMode::Mailbox) presentMode = VK_PRESENT_MODE_MAILBOX_KHR;
+        else if (settings.presentMode == PresentMode::Immediate) presentMode = VK_PRESENT_MODE_IMMEDIATE_KHR;
+
+        // Enough images to keep every frame in flight busy, plus the one mailbox holds back
+        uint32_t minImageCount = std::max(2u, settings.framesInFlight);
+        if (presentMode == VK_PRESENT_MODE_MAILBOX_KHR) ++minImageCount;
+
+        // The device may outlive the surface it was created with, so name the current one
+        vkb::SwapchainBuilder swapchainBuilder(physicalDevice.physical_device, device.device, surface, getGraphicsQueueFamily(), getGraphicsQueueFamily());
+        auto swapRet = swapchainBuilder.set_desired_extent(width, height)
+            .set_desired_min_image_count(minImageCount)
+            .set_desired_format({ VK_FORMAT_B8G8R8A8_UNORM, VK_COLOR_SPACE_SRGB_NONLINEAR_KHR })
+            .set_desired_present_mode(presentMode)
+            .add_fallback_present_mode(VK_PRESENT_MODE_FIFO_KHR) // Always supported
+            .set_old_swapchain(swapchain)
+            .build();
+        if (!swapRet) {
+            LOG(ERROR) << "Failed to create swapchain: " << swapRet.error().message();
+            throw std::runtime_error("Swapchain creation failed");
+        }
+        if (swapchain.swapchain) vkb::destroy_swapchain(swapchain); // Retired by the new one
+        swapchain = swapRet.value();
+        swapchainImages = swapchain.get_images().value();
+        swapchainImageViews = swapchain.get_image_views().value();
+        width = swapchain.extent.width;
+        height = swapchain.extent.height;
+        if (swapchain.present_mode != presentMode) {
+            LOG(WARNING) << "Present mode " << VulkanSettings::getPresentModeName(settings.presentMode) << " not supported, falling back to FIFO";
+        }
+        LOG(INFO) << "Swapchain created with " << swapchainImages.size() << " images at " << width << "x" << height << " ("
+            << VulkanSettings::getPresentModeName(settings.presentMode) << ")";
+    }
+
     void VulkanMain::createRenderPass() {
+        ANITO3D_TRACE_ZONE("VulkanMain::createRenderPass");
         VkAttachmentDescription colorAttachment = {};
         colorAttachment.format = swapchain.image_format;
         colorAttachment.samples = VK_SAMPLE_COUNT_1_BIT;
@@ -261,9 +408,21 @@ namespace Anito3D {
             LOG(ERROR) << "Failed to create render pass: " << result;
             throw std::runtime_error("Render pass creation failed");
         }
+        renderPassFormat = swapchain.image_format;
+
+        // Compatible with the first one (layouts do not count), so ImGui's pipeline works in both
+        if (settings.presentMode == PresentMode::Offscreen) {
+            colorAttachment.finalLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+            result = vkCreateRenderPass(device.device, &renderPassInfo, nullptr, &offscreenRenderPass);
+            if (result != VK_SUCCESS) {
+                LOG(ERROR) << "Failed to create offscreen render pass: " << result;
+                throw std::runtime_error("Render pass creation failed");
+            }
+        }
     }
 
     void VulkanMain::createFramebuffers() {
+        ANITO3D_TRACE_ZONE("VulkanMain::createFramebuffers");
         framebuffers.resize(swapchainImageViews.size());
         for (size_t i = 0; i < swapchainImageViews.size(); ++i) {
             VkFramebufferCreateInfo fbInfo = { VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO };
@@ -281,58 +440,115 @@ namespace Anito3D {
         }
     }
 
-    void VulkanMain::createCommandBuffers() {
-        VkCommandPoolCreateInfo poolInfo = { VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO };
-        poolInfo.queueFamilyIndex = device.get_queue_index(vkb::QueueType::graphics).value();
-        poolInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT; // Enable command buffer reset
-        VkResult result = vkCreateCommandPool(device.device, &poolInfo, nullptr, &commandPool);
-        if (result != VK_SUCCESS) {
-            LOG(ERROR) << "Failed to create command pool: " << result;
-            throw std::runtime_error("Command pool creation failed");
+    void VulkanMain::createOffscreenTargets() {
+        ANITO3D_TRACE_ZONE("VulkanMain::createOffscreenTargets");
+        // A frame slot's fence guards its target, so one target per frame in flight is enough
+        offscreenTargets.resize(settings.framesInFlight);
+        for (size_t i = 0; i < offscreenTargets.size(); ++i) {
+            OffscreenTarget& target = offscreenTargets[i];
+            VkImageCreateInfo imageInfo = { VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO };
+            imageInfo.imageType = VK_IMAGE_TYPE_2D;
+            imageInfo.format = swapchain.image_format;
+            imageInfo.extent = { width, height, 1 };
+            imageInfo.mipLevels = 1;
+            imageInfo.arrayLayers = 1;
+            imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+            imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+            imageInfo.usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+            imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+            imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+            if (!memoryAllocator.createImage(imageInfo, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, target.image, target.allocation)) {
+                LOG(ERROR) << "Failed to create offscreen image " << i;
+                throw std::runtime_error("Offscreen image creation failed");
+            }
+
+            VkImageViewCreateInfo viewInfo = { VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO };
+            viewInfo.image = target.image;
+            viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+            viewInfo.format = swapchain.image_format;
+            viewInfo.subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1 };
+            VkResult result = vkCreateImageView(device.device, &viewInfo, nullptr, &target.view);
+            if (result != VK_SUCCESS) {
+                LOG(ERROR) << "Failed to create offscreen image view " << i << ": " << result;
+                throw std::runtime_error("Offscreen image view creation failed");
+            }
+
+            VkFramebufferCreateInfo fbInfo = { VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO };
+            fbInfo.renderPass = offscreenRenderPass;
+            fbInfo.attachmentCount = 1;
+            fbInfo.pAttachments = &target.view;
+            fbInfo.width = width;
+            fbInfo.height = height;
+            fbInfo.layers = 1;
+            result = vkCreateFramebuffer(device.device, &fbInfo, nullptr, &target.framebuffer);
+            if (result != VK_SUCCESS) {
+                LOG(ERROR) << "Failed to create offscreen framebuffer " << i << ": " << result;
+                throw std::runtime_error("Framebuffer creation failed");
+            }
+        }
+    }
+
+    void VulkanMain::destroySwapchainResources() {
+        for (auto& target : offscreenTargets) {
+            if (target.framebuffer) vkDestroyFramebuffer(device.device, target.framebuffer, nullptr);
+            if (target.view) vkDestroyImageView(device.device, target.view, nullptr);
+            memoryAllocator.destroyImage(target.image, target.allocation);
         }
-        LOG(INFO) << "Command pool created with VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT";
+        offscreenTargets.clear();
+        for (auto framebuffer : framebuffers) if (framebuffer) vkDestroyFramebuffer(device.device, framebuffer, nullptr);
+        framebuffers.clear();
+        for (auto imageView : swapchainImageViews) if (imageView) vkDestroyImageView(device.device, imageView, nullptr);
+        swapchainImageViews.clear();
+    }
 
-        VkCommandBufferAllocateInfo allocInfo = { VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO };
-        allocInfo.commandPool = commandPool;
-        allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-        allocInfo.commandBufferCount = static_cast<uint32_t>(framebuffers.size());
-        commandBuffers.resize(framebuffers.size());
-        result = vkAllocateCommandBuffers(device.device, &allocInfo, commandBuffers.data());
-        if (result != VK_SUCCESS) {
-            LOG(ERROR) << "Failed to allocate command buffers: " << result;
-            throw std::runtime_error("Command buffer allocation failed");
+    void VulkanMain::recreateSwapchain(GLFWwindow* window, uint32_t width, uint32_t height) {
+        ANITO3D_TRACE_ZONE("VulkanMain::recreateSwapchain");
+        if (width == 0 || height == 0) return; // Minimized
+        vkDeviceWaitIdle(device.device);
+
+        const VkFormat oldFormat = swapchain.image_format;
+        const size_t oldImageCount = swapchainImages.size();
+        destroySwapchainResources();
+        this->width = width;
+        this->height = height;
+        createSwapchain();
+        // The render passes and ImGui's pipeline are built for the old format
+        if (swapchain.image_format != oldFormat) throw std::runtime_error("Swapchain format changed");
+
+        createFramebuffers();
+        if (settings.presentMode == PresentMode::Offscreen) createOffscreenTargets();
+        if (swapchainImages.size() != oldImageCount) {
+            for (auto semaphore : renderFinishedSemaphores) vkDestroySemaphore(device.device, semaphore, nullptr);
+            createSyncObjects();
+        }
+    }
+
+    void VulkanMain::createFrameContexts() {
+        ANITO3D_TRACE_ZONE("VulkanMain::createFrameContexts");
+        if (!frameContexts.init(physicalDevice.physical_device, device.device, getGraphicsQueueFamily(), settings.framesInFlight, TransientBytesPerFrame)) {
+            throw std::runtime_error("Frame context creation failed");
         }
-        LOG(INFO) << "Allocated " << commandBuffers.size() << " command buffers";
     }
 
     void VulkanMain::createSyncObjects() {
-        imageAvailableSemaphores.resize(2);
-        renderFinishedSemaphores.resize(2);
-        inFlightFences.resize(2);
+        ANITO3D_TRACE_ZONE("VulkanMain::createSyncObjects");
+        renderFinishedSemaphores.resize(swapchainImages.size());
 
         VkSemaphoreCreateInfo semaphoreInfo = { VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO };
-        VkFenceCreateInfo fenceInfo = { VK_STRUCTURE_TYPE_FENCE_CREATE_INFO };
-        fenceInfo.flags = VK_FENCE_CREATE_SIGNALED_BIT;
-
-        for (size_t i = 0; i < 2; ++i) {
-            VkResult result = vkCreateSemaphore(device.device, &semaphoreInfo, nullptr, &imageAvailableSemaphores[i]);
-            if (result != VK_SUCCESS) {
-                LOG(ERROR) << "Failed to create image available semaphore " << i << ": " << result;
-                throw std::runtime_error("Semaphore creation failed");
-            }
-            result = vkCreateSemaphore(device.device, &semaphoreInfo, nullptr, &renderFinishedSemaphores[i]);
+        for (size_t i = 0; i < renderFinishedSemaphores.size(); ++i) {
+            VkResult result = vkCreateSemaphore(device.device, &semaphoreInfo, nullptr, &renderFinishedSemaphores[i]);
             if (result != VK_SUCCESS) {
                 LOG(ERROR) << "Failed to create render finished semaphore " << i << ": " << result;
                 throw std::runtime_error("Semaphore creation failed");
             }
-            result = vkCreateFence(device.device, &fenceInfo, nullptr, &inFlightFences[i]);
-            if (result != VK_SUCCESS) {
-                LOG(ERROR) << "Failed to create fence " << i << ": " << result;
-                throw std::runtime_error("Fence creation failed");
-            }
         }
     }
 
+    void VulkanMain::setFrameStatsEnabled(bool enabled) {
+        frameProfiler.SetEnabled(enabled);
+        gpuProfiler.setEnabled(enabled);
+    }
+
     int VulkanMain::runMainMenu(GLFWwindow* window) {
         if (!window) {
             LOG(ERROR) << "VulkanMain::runMainMenu: Null window provided";
@@ -344,10 +560,20 @@ namespace Anito3D {
         ImGuiMain imguiMain;
 
         int selectedRenderer = 0; // 0 = none, 1 = BGFX, 2 = Ogre3D, 3 = Diligent
-        uint32_t currentFrame = 0;
+        bool toggleFrameStats = false;
+        double nextPreviewTime = 0.0;
 
         while (!glfwWindowShouldClose(window)) {
+            // Toggle between frames so the first profiled frame is a whole one
+            if (toggleFrameStats) {
+                setFrameStatsEnabled(!frameProfiler.IsEnabled());
+                LOG(INFO) << "Frame statistics " << (frameProfiler.IsEnabled() ? "enabled" : "disabled");
+                toggleFrameStats = false;
+            }
+            frameProfiler.BeginFrame();
             glfwPollEvents();
+            frameProfiler.EndPhase(PollPhase);
+
             ImGui_ImplVulkan_NewFrame();
             ImGui_ImplGlfw_NewFrame();
             ImGui::NewFrame();
@@ -358,87 +584,157 @@ namespace Anito3D {
             }
             catch (const std::exception& e) {
                 LOG(ERROR) << "ImGuiMain::renderMainMenu exception: " << e.what();
+                ImGui::EndFrame();
+                break;
+            }
+
+            // The ImGui context outlives this menu, so close the frame before leaving
+            if (selectedRenderer != 0) {
+                ImGui::EndFrame();
                 break;
             }
 
-            if (selectedRenderer != 0) break;
+            if (ImGui::IsKeyPressed(ImGuiKey_F3, false)) toggleFrameStats = true;
+            frameStatsOverlay.render(frameProfiler);
 
-            // Render
-            vkWaitForFences(device.device, 1, &inFlightFences[currentFrame], VK_TRUE, UINT64_MAX);
-            vkResetFences(device.device, 1, &inFlightFences[currentFrame]);
+            // Finish the UI before waiting on the GPU, so skipped frames still end the ImGui frame
+            ImGui::Render();
+            frameProfiler.EndPhase(ImGuiPhase);
 
-            uint32_t imageIndex;
-            VkResult result = vkAcquireNextImageKHR(device.device, swapchain.swapchain, UINT64_MAX, imageAvailableSemaphores[currentFrame], VK_NULL_HANDLE, &imageIndex);
-            if (result == VK_ERROR_OUT_OF_DATE_KHR || result == VK_SUBOPTIMAL_KHR) {
-                LOG(WARNING) << "Swapchain out of date, skipping frame";
+            // A minimized window has nothing to present to
+            int framebufferWidth = 0, framebufferHeight = 0;
+            glfwGetFramebufferSize(window, &framebufferWidth, &framebufferHeight);
+            if (framebufferWidth == 0 || framebufferHeight == 0) {
+                glfwWaitEvents();
                 continue;
             }
-            else if (result != VK_SUCCESS) {
-                LOG(ERROR) << "Failed to acquire swapchain image: " << result;
-                break;
+            if (static_cast<uint32_t>(framebufferWidth) != width || static_cast<uint32_t>(framebufferHeight) != height) {
+                recreateSwapchain(window, framebufferWidth, framebufferHeight);
+            }
+
+            // Offscreen frames skip the swapchain; a preview frame goes through it now and then
+            bool present = true;
+            if (settings.presentMode == PresentMode::Offscreen) {
+                present = glfwGetTime() >= nextPreviewTime;
+                if (present) nextPreviewTime = glfwGetTime() + OffscreenPreviewInterval;
+            }
+
+            // Render
+            const uint32_t frameSlot = frameContexts.getFrameSlot();
+            FrameContext& frame = frameContexts.beginFrame();
+
+            uint32_t imageIndex = 0;
+            VkResult result = VK_SUCCESS;
+            bool swapchainStale = false;
+            if (present) {
+                result = vkAcquireNextImageKHR(device.device, swapchain.swapchain, UINT64_MAX, frame.imageAvailable, VK_NULL_HANDLE, &imageIndex);
+                if (result == VK_ERROR_OUT_OF_DATE_KHR) {
+                    // Nothing was acquired, so the frame's semaphore and fence stay untouched
+                    recreateSwapchain(window, framebufferWidth, framebufferHeight);
+                    continue;
+                }
+                else if (result == VK_SUBOPTIMAL_KHR) {
+                    swapchainStale = true; // The image is acquired and its semaphore pending, so finish the frame first
+                }
+                else if (result != VK_SUCCESS) {
+                    LOG(ERROR) << "Failed to acquire swapchain image: " << result;
+                    break;
+                }
             }
+            frameProfiler.EndPhase(AcquirePhase);
 
-            vkResetCommandBuffer(commandBuffers[imageIndex], 0);
+            VkCommandBuffer commandBuffer = frame.commandBuffer;
             VkCommandBufferBeginInfo beginInfo = { VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO };
-            result = vkBeginCommandBuffer(commandBuffers[imageIndex], &beginInfo);
+            beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+            result = vkBeginCommandBuffer(commandBuffer, &beginInfo);
             if (result != VK_SUCCESS) {
                 LOG(ERROR) << "Failed to begin command buffer: " << result;
                 break;
             }
+            // This slot's fence has been waited on, so its previous GPU timings are ready
+            if (gpuProfiler.beginFrame(commandBuffer, frameSlot, frameProfiler.GetCurrentFrame())) {
+                frameProfiler.SetGpuTime(gpuProfiler.getLastFrameTag(), gpuProfiler.getLastFrameMs());
+            }
 
             VkRenderPassBeginInfo renderPassInfo = { VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO };
-            renderPassInfo.renderPass = renderPass;
-            renderPassInfo.framebuffer = framebuffers[imageIndex];
+            renderPassInfo.renderPass = present ? renderPass : offscreenRenderPass;
+            renderPassInfo.framebuffer = present ? framebuffers[imageIndex] : offscreenTargets[frameSlot].framebuffer;
             renderPassInfo.renderArea.extent = { width, height };
             VkClearValue clearColor = { {{0.3f, 0.3f, 0.3f, 1.0f}} };
             renderPassInfo.clearValueCount = 1;
             renderPassInfo.pClearValues = &clearColor;
-            vkCmdBeginRenderPass(commandBuffers[imageIndex], &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
+            gpuProfiler.beginScope(commandBuffer, "menuPass");
+            vkCmdBeginRenderPass(commandBuffer, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
 
-            ImGui::Render();
-            ImGui_ImplVulkan_RenderDrawData(ImGui::GetDrawData(), commandBuffers[imageIndex]);
+            ImGui_ImplVulkan_RenderDrawData(ImGui::GetDrawData(), commandBuffer);
 
-            vkCmdEndRenderPass(commandBuffers[imageIndex]);
-            result = vkEndCommandBuffer(commandBuffers[imageIndex]);
+            vkCmdEndRenderPass(commandBuffer);
+            gpuProfiler.endScope(commandBuffer);
+            gpuProfiler.endFrame(commandBuffer);
+            result = vkEndCommandBuffer(commandBuffer);
             if (result != VK_SUCCESS) {
                 LOG(ERROR) << "Failed to end command buffer: " << result;
                 break;
             }
+            frameProfiler.EndPhase(RecordPhase);
 
             VkSubmitInfo submitInfo = { VK_STRUCTURE_TYPE_SUBMIT_INFO };
             VkPipelineStageFlags waitStages[] = { VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT };
-            submitInfo.waitSemaphoreCount = 1;
-            submitInfo.pWaitSemaphores = &imageAvailableSemaphores[currentFrame];
+            submitInfo.waitSemaphoreCount = present ? 1 : 0;
+            submitInfo.pWaitSemaphores = &frame.imageAvailable;
             submitInfo.pWaitDstStageMask = waitStages;
             submitInfo.commandBufferCount = 1;
-            submitInfo.pCommandBuffers = &commandBuffers[imageIndex];
-            submitInfo.signalSemaphoreCount = 1;
-            submitInfo.pSignalSemaphores = &renderFinishedSemaphores[currentFrame];
-            result = vkQueueSubmit(graphicsQueue, 1, &submitInfo, inFlightFences[currentFrame]);
+            submitInfo.pCommandBuffers = &commandBuffer;
+            submitInfo.signalSemaphoreCount = present ? 1 : 0;
+            submitInfo.pSignalSemaphores = &renderFinishedSemaphores[imageIndex];
+            // Reset only now, so a frame dropped before its submit leaves the fence signaled
+            vkResetFences(device.device, 1, &frame.inFlight);
+            result = vkQueueSubmit(graphicsQueue, 1, &submitInfo, frame.inFlight);
             if (result != VK_SUCCESS) {
                 LOG(ERROR) << "Failed to submit draw command buffer: " << result;
                 break;
             }
-
-            VkPresentInfoKHR presentInfo = { VK_STRUCTURE_TYPE_PRESENT_INFO_KHR };
-            presentInfo.waitSemaphoreCount = 1;
-            presentInfo.pWaitSemaphores = &renderFinishedSemaphores[currentFrame];
-            presentInfo.swapchainCount = 1;
-            presentInfo.pSwapchains = &swapchain.swapchain;
-            presentInfo.pImageIndices = &imageIndex;
-            result = vkQueuePresentKHR(graphicsQueue, &presentInfo);
-            if (result == VK_ERROR_OUT_OF_DATE_KHR || result == VK_SUBOPTIMAL_KHR) {
-                LOG(WARNING) << "Swapchain out of date, skipping frame";
-                continue;
+            frameContexts.endFrame();
+            frameProfiler.EndPhase(SubmitPhase);
+
+            if (present) {
+                VkPresentInfoKHR presentInfo = { VK_STRUCTURE_TYPE_PRESENT_INFO_KHR };
+                presentInfo.waitSemaphoreCount = 1;
+                presentInfo.pWaitSemaphores = &renderFinishedSemaphores[imageIndex];
+                presentInfo.swapchainCount = 1;
+                presentInfo.pSwapchains = &swapchain.swapchain;
+                presentInfo.pImageIndices = &imageIndex;
+                result = vkQueuePresentKHR(graphicsQueue, &presentInfo);
+            }
+            frameProfiler.EndPhase(PresentPhase);
+            frameProfiler.EndFrame();
+            if (result == VK_ERROR_OUT_OF_DATE_KHR || result == VK_SUBOPTIMAL_KHR || swapchainStale) {
+                recreateSwapchain(window, framebufferWidth, framebufferHeight);
             }
             else if (result != VK_SUCCESS) {
                 LOG(ERROR) << "Failed to present swapchain image: " << result;
                 break;
             }
+            if (firstFramePending) {
+                firstFramePending = false;
+                timeToFirstFrameMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - initStart).count();
+                LOG(INFO) << "Time to first frame: " << timeToFirstFrameMs << " ms (" << (coldStart ? "cold" : "warm") << " start)";
+                ANITO3D_TRACE_COUNTER("timeToFirstFrameMs", timeToFirstFrameMs);
+            }
+        }
 
-            currentFrame = (currentFrame + 1) % 2;
-
-            if (selectedRenderer != 0) break;
+        if (frameProfiler.GetFrameCount() > 0) {
+            const FrameStatistics statistics = frameProfiler.ComputeStatistics();
+            LOG(INFO) << "Main menu frame statistics (last " << statistics.frames << " frames, " << frameContexts.getFramesInFlight() << " in flight, "
+                << VulkanSettings::getPresentModeName(settings.presentMode) << "): mean " << statistics.total.mean << " ms, p95 "
+                << statistics.total.p95 << " ms, p99 " << statistics.total.p99 << " ms, max " << statistics.total.max << " ms, "
+                << statistics.totalStutters << " stutters";
+            if (statistics.gpuFrames > 0) {
+                std::ostringstream scopes;
+                for (const auto& timing : gpuProfiler.getFrameTimings()) scopes << ", " << timing.name << " " << timing.milliseconds << " ms";
+                LOG(INFO) << "Main menu GPU time: mean " << statistics.gpu.mean << " ms, p95 " << statistics.gpu.p95 << " ms, max "
+                    << statistics.gpu.max << " ms (last frame" << scopes.str() << ")";
+            }
         }
 
         return selectedRenderer;
@@ -446,27 +742,27 @@ namespace Anito3D {
 
     void VulkanMain::cleanup() {
         if (device.device != VK_NULL_HANDLE) {
-            vkDeviceWaitIdle(device.device);
+            releaseWindow();
 
-            for (auto semaphore : imageAvailableSemaphores) if (semaphore) vkDestroySemaphore(device.device, semaphore, nullptr);
-            for (auto semaphore : renderFinishedSemaphores) if (semaphore) vkDestroySemaphore(device.device, semaphore, nullptr);
-            for (auto fence : inFlightFences) if (fence) vkDestroyFence(device.device, fence, nullptr);
-            if (commandPool) vkDestroyCommandPool(device.device, commandPool, nullptr);
-            for (auto framebuffer : framebuffers) if (framebuffer) vkDestroyFramebuffer(device.device, framebuffer, nullptr);
+            gpuProfiler.cleanup();
+            frameContexts.cleanup();
             if (renderPass) vkDestroyRenderPass(device.device, renderPass, nullptr);
+            if (offscreenRenderPass) vkDestroyRenderPass(device.device, offscreenRenderPass, nullptr);
             if (imguiPool) {
                 ImGui_ImplVulkan_Shutdown();
+                ImGui::DestroyContext();
                 vkDestroyDescriptorPool(device.device, imguiPool, nullptr);
             }
-            for (auto imageView : swapchainImageViews) if (imageView) vkDestroyImageView(device.device, imageView, nullptr);
-            if (swapchain.swapchain) vkb::destroy_swapchain(swapchain);
+            pipelineCache.cleanup();
+            memoryAllocator.cleanup();
             if (device.device) vkb::destroy_device(device);
-            if (surface) vkb::destroy_surface(vkbInstance.instance, surface);
             if (vkbInstance.instance) vkb::destroy_instance(vkbInstance);
 
             device.device = VK_NULL_HANDLE;
-            surface = VK_NULL_HANDLE;
+            vkbInstance.instance = VK_NULL_HANDLE;
             renderPass = VK_NULL_HANDLE;
+            offscreenRenderPass = VK_NULL_HANDLE;
+            renderPassFormat = VK_FORMAT_UNDEFINED;
             imguiPool = VK_NULL_HANDLE;
         }
         LOG(INFO) << "VulkanMain cleaned up";
@@ -4,57 +4,148 @@
 #include <VkBootstrap.h>
 #include <GLFW/glfw3.h>
 #include <imgui.h>
+#include <chrono>
 #include <functional>
+#include <string>
 
 #include "ImGuiMain.hpp"
 #include "AnitoImGuiStyle.hpp"
+#include "FrameProfiler.hpp"
+#include "FrameStatsOverlay.hpp"
+#include "GpuProfiler.hpp"
+#include "FrameContext.hpp"
+#include "PipelineCache.hpp"
+#include "GpuMemoryAllocator.hpp"
 
 namespace Anito3D {
 
+    // Swapchain presentation; a mode the surface does not support falls back to Fifo
+    enum class PresentMode {
+        Fifo,      // Vsync, capped at the refresh rate
+        Mailbox,   // Uncapped rendering, the newest image replaces the queued one
+        Immediate, // Uncapped and unsynchronized, may tear
+        Offscreen  // Renders into offscreen images and only presents a preview twice a second
+    };
+
+    struct VulkanSettings {
+        uint32_t framesInFlight = 2; // 1-4, trades input latency against CPU/GPU overlap
+        PresentMode presentMode = PresentMode::Fifo;
+
+        // "fifo", "mailbox", "immediate" or "offscreen"
+        static bool parsePresentMode(const std::string& name, PresentMode& mode);
+        static const char* getPresentModeName(PresentMode mode);
+    };
+
 	class VulkanMain {
 	public:
 		VulkanMain();
 		~VulkanMain();
 
-		bool init(GLFWwindow* window, uint32_t width, uint32_t height);
+		// The first call creates the instance and device (cold start). Later calls after
+		// releaseWindow only attach the new window: surface, swapchain and what depends on its
+		// images (warm start). The device, pipeline cache, frame contexts and ImGui's context,
+		// fonts and pipeline survive, unless the settings changed or the new surface cannot use
+		// the existing device or swapchain format. Validation layers are enabled in debug builds only.
+		bool init(GLFWwindow* window, uint32_t width, uint32_t height, const VulkanSettings& settings = {});
+
+		// Drop everything tied to the window so it can be destroyed, keeping the device
+		void releaseWindow();
 
         // Render the main menu, returns selected renderer (-1 = None, 1 = BGFX, 2 = Diligent, etc.)
         int runMainMenu(GLFWwindow* window);
 
+        // Rebuilds the swapchain for a new window size, keeping the render pass, frame contexts
+        // and ImGui; framebuffers, offscreen targets and per-image semaphores follow the new images
         void recreateSwapchain(GLFWwindow* window, uint32_t width, uint32_t height);
 
 		void cleanup();
 
+        // From the start of init to the first submitted frame of runMainMenu, 0 before that
+        double getTimeToFirstFrameMs() const { return timeToFirstFrameMs; }
+        bool isColdStart() const { return coldStart; }
+
+        // Per-phase CPU and GPU frame timing of the menu loop, shown in an overlay when enabled (F3 toggles it)
+        void setFrameStatsEnabled(bool enabled);
+        const FrameProfiler& getFrameProfiler() const { return frameProfiler; }
+        const GpuProfiler& getGpuProfiler() const { return gpuProfiler; }
+        uint32_t getFramesInFlight() const { return frameContexts.getFramesInFlight(); }
+
+        // Pass get() to every pipeline creation and report its time with addPipelineCreation
+        PipelineCache& getPipelineCache() { return pipelineCache; }
+
+        // Device memory for buffers and images that outlive a frame; fill buffers through a StagingRing
+        GpuMemoryAllocator& getMemoryAllocator() { return memoryAllocator; }
+
 	private:
+        static constexpr VkDeviceSize TransientBytesPerFrame = 4 * 1024 * 1024;
+        static constexpr double OffscreenPreviewInterval = 0.5; // Seconds between presented frames in offscreen mode
+
+        // Color target of an offscreen frame, one per frame in flight
+        struct OffscreenTarget {
+            VkImage image = VK_NULL_HANDLE;
+            GpuAllocation allocation;
+            VkImageView view = VK_NULL_HANDLE;
+            VkFramebuffer framebuffer = VK_NULL_HANDLE;
+        };
+
+        enum FramePhase : uint32_t {
+            PollPhase,
+            ImGuiPhase,
+            AcquirePhase, // Includes the in-flight fence wait
+            RecordPhase,
+            SubmitPhase,
+            PresentPhase
+        };
+
         // Vulkan resources
         vkb::Instance vkbInstance;
         VkSurfaceKHR surface;
+        GLFWwindow* attachedWindow = nullptr; // ImGui's GLFW backend is bound to it
         vkb::PhysicalDevice physicalDevice;
         vkb::Device device;
         VkQueue graphicsQueue;
         VkQueue presentQueue;
+        PipelineCache pipelineCache;
+        GpuMemoryAllocator memoryAllocator;
         vkb::Swapchain swapchain;
         std::vector<VkImage> swapchainImages;
         std::vector<VkImageView> swapchainImageViews;
         VkRenderPass renderPass;
+        VkFormat renderPassFormat = VK_FORMAT_UNDEFINED;
+        VkRenderPass offscreenRenderPass; // Same attachments, ends in COLOR_ATTACHMENT_OPTIMAL instead of PRESENT_SRC
         std::vector<VkFramebuffer> framebuffers;
-        VkCommandPool commandPool;
-        std::vector<VkCommandBuffer> commandBuffers;
-        std::vector<VkSemaphore> imageAvailableSemaphores;
-        std::vector<VkSemaphore> renderFinishedSemaphores;
-        std::vector<VkFence> inFlightFences;
+        std::vector<OffscreenTarget> offscreenTargets;
+        FrameContextRing frameContexts;
+        std::vector<VkSemaphore> renderFinishedSemaphores; // Per swapchain image, reused once the image is acquired again
 
         // ImGui resources
         VkDescriptorPool imguiPool;
 
         // Window dimensions
         uint32_t width, height;
+        VulkanSettings settings;
+
+        // Time to first frame
+        std::chrono::steady_clock::time_point initStart;
+        bool coldStart = true;
+        bool firstFramePending = false;
+        double timeToFirstFrameMs = 0.0;
+
+        // Frame statistics
+        FrameProfiler frameProfiler;
+        FrameStatsOverlay frameStatsOverlay;
+        GpuProfiler gpuProfiler;
 
         void initVulkan(GLFWwindow* window);
         void initImGui(GLFWwindow* window);
+        bool attachWindow(GLFWwindow* window);
+        uint32_t getGraphicsQueueFamily() const { return device.get_queue_index(vkb::QueueType::graphics).value(); }
+        void createSwapchain();
         void createRenderPass();
         void createFramebuffers();
-        void createCommandBuffers();
+        void createOffscreenTargets();
+        void destroySwapchainResources();
+        void createFrameContexts();
         void createSyncObjects();
 	};
 
@@ -0,0 +1,152 @@
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "MeshCache.hpp"
+#include "MeshOptimizer.hpp"
+#include "MeshProcessing.hpp"
+#include "SceneImporter.hpp"
+
+namespace {
+    void printUsage(const char* programName) {
+        std::cout << "Usage: " << programName << " [options] <model file or directory>...\n"
+            << "  --cache-dir <dir>   Cache directory (default: " << Anito3D::MeshCache::Default().GetDirectory() << ")\n"
+            << "  --verify            Only validate existing caches, do not bake\n"
+            << "  --hash              Validate against the source content hash instead of size/mtime\n"
+            << "  --force             Rebake even if the cache is valid\n"
+            << "  --optimize          Bake vertex cache/overdraw/fetch optimized meshes\n"
+            << "  --weld              Bake welded meshes (duplicate vertices merged)\n"
+            << "  --no-narrow-indices Keep 32-bit indices\n"
+            << "  --invalidate        Delete the cache entries of the given sources\n";
+    }
+
+    void collectSources(const std::filesystem::path& path, std::vector<std::string>& sources) {
+        Assimp::Importer importer;
+        if (std::filesystem::is_directory(path)) {
+            for (const auto& entry : std::filesystem::recursive_directory_iterator(path)) {
+                if (entry.is_regular_file() && importer.IsExtensionSupported(entry.path().extension().string())) {
+                    sources.push_back(entry.path().string());
+                }
+            }
+        }
+        else {
+            sources.push_back(path.string());
+        }
+    }
+
+    double elapsedMilliseconds(std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+}
+
+int main(int argc, char* argv[]) {
+    std::string cacheDirectory = Anito3D::MeshCache::Default().GetDirectory();
+    bool verifyOnly = false;
+    bool force = false;
+    bool invalidate = false;
+    Anito3D::MeshProcessOptions process;
+    auto validation = Anito3D::MeshCache::Validation::Timestamp;
+    std::vector<std::string> sources;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--cache-dir" && i + 1 < argc) cacheDirectory = argv[++i];
+        else if (arg == "--verify") verifyOnly = true;
+        else if (arg == "--hash") validation = Anito3D::MeshCache::Validation::ContentHash;
+        else if (arg == "--force") force = true;
+        else if (arg == "--invalidate") invalidate = true;
+        else if (arg == "--optimize") process.flags |= Anito3D::MeshProcess::Optimize;
+        else if (arg == "--weld") process.flags |= Anito3D::MeshProcess::WeldVertices;
+        else if (arg == "--no-narrow-indices") process.flags &= ~Anito3D::MeshProcess::NarrowIndices;
+        else if (arg == "--help" || arg == "-h") {
+            printUsage(argv[0]);
+            return 0;
+        }
+        else if (arg.rfind("--", 0) == 0) {
+            std::cerr << "Unknown argument: " << arg << "\n";
+            printUsage(argv[0]);
+            return 1;
+        }
+        else collectSources(arg, sources);
+    }
+
+    if (sources.empty()) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    Anito3D::MeshCache cache(cacheDirectory);
+    const Anito3D::MeshCacheKey cacheKey(Anito3D::SceneImporter::DefaultImportFlags, process.flags, process.GetSettingsHash());
+    int failures = 0;
+
+    for (const auto& source : sources) {
+        if (invalidate) {
+            std::cout << (cache.Invalidate(source, cacheKey) ? "removed  " : "absent   ") << source << "\n";
+            continue;
+        }
+
+        Anito3D::MeshCacheStatus status = cache.Validate(source, cacheKey, validation);
+        if (verifyOnly) {
+            std::cout << Anito3D::ToString(status) << "\t" << source << "\n";
+            if (status != Anito3D::MeshCacheStatus::Valid) ++failures;
+            continue;
+        }
+
+        if (status == Anito3D::MeshCacheStatus::Valid && !force) {
+            std::cout << "up to date  " << source << "\n";
+            continue;
+        }
+
+        auto importStart = std::chrono::steady_clock::now();
+        Anito3D::MeshData meshData;
+        if (!Anito3D::SceneImporter::Import(source, meshData, cacheKey.importFlags)) {
+            std::cerr << "import failed  " << source << "\n";
+            ++failures;
+            continue;
+        }
+        double importMs = elapsedMilliseconds(importStart);
+
+        std::string processSummary;
+        if (process.flags) {
+            const size_t verticesBefore = meshData.GetVertexCount();
+            const size_t memoryBefore = meshData.GetVertexMemory() + meshData.GetIndexMemory();
+            auto cacheBefore = Anito3D::MeshOptimizer::AnalyzeVertexCache(meshData);
+            auto processStart = std::chrono::steady_clock::now();
+            Anito3D::MeshProcessor::Run(meshData, process);
+            double processMs = elapsedMilliseconds(processStart);
+            const size_t memoryAfter = meshData.GetVertexMemory() + meshData.GetIndexMemory();
+
+            processSummary = "\n       processed in " + std::to_string(processMs) + " ms: vertices " + std::to_string(verticesBefore)
+                + " -> " + std::to_string(meshData.GetVertexCount()) + ", vertex+index bytes " + std::to_string(memoryBefore)
+                + " -> " + std::to_string(memoryAfter);
+            if (process.flags & Anito3D::MeshProcess::Optimize) {
+                auto cacheAfter = Anito3D::MeshOptimizer::AnalyzeVertexCache(meshData);
+                processSummary += ", ACMR " + std::to_string(cacheBefore.GetAcmr()) + " -> " + std::to_string(cacheAfter.GetAcmr())
+                    + ", ATVR " + std::to_string(cacheBefore.GetAtvr()) + " -> " + std::to_string(cacheAfter.GetAtvr());
+            }
+        }
+
+        if (!cache.Store(source, cacheKey, meshData)) {
+            std::cerr << "store failed  " << source << "\n";
+            ++failures;
+            continue;
+        }
+
+        // Time a warm load so the speedup is visible right away
+        auto loadStart = std::chrono::steady_clock::now();
+        Anito3D::MeshData cached;
+        bool warmLoaded = cache.Load(source, cacheKey, cached, validation);
+        double loadMs = elapsedMilliseconds(loadStart);
+
+        std::cout << "baked  " << source << " (" << Anito3D::ToString(status) << ") -> "
+            << cache.GetCachePath(source, cacheKey) << "\n"
+            << "       " << meshData.GetVertexCount() << " vertices, " << meshData.GetTriangleCount() << " triangles, "
+            << meshData.subMeshes.size() << " submeshes | assimp " << importMs << " ms, cache "
+            << (warmLoaded ? std::to_string(loadMs) + " ms" : std::string("FAILED")) << processSummary << "\n";
+        if (!warmLoaded) ++failures;
+    }
+
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+#include <cstdint>
+
+// Test double for the handful of Vulkan entry points GpuMemoryAllocator and StagingRing
+// call, so their tests run without a driver. Device memory is host memory; every memory
+// type is host-addressable, but only type 1 reports HOST_VISIBLE. Queue submissions are
+// deferred: their copies run when the fence is waited for, so staging data overwritten
+// while still in flight shows up as wrong bytes in the destination.
+namespace Anito3D::Test {
+
+    struct MockVulkanState {
+        int liveMemoryBlocks = 0;
+        int liveBuffers = 0;
+        uint64_t submits = 0;
+        uint64_t copyCommands = 0;
+        bool failSubmits = false; // vkQueueSubmit returns VK_ERROR_DEVICE_LOST
+    };
+
+    MockVulkanState& GetMockVulkan();
+
+    // Contents of a bound buffer, as the GPU would see it
+    const uint8_t* GetMockBufferData(VkBuffer buffer);
+
+    inline VkPhysicalDevice GetMockPhysicalDevice() { return reinterpret_cast<VkPhysicalDevice>(uintptr_t(1)); }
+    inline VkDevice GetMockDevice() { return reinterpret_cast<VkDevice>(uintptr_t(1)); }
+    inline VkQueue GetMockQueue() { return reinterpret_cast<VkQueue>(uintptr_t(1)); }
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+// Minimal assertion helpers for the unit tests. Every test source registers its cases with
+// ANITO3D_TEST and is linked with TestMain.cpp into its own executable; CTest runs each
+// executable and a non-zero exit code fails it.
+namespace Anito3D::Test {
+
+    struct TestCase {
+        const char* name;
+        void (*run)();
+    };
+
+    inline std::vector<TestCase>& GetRegistry() {
+        static std::vector<TestCase> registry;
+        return registry;
+    }
+
+    inline int& GetFailureCount() {
+        static int failures = 0;
+        return failures;
+    }
+
+    struct TestRegistrar {
+        TestRegistrar(const char* name, void (*run)()) { GetRegistry().push_back({ name, run }); }
+    };
+
+    inline void ReportFailure(const char* file, int line, const char* expression) {
+        std::fprintf(stderr, "%s:%d: check failed: %s\n", file, line, expression);
+        ++GetFailureCount();
+    }
+
+    inline void ReportNearFailure(const char* file, int line, const char* expression, double actual, double expected, double tolerance) {
+        std::fprintf(stderr, "%s:%d: check failed: %s (%.9g vs %.9g, tolerance %.9g)\n", file, line, expression, actual, expected, tolerance);
+        ++GetFailureCount();
+    }
+
+    // Runs every registered case, returns the process exit code
+    inline int RunAll() {
+        int failedCases = 0;
+        for (const TestCase& testCase : GetRegistry()) {
+            const int failuresBefore = GetFailureCount();
+            std::printf("[ RUN    ] %s\n", testCase.name);
+            testCase.run();
+            const bool passed = GetFailureCount() == failuresBefore;
+            std::printf("[ %s ] %s\n", passed ? "    OK" : "FAILED", testCase.name);
+            failedCases += passed ? 0 : 1;
+        }
+        std::printf("%zu cases, %d failed\n", GetRegistry().size(), failedCases);
+        return failedCases == 0 ? 0 : 1;
+    }
+}
+
+#define ANITO3D_TEST(name) \
+    static void name(); \
+    static const ::Anito3D::Test::TestRegistrar name##Registrar(#name, &name); \
+    static void name()
+
+#define CHECK(expression) \
+    do { if (!(expression)) ::Anito3D::Test::ReportFailure(__FILE__, __LINE__, #expression); } while (0)
+
+// Stops the current case, for checks later ones depend on
+#define REQUIRE(expression) \
+    do { if (!(expression)) { ::Anito3D::Test::ReportFailure(__FILE__, __LINE__, #expression); return; } } while (0)
+
+#define CHECK_NEAR(actual, expected, tolerance) \
+    do { \
+        const double actualValue_ = static_cast<double>(actual); \
+        const double expectedValue_ = static_cast<double>(expected); \
+        if (!(std::abs(actualValue_ - expectedValue_) <= static_cast<double>(tolerance))) \
+            ::Anito3D::Test::ReportNearFailure(__FILE__, __LINE__, #actual " == " #expected, actualValue_, expectedValue_, static_cast<double>(tolerance)); \
+    } while (0)
@@ -0,0 +1,36 @@
+#pragma once
+
+#include "MeshBounds.hpp"
+#include "MeshData.hpp"
+#include <cmath>
+
+// Procedural meshes shared by the mesh processing tests
+namespace Anito3D::Test {
+
+    // n x n quads on [0, size]^2 as one indexed range, two triangles per quad. bump displaces
+    // z with a smooth wave so simplification has curvature to preserve.
+    inline MeshData MakeGrid(int n, float size = 1.0f, float bump = 0.0f) {
+        MeshData meshData;
+        for (int y = 0; y <= n; ++y) {
+            for (int x = 0; x <= n; ++x) {
+                const float u = float(x) / n, v = float(y) / n;
+                const float z = bump * std::sin(u * 6.0f) * std::cos(v * 5.0f);
+                meshData.vertices.emplace_back(u * size, v * size, z);
+                meshData.normals.emplace_back(0.0f, 0.0f, 1.0f);
+                meshData.texCoords.emplace_back(u, v);
+            }
+        }
+        for (int y = 0; y < n; ++y) {
+            for (int x = 0; x < n; ++x) {
+                const uint32_t a = y * (n + 1) + x, b = a + 1, c = a + (n + 1), d = c + 1;
+                meshData.indices.insert(meshData.indices.end(), { a, b, d, a, d, c });
+            }
+        }
+        MeshData::SubMesh subMesh;
+        subMesh.indexCount = static_cast<uint32_t>(meshData.indices.size());
+        subMesh.vertexCount = static_cast<uint32_t>(meshData.vertices.size());
+        meshData.subMeshes.push_back(subMesh);
+        MeshBounds::Update(meshData);
+        return meshData;
+    }
+}
@@ -0,0 +1,159 @@
+#include "TestHarness.hpp"
+#include "Bvh.hpp"
+#include "MeshBounds.hpp"
+#include "ThreadPool.hpp"
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+using namespace Anito3D;
+
+namespace {
+    // Unit UV sphere with a bumpy radius, so leaves overlap unevenly
+    MeshData MakeSphere(uint32_t segments, uint32_t rings) {
+        MeshData meshData;
+        for (uint32_t ring = 0; ring <= rings; ++ring) {
+            const float theta = 3.14159265f * float(ring) / float(rings);
+            for (uint32_t segment = 0; segment <= segments; ++segment) {
+                const float phi = 6.28318531f * float(segment) / float(segments);
+                const glm::vec3 normal(std::sin(theta) * std::cos(phi), std::cos(theta), std::sin(theta) * std::sin(phi));
+                meshData.vertices.push_back(normal * (1.0f + 0.1f * std::sin(phi * 5.0f) * std::sin(theta * 3.0f)));
+                meshData.normals.push_back(normal);
+                meshData.texCoords.emplace_back(float(segment) / segments, float(ring) / rings);
+            }
+        }
+        for (uint32_t ring = 0; ring < rings; ++ring) {
+            for (uint32_t segment = 0; segment < segments; ++segment) {
+                const uint32_t a = ring * (segments + 1) + segment, b = a + 1, c = a + segments + 1, d = c + 1;
+                meshData.indices.insert(meshData.indices.end(), { a, c, b, b, c, d });
+            }
+        }
+        MeshData::SubMesh subMesh;
+        subMesh.indexCount = static_cast<uint32_t>(meshData.indices.size());
+        subMesh.vertexCount = static_cast<uint32_t>(meshData.vertices.size());
+        meshData.subMeshes.push_back(subMesh);
+
+        // A second, overlapping instance of the same range
+        subMesh.transform = glm::mat4(1.0f);
+        subMesh.transform[3] = glm::vec4(1.5f, 0.2f, 0.1f, 1.0f);
+        meshData.subMeshes.push_back(subMesh);
+        MeshBounds::Update(meshData);
+        return meshData;
+    }
+
+    RayHit IntersectBruteForce(const Bvh& bvh, const Ray& ray) {
+        RayHit hit;
+        for (uint32_t t = 0; t < bvh.GetTriangles().size(); ++t) Bvh::IntersectTriangle(ray, bvh.GetTriangles()[t], t, hit);
+        return hit;
+    }
+
+    Ray MakeRay(std::mt19937& rng, int i) {
+        std::uniform_real_distribution<float> coordinate(-3.0f, 3.0f);
+        Ray ray;
+        ray.origin = glm::vec3(coordinate(rng), coordinate(rng), coordinate(rng));
+        ray.direction = glm::normalize(glm::vec3(coordinate(rng), coordinate(rng), coordinate(rng)));
+        if (i % 2 == 0) { // Aim near the spheres so both hits and misses are common
+            const glm::vec3 target(coordinate(rng) * 0.5f, coordinate(rng) * 0.3f, coordinate(rng) * 0.3f);
+            if (target != ray.origin) ray.direction = glm::normalize(target - ray.origin);
+        }
+        if (i % 3 == 0) ray.direction = glm::vec3(0.0f, 0.0f, ray.direction.z > 0.0f ? 1.0f : -1.0f); // Zero components
+        if (i % 5 == 0) ray.tMax = 1.0f;
+        if (i % 7 == 0) ray.tMin = 0.5f;
+        return ray;
+    }
+}
+
+ANITO3D_TEST(BuildKeepsEveryTriangle) {
+    const MeshData meshData = MakeSphere(48, 24);
+    ThreadPool pool(3);
+    BvhBuildStatistics statistics;
+    const Bvh bvh = Bvh::Build(meshData, {}, &pool, &statistics);
+    CHECK(bvh.GetTriangles().size() == 2 * meshData.subMeshes[0].indexCount / 3);
+    CHECK(statistics.triangles == bvh.GetTriangles().size());
+    CHECK(statistics.nodes == bvh.GetNodes().size());
+
+    // Leaves partition the triangles and every node box holds its children
+    std::vector<uint32_t> covered(bvh.GetTriangles().size(), 0);
+    for (const BvhNode& node : bvh.GetNodes()) {
+        if (node.IsLeaf()) {
+            for (uint32_t t = node.index; t < node.index + node.count; ++t) ++covered[t];
+            continue;
+        }
+        for (uint32_t child = node.index; child < node.index + 2; ++child) {
+            const BvhNode& inner = bvh.GetNodes()[child];
+            for (int axis = 0; axis < 3; ++axis) {
+                CHECK(node.boundsMin[axis] <= inner.boundsMin[axis]);
+                CHECK(inner.boundsMax[axis] <= node.boundsMax[axis]);
+            }
+        }
+    }
+    CHECK(std::all_of(covered.begin(), covered.end(), [](uint32_t count) { return count == 1; }));
+}
+
+ANITO3D_TEST(ClosestHitMatchesBruteForce) {
+    const MeshData meshData = MakeSphere(48, 24);
+    const Bvh serial = Bvh::Build(meshData);
+    ThreadPool pool(3);
+    const Bvh parallel = Bvh::Build(meshData, {}, &pool);
+    const Bvh4 bvh4 = Bvh4::Collapse(serial);
+    const Bvh8 bvh8 = Bvh8::Collapse(serial);
+
+    std::mt19937 rng(1);
+    int hits = 0;
+    for (int i = 0; i < 3000; ++i) {
+        const Ray ray = MakeRay(rng, i);
+        const RayHit expected = IntersectBruteForce(serial, ray);
+        hits += expected.IsHit() ? 1 : 0;
+
+        RayHit binary, wide4, wide8;
+        CHECK(serial.Intersect(ray, binary) == expected.IsHit());
+        CHECK(binary.t == expected.t);
+        CHECK(bvh4.Intersect(ray, wide4) == expected.IsHit());
+        CHECK(wide4.t == expected.t);
+        CHECK(bvh8.Intersect(ray, wide8) == expected.IsHit());
+        CHECK(wide8.t == expected.t);
+        CHECK(serial.Occluded(ray) == expected.IsHit());
+
+        RayHit pooled;
+        CHECK(parallel.Intersect(ray, pooled) == expected.IsHit());
+        CHECK(pooled.t == expected.t);
+    }
+    // Both outcomes are exercised
+    CHECK(hits > 300 && hits < 2700);
+}
+
+ANITO3D_TEST(PacketMatchesSingleRays) {
+    const MeshData meshData = MakeSphere(32, 16);
+    const Bvh bvh = Bvh::Build(meshData);
+    std::mt19937 rng(2);
+    for (int i = 0; i < 1000; ++i) {
+        RayPacket packet;
+        Ray rays[RayPacket::Size];
+        for (uint32_t lane = 0; lane < RayPacket::Size; ++lane) {
+            rays[lane] = MakeRay(rng, i + int(lane));
+            if (lane > 0 && i % 2 == 0) rays[lane].origin = rays[0].origin; // Coherent packets share an origin
+            packet.Set(lane, rays[lane]);
+        }
+        if (i % 4 == 0) packet.Disable(2);
+
+        RayHit hits[RayPacket::Size];
+        bvh.Intersect(packet, hits);
+        for (uint32_t lane = 0; lane < RayPacket::Size; ++lane) {
+            const RayHit expected = packet.IsActive(lane) ? IntersectBruteForce(bvh, rays[lane]) : RayHit{};
+            CHECK(hits[lane].t == expected.t);
+            CHECK(hits[lane].triangle == expected.triangle);
+        }
+    }
+}
+
+ANITO3D_TEST(EmptyMeshNeverHits) {
+    const MeshData empty;
+    const Bvh bvh = Bvh::Build(empty);
+    CHECK(bvh.IsEmpty());
+    RayHit hit;
+    CHECK(!bvh.Intersect(Ray{}, hit));
+    CHECK(!bvh.Occluded(Ray{}));
+    CHECK(!Bvh4::Collapse(bvh).Intersect(Ray{}, hit));
+    CHECK(!hit.IsHit());
+}
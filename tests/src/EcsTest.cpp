@@ -0,0 +1,147 @@
+#include "TestHarness.hpp"
+#include "SystemScheduler.hpp"
+#include "ThreadPool.hpp"
+#include "World.hpp"
+#include <string>
+#include <vector>
+
+using namespace Anito3D;
+
+namespace {
+    struct Position {
+        int value;
+    };
+
+    struct Name {
+        std::string text;
+    };
+
+    // Counts live instances so moves between archetypes can be checked for leaks and double frees
+    struct Tracked {
+        static inline int live = 0;
+        int value = 0;
+
+        explicit Tracked(int value) : value(value) { ++live; }
+        Tracked(Tracked&& other) noexcept : value(other.value) { ++live; }
+        Tracked& operator=(Tracked&& other) noexcept { value = other.value; return *this; }
+        ~Tracked() { --live; }
+    };
+}
+
+ANITO3D_TEST(AddAndRemoveMoveBetweenArchetypes) {
+    World world;
+    std::vector<EntityId> entities;
+    constexpr int Count = 5000; // Several chunks per archetype
+    for (int i = 0; i < Count; ++i) entities.push_back(world.Create(Position{ i }));
+    for (int i = 0; i < Count; i += 3) world.Add(entities[i], Name{ std::to_string(i) });
+    for (int i = 0; i < Count; i += 7) world.Destroy(entities[i]);
+    for (int i = 0; i < Count; i += 6) world.Remove<Name>(entities[i]);
+
+    size_t alive = 0, expectNamed = 0;
+    for (int i = 0; i < Count; ++i) {
+        const bool expectAlive = i % 7 != 0;
+        CHECK(world.IsAlive(entities[i]) == expectAlive);
+        if (!expectAlive) {
+            CHECK(world.Get<Position>(entities[i]) == nullptr);
+            continue;
+        }
+        ++alive;
+        const Position* position = world.Get<Position>(entities[i]);
+        REQUIRE(position);
+        CHECK(position->value == i);
+        const bool expectName = i % 3 == 0 && i % 6 != 0;
+        CHECK(world.Has<Name>(entities[i]) == expectName);
+        expectNamed += expectName ? 1 : 0;
+        if (expectName) CHECK(world.Get<Name>(entities[i])->text == std::to_string(i));
+    }
+    CHECK(world.GetEntityCount() == alive);
+
+    size_t visited = 0;
+    world.ForEach<Position>([&](Position&) { ++visited; });
+    CHECK(visited == alive);
+
+    // Chunk entity arrays agree with the components next to them
+    size_t named = 0;
+    world.ForEachChunk<const Position, const Name>([&](uint32_t count, const EntityId* ids, const Position* positions, const Name* names) {
+        for (uint32_t i = 0; i < count; ++i) {
+            CHECK(world.Get<Position>(ids[i])->value == positions[i].value);
+            CHECK(names[i].text == std::to_string(positions[i].value));
+            ++named;
+        }
+    });
+    CHECK(named == expectNamed);
+}
+
+ANITO3D_TEST(AddReplacesAnExistingComponent) {
+    World world;
+    const EntityId entity = world.Create(Position{ 1 }, Name{ "first" });
+    const size_t archetypes = world.GetArchetypes().size();
+    world.Add(entity, Name{ "second" });
+    CHECK(world.GetArchetypes().size() == archetypes);
+    CHECK(world.Get<Name>(entity)->text == "second");
+    CHECK(world.Get<Position>(entity)->value == 1);
+
+    // Removing a missing component is a no-op
+    world.Remove<Tracked>(entity);
+    CHECK(world.IsAlive(entity));
+    CHECK(world.Get<Name>(entity)->text == "second");
+}
+
+ANITO3D_TEST(DestroyedIdsAreNotRevived) {
+    World world;
+    const EntityId first = world.Create(Position{ 1 });
+    world.Destroy(first);
+    CHECK(!world.IsAlive(first));
+    world.Destroy(first); // Twice is harmless
+
+    const EntityId second = world.Create(Position{ 2 });
+    CHECK(second.index == first.index);
+    CHECK(second.generation != first.generation);
+    CHECK(!world.IsAlive(first));
+    CHECK(world.Get<Position>(first) == nullptr);
+    world.Add(first, Name{ "stale" });
+    CHECK(!world.Has<Name>(second));
+    CHECK(world.Get<Position>(second)->value == 2);
+}
+
+ANITO3D_TEST(MovesNeitherLeakNorDoubleDestroy) {
+    Tracked::live = 0;
+    {
+        World world;
+        std::vector<EntityId> entities;
+        for (int i = 0; i < 3000; ++i) entities.push_back(world.Create(Tracked(i)));
+        CHECK(Tracked::live == 3000);
+        for (int i = 0; i < 3000; i += 2) world.Add(entities[i], Position{ i });
+        CHECK(Tracked::live == 3000);
+        for (int i = 0; i < 3000; i += 4) world.Remove<Position>(entities[i]);
+        for (int i = 0; i < 3000; i += 5) world.Destroy(entities[i]);
+        CHECK(Tracked::live == 3000 - 600);
+        for (int i = 1; i < 3000; i += 5) world.Remove<Tracked>(entities[i]);
+        CHECK(Tracked::live == 3000 - 1200);
+
+        for (int i = 0; i < 3000; ++i) {
+            if (const Tracked* tracked = world.Get<Tracked>(entities[i])) CHECK(tracked->value == i);
+        }
+    }
+    CHECK(Tracked::live == 0);
+}
+
+ANITO3D_TEST(ConstQueriesMatchTheSameComponents) {
+    CHECK(ComponentRegistry::GetId<const Position>() == ComponentRegistry::GetId<Position>());
+
+    World world;
+    std::vector<EntityId> entities;
+    for (int i = 0; i < 2000; ++i) {
+        entities.push_back(i % 2 ? world.Create(Position{ i }, Name{}) : world.Create(Position{ i }));
+    }
+
+    // Reads through const, writes the other component
+    SystemScheduler scheduler;
+    scheduler.Add<const Position, Name>("name", [](float, uint32_t count, const Position* positions, Name* names) {
+        for (uint32_t i = 0; i < count; ++i) names[i].text = std::to_string(positions[i].value);
+    });
+    ThreadPool pool(2);
+    scheduler.Run(world, 0.0f, &pool);
+
+    for (int i = 1; i < 2000; i += 2) CHECK(world.Get<Name>(entities[i])->text == std::to_string(i));
+}
@@ -0,0 +1,118 @@
+#include "TestHarness.hpp"
+#include "FrustumCuller.hpp"
+#include "ThreadPool.hpp"
+#include <glm/gtc/matrix_transform.hpp>
+#include <algorithm>
+#include <random>
+#include <vector>
+
+using namespace Anito3D;
+
+namespace {
+    const CullPath Paths[] = { CullPath::Scalar, CullPath::Sse2, CullPath::Avx2 };
+
+    BoundingBoxArray MakeBoxes(size_t count, std::mt19937& rng) {
+        std::uniform_real_distribution<float> position(-50.0f, 50.0f);
+        std::uniform_real_distribution<float> size(0.0f, 3.0f);
+        BoundingBoxArray boxes;
+        boxes.Reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            const glm::vec3 center(position(rng), position(rng), position(rng));
+            const glm::vec3 extent(size(rng), size(rng), size(rng));
+            boxes.Add(center - extent, center + extent);
+        }
+        return boxes;
+    }
+
+    Frustum MakeFrustum(std::mt19937& rng) {
+        std::uniform_real_distribution<float> position(-50.0f, 50.0f);
+        const glm::vec3 eye(position(rng), position(rng), position(rng));
+        return Frustum::FromMatrix(glm::perspective(1.0f, 1.5f, 0.1f, 60.0f) * glm::lookAt(eye, glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f)));
+    }
+
+    // Box outside a plane when even its corner furthest along the normal is behind it
+    std::vector<uint32_t> CullReference(const Frustum& frustum, const BoundingBoxArray& boxes) {
+        std::vector<uint32_t> visible;
+        for (size_t i = 0; i < boxes.Size(); ++i) {
+            const glm::vec3 center(boxes.centerX[i], boxes.centerY[i], boxes.centerZ[i]);
+            const glm::vec3 extent(boxes.extentX[i], boxes.extentY[i], boxes.extentZ[i]);
+            bool inside = true;
+            for (const glm::vec4& plane : frustum.planes) {
+                const glm::vec3 normal(plane);
+                if (glm::dot(normal, center) + plane.w + glm::dot(glm::abs(normal), extent) < 0.0f) inside = false;
+            }
+            if (inside) visible.push_back(static_cast<uint32_t>(i));
+        }
+        return visible;
+    }
+
+    bool SameVisible(const std::vector<uint32_t>& expected, const std::vector<uint32_t>& visible, size_t count) {
+        return count == expected.size() && visible.size() >= count && std::equal(expected.begin(), expected.end(), visible.begin());
+    }
+}
+
+ANITO3D_TEST(ScalarMatchesReference) {
+    std::mt19937 rng(5);
+    for (int iteration = 0; iteration < 20; ++iteration) {
+        const BoundingBoxArray boxes = MakeBoxes(rng() % 5000, rng);
+        const Frustum frustum = MakeFrustum(rng);
+        std::vector<uint32_t> visible;
+        const size_t count = FrustumCuller::Cull(frustum, boxes, visible, CullPath::Scalar);
+        CHECK(SameVisible(CullReference(frustum, boxes), visible, count));
+    }
+}
+
+ANITO3D_TEST(SimdPathsMatchScalar) {
+    std::mt19937 rng(7);
+    ThreadPool pool(3);
+    // Every tail length of the 4- and 8-wide loops, then sizes large enough to split for the pool
+    std::vector<size_t> sizes;
+    for (size_t size = 0; size <= 17; ++size) sizes.push_back(size);
+    for (int i = 0; i < 8; ++i) sizes.push_back(20000 + rng() % 50000);
+
+    for (size_t size : sizes) {
+        const BoundingBoxArray boxes = MakeBoxes(size, rng);
+        const Frustum frustum = MakeFrustum(rng);
+        std::vector<uint32_t> reference;
+        const size_t referenceCount = FrustumCuller::Cull(frustum, boxes, reference, CullPath::Scalar);
+        reference.resize(referenceCount);
+
+        for (CullPath path : Paths) {
+            if (!FrustumCuller::IsSupported(path)) continue;
+            for (ThreadPool* threadPool : { static_cast<ThreadPool*>(nullptr), &pool }) {
+                std::vector<uint32_t> visible;
+                const size_t count = FrustumCuller::Cull(frustum, boxes, visible, path, threadPool);
+                CHECK(SameVisible(reference, visible, count));
+            }
+        }
+    }
+}
+
+ANITO3D_TEST(VisibleListIsReused) {
+    std::mt19937 rng(11);
+    const BoundingBoxArray boxes = MakeBoxes(1000, rng);
+    const Frustum frustum = MakeFrustum(rng);
+    const std::vector<uint32_t> expected = CullReference(frustum, boxes);
+
+    // Stale entries beyond count are allowed, stale entries below it are not
+    std::vector<uint32_t> visible(4000, 0xDEADBEEFu);
+    const size_t count = FrustumCuller::Cull(frustum, boxes, visible, FrustumCuller::GetBestPath());
+    CHECK(SameVisible(expected, visible, count));
+    CHECK(visible.size() == 4000);
+}
+
+ANITO3D_TEST(BoxesOnEitherSideOfAPlane) {
+    const Frustum frustum = Frustum::FromMatrix(glm::ortho(-1.0f, 1.0f, -1.0f, 1.0f, -1.0f, 1.0f));
+    BoundingBoxArray boxes;
+    boxes.Add(glm::vec3(-0.5f), glm::vec3(0.5f));                      // Inside
+    boxes.Add(glm::vec3(0.9f, 0.0f, 0.0f), glm::vec3(1.5f, 0.1f, 0.1f)); // Straddles the right plane
+    boxes.Add(glm::vec3(1.5f, 0.0f, 0.0f), glm::vec3(2.0f, 0.1f, 0.1f)); // Beyond the right plane
+    boxes.Add(glm::vec3(-3.0f), glm::vec3(3.0f));                      // Contains the frustum
+    boxes.Add(glm::vec3(0.0f, -2.0f, 0.0f), glm::vec3(0.1f, -1.5f, 0.1f)); // Below
+    for (CullPath path : Paths) {
+        if (!FrustumCuller::IsSupported(path)) continue;
+        std::vector<uint32_t> visible;
+        const size_t count = FrustumCuller::Cull(frustum, boxes, visible, path);
+        CHECK(SameVisible({ 0, 1, 3 }, visible, count));
+    }
+}
@@ -0,0 +1,243 @@
+#include "TestHarness.hpp"
+#include "MockVulkan.hpp"
+#include "GpuMemoryAllocator.hpp"
+#include "GpuMesh.hpp"
+#include "StagingRing.hpp"
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <random>
+#include <vector>
+
+using namespace Anito3D;
+using Anito3D::Test::GetMockVulkan;
+
+namespace {
+    constexpr VkDeviceSize SmallBlockSize = 1024 * 1024;
+
+    void InitAllocator(GpuMemoryAllocator& allocator, VkDeviceSize blockSize = SmallBlockSize) {
+        allocator.init(Test::GetMockPhysicalDevice(), Test::GetMockDevice(), blockSize);
+    }
+
+    std::vector<uint8_t> RandomBytes(std::mt19937& rng, size_t count) {
+        std::vector<uint8_t> bytes(count);
+        for (uint8_t& byte : bytes) byte = static_cast<uint8_t>(rng());
+        return bytes;
+    }
+
+    bool BufferHolds(const GpuBuffer& buffer, const std::vector<uint8_t>& expected, VkDeviceSize offset = 0) {
+        return std::memcmp(Test::GetMockBufferData(buffer.buffer) + offset, expected.data(), expected.size()) == 0;
+    }
+}
+
+ANITO3D_TEST(TlsfAllocationsAreAlignedAndDisjoint) {
+    TlsfHeap heap;
+    const VkDeviceSize heapSize = 16 * 1024 * 1024;
+    heap.init(heapSize);
+
+    std::mt19937_64 rng(1);
+    std::map<VkDeviceSize, VkDeviceSize> live; // Offset to size
+    uint32_t failures = 0;
+    for (int i = 0; i < 100000; ++i) {
+        if (live.empty() || rng() % 3 != 0) {
+            const VkDeviceSize size = 1 + rng() % (rng() % 4 == 0 ? 1000000 : 5000);
+            const VkDeviceSize alignment = VkDeviceSize(1) << (rng() % 9);
+            const VkDeviceSize offset = heap.allocate(size, alignment);
+            if (offset == TlsfHeap::InvalidOffset) {
+                ++failures;
+                continue;
+            }
+            CHECK(offset % alignment == 0);
+            CHECK(offset + size <= heapSize);
+            const auto next = live.lower_bound(offset);
+            if (next != live.end()) CHECK(offset + size <= next->first);
+            if (next != live.begin()) CHECK(std::prev(next)->first + std::prev(next)->second <= offset);
+            live[offset] = size;
+        }
+        else {
+            auto victim = live.begin();
+            std::advance(victim, rng() % live.size());
+            heap.free(victim->first);
+            live.erase(victim);
+        }
+    }
+    CHECK(heap.getAllocationCount() == live.size());
+    CHECK(failures > 0); // The heap was driven full
+
+    // Freeing everything merges back into a single region
+    for (const auto& [offset, size] : live) heap.free(offset);
+    CHECK(heap.isEmpty());
+    CHECK(heap.getUsedBytes() == 0);
+    CHECK(heap.getFreeRegionCount() == 1);
+    CHECK(heap.getLargestFreeRegion() == heapSize);
+}
+
+ANITO3D_TEST(TlsfFreeMergesNeighbours) {
+    TlsfHeap heap;
+    heap.init(4096);
+    VkDeviceSize offsets[4];
+    for (VkDeviceSize& offset : offsets) offset = heap.allocate(1024, 16);
+    CHECK(offsets[0] == 0 && offsets[1] == 1024 && offsets[2] == 2048 && offsets[3] == 3072);
+    CHECK(heap.getFreeRegionCount() == 0);
+    CHECK(heap.allocate(1, 1) == TlsfHeap::InvalidOffset);
+
+    heap.free(offsets[0]);
+    heap.free(offsets[2]);
+    CHECK(heap.getFreeRegionCount() == 2);
+    CHECK(heap.getLargestFreeRegion() == 1024);
+    CHECK(heap.allocate(2048, 16) == TlsfHeap::InvalidOffset);
+
+    // The middle one joins both neighbours
+    heap.free(offsets[1]);
+    CHECK(heap.getFreeRegionCount() == 1);
+    CHECK(heap.getLargestFreeRegion() == 3072);
+
+    // The merged region is reused exactly, without a tail
+    CHECK(heap.allocate(3072, 256) == 0);
+    CHECK(heap.getFreeRegionCount() == 0);
+    CHECK(heap.getUsedBytes() == 4096);
+
+    heap.free(0);
+    heap.free(offsets[3]);
+    CHECK(heap.getFreeRegionCount() == 1);
+    CHECK(heap.getLargestFreeRegion() == 4096);
+}
+
+ANITO3D_TEST(AllocatorSharesBlocks) {
+    const int blocksBefore = GetMockVulkan().liveMemoryBlocks;
+    GpuMemoryAllocator allocator;
+    InitAllocator(allocator);
+
+    std::mt19937 rng(3);
+    std::vector<GpuBuffer> buffers(2000);
+    for (GpuBuffer& buffer : buffers) {
+        CHECK(allocator.createBuffer(1000 + rng() % 20000, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, 0, buffer));
+        CHECK(buffer.allocation.offset % 256 == 0);
+    }
+    GpuBuffer large;
+    CHECK(allocator.createBuffer(3 * SmallBlockSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT, 0, large));
+    CHECK(large.allocation.mapped != nullptr);
+
+    GpuMemoryStats stats = allocator.getStats();
+    CHECK(stats.allocationCount == buffers.size() + 1);
+    CHECK(stats.dedicatedBlockCount == 1);
+    CHECK(stats.blockCount < 40); // About 22 MiB of buffers in 1 MiB blocks
+    CHECK(static_cast<int>(stats.blockCount) == GetMockVulkan().liveMemoryBlocks - blocksBefore);
+
+    // Buffers sharing a block never overlap
+    std::vector<std::pair<VkDeviceMemory, VkDeviceSize>> ranges;
+    for (const GpuBuffer& buffer : buffers) ranges.emplace_back(buffer.allocation.memory, buffer.allocation.offset);
+    std::sort(ranges.begin(), ranges.end());
+    for (size_t i = 1; i < ranges.size(); ++i) {
+        if (ranges[i].first != ranges[i - 1].first) continue;
+        const auto previous = std::find_if(buffers.begin(), buffers.end(), [&](const GpuBuffer& buffer) {
+            return buffer.allocation.memory == ranges[i - 1].first && buffer.allocation.offset == ranges[i - 1].second;
+        });
+        CHECK(ranges[i - 1].second + previous->allocation.size <= ranges[i].second);
+    }
+
+    for (size_t i = 0; i < buffers.size(); i += 2) allocator.destroyBuffer(buffers[i]);
+    stats = allocator.getStats();
+    CHECK(stats.allocationCount == buffers.size() / 2 + 1);
+    CHECK(stats.fragmentation > 0.0);
+
+    for (GpuBuffer& buffer : buffers) allocator.destroyBuffer(buffer);
+    allocator.destroyBuffer(large);
+    stats = allocator.getStats();
+    CHECK(stats.allocationCount == 0);
+    CHECK(stats.usedBytes == 0);
+    CHECK(stats.blockCount <= 1); // One empty block is kept for reuse
+
+    allocator.cleanup();
+    CHECK(GetMockVulkan().liveMemoryBlocks == blocksBefore);
+}
+
+ANITO3D_TEST(StagingRingWrapsWithoutCorruptingData) {
+    GpuMemoryAllocator allocator;
+    InitAllocator(allocator);
+    StagingRing ring;
+    CHECK(ring.init(allocator, Test::GetMockQueue(), 0, 4096));
+
+    // Every upload is larger than a ring quarter and most are larger than the ring
+    std::mt19937 rng(5);
+    std::vector<GpuBuffer> buffers(50);
+    std::vector<std::vector<uint8_t>> expected(buffers.size());
+    for (size_t i = 0; i < buffers.size(); ++i) {
+        const size_t size = 1025 + rng() % 20000;
+        CHECK(allocator.createBuffer(size, VK_BUFFER_USAGE_TRANSFER_DST_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, 0, buffers[i]));
+        expected[i] = RandomBytes(rng, size);
+        const size_t half = size / 2;
+        CHECK(ring.upload(buffers[i].buffer, 0, expected[i].data(), half));
+        CHECK(ring.upload(buffers[i].buffer, half, expected[i].data() + half, size - half));
+    }
+    CHECK(ring.finish());
+
+    for (size_t i = 0; i < buffers.size(); ++i) CHECK(BufferHolds(buffers[i], expected[i]));
+    const StagingStats& stats = ring.getStats();
+    CHECK(stats.uploads == 2 * buffers.size());
+    CHECK(stats.stalls > 0);
+    CHECK(stats.submits > buffers.size());
+
+    ring.cleanup();
+    for (GpuBuffer& buffer : buffers) allocator.destroyBuffer(buffer);
+    allocator.cleanup();
+}
+
+ANITO3D_TEST(StagingRingGroupsCopiesByDestination) {
+    GpuMemoryAllocator allocator;
+    InitAllocator(allocator);
+    StagingRing ring;
+    CHECK(ring.init(allocator, Test::GetMockQueue(), 0, 1024 * 1024));
+
+    std::mt19937 rng(7);
+    const std::vector<uint8_t> bytes = RandomBytes(rng, 1000);
+    std::vector<GpuBuffer> buffers(20);
+    for (GpuBuffer& buffer : buffers) {
+        CHECK(allocator.createBuffer(bytes.size(), VK_BUFFER_USAGE_TRANSFER_DST_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, 0, buffer));
+        CHECK(ring.upload(buffer.buffer, 0, bytes.data(), 496));
+        CHECK(ring.upload(buffer.buffer, 496, bytes.data() + 496, bytes.size() - 496));
+    }
+    CHECK(ring.finish());
+
+    // Back-to-back streams of one buffer become one region of one copy command
+    const StagingStats& stats = ring.getStats();
+    CHECK(stats.submits == 1);
+    CHECK(stats.copyCommands == buffers.size());
+    CHECK(stats.copyRegions == buffers.size());
+    for (const GpuBuffer& buffer : buffers) CHECK(BufferHolds(buffer, bytes));
+
+    ring.cleanup();
+    for (GpuBuffer& buffer : buffers) allocator.destroyBuffer(buffer);
+    allocator.cleanup();
+}
+
+ANITO3D_TEST(GpuMeshUploadFailureFreesBuffer) {
+    GpuMemoryAllocator allocator;
+    InitAllocator(allocator);
+    StagingRing ring;
+    CHECK(ring.init(allocator, Test::GetMockQueue(), 0, 4096));
+    const int buffersBefore = GetMockVulkan().liveBuffers;
+
+    MeshData meshData;
+    for (int i = 0; i < 2000; ++i) meshData.vertices.emplace_back(float(i), float(i) * 0.5f, -float(i));
+    for (uint32_t i = 0; i + 2 < 2000; ++i) meshData.indices.insert(meshData.indices.end(), { i, i + 1, i + 2 });
+
+    // The ring fills up and its first submit fails
+    GpuMesh mesh;
+    GetMockVulkan().failSubmits = true;
+    CHECK(!GpuMesh::Upload(meshData, allocator, ring, mesh));
+    GetMockVulkan().failSubmits = false;
+    CHECK(mesh.buffer.buffer == VK_NULL_HANDLE);
+    CHECK(GetMockVulkan().liveBuffers == buffersBefore);
+    CHECK(allocator.getStats().allocationCount == 1); // Only the ring
+
+    // The ring is still usable afterwards
+    CHECK(GpuMesh::Upload(meshData, allocator, ring, mesh));
+    CHECK(ring.finish());
+    CHECK(std::memcmp(Test::GetMockBufferData(mesh.buffer.buffer) + mesh.positions.offset, meshData.vertices.data(), mesh.positions.size) == 0);
+    CHECK(std::memcmp(Test::GetMockBufferData(mesh.buffer.buffer) + mesh.indices.offset, meshData.indices.data(), mesh.indices.size) == 0);
+
+    GpuMesh::Destroy(allocator, mesh);
+    ring.cleanup();
+    allocator.cleanup();
+}
@@ -0,0 +1,246 @@
+#include "TestHarness.hpp"
+#include "MeshCache.hpp"
+#include "MeshEntity.hpp"
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <thread>
+#include <vector>
+
+using namespace Anito3D;
+
+namespace {
+    // Fresh cache directory and a stand-in source file; the cache never parses the source
+    struct CacheFixture {
+        std::filesystem::path root;
+        std::string sourcePath;
+
+        CacheFixture() {
+            root = std::filesystem::temp_directory_path() / ("Anito3DMeshCacheTest-" + std::to_string(std::random_device{}()));
+            std::filesystem::create_directories(root);
+            sourcePath = (root / "model.obj").string();
+            WriteSource("o model\nv 0 0 0\n");
+        }
+
+        ~CacheFixture() {
+            std::error_code ec;
+            std::filesystem::remove_all(root, ec);
+        }
+
+        void WriteSource(const std::string& content) const {
+            std::ofstream(sourcePath, std::ios::binary | std::ios::trunc) << content;
+        }
+
+        std::string GetCacheDirectory() const { return (root / "cache").string(); }
+    };
+
+    // Two submeshes (one 32-bit, one narrowed to 16-bit) under a two-node hierarchy
+    MeshData MakeMesh() {
+        MeshData meshData;
+        for (int i = 0; i < 8; ++i) {
+            meshData.vertices.emplace_back(float(i), float(i * 2), float(-i));
+            meshData.normals.emplace_back(0.0f, 1.0f, 0.0f);
+            meshData.texCoords.emplace_back(i * 0.125f, 1.0f - i * 0.125f);
+        }
+        meshData.indices = { 0, 1, 2, 2, 1, 3 };
+        meshData.indices16 = { 0, 1, 2, 1, 3, 2 };
+        meshData.materials.push_back({ glm::vec3(0.5f, 0.25f, 1.0f), 0.75f, 0.125f });
+
+        meshData.nodes.push_back({ glm::mat4(1.0f), MeshData::NoParent });
+        meshData.nodes.push_back({ glm::mat4(2.0f), 0 });
+
+        MeshData::SubMesh first;
+        first.indexCount = 6;
+        first.vertexCount = 4;
+        MeshData::SubMesh second;
+        second.indexCount = 6;
+        second.vertexOffset = 4;
+        second.vertexCount = 4;
+        second.indexType = MeshData::IndexType::Uint16;
+        second.node = 1;
+        meshData.subMeshes = { first, second };
+        return meshData;
+    }
+
+    template <typename A, typename B>
+    bool SameBytes(const A& a, const B& b) {
+        return a.size() == b.size() && (a.empty() || std::memcmp(a.data(), b.data(), a.size() * sizeof(a[0])) == 0);
+    }
+
+    bool SameMesh(const MeshDataView& a, const MeshDataView& b) {
+        return SameBytes(a.vertices, b.vertices) && SameBytes(a.normals, b.normals) && SameBytes(a.texCoords, b.texCoords)
+            && SameBytes(a.indices, b.indices) && SameBytes(a.indices16, b.indices16) && SameBytes(a.materials, b.materials)
+            && SameBytes(a.subMeshes, b.subMeshes) && SameBytes(a.nodes, b.nodes);
+    }
+}
+
+ANITO3D_TEST(StoreThenLoadRoundTrips) {
+    CacheFixture fixture;
+    MeshCache cache(fixture.GetCacheDirectory());
+    const MeshCacheKey key(0x1234u, 5u, 0xABCDull);
+    const MeshData source = MakeMesh();
+    REQUIRE(cache.Store(fixture.sourcePath, key, source));
+
+    MeshCacheStatus status = MeshCacheStatus::Missing;
+    std::unique_ptr<MappedMesh> mapped = cache.Map(fixture.sourcePath, key, MeshCache::Validation::ContentHash, &status);
+    REQUIRE(mapped);
+    CHECK(status == MeshCacheStatus::Valid);
+    CHECK(SameMesh(mapped->GetView(), source.GetView()));
+    CHECK(reinterpret_cast<uintptr_t>(mapped->GetView().vertices.data()) % MeshCache::SectionAlignment == 0);
+
+    MeshData loaded;
+    REQUIRE(cache.Load(fixture.sourcePath, key, loaded));
+    CHECK(SameMesh(loaded.GetView(), source.GetView()));
+    CHECK(cache.Validate(fixture.sourcePath, key) == MeshCacheStatus::Valid);
+}
+
+ANITO3D_TEST(MeshEntityReadsCacheHitsInPlace) {
+    CacheFixture fixture;
+    MeshCache cache(fixture.GetCacheDirectory());
+    MeshLoadOptions options;
+    options.cache = &cache;
+    const MeshData source = MakeMesh();
+    REQUIRE(cache.Store(fixture.sourcePath, MeshCacheKey(options.importFlags, options.process.flags, options.process.GetSettingsHash()), source));
+
+    // A hit is served from the mapping; nothing is copied until a MeshData is asked for
+    MeshEntity entity;
+    REQUIRE(entity.LoadMesh(fixture.sourcePath, options));
+    CHECK(entity.WasLoadedFromCache());
+    CHECK(entity.GetStorage() == MeshStorage::CacheMapped);
+    const MeshDataView view = entity.GetMeshView();
+    CHECK(SameMesh(view, source.GetView()));
+    CHECK(reinterpret_cast<uintptr_t>(view.vertices.data()) % MeshCache::SectionAlignment == 0);
+
+    const MeshData& copy = entity.GetMeshData();
+    CHECK(entity.GetStorage() == MeshStorage::CacheCopied);
+    CHECK(SameMesh(copy.GetView(), source.GetView()));
+    CHECK(copy.vertices.data() != view.vertices.data());
+    CHECK(entity.GetMeshView().vertices.data() == view.vertices.data()); // Views stay valid
+    CHECK(&entity.GetMeshData() == &copy);
+
+    // Opting into the copy does it during the load
+    options.copyFromCache = true;
+    MeshEntity copied;
+    REQUIRE(copied.LoadMesh(fixture.sourcePath, options));
+    CHECK(copied.GetStorage() == MeshStorage::CacheCopied);
+    CHECK(SameMesh(copied.GetMeshData().GetView(), source.GetView()));
+}
+
+ANITO3D_TEST(MissesReportTheReason) {
+    CacheFixture fixture;
+    MeshCache cache(fixture.GetCacheDirectory());
+    const MeshCacheKey key(0x1234u);
+    CHECK(cache.Validate(fixture.sourcePath, key) == MeshCacheStatus::Missing);
+    REQUIRE(cache.Store(fixture.sourcePath, key, MakeMesh()));
+
+    // Other flags map to another file name
+    CHECK(cache.Validate(fixture.sourcePath, MeshCacheKey(0x4321u)) == MeshCacheStatus::Missing);
+
+    fixture.WriteSource("o model\nv 0 0 0\nv 1 1 1\n");
+    CHECK(cache.Validate(fixture.sourcePath, key) == MeshCacheStatus::SourceChanged);
+    MeshData loaded;
+    CHECK(!cache.Load(fixture.sourcePath, key, loaded));
+
+    REQUIRE(cache.Store(fixture.sourcePath, key, MakeMesh()));
+    CHECK(cache.Validate(fixture.sourcePath, key) == MeshCacheStatus::Valid);
+    CHECK(cache.Invalidate(fixture.sourcePath, key));
+    CHECK(cache.Validate(fixture.sourcePath, key) == MeshCacheStatus::Missing);
+
+    std::error_code ec;
+    std::filesystem::remove(fixture.sourcePath, ec);
+    CHECK(cache.Validate(fixture.sourcePath, key) == MeshCacheStatus::SourceMissing);
+}
+
+ANITO3D_TEST(TruncatedFileIsCorrupt) {
+    CacheFixture fixture;
+    MeshCache cache(fixture.GetCacheDirectory());
+    const MeshCacheKey key(0x1234u);
+    REQUIRE(cache.Store(fixture.sourcePath, key, MakeMesh()));
+
+    const std::string cachePath = cache.GetCachePath(fixture.sourcePath, key);
+    std::filesystem::resize_file(cachePath, std::filesystem::file_size(cachePath) - 64);
+    CHECK(cache.Validate(fixture.sourcePath, key) == MeshCacheStatus::Corrupt);
+}
+
+ANITO3D_TEST(OutOfRangeSubMeshIsAMiss) {
+    CacheFixture fixture;
+    MeshCache cache(fixture.GetCacheDirectory());
+    const MeshCacheKey key(0x1234u);
+    MeshData loaded;
+
+    auto expectCorrupt = [&](const MeshData& meshData) {
+        REQUIRE(cache.Store(fixture.sourcePath, key, meshData));
+        CHECK(cache.Validate(fixture.sourcePath, key) == MeshCacheStatus::Corrupt);
+        CHECK(!cache.Map(fixture.sourcePath, key));
+        CHECK(!cache.Load(fixture.sourcePath, key, loaded));
+    };
+
+    MeshData badIndices = MakeMesh();
+    badIndices.subMeshes[0].firstIndex = 3; // 3 + 6 > 6 indices
+    expectCorrupt(badIndices);
+
+    MeshData badIndices16 = MakeMesh();
+    badIndices16.subMeshes[1].indexCount = 9;
+    expectCorrupt(badIndices16);
+
+    MeshData badVertices = MakeMesh();
+    badVertices.subMeshes[1].vertexCount = 5; // 4 + 5 > 8 vertices
+    expectCorrupt(badVertices);
+
+    MeshData overflow = MakeMesh();
+    overflow.subMeshes[0].firstIndex = 0xFFFFFFFFu; // Must not wrap around
+    expectCorrupt(overflow);
+
+    MeshData badNode = MakeMesh();
+    badNode.subMeshes[1].node = 2;
+    expectCorrupt(badNode);
+
+    MeshData badParent = MakeMesh();
+    badParent.nodes[0].parent = 1;
+    expectCorrupt(badParent);
+
+    MeshData badNormals = MakeMesh();
+    badNormals.normals.pop_back();
+    expectCorrupt(badNormals);
+}
+
+ANITO3D_TEST(ConcurrentStoresDoNotCollide) {
+    CacheFixture fixture;
+    MeshCache cache(fixture.GetCacheDirectory());
+    const MeshCacheKey key(0x1234u);
+    const MeshData source = MakeMesh();
+
+    // Writers sharing a temporary file would truncate each other's output and rename half-written caches
+    constexpr int ThreadCount = 8;
+    constexpr int Repeats = 32;
+    std::vector<int> stored(ThreadCount, 0);
+    std::vector<int> intact(ThreadCount, 0);
+    std::vector<std::thread> threads;
+    for (int i = 0; i < ThreadCount; ++i) {
+        threads.emplace_back([&, i]() {
+            for (int repeat = 0; repeat < Repeats; ++repeat) {
+                stored[i] += cache.Store(fixture.sourcePath, key, source) ? 1 : 0;
+                MeshData loaded;
+                intact[i] += cache.Load(fixture.sourcePath, key, loaded) && SameMesh(loaded.GetView(), source.GetView()) ? 1 : 0;
+            }
+        });
+    }
+    for (auto& thread : threads) thread.join();
+
+    for (int i = 0; i < ThreadCount; ++i) {
+        CHECK(stored[i] == Repeats);
+        CHECK(intact[i] == Repeats);
+    }
+    MeshData loaded;
+    REQUIRE(cache.Load(fixture.sourcePath, key, loaded));
+    CHECK(SameMesh(loaded.GetView(), source.GetView()));
+
+    // Every temporary file was renamed into place
+    size_t files = 0;
+    for (const auto& entry : std::filesystem::directory_iterator(fixture.GetCacheDirectory())) {
+        CHECK(entry.path().extension() == ".a3dmesh");
+        ++files;
+    }
+    CHECK(files == 1);
+}
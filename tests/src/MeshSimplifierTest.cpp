@@ -0,0 +1,90 @@
+#include "TestHarness.hpp"
+#include "TestMeshes.hpp"
+#include "MeshBounds.hpp"
+#include "MeshSimplifier.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+using namespace Anito3D;
+using Anito3D::Test::MakeGrid;
+
+namespace {
+    // Every base vertex collapsed onto some LOD vertex within the bound, so the nearest one is
+    // at least that close
+    float GetLargestVertexDistance(const MeshData& base, const MeshData& lod) {
+        float largest = 0.0f;
+        for (const glm::vec3& vertex : base.vertices) {
+            float nearest = std::numeric_limits<float>::max();
+            for (const glm::vec3& kept : lod.vertices) nearest = std::min(nearest, glm::length(vertex - kept));
+            largest = std::max(largest, nearest);
+        }
+        return largest;
+    }
+
+    bool Contains(const MeshData::Bounds& bounds, const glm::vec3& point) {
+        for (int axis = 0; axis < 3; ++axis) {
+            if (point[axis] < bounds.min[axis] || point[axis] > bounds.max[axis]) return false;
+        }
+        return true;
+    }
+}
+
+ANITO3D_TEST(FlatCollapsesStillReportDistance) {
+    // Coplanar collapses cost nothing in the quadric metric, yet vertices slide across the plane
+    const MeshData base = MakeGrid(32, 4.0f);
+    SimplifyOptions options;
+    options.targetRatio = 0.1f;
+    SimplifyStatistics statistics;
+    const MeshData simplified = MeshSimplifier::Simplify(base, options, nullptr, &statistics);
+
+    CHECK(statistics.trianglesAfter < statistics.trianglesBefore / 2);
+    CHECK(statistics.quadricError < 1e-4f);
+    const float moved = GetLargestVertexDistance(base, simplified);
+    CHECK(moved > 0.1f);
+    CHECK(statistics.error >= moved);
+}
+
+ANITO3D_TEST(LodErrorBoundsVertexDistance) {
+    const MeshData base = MakeGrid(48, 2.0f, 0.2f);
+    LodChainOptions options;
+    options.levels = { { 0.5f, 0.01f }, { 0.25f, 0.02f }, { 0.1f, 0.05f } };
+    const std::vector<MeshLod> chain = MeshSimplifier::BuildLodChain(base, options);
+    REQUIRE(!chain.empty());
+
+    // The level budgets limit the accumulated quadric error, the distance bound only adds up
+    const float extent = MeshSimplifier::GetExtent(base);
+    float previousError = 0.0f;
+    for (size_t level = 0; level < chain.size(); ++level) {
+        const MeshLod& lod = chain[level];
+        CHECK(lod.meshData.GetTriangleCount() < base.GetTriangleCount());
+        CHECK(lod.error >= GetLargestVertexDistance(base, lod.meshData));
+        CHECK(lod.error >= previousError);
+        CHECK(lod.quadricError <= options.levels[level].maxError * extent * 1.0001f);
+        previousError = lod.error;
+    }
+}
+
+ANITO3D_TEST(LodBoundsAreRecomputed) {
+    const MeshData base = MakeGrid(32, 3.0f, 0.5f);
+    LodChainOptions options;
+    options.levels = { { 0.5f, 0.05f }, { 0.1f, 0.2f } };
+    const std::vector<MeshLod> chain = MeshSimplifier::BuildLodChain(base, options);
+    REQUIRE(!chain.empty());
+
+    for (const MeshLod& lod : chain) {
+        const MeshData& meshData = lod.meshData;
+        REQUIRE(!meshData.subMeshes.empty());
+        // The scene box goes through the (identity) submesh transform, so compare loosely
+        const MeshData::Bounds expected = MeshBounds::Compute(meshData.vertices);
+        CHECK(glm::length(meshData.bounds.min - expected.min) < 1e-5f);
+        CHECK(glm::length(meshData.bounds.max - expected.max) < 1e-5f);
+        CHECK(meshData.bounds.radius > 0.0f);
+        for (const auto& subMesh : meshData.subMeshes) {
+            for (uint32_t i = 0; i < subMesh.vertexCount; ++i) {
+                CHECK(Contains(subMesh.bounds, meshData.vertices[subMesh.vertexOffset + i]));
+            }
+        }
+    }
+}
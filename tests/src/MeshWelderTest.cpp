@@ -0,0 +1,241 @@
+#include "TestHarness.hpp"
+#include "TestMeshes.hpp"
+#include "MeshProcessing.hpp"
+#include "MeshWelder.hpp"
+#include "ThreadPool.hpp"
+#include <array>
+#include <vector>
+
+using namespace Anito3D;
+
+namespace {
+    using Triangle = std::array<glm::vec3, 3>;
+
+    // Appends triangles as an unindexed range (every corner its own vertex), like a raw OBJ import
+    void AddUnindexedRange(MeshData& meshData, const std::vector<Triangle>& triangles, glm::vec2 uv = glm::vec2(0.0f)) {
+        MeshData::SubMesh subMesh;
+        subMesh.firstIndex = static_cast<uint32_t>(meshData.indices.size());
+        subMesh.vertexOffset = static_cast<uint32_t>(meshData.vertices.size());
+        for (const Triangle& triangle : triangles) {
+            for (const glm::vec3& corner : triangle) {
+                meshData.indices.push_back(subMesh.vertexCount++);
+                meshData.vertices.push_back(corner);
+                meshData.normals.emplace_back(0.0f, 0.0f, 1.0f);
+                meshData.texCoords.push_back(uv + glm::vec2(corner.x, corner.y));
+            }
+        }
+        subMesh.indexCount = static_cast<uint32_t>(triangles.size() * 3);
+        meshData.subMeshes.push_back(subMesh);
+    }
+
+    // Quad as two triangles sharing an edge: 6 corners, 4 distinct vertices
+    std::vector<Triangle> MakeQuad(glm::vec3 origin) {
+        const glm::vec3 a = origin, b = origin + glm::vec3(1, 0, 0), c = origin + glm::vec3(1, 1, 0), d = origin + glm::vec3(0, 1, 0);
+        return { Triangle{ a, b, c }, Triangle{ a, c, d } };
+    }
+
+    std::vector<Triangle> GetTriangles(const MeshData& meshData, const MeshData::SubMesh& subMesh) {
+        std::vector<Triangle> triangles;
+        for (uint32_t i = 0; i + 2 < subMesh.indexCount; i += 3) {
+            Triangle triangle;
+            for (uint32_t corner = 0; corner < 3; ++corner) {
+                triangle[corner] = meshData.vertices[subMesh.vertexOffset + meshData.GetIndex(subMesh, i + corner)];
+            }
+            triangles.push_back(triangle);
+        }
+        return triangles;
+    }
+
+    // n x n quads with unit spacing, one triangle list
+    std::vector<Triangle> MakeGridTriangles(int n) {
+        const MeshData grid = Test::MakeGrid(n, float(n));
+        return GetTriangles(grid, grid.subMeshes[0]);
+    }
+
+    bool IndicesInRange(const MeshData& meshData) {
+        for (const auto& subMesh : meshData.subMeshes) {
+            if (uint64_t(subMesh.vertexOffset) + subMesh.vertexCount > meshData.vertices.size()) return false;
+            for (uint32_t i = 0; i < subMesh.indexCount; ++i) {
+                if (meshData.GetIndex(subMesh, i) >= subMesh.vertexCount) return false;
+            }
+        }
+        return true;
+    }
+}
+
+ANITO3D_TEST(ExactDuplicatesMergeWithinEachRange) {
+    MeshData meshData;
+    AddUnindexedRange(meshData, MakeQuad(glm::vec3(0.0f)));
+    AddUnindexedRange(meshData, MakeQuad(glm::vec3(0.0f))); // Same positions, but its own range
+    const std::vector<Triangle> first = GetTriangles(meshData, meshData.subMeshes[0]);
+    const std::vector<Triangle> second = GetTriangles(meshData, meshData.subMeshes[1]);
+
+    const WeldStatistics statistics = MeshWelder::Weld(meshData);
+    CHECK(statistics.verticesBefore == 12);
+    CHECK(statistics.verticesAfter == 8);
+    REQUIRE(meshData.vertices.size() == 8);
+    CHECK(meshData.normals.size() == 8);
+    CHECK(meshData.texCoords.size() == 8);
+
+    CHECK(meshData.subMeshes[0].vertexOffset == 0 && meshData.subMeshes[0].vertexCount == 4);
+    CHECK(meshData.subMeshes[1].vertexOffset == 4 && meshData.subMeshes[1].vertexCount == 4);
+    CHECK(IndicesInRange(meshData));
+    CHECK(GetTriangles(meshData, meshData.subMeshes[0]) == first);
+    CHECK(GetTriangles(meshData, meshData.subMeshes[1]) == second);
+}
+
+ANITO3D_TEST(AttributeSeamsStaySeparate) {
+    MeshData meshData;
+    AddUnindexedRange(meshData, MakeQuad(glm::vec3(0.0f)));
+    // The shared corners of the second triangle get their own uvs: same positions, different vertices
+    meshData.texCoords[3] = glm::vec2(0.5f, 0.5f);
+    meshData.texCoords[4] = glm::vec2(0.25f, 0.5f);
+    const std::vector<Triangle> triangles = GetTriangles(meshData, meshData.subMeshes[0]);
+
+    MeshWelder::Weld(meshData);
+    CHECK(meshData.vertices.size() == 6);
+    CHECK(IndicesInRange(meshData));
+    CHECK(GetTriangles(meshData, meshData.subMeshes[0]) == triangles);
+}
+
+ANITO3D_TEST(EpsilonMergesNearDuplicates) {
+    MeshData meshData;
+    AddUnindexedRange(meshData, MakeQuad(glm::vec3(0.0f)));
+    for (size_t i = 0; i < meshData.vertices.size(); ++i) {
+        const float jitter = float(i + 1) * 1e-5f; // Every corner slightly different
+        meshData.vertices[i] += glm::vec3(jitter);
+        meshData.texCoords[i] += glm::vec2(jitter);
+    }
+
+    MeshData exact = meshData;
+    CHECK(MeshWelder::Weld(exact).verticesAfter == 6);
+
+    WeldOptions options;
+    options.positionEpsilon = 1e-3f;
+    options.normalEpsilon = 1e-3f;
+    options.texCoordEpsilon = 1e-3f;
+    CHECK(MeshWelder::Weld(meshData, options).verticesAfter == 4);
+    CHECK(IndicesInRange(meshData));
+}
+
+ANITO3D_TEST(EpsilonMergesAcrossCellBoundaries) {
+    // 0.0049 and 0.0051 are 2e-4 apart but round to different multiples of 0.01
+    MeshData meshData;
+    AddUnindexedRange(meshData, { Triangle{ glm::vec3(0.0049f, 0, 0), glm::vec3(1, 0, 0), glm::vec3(0, 1, 0) },
+        Triangle{ glm::vec3(0.0051f, 0, 0), glm::vec3(1, 0, 0), glm::vec3(0, 1, 0) } });
+    for (auto& uv : meshData.texCoords) uv = glm::vec2(0.0f);
+
+    WeldOptions options;
+    options.positionEpsilon = 0.01f;
+    CHECK(MeshWelder::Weld(meshData, options).verticesAfter == 3);
+    CHECK(meshData.vertices[0] == glm::vec3(0.0049f, 0, 0)); // The first one is kept
+    CHECK(IndicesInRange(meshData));
+}
+
+ANITO3D_TEST(EpsilonIsADistanceNotACell) {
+    WeldOptions options;
+    options.positionEpsilon = 0.01f;
+    options.texCoordEpsilon = 0.001f;
+
+    // Same cell on every axis, but 0.017 apart
+    MeshData sameCell;
+    AddUnindexedRange(sameCell, { Triangle{ glm::vec3(0.0051f), glm::vec3(0.0149f), glm::vec3(1, 0, 0) } });
+    for (auto& uv : sameCell.texCoords) uv = glm::vec2(0.0f);
+    CHECK(MeshWelder::Weld(sameCell, options).verticesAfter == 3);
+
+    // Within the position epsilon, but the uvs are 0.002 apart
+    MeshData uvSeam;
+    AddUnindexedRange(uvSeam, { Triangle{ glm::vec3(0.0f), glm::vec3(0.001f, 0, 0), glm::vec3(1, 0, 0) } });
+    uvSeam.texCoords = { glm::vec2(0.0f), glm::vec2(0.002f, 0.0f), glm::vec2(1.0f, 0.0f) };
+    CHECK(MeshWelder::Weld(uvSeam, options).verticesAfter == 3);
+
+    // 0.008 steps: the middle vertex joins the first, the last is 0.016 from it and stays
+    MeshData chain;
+    AddUnindexedRange(chain, { Triangle{ glm::vec3(0.0f), glm::vec3(0.008f, 0, 0), glm::vec3(0.016f, 0, 0) } });
+    for (auto& uv : chain.texCoords) uv = glm::vec2(0.0f);
+    CHECK(MeshWelder::Weld(chain, options).verticesAfter == 2);
+    CHECK(chain.vertices[0] == glm::vec3(0.0f));
+    CHECK(chain.vertices[1] == glm::vec3(0.016f, 0, 0));
+}
+
+ANITO3D_TEST(EpsilonParallelMatchesSerial) {
+    MeshData source;
+    AddUnindexedRange(source, MakeGridTriangles(40));
+    AddUnindexedRange(source, MakeGridTriangles(10), glm::vec2(2.0f));
+    for (size_t i = 0; i < source.vertices.size(); ++i) source.vertices[i].z = float(i % 7) * 1e-4f;
+
+    WeldOptions options;
+    options.positionEpsilon = 1e-3f;
+    MeshData serial = source;
+    MeshWelder::Weld(serial, options);
+    ThreadPool pool(4);
+    MeshData parallel = source;
+    MeshWelder::Weld(parallel, options, &pool);
+
+    CHECK(serial.vertices.size() == 41u * 41u + 11u * 11u);
+    CHECK(parallel.vertices == serial.vertices);
+    CHECK(parallel.indices == serial.indices);
+    CHECK(IndicesInRange(parallel));
+}
+
+ANITO3D_TEST(ParallelMatchesSerial) {
+    MeshData source;
+    AddUnindexedRange(source, MakeGridTriangles(160)); // > 64k corners, several chunks
+    AddUnindexedRange(source, MakeGridTriangles(20), glm::vec2(2.0f));
+    AddUnindexedRange(source, MakeQuad(glm::vec3(5.0f)));
+
+    MeshData serial = source;
+    const WeldStatistics serialStatistics = MeshWelder::Weld(serial);
+    ThreadPool pool(4);
+    MeshData parallel = source;
+    const WeldStatistics parallelStatistics = MeshWelder::Weld(parallel, {}, &pool);
+
+    CHECK(serialStatistics.verticesAfter == 161u * 161u + 21u * 21u + 4u);
+    CHECK(parallelStatistics.verticesAfter == serialStatistics.verticesAfter);
+    CHECK(parallel.vertices == serial.vertices);
+    CHECK(parallel.texCoords == serial.texCoords);
+    CHECK(parallel.indices == serial.indices);
+    CHECK(IndicesInRange(parallel));
+    for (size_t i = 0; i < source.subMeshes.size(); ++i) {
+        CHECK(GetTriangles(parallel, parallel.subMeshes[i]) == GetTriangles(source, source.subMeshes[i]));
+    }
+}
+
+ANITO3D_TEST(DefaultProcessingDoesNotWeld) {
+    MeshData meshData;
+    AddUnindexedRange(meshData, MakeQuad(glm::vec3(0.0f)));
+    const MeshProcessOptions options;
+    CHECK((options.flags & MeshProcess::WeldVertices) == 0);
+
+    MeshProcessor::Run(meshData, options);
+    CHECK(meshData.vertices.size() == 6);
+    CHECK(meshData.indices.empty());
+    CHECK(meshData.indices16.size() == 6);
+
+    MeshProcessOptions weld;
+    weld.flags |= MeshProcess::WeldVertices;
+    MeshData welded;
+    AddUnindexedRange(welded, MakeQuad(glm::vec3(0.0f)));
+    MeshProcessor::Run(welded, weld);
+    CHECK(welded.vertices.size() == 4);
+    CHECK(IndicesInRange(welded));
+}
+
+ANITO3D_TEST(NarrowIndicesChecksEveryIndex) {
+    MeshData meshData;
+    AddUnindexedRange(meshData, MakeQuad(glm::vec3(0.0f)));
+    AddUnindexedRange(meshData, MakeQuad(glm::vec3(2.0f)));
+    meshData.indices[meshData.subMeshes[1].firstIndex + 2] = 70000; // Stray index in a small range
+    MeshData::SubMesh invalid = meshData.subMeshes[0];
+    invalid.firstIndex = 1000; // Past the end of indices
+    meshData.subMeshes.push_back(invalid);
+
+    meshData.NarrowIndices();
+    REQUIRE(meshData.subMeshes.size() == 3);
+    CHECK(meshData.subMeshes[0].indexType == MeshData::IndexType::Uint16);
+    CHECK(meshData.subMeshes[1].indexType == MeshData::IndexType::Uint32);
+    CHECK(meshData.indices16.size() == 6);
+    CHECK(meshData.indices.size() == 6);
+    CHECK(meshData.GetIndex(meshData.subMeshes[1], 2) == 70000);
+    CHECK(meshData.subMeshes[2].indexCount == 0);
+}
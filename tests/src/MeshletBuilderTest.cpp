@@ -0,0 +1,69 @@
+#include "TestHarness.hpp"
+#include "TestMeshes.hpp"
+#include "MeshletBuilder.hpp"
+#include <algorithm>
+#include <array>
+#include <vector>
+
+using namespace Anito3D;
+using Anito3D::Test::MakeGrid;
+
+namespace {
+    using Triangle = std::array<uint32_t, 3>;
+
+    // Rotated so the smallest index comes first; winding is kept
+    Triangle Canonical(Triangle triangle) {
+        std::rotate(triangle.begin(), std::min_element(triangle.begin(), triangle.end()), triangle.end());
+        return triangle;
+    }
+
+    // Every input triangle comes back exactly once, through valid meshlet-local indices
+    bool CoversMesh(const MeshData& meshData, const MeshletData& meshletData, uint32_t maxVertices, uint32_t maxTriangles) {
+        std::vector<Triangle> expected;
+        for (size_t i = 0; i < meshData.indices.size(); i += 3) {
+            expected.push_back(Canonical({ meshData.indices[i], meshData.indices[i + 1], meshData.indices[i + 2] }));
+        }
+
+        std::vector<Triangle> built;
+        for (const Meshlet& meshlet : meshletData.meshlets) {
+            if (meshlet.vertexCount > maxVertices || meshlet.triangleCount > maxTriangles) return false;
+            for (uint32_t t = 0; t < meshlet.triangleCount; ++t) {
+                Triangle triangle;
+                for (uint32_t k = 0; k < 3; ++k) {
+                    const uint8_t local = meshletData.triangles[meshlet.triangleOffset + t * 3 + k];
+                    if (local >= meshlet.vertexCount) return false;
+                    triangle[k] = meshletData.vertices[meshlet.vertexOffset + local];
+                }
+                built.push_back(Canonical(triangle));
+            }
+        }
+        std::sort(expected.begin(), expected.end());
+        std::sort(built.begin(), built.end());
+        return built == expected;
+    }
+}
+
+ANITO3D_TEST(DefaultLimitsCoverTheMesh) {
+    const MeshData meshData = MakeGrid(40);
+    const MeshletBuildOptions options;
+    const MeshletData meshletData = MeshletBuilder::Build(meshData, options);
+    REQUIRE(!meshletData.meshlets.empty());
+    CHECK(meshletData.bounds.size() == meshletData.meshlets.size());
+    CHECK(meshletData.GetTriangleCount() == meshData.GetTriangleCount());
+    CHECK(CoversMesh(meshData, meshletData, options.maxVertices, options.maxTriangles));
+}
+
+ANITO3D_TEST(VertexLimitStaysBelowTheEmptySlot) {
+    // 8-bit local slots reserve 0xFF, so anything above 255 vertices is clamped
+    const MeshData meshData = MakeGrid(40);
+    MeshletBuildOptions options;
+    options.maxVertices = 1000;
+    options.maxTriangles = 512;
+    const MeshletData meshletData = MeshletBuilder::Build(meshData, options);
+    REQUIRE(!meshletData.meshlets.empty());
+    CHECK(CoversMesh(meshData, meshletData, 255, options.maxTriangles));
+
+    uint32_t largest = 0;
+    for (const Meshlet& meshlet : meshletData.meshlets) largest = std::max(largest, meshlet.vertexCount);
+    CHECK(largest == 255);
+}
@@ -0,0 +1,219 @@
+#include "MockVulkan.hpp"
+#include <cstring>
+#include <memory>
+#include <vector>
+
+using namespace Anito3D::Test;
+
+namespace {
+    constexpr VkDeviceSize BufferAlignment = 256;
+    constexpr VkDeviceSize ImageAlignment = 65536;
+
+    struct MockMemory {
+        std::vector<uint8_t> bytes;
+    };
+
+    struct MockBuffer {
+        VkDeviceSize size = 0;
+        MockMemory* memory = nullptr;
+        VkDeviceSize offset = 0;
+    };
+
+    struct MockImage {
+        VkDeviceSize size = 0;
+    };
+
+    struct MockCopy {
+        MockBuffer* source;
+        MockBuffer* destination;
+        VkBufferCopy region;
+    };
+
+    struct MockCommandBuffer {
+        std::vector<MockCopy> copies;
+    };
+
+    struct MockCommandPool {
+        std::vector<std::unique_ptr<MockCommandBuffer>> commandBuffers;
+    };
+
+    struct MockFence {
+        std::vector<MockCopy> submitted; // Runs on the next wait
+    };
+
+    template <typename T, typename Handle>
+    T* From(Handle handle) { return reinterpret_cast<T*>(handle); }
+
+    template <typename Handle, typename T>
+    Handle To(T* object) { return reinterpret_cast<Handle>(object); }
+}
+
+namespace Anito3D::Test {
+
+    MockVulkanState& GetMockVulkan() {
+        static MockVulkanState state;
+        return state;
+    }
+
+    const uint8_t* GetMockBufferData(VkBuffer buffer) {
+        const MockBuffer* mockBuffer = From<MockBuffer>(buffer);
+        return mockBuffer->memory ? mockBuffer->memory->bytes.data() + mockBuffer->offset : nullptr;
+    }
+}
+
+VKAPI_ATTR void VKAPI_CALL vkGetPhysicalDeviceMemoryProperties(VkPhysicalDevice, VkPhysicalDeviceMemoryProperties* pMemoryProperties) {
+    std::memset(pMemoryProperties, 0, sizeof(*pMemoryProperties));
+    pMemoryProperties->memoryTypeCount = 2;
+    pMemoryProperties->memoryTypes[0].propertyFlags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+    pMemoryProperties->memoryTypes[1].propertyFlags = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+}
+
+VKAPI_ATTR void VKAPI_CALL vkGetPhysicalDeviceProperties(VkPhysicalDevice, VkPhysicalDeviceProperties* pProperties) {
+    std::memset(pProperties, 0, sizeof(*pProperties));
+    pProperties->limits.maxMemoryAllocationCount = 4096;
+}
+
+VKAPI_ATTR VkResult VKAPI_CALL vkAllocateMemory(VkDevice, const VkMemoryAllocateInfo* pAllocateInfo, const VkAllocationCallbacks*, VkDeviceMemory* pMemory) {
+    *pMemory = To<VkDeviceMemory>(new MockMemory{ std::vector<uint8_t>(pAllocateInfo->allocationSize) });
+    ++GetMockVulkan().liveMemoryBlocks;
+    return VK_SUCCESS;
+}
+
+VKAPI_ATTR void VKAPI_CALL vkFreeMemory(VkDevice, VkDeviceMemory memory, const VkAllocationCallbacks*) {
+    if (!memory) return;
+    delete From<MockMemory>(memory);
+    --GetMockVulkan().liveMemoryBlocks;
+}
+
+VKAPI_ATTR VkResult VKAPI_CALL vkMapMemory(VkDevice, VkDeviceMemory memory, VkDeviceSize offset, VkDeviceSize, VkMemoryMapFlags, void** ppData) {
+    *ppData = From<MockMemory>(memory)->bytes.data() + offset;
+    return VK_SUCCESS;
+}
+
+VKAPI_ATTR void VKAPI_CALL vkUnmapMemory(VkDevice, VkDeviceMemory) {}
+
+VKAPI_ATTR VkResult VKAPI_CALL vkCreateBuffer(VkDevice, const VkBufferCreateInfo* pCreateInfo, const VkAllocationCallbacks*, VkBuffer* pBuffer) {
+    *pBuffer = To<VkBuffer>(new MockBuffer{ pCreateInfo->size });
+    ++GetMockVulkan().liveBuffers;
+    return VK_SUCCESS;
+}
+
+VKAPI_ATTR void VKAPI_CALL vkDestroyBuffer(VkDevice, VkBuffer buffer, const VkAllocationCallbacks*) {
+    if (!buffer) return;
+    delete From<MockBuffer>(buffer);
+    --GetMockVulkan().liveBuffers;
+}
+
+VKAPI_ATTR void VKAPI_CALL vkGetBufferMemoryRequirements(VkDevice, VkBuffer buffer, VkMemoryRequirements* pMemoryRequirements) {
+    pMemoryRequirements->size = From<MockBuffer>(buffer)->size;
+    pMemoryRequirements->alignment = BufferAlignment;
+    pMemoryRequirements->memoryTypeBits = 0x3;
+}
+
+VKAPI_ATTR VkResult VKAPI_CALL vkBindBufferMemory(VkDevice, VkBuffer buffer, VkDeviceMemory memory, VkDeviceSize memoryOffset) {
+    MockBuffer* mockBuffer = From<MockBuffer>(buffer);
+    mockBuffer->memory = From<MockMemory>(memory);
+    mockBuffer->offset = memoryOffset;
+    return mockBuffer->offset + mockBuffer->size <= mockBuffer->memory->bytes.size() ? VK_SUCCESS : VK_ERROR_OUT_OF_DEVICE_MEMORY;
+}
+
+VKAPI_ATTR VkResult VKAPI_CALL vkCreateImage(VkDevice, const VkImageCreateInfo* pCreateInfo, const VkAllocationCallbacks*, VkImage* pImage) {
+    *pImage = To<VkImage>(new MockImage{ VkDeviceSize(pCreateInfo->extent.width) * pCreateInfo->extent.height * 4 });
+    return VK_SUCCESS;
+}
+
+VKAPI_ATTR void VKAPI_CALL vkDestroyImage(VkDevice, VkImage image, const VkAllocationCallbacks*) {
+    delete From<MockImage>(image);
+}
+
+VKAPI_ATTR void VKAPI_CALL vkGetImageMemoryRequirements(VkDevice, VkImage image, VkMemoryRequirements* pMemoryRequirements) {
+    pMemoryRequirements->size = From<MockImage>(image)->size;
+    pMemoryRequirements->alignment = ImageAlignment;
+    pMemoryRequirements->memoryTypeBits = 0x3;
+}
+
+VKAPI_ATTR VkResult VKAPI_CALL vkBindImageMemory(VkDevice, VkImage, VkDeviceMemory, VkDeviceSize) {
+    return VK_SUCCESS;
+}
+
+VKAPI_ATTR VkResult VKAPI_CALL vkCreateCommandPool(VkDevice, const VkCommandPoolCreateInfo*, const VkAllocationCallbacks*, VkCommandPool* pCommandPool) {
+    *pCommandPool = To<VkCommandPool>(new MockCommandPool);
+    return VK_SUCCESS;
+}
+
+VKAPI_ATTR void VKAPI_CALL vkDestroyCommandPool(VkDevice, VkCommandPool commandPool, const VkAllocationCallbacks*) {
+    delete From<MockCommandPool>(commandPool);
+}
+
+VKAPI_ATTR VkResult VKAPI_CALL vkAllocateCommandBuffers(VkDevice, const VkCommandBufferAllocateInfo* pAllocateInfo, VkCommandBuffer* pCommandBuffers) {
+    MockCommandPool* pool = From<MockCommandPool>(pAllocateInfo->commandPool);
+    for (uint32_t i = 0; i < pAllocateInfo->commandBufferCount; ++i) {
+        pool->commandBuffers.push_back(std::make_unique<MockCommandBuffer>());
+        pCommandBuffers[i] = To<VkCommandBuffer>(pool->commandBuffers.back().get());
+    }
+    return VK_SUCCESS;
+}
+
+VKAPI_ATTR void VKAPI_CALL vkFreeCommandBuffers(VkDevice, VkCommandPool commandPool, uint32_t commandBufferCount, const VkCommandBuffer* pCommandBuffers) {
+    auto& commandBuffers = From<MockCommandPool>(commandPool)->commandBuffers;
+    for (uint32_t i = 0; i < commandBufferCount; ++i) {
+        std::erase_if(commandBuffers, [&](const auto& commandBuffer) { return To<VkCommandBuffer>(commandBuffer.get()) == pCommandBuffers[i]; });
+    }
+}
+
+VKAPI_ATTR VkResult VKAPI_CALL vkBeginCommandBuffer(VkCommandBuffer commandBuffer, const VkCommandBufferBeginInfo*) {
+    From<MockCommandBuffer>(commandBuffer)->copies.clear();
+    return VK_SUCCESS;
+}
+
+VKAPI_ATTR VkResult VKAPI_CALL vkEndCommandBuffer(VkCommandBuffer) {
+    return VK_SUCCESS;
+}
+
+VKAPI_ATTR void VKAPI_CALL vkCmdCopyBuffer(VkCommandBuffer commandBuffer, VkBuffer srcBuffer, VkBuffer dstBuffer, uint32_t regionCount, const VkBufferCopy* pRegions) {
+    for (uint32_t i = 0; i < regionCount; ++i) {
+        From<MockCommandBuffer>(commandBuffer)->copies.push_back({ From<MockBuffer>(srcBuffer), From<MockBuffer>(dstBuffer), pRegions[i] });
+    }
+    ++GetMockVulkan().copyCommands;
+}
+
+VKAPI_ATTR void VKAPI_CALL vkCmdPipelineBarrier(VkCommandBuffer, VkPipelineStageFlags, VkPipelineStageFlags, VkDependencyFlags, uint32_t, const VkMemoryBarrier*,
+    uint32_t, const VkBufferMemoryBarrier*, uint32_t, const VkImageMemoryBarrier*) {}
+
+VKAPI_ATTR VkResult VKAPI_CALL vkCreateFence(VkDevice, const VkFenceCreateInfo*, const VkAllocationCallbacks*, VkFence* pFence) {
+    *pFence = To<VkFence>(new MockFence);
+    return VK_SUCCESS;
+}
+
+VKAPI_ATTR void VKAPI_CALL vkDestroyFence(VkDevice, VkFence fence, const VkAllocationCallbacks*) {
+    delete From<MockFence>(fence);
+}
+
+VKAPI_ATTR VkResult VKAPI_CALL vkQueueSubmit(VkQueue, uint32_t submitCount, const VkSubmitInfo* pSubmits, VkFence fence) {
+    if (GetMockVulkan().failSubmits) return VK_ERROR_DEVICE_LOST;
+    MockFence* mockFence = From<MockFence>(fence);
+    for (uint32_t submit = 0; submit < submitCount; ++submit) {
+        for (uint32_t i = 0; i < pSubmits[submit].commandBufferCount; ++i) {
+            const auto& copies = From<MockCommandBuffer>(pSubmits[submit].pCommandBuffers[i])->copies;
+            mockFence->submitted.insert(mockFence->submitted.end(), copies.begin(), copies.end());
+        }
+    }
+    ++GetMockVulkan().submits;
+    return VK_SUCCESS;
+}
+
+VKAPI_ATTR VkResult VKAPI_CALL vkWaitForFences(VkDevice, uint32_t fenceCount, const VkFence* pFences, VkBool32, uint64_t) {
+    for (uint32_t i = 0; i < fenceCount; ++i) {
+        MockFence* mockFence = From<MockFence>(pFences[i]);
+        for (const MockCopy& copy : mockFence->submitted) {
+            std::memcpy(copy.destination->memory->bytes.data() + copy.destination->offset + copy.region.dstOffset,
+                copy.source->memory->bytes.data() + copy.source->offset + copy.region.srcOffset, copy.region.size);
+        }
+        mockFence->submitted.clear();
+    }
+    return VK_SUCCESS;
+}
+
+VKAPI_ATTR VkResult VKAPI_CALL vkResetFences(VkDevice, uint32_t, const VkFence*) {
+    return VK_SUCCESS;
+}
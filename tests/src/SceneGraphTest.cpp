@@ -0,0 +1,175 @@
+#include "TestHarness.hpp"
+#include "SceneGraph.hpp"
+#include "ThreadPool.hpp"
+#include <glm/gtc/matrix_transform.hpp>
+#include <algorithm>
+#include <random>
+#include <vector>
+
+using namespace Anito3D;
+
+namespace {
+    glm::mat4 Translation(float x, float y, float z) {
+        return glm::translate(glm::mat4(1.0f), glm::vec3(x, y, z));
+    }
+
+    // World transform composed by walking the parent chain, independent of the slot order
+    glm::mat4 ComposeWorld(const SceneGraph& graph, SceneNodeId node) {
+        glm::mat4 world = graph.GetLocalTransform(node);
+        for (SceneNodeId parent = graph.GetParent(node); parent != SceneGraph::InvalidNode; parent = graph.GetParent(parent)) {
+            world = graph.GetLocalTransform(parent) * world;
+        }
+        return world;
+    }
+
+    float MaxDifference(const glm::mat4& a, const glm::mat4& b) {
+        float difference = 0.0f;
+        for (int column = 0; column < 4; ++column) {
+            for (int row = 0; row < 4; ++row) difference = std::max(difference, std::abs(a[column][row] - b[column][row]));
+        }
+        return difference;
+    }
+
+    bool WorldsMatch(const SceneGraph& graph, const std::vector<SceneNodeId>& nodes) {
+        for (SceneNodeId node : nodes) {
+            if (graph.IsValid(node) && MaxDifference(graph.GetWorldTransform(node), ComposeWorld(graph, node)) > 1e-4f) return false;
+        }
+        return true;
+    }
+}
+
+ANITO3D_TEST(WorldTransformsFollowTheHierarchy) {
+    SceneGraph graph;
+    const SceneNodeId root = graph.CreateNode(SceneGraph::InvalidNode, Translation(1, 0, 0));
+    const SceneNodeId child = graph.CreateNode(root, Translation(0, 2, 0));
+    const SceneNodeId grandchild = graph.CreateNode(child, Translation(0, 0, 3));
+    graph.Update();
+    CHECK(MaxDifference(graph.GetWorldTransform(grandchild), Translation(1, 2, 3)) == 0.0f);
+
+    // Only the changed subtree is walked
+    graph.SetLocalTransform(child, Translation(0, 5, 0));
+    const SceneGraphUpdateStatistics statistics = graph.Update();
+    CHECK(statistics.dirtySubtrees == 1);
+    CHECK(statistics.nodesUpdated == 2);
+    CHECK(MaxDifference(graph.GetWorldTransform(grandchild), Translation(1, 5, 3)) == 0.0f);
+    CHECK(MaxDifference(graph.GetWorldTransform(root), Translation(1, 0, 0)) == 0.0f);
+}
+
+ANITO3D_TEST(ReparentMovesTheSubtree) {
+    SceneGraph graph;
+    const SceneNodeId left = graph.CreateNode(SceneGraph::InvalidNode, Translation(-10, 0, 0));
+    const SceneNodeId right = graph.CreateNode(SceneGraph::InvalidNode, Translation(10, 0, 0));
+    const SceneNodeId node = graph.CreateNode(left, Translation(0, 1, 0));
+    const SceneNodeId leaf = graph.CreateNode(node, Translation(0, 0, 1));
+    graph.Update();
+
+    CHECK(graph.SetParent(node, right));
+    CHECK(graph.GetParent(node) == right);
+    const SceneGraphUpdateStatistics statistics = graph.Update();
+    CHECK(statistics.rebuilt);
+    CHECK(MaxDifference(graph.GetWorldTransform(leaf), Translation(10, 1, 1)) == 0.0f);
+    CHECK(MaxDifference(graph.GetWorldTransform(left), Translation(-10, 0, 0)) == 0.0f);
+
+    // Detaching makes the node a root
+    CHECK(graph.SetParent(node, SceneGraph::InvalidNode));
+    graph.Update();
+    CHECK(MaxDifference(graph.GetWorldTransform(leaf), Translation(0, 1, 1)) == 0.0f);
+}
+
+ANITO3D_TEST(ReparentRejectsCycles) {
+    SceneGraph graph;
+    const SceneNodeId a = graph.CreateNode();
+    const SceneNodeId b = graph.CreateNode(a);
+    const SceneNodeId c = graph.CreateNode(b);
+    CHECK(!graph.SetParent(a, a));
+    CHECK(!graph.SetParent(a, c));
+    CHECK(graph.GetParent(a) == SceneGraph::InvalidNode);
+    CHECK(graph.SetParent(c, a));
+    CHECK(graph.GetParent(c) == a);
+}
+
+ANITO3D_TEST(DestroyKeepsChildrenUnderTheClosestAncestor) {
+    SceneGraph graph;
+    const SceneNodeId root = graph.CreateNode(SceneGraph::InvalidNode, Translation(1, 0, 0));
+    const SceneNodeId middle = graph.CreateNode(root, Translation(0, 1, 0));
+    const SceneNodeId leaf = graph.CreateNode(middle, Translation(0, 0, 1));
+    const SceneNodeId sibling = graph.CreateNode(middle);
+    graph.Update();
+    REQUIRE(graph.GetNodeCount() == 4);
+
+    graph.DestroyNode(middle);
+    CHECK(!graph.IsValid(middle));
+    CHECK(graph.GetNodeCount() == 3);
+    CHECK(graph.GetParent(leaf) == root);
+    CHECK(graph.GetParent(sibling) == root);
+    graph.Update();
+    CHECK(MaxDifference(graph.GetWorldTransform(leaf), Translation(1, 0, 1)) == 0.0f);
+
+    // Destroying a node and its ancestor together lifts the children to the surviving root
+    const SceneNodeId a = graph.CreateNode(root);
+    const SceneNodeId b = graph.CreateNode(a);
+    const SceneNodeId c = graph.CreateNode(b, Translation(0, 0, 2));
+    const SceneNodeId doomed[] = { b, a };
+    graph.DestroyNodes(doomed);
+    CHECK(graph.GetParent(c) == root);
+    graph.Update();
+    CHECK(MaxDifference(graph.GetWorldTransform(c), Translation(1, 0, 2)) == 0.0f);
+
+    // Ids are reused without inheriting the old node
+    const SceneNodeId reused = graph.CreateNode();
+    CHECK(graph.IsValid(reused));
+    CHECK(graph.GetParent(reused) == SceneGraph::InvalidNode);
+    graph.Update();
+    CHECK(MaxDifference(graph.GetWorldTransform(reused), glm::mat4(1.0f)) == 0.0f);
+}
+
+ANITO3D_TEST(RandomEditsMatchTheParentChain) {
+    std::mt19937 rng(3);
+    auto randomLocal = [&]() { return Translation(float(rng() % 7) * 0.1f, float(rng() % 5) * 0.1f, 0.1f); };
+    ThreadPool pool(3);
+    SceneGraph graph;
+    std::vector<SceneNodeId> nodes;
+    for (int i = 0; i < 8000; ++i) {
+        const SceneNodeId parent = nodes.empty() || rng() % 50 == 0 ? SceneGraph::InvalidNode : nodes[rng() % nodes.size()];
+        nodes.push_back(graph.CreateNode(parent, randomLocal()));
+    }
+
+    for (int iteration = 0; iteration < 40; ++iteration) {
+        switch (iteration % 4) {
+        case 0:
+            for (int k = 0; k < 30; ++k) {
+                const SceneNodeId node = nodes[rng() % nodes.size()];
+                if (graph.IsValid(node)) graph.SetLocalTransform(node, randomLocal());
+            }
+            break;
+        case 1: {
+            const SceneNodeId node = nodes[rng() % nodes.size()];
+            const SceneNodeId parent = nodes[rng() % nodes.size()];
+            if (graph.IsValid(node) && graph.IsValid(parent)) graph.SetParent(node, parent);
+            break;
+        }
+        case 2: {
+            std::vector<SceneNodeId> doomed;
+            for (int k = 0; k < 5; ++k) doomed.push_back(nodes[rng() % nodes.size()]);
+            graph.DestroyNodes(doomed);
+            break;
+        }
+        default:
+            for (int k = 0; k < 10; ++k) {
+                const SceneNodeId parent = nodes[rng() % nodes.size()];
+                nodes.push_back(graph.CreateNode(graph.IsValid(parent) ? parent : SceneGraph::InvalidNode, randomLocal()));
+            }
+            break;
+        }
+        graph.Update(iteration % 2 ? &pool : nullptr);
+        CHECK(WorldsMatch(graph, nodes));
+    }
+
+    std::vector<SceneNodeId> alive;
+    for (SceneNodeId node : nodes) {
+        if (graph.IsValid(node)) alive.push_back(node);
+    }
+    std::sort(alive.begin(), alive.end());
+    alive.erase(std::unique(alive.begin(), alive.end()), alive.end());
+    CHECK(alive.size() == graph.GetNodeCount());
+}
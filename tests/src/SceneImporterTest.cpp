@@ -0,0 +1,146 @@
+#include "TestHarness.hpp"
+#include "SceneImporter.hpp"
+#include "ThreadPool.hpp"
+#include <algorithm>
+#include <initializer_list>
+#include <memory>
+#include <vector>
+
+using namespace Anito3D;
+
+namespace {
+    aiFace MakeFace(std::initializer_list<unsigned int> indices) {
+        aiFace face;
+        face.mNumIndices = static_cast<unsigned int>(indices.size());
+        face.mIndices = new unsigned int[indices.size()];
+        std::copy(indices.begin(), indices.end(), face.mIndices);
+        return face;
+    }
+
+    aiNode* MakeNode(aiNode* parent, float x, float y, std::initializer_list<unsigned int> meshes) {
+        aiNode* node = new aiNode();
+        node->mTransformation.a4 = x; // Row-major translation column
+        node->mTransformation.b4 = y;
+        node->mParent = parent;
+        node->mNumMeshes = static_cast<unsigned int>(meshes.size());
+        node->mMeshes = new unsigned int[meshes.size()];
+        std::copy(meshes.begin(), meshes.end(), node->mMeshes);
+        return node;
+    }
+
+    void SetChildren(aiNode* node, std::initializer_list<aiNode*> children) {
+        node->mNumChildren = static_cast<unsigned int>(children.size());
+        node->mChildren = new aiNode*[children.size()];
+        std::copy(children.begin(), children.end(), node->mChildren);
+    }
+
+    // Mesh 0 is a quad with normals and uvs, mesh 1 a bare triangle plus a line.
+    // Hierarchy: root (mesh 1) -> { a (mesh 0) -> { b (mesh 0) }, c }, so mesh 0 is
+    // instanced twice under different transforms.
+    std::unique_ptr<aiScene> MakeScene() {
+        auto scene = std::make_unique<aiScene>();
+
+        aiMesh* quad = new aiMesh();
+        quad->mNumVertices = 4;
+        quad->mVertices = new aiVector3D[4]{ { 0, 0, 0 }, { 1, 0, 0 }, { 1, 1, 0 }, { 0, 1, 0 } };
+        quad->mNormals = new aiVector3D[4]{ { 0, 0, 1 }, { 0, 0, 1 }, { 0, 0, 1 }, { 0, 0, 1 } };
+        quad->mTextureCoords[0] = new aiVector3D[4]{ { 0, 0, 0 }, { 1, 0, 0 }, { 1, 1, 0 }, { 0, 1, 0 } };
+        quad->mNumFaces = 2;
+        quad->mFaces = new aiFace[2];
+        quad->mFaces[0] = MakeFace({ 0, 1, 2 });
+        quad->mFaces[1] = MakeFace({ 0, 2, 3 });
+        quad->mMaterialIndex = 1;
+
+        aiMesh* triangle = new aiMesh();
+        triangle->mNumVertices = 3;
+        triangle->mVertices = new aiVector3D[3]{ { 0, 0, 2 }, { 1, 0, 2 }, { 0, 1, 2 } };
+        triangle->mNumFaces = 2;
+        triangle->mFaces = new aiFace[2];
+        triangle->mFaces[0] = MakeFace({ 0, 1 }); // Skipped: not a triangle
+        triangle->mFaces[1] = MakeFace({ 2, 1, 0 });
+        triangle->mMaterialIndex = 0;
+
+        scene->mNumMeshes = 2;
+        scene->mMeshes = new aiMesh*[2]{ quad, triangle };
+        scene->mNumMaterials = 2;
+        scene->mMaterials = new aiMaterial*[2]{ new aiMaterial(), new aiMaterial() };
+
+        aiNode* root = MakeNode(nullptr, 0.0f, 0.0f, { 1 });
+        aiNode* a = MakeNode(root, 5.0f, 0.0f, { 0 });
+        aiNode* b = MakeNode(a, 0.0f, 3.0f, { 0 });
+        aiNode* c = MakeNode(root, 0.0f, 0.0f, {});
+        SetChildren(root, { a, c });
+        SetChildren(a, { b });
+        scene->mRootNode = root;
+        return scene;
+    }
+
+    glm::vec3 GetTranslation(const glm::mat4& transform) {
+        return glm::vec3(transform[3]);
+    }
+}
+
+ANITO3D_TEST(RangeTableAndNodes) {
+    const std::unique_ptr<aiScene> scene = MakeScene();
+    MeshData meshData;
+    SceneImporter::ProcessScene(scene.get(), meshData);
+
+    // Every source mesh is laid out once: quad first, then the triangle
+    CHECK(meshData.vertices.size() == 7);
+    CHECK(meshData.normals.size() == 7);   // The triangle's share is zero-filled
+    CHECK(meshData.texCoords.size() == 7);
+    CHECK(meshData.indices == std::vector<uint32_t>({ 0, 1, 2, 0, 2, 3, 2, 1, 0 }));
+    CHECK(meshData.vertices[4] == glm::vec3(0, 0, 2));
+    CHECK(meshData.normals[4] == glm::vec3(0.0f));
+    CHECK(meshData.materials.size() == 2);
+
+    // Pre-order nodes: root, a, b, c
+    REQUIRE(meshData.nodes.size() == 4);
+    CHECK(meshData.nodes[0].parent == MeshData::NoParent);
+    CHECK(meshData.nodes[1].parent == 0);
+    CHECK(meshData.nodes[2].parent == 1);
+    CHECK(meshData.nodes[3].parent == 0);
+    CHECK(GetTranslation(meshData.nodes[2].localTransform) == glm::vec3(0, 3, 0));
+
+    // One submesh per (node, mesh) reference, in node order
+    REQUIRE(meshData.subMeshes.size() == 3);
+    const MeshData::SubMesh& triangle = meshData.subMeshes[0];
+    CHECK(triangle.firstIndex == 6 && triangle.indexCount == 3);
+    CHECK(triangle.vertexOffset == 4 && triangle.vertexCount == 3);
+    CHECK(triangle.materialId == 0);
+    CHECK(triangle.node == 0);
+
+    const MeshData::SubMesh& first = meshData.subMeshes[1];
+    const MeshData::SubMesh& second = meshData.subMeshes[2];
+    CHECK(first.firstIndex == 0 && first.indexCount == 6);
+    CHECK(first.vertexOffset == 0 && first.vertexCount == 4);
+    CHECK(first.materialId == 1);
+    CHECK(first.node == 1 && second.node == 2);
+
+    // The instanced quad shares its range and differs only in transform
+    CHECK(second.firstIndex == first.firstIndex && second.indexCount == first.indexCount);
+    CHECK(second.vertexOffset == first.vertexOffset && second.vertexCount == first.vertexCount);
+    CHECK(second.materialId == first.materialId);
+    CHECK(GetTranslation(first.transform) == glm::vec3(5, 0, 0));
+    CHECK(GetTranslation(second.transform) == glm::vec3(5, 3, 0));
+    CHECK(meshData.GetUniqueRanges().size() == 2);
+}
+
+ANITO3D_TEST(ParallelProcessingMatchesSerial) {
+    const std::unique_ptr<aiScene> scene = MakeScene();
+    MeshData serial;
+    SceneImporter::ProcessScene(scene.get(), serial);
+    ThreadPool pool(2);
+    MeshData parallel;
+    SceneImporter::ProcessScene(scene.get(), parallel, &pool);
+
+    CHECK(parallel.vertices == serial.vertices);
+    CHECK(parallel.normals == serial.normals);
+    CHECK(parallel.texCoords == serial.texCoords);
+    CHECK(parallel.indices == serial.indices);
+    REQUIRE(parallel.subMeshes.size() == serial.subMeshes.size());
+    for (size_t i = 0; i < serial.subMeshes.size(); ++i) {
+        CHECK(parallel.subMeshes[i].firstIndex == serial.subMeshes[i].firstIndex);
+        CHECK(parallel.subMeshes[i].transform == serial.subMeshes[i].transform);
+    }
+}
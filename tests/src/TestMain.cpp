@@ -0,0 +1,5 @@
+#include "TestHarness.hpp"
+
+int main() {
+    return Anito3D::Test::RunAll();
+}
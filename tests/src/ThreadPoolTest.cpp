@@ -0,0 +1,158 @@
+#include "TestHarness.hpp"
+#include "ThreadPool.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+using namespace Anito3D;
+
+namespace {
+    // Per-index hit counts for a range body
+    struct Coverage {
+        std::vector<std::atomic<uint32_t>> hits;
+        std::atomic<uint32_t> ranges{ 0 };
+
+        explicit Coverage(size_t count) : hits(count) {}
+
+        void Add(size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) hits[i].fetch_add(1);
+            ranges.fetch_add(1);
+        }
+
+        bool EveryIndexOnce() const {
+            return std::all_of(hits.begin(), hits.end(), [](const std::atomic<uint32_t>& hit) { return hit.load() == 1; });
+        }
+    };
+}
+
+ANITO3D_TEST(ParallelForRangeCoversEveryIndexOnce) {
+    ThreadPool pool(4);
+    for (const auto& [count, minGrain] : { std::pair<size_t, size_t>(100003, 1), { 100003, 1000 }, { 1021, 7 }, { 3, 1 }, { 1, 1 } }) {
+        Coverage coverage(count);
+        std::atomic<bool> ordered{ true };
+        pool.ParallelForRange(count, [&](size_t begin, size_t end) {
+            if (begin >= end || end > count) ordered = false;
+            coverage.Add(begin, end);
+        }, minGrain);
+        CHECK(ordered);
+        CHECK(coverage.EveryIndexOnce());
+        if (count > 1000) CHECK(coverage.ranges.load() > 1); // Actually split
+    }
+
+    // A count within minGrain stays in one piece on the calling thread
+    Coverage single(50);
+    pool.ParallelForRange(50, [&](size_t begin, size_t end) { single.Add(begin, end); }, 64);
+    CHECK(single.ranges.load() == 1);
+    CHECK(single.EveryIndexOnce());
+
+    Coverage perIndex(777);
+    pool.ParallelFor(777, [&](size_t i) { perIndex.Add(i, i + 1); });
+    CHECK(perIndex.EveryIndexOnce());
+}
+
+ANITO3D_TEST(ZeroCountNeverCallsBody) {
+    ThreadPool pool(2);
+    std::atomic<uint32_t> calls{ 0 };
+    pool.ParallelFor(0, [&](size_t) { calls.fetch_add(1); });
+    pool.ParallelForRange(0, [&](size_t, size_t) { calls.fetch_add(1); }, 16);
+    CHECK(calls.load() == 0);
+}
+
+ANITO3D_TEST(NestedParallelForFromWorkers) {
+    ThreadPool pool(3);
+    constexpr size_t Outer = 16, Inner = 1000;
+    Coverage coverage(Outer * Inner);
+    std::atomic<uint32_t> onWorkers{ 0 };
+    const std::thread::id caller = std::this_thread::get_id();
+    pool.ParallelFor(Outer, [&](size_t i) {
+        if (std::this_thread::get_id() != caller) onWorkers.fetch_add(1);
+        std::this_thread::sleep_for(std::chrono::milliseconds(1)); // Long enough for the workers to steal outer indices
+        pool.ParallelForRange(Inner, [&](size_t begin, size_t end) { coverage.Add(i * Inner + begin, i * Inner + end); });
+    });
+    CHECK(coverage.EveryIndexOnce());
+    CHECK(onWorkers.load() > 0);
+
+    // The same from a scheduled job, waited on from outside the pool
+    Coverage scheduled(Inner);
+    JobCounter counter;
+    pool.Schedule([&]() { pool.ParallelFor(Inner, [&](size_t i) { scheduled.Add(i, i + 1); }); }, &counter);
+    pool.Wait(counter);
+    CHECK(scheduled.EveryIndexOnce());
+}
+
+ANITO3D_TEST(DependentJobsWaitForTheirDependency) {
+    ThreadPool pool(4);
+    for (int round = 0; round < 50; ++round) {
+        constexpr uint32_t First = 32, Second = 32;
+        JobCounter first, second;
+        std::atomic<uint32_t> finished{ 0 };
+        std::atomic<uint32_t> early{ 0 };
+        for (uint32_t i = 0; i < First; ++i) {
+            pool.Schedule([&finished, i]() {
+                if (i % 4 == 0) std::this_thread::sleep_for(std::chrono::microseconds(50));
+                finished.fetch_add(1);
+            }, &first);
+        }
+        for (uint32_t i = 0; i < Second; ++i) {
+            pool.Schedule([&]() {
+                if (finished.load() != First) early.fetch_add(1);
+            }, &second, &first);
+        }
+        pool.Wait(second);
+        CHECK(early.load() == 0);
+        CHECK(first.IsDone());
+        CHECK(second.IsDone());
+    }
+
+    // A dependency that is already done does not hold the job back
+    JobCounter idle, counter;
+    std::atomic<bool> ran{ false };
+    pool.Schedule([&]() { ran = true; }, &counter, &idle);
+    pool.Wait(counter);
+    CHECK(ran.load());
+}
+
+ANITO3D_TEST(ParallelForRethrowsBodyExceptions) {
+    ThreadPool pool(3);
+    bool caught = false;
+    try {
+        pool.ParallelFor(10000, [](size_t i) {
+            if (i == 7777) throw std::runtime_error("ParallelFor");
+        });
+    }
+    catch (const std::runtime_error&) {
+        caught = true;
+    }
+    CHECK(caught);
+
+    caught = false;
+    try {
+        pool.ParallelForRange(10000, [](size_t begin, size_t end) {
+            if (begin <= 123 && 123 < end) throw std::logic_error("ParallelForRange");
+        }, 10);
+    }
+    catch (const std::logic_error&) {
+        caught = true;
+    }
+    CHECK(caught);
+
+    // Single-piece ranges run inline and throw straight through
+    caught = false;
+    try {
+        pool.ParallelForRange(4, [](size_t, size_t) { throw std::runtime_error("inline"); }, 8);
+    }
+    catch (const std::runtime_error&) {
+        caught = true;
+    }
+    CHECK(caught);
+
+    // The pool keeps working afterwards
+    Coverage coverage(5000);
+    pool.ParallelForRange(5000, [&](size_t begin, size_t end) { coverage.Add(begin, end); });
+    CHECK(coverage.EveryIndexOnce());
+}
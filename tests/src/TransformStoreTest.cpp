@@ -0,0 +1,163 @@
+#include "TestHarness.hpp"
+#include "TransformStore.hpp"
+#include "ThreadPool.hpp"
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+using namespace Anito3D;
+
+namespace {
+    float MaxDifference(const glm::mat4& a, const glm::mat4& b) {
+        float difference = 0.0f;
+        for (int column = 0; column < 4; ++column) {
+            for (int row = 0; row < 4; ++row) difference = std::max(difference, std::abs(a[column][row] - b[column][row]));
+        }
+        return difference;
+    }
+
+    struct RandomTransform {
+        glm::vec3 position;
+        glm::quat rotation; // Not normalized
+        glm::vec3 scale;     // Non-uniform, sometimes mirrored
+    };
+
+    RandomTransform MakeRandomTransform(std::mt19937& rng) {
+        std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+        RandomTransform transform;
+        transform.position = glm::vec3(unit(rng), unit(rng), unit(rng)) * 100.0f;
+        transform.rotation = glm::quat(3.0f * unit(rng), 3.0f * unit(rng), 3.0f * unit(rng), 3.0f * unit(rng));
+        if (glm::length(transform.rotation) < 1e-3f) transform.rotation = glm::quat(2.0f, 0.0f, 0.0f, 0.0f);
+        transform.scale = glm::vec3(unit(rng), unit(rng), unit(rng)) * 4.0f;
+        return transform;
+    }
+
+    // Identical stores: one is rebuilt with SSE2, the other with the scalar path
+    struct StorePair {
+        TransformStore simd;
+        TransformStore scalar;
+        std::vector<TransformHandle> handles;
+
+        void Create(const RandomTransform& transform) {
+            const TransformHandle handle = simd.Create(transform.position, transform.rotation, transform.scale);
+            const TransformHandle twin = scalar.Create(transform.position, transform.rotation, transform.scale);
+            CHECK(handle.index == twin.index && handle.generation == twin.generation);
+            handles.push_back(handle);
+        }
+
+        void Update(ThreadPool* threadPool) {
+            CHECK(simd.UpdateWorldMatrices(threadPool, true) == scalar.UpdateWorldMatrices(threadPool, false));
+        }
+
+        // Both paths agree with each other and with ComposeMatrix on the normalized rotation
+        bool Matches() const {
+            for (TransformHandle handle : handles) {
+                if (!simd.IsAlive(handle)) continue;
+                const glm::mat4 expected = TransformStore::ComposeMatrix(simd.GetPosition(handle), simd.GetRotation(handle), simd.GetScale(handle));
+                if (MaxDifference(simd.GetWorldMatrix(handle), scalar.GetWorldMatrix(handle)) > 1e-4f) return false;
+                if (MaxDifference(scalar.GetWorldMatrix(handle), expected) > 1e-4f) return false;
+            }
+            return true;
+        }
+    };
+}
+
+ANITO3D_TEST(SimdMatchesScalar) {
+    ThreadPool pool(4);
+    for (ThreadPool* threadPool : { static_cast<ThreadPool*>(nullptr), &pool }) {
+        std::mt19937 rng(11);
+        StorePair stores;
+        const size_t count = threadPool ? 9001 : 1003; // Batches of four plus a remainder; the larger spans several tasks
+        for (size_t i = 0; i < count; ++i) stores.Create(MakeRandomTransform(rng));
+        stores.Update(threadPool);
+        CHECK(stores.Matches());
+        CHECK(std::abs(glm::length(stores.simd.GetRotation(stores.handles[0])) - 1.0f) < 1e-5f);
+
+        // Free every seventh slot and reuse them with new transforms
+        for (size_t i = 0; i < count; i += 7) {
+            stores.simd.Destroy(stores.handles[i]);
+            stores.scalar.Destroy(stores.handles[i]);
+        }
+        const size_t reused = (count + 6) / 7;
+        for (size_t i = 0; i < reused; ++i) stores.Create(MakeRandomTransform(rng));
+        CHECK(stores.simd.GetCapacity() == count);
+        CHECK(stores.simd.GetDirtyCount() == reused);
+        stores.Update(threadPool);
+        CHECK(stores.Matches());
+
+        // A sparse, uneven set of dirty slots
+        for (size_t i = 3; i < stores.handles.size(); i += 5) {
+            if (!stores.simd.IsAlive(stores.handles[i])) continue;
+            const RandomTransform transform = MakeRandomTransform(rng);
+            stores.simd.SetTransform(stores.handles[i], transform.position, transform.rotation, transform.scale);
+            stores.scalar.SetTransform(stores.handles[i], transform.position, transform.rotation, transform.scale);
+        }
+        stores.Update(threadPool);
+        CHECK(stores.Matches());
+    }
+}
+
+ANITO3D_TEST(OnlyDirtySlotsAreRebuilt) {
+    TransformStore store;
+    std::vector<TransformHandle> handles;
+    for (int i = 0; i < 200; ++i) handles.push_back(store.Create(glm::vec3(float(i), 0.0f, 0.0f)));
+    CHECK(store.GetDirtyCount() == 200);
+    CHECK(store.UpdateWorldMatrices() == 200);
+    CHECK(store.GetDirtyCount() == 0);
+    CHECK(store.UpdateWorldMatrices() == 0);
+
+    // Repeated writes to a slot flag it once
+    store.SetPosition(handles[5], glm::vec3(0.0f, 5.0f, 0.0f));
+    store.SetScale(handles[5], glm::vec3(2.0f));
+    store.SetRotation(handles[70], glm::quat(0.0f, 0.0f, 0.0f, 3.0f));
+    store.SetPosition(handles[199], glm::vec3(0.0f, 0.0f, 199.0f));
+    CHECK(store.GetDirtyCount() == 3);
+    for (size_t i = 0; i < handles.size(); ++i) CHECK(store.IsDirty(handles[i]) == (i == 5 || i == 70 || i == 199));
+
+    // The cached matrix keeps the old value until the update
+    CHECK(store.GetWorldMatrix(handles[5])[3] == glm::vec4(5.0f, 0.0f, 0.0f, 1.0f));
+    CHECK(store.UpdateWorldMatrices() == 3);
+    CHECK(store.GetWorldMatrix(handles[5])[3] == glm::vec4(0.0f, 5.0f, 0.0f, 1.0f));
+    CHECK(store.GetWorldMatrix(handles[5])[0] == glm::vec4(2.0f, 0.0f, 0.0f, 0.0f));
+    CHECK(store.GetWorldMatrix(handles[199])[3] == glm::vec4(0.0f, 0.0f, 199.0f, 1.0f));
+    CHECK(MaxDifference(store.GetWorldMatrix(handles[70]), TransformStore::ComposeMatrix(glm::vec3(70.0f, 0.0f, 0.0f), glm::quat(0.0f, 0.0f, 0.0f, 1.0f), glm::vec3(1.0f))) < 1e-6f);
+    CHECK(store.GetDirtyCount() == 0);
+}
+
+ANITO3D_TEST(DestroyClearsDirtyBitAndRetiresHandle) {
+    TransformStore store;
+    std::vector<TransformHandle> handles;
+    for (int i = 0; i < 130; ++i) handles.push_back(store.Create());
+    store.UpdateWorldMatrices();
+
+    store.SetPosition(handles[64], glm::vec3(1.0f));
+    store.SetPosition(handles[65], glm::vec3(1.0f));
+    store.Destroy(handles[64]);
+    CHECK(!store.IsAlive(handles[64]));
+    CHECK(!store.IsDirty(handles[64]));
+    CHECK(store.GetDirtyCount() == 1);
+    CHECK(store.GetCount() == 129);
+    CHECK(store.UpdateWorldMatrices() == 1);
+
+    // Destroying twice is a no-op
+    store.Destroy(handles[64]);
+    CHECK(store.GetCount() == 129);
+
+    // The slot is reused under a new generation and starts dirty
+    const TransformHandle reused = store.Create(glm::vec3(7.0f));
+    CHECK(reused.index == handles[64].index);
+    CHECK(reused.generation != handles[64].generation);
+    CHECK(store.IsAlive(reused));
+    CHECK(!store.IsAlive(handles[64]));
+    CHECK(store.IsDirty(reused));
+    CHECK(store.UpdateWorldMatrices() == 1);
+    CHECK(store.GetWorldMatrix(reused)[3] == glm::vec4(7.0f, 7.0f, 7.0f, 1.0f));
+
+    // MarkAllDirty skips free slots
+    store.Destroy(handles[3]);
+    store.MarkAllDirty();
+    CHECK(store.GetDirtyCount() == store.GetCount());
+    CHECK(!store.IsDirty(handles[3]));
+    CHECK(store.UpdateWorldMatrices() == 129);
+}
@@ -0,0 +1,144 @@
+#include "TestHarness.hpp"
+#include "VertexPacking.hpp"
+#include <algorithm>
+#include <cstring>
+#include <random>
+
+using namespace Anito3D;
+
+namespace {
+    const PackedVertexFormat Formats[] = {
+        { PositionEncoding::Float32, TexCoordEncoding::Half },
+        { PositionEncoding::Unorm16, TexCoordEncoding::Half },
+        { PositionEncoding::Float32, TexCoordEncoding::Unorm16 },
+        { PositionEncoding::Unorm16, TexCoordEncoding::Unorm16 },
+    };
+
+    // Random vertices with an uneven box, axis-aligned normals and a few tiny UVs
+    MeshData MakeMesh(size_t vertexCount, uint32_t seed) {
+        std::mt19937 rng(seed);
+        std::uniform_real_distribution<float> position(-50.0f, 130.0f);
+        std::uniform_real_distribution<float> direction(-1.0f, 1.0f);
+        std::uniform_real_distribution<float> uv(-3.0f, 5.0f);
+
+        MeshData meshData;
+        for (size_t i = 0; i < vertexCount; ++i) {
+            meshData.vertices.emplace_back(position(rng), position(rng) * 0.1f, position(rng));
+            glm::vec3 normal(direction(rng), direction(rng), direction(rng));
+            if (i % 17 == 0) normal = glm::vec3(0.0f, 0.0f, (i % 2) ? 1.0f : -1.0f);
+            if (i % 23 == 0) normal = glm::vec3(1.0f, 0.0f, 0.0f);
+            meshData.normals.push_back(glm::normalize(normal));
+            meshData.texCoords.emplace_back(uv(rng), (i % 31 == 0) ? 1e-6f : uv(rng));
+        }
+        return meshData;
+    }
+
+    float AngleBetween(const glm::vec3& a, const glm::vec3& b) {
+        return std::atan2(glm::length(glm::cross(a, b)), glm::dot(a, b));
+    }
+}
+
+ANITO3D_TEST(RoundTripStaysWithinErrorBounds) {
+    const MeshData source = MakeMesh(4099, 1);
+    for (const auto& format : Formats) {
+        const PackedMeshData packed = VertexPacker::Pack(source, format);
+        REQUIRE(packed.vertexCount == source.vertices.size());
+        REQUIRE(packed.GetByteSize() == source.vertices.size() * format.GetStride());
+
+        MeshData decoded;
+        VertexPacker::Unpack(packed, decoded);
+        REQUIRE(decoded.vertices.size() == source.vertices.size());
+        REQUIRE(decoded.normals.size() == source.normals.size());
+        REQUIRE(decoded.texCoords.size() == source.texCoords.size());
+
+        const PackingErrorBounds bounds = VertexPacker::GetErrorBounds(packed);
+        float positionError = 0.0f, normalError = 0.0f, texCoordError = 0.0f;
+        for (size_t i = 0; i < source.vertices.size(); ++i) {
+            for (int axis = 0; axis < 3; ++axis) {
+                positionError = std::max(positionError, std::abs(source.vertices[i][axis] - decoded.vertices[i][axis]));
+            }
+            normalError = std::max(normalError, AngleBetween(source.normals[i], decoded.normals[i]));
+            for (int axis = 0; axis < 2; ++axis) {
+                texCoordError = std::max(texCoordError, std::abs(source.texCoords[i][axis] - decoded.texCoords[i][axis]));
+            }
+        }
+
+        CHECK(positionError <= bounds.position);
+        CHECK(normalError <= bounds.normalRadians);
+        CHECK(texCoordError <= bounds.texCoord);
+        if (format.position == PositionEncoding::Float32) CHECK(positionError == 0.0f);
+    }
+}
+
+ANITO3D_TEST(SimdMatchesScalarTail) {
+    // Appending three vertices of the mesh keeps the quantization ranges but sends the copies
+    // through the scalar tail, so they must come out byte for byte like the SIMD blocks
+    const MeshData source = MakeMesh(256, 2);
+    for (const auto& format : Formats) {
+        const PackedMeshData reference = VertexPacker::Pack(source, format);
+        MeshData referenceDecoded;
+        VertexPacker::Unpack(reference, referenceDecoded);
+
+        for (size_t first = 0; first + 3 <= source.vertices.size(); first += 3) {
+            MeshData extended = source;
+            for (size_t i = first; i < first + 3; ++i) {
+                extended.vertices.push_back(source.vertices[i]);
+                extended.normals.push_back(source.normals[i]);
+                extended.texCoords.push_back(source.texCoords[i]);
+            }
+            const PackedMeshData packed = VertexPacker::Pack(extended, format);
+            MeshData decoded;
+            VertexPacker::Unpack(packed, decoded);
+
+            for (size_t i = 0; i < 3; ++i) {
+                const size_t tail = source.vertices.size() + i;
+                CHECK(std::memcmp(packed.vertexData.data() + tail * packed.stride,
+                    reference.vertexData.data() + (first + i) * reference.stride, packed.stride) == 0);
+                CHECK(decoded.vertices[tail] == referenceDecoded.vertices[first + i]);
+                // The SIMD decode scales by reciprocals where the scalar one divides: a few ulps apart
+                CHECK(glm::length(decoded.normals[tail] - referenceDecoded.normals[first + i]) <= 1e-6f);
+                CHECK(decoded.texCoords[tail] == referenceDecoded.texCoords[first + i]);
+            }
+        }
+    }
+}
+
+ANITO3D_TEST(SimdMatchesScalarBuildingBlocks) {
+    const MeshData source = MakeMesh(1024, 3);
+    const PackedVertexFormat format = { PositionEncoding::Float32, TexCoordEncoding::Half };
+    const PackedMeshData packed = VertexPacker::Pack(source, format);
+
+    for (size_t i = 0; i < source.vertices.size(); ++i) {
+        const uint8_t* vertex = packed.vertexData.data() + i * packed.stride;
+        int16_t octX = 0, octY = 0;
+        VertexPacker::EncodeOctahedral(source.normals[i], octX, octY);
+        int16_t packedNormal[2];
+        std::memcpy(packedNormal, vertex + format.GetNormalOffset(), sizeof(packedNormal));
+        CHECK(packedNormal[0] == octX && packedNormal[1] == octY);
+
+        uint16_t packedTexCoord[2];
+        std::memcpy(packedTexCoord, vertex + format.GetTexCoordOffset(), sizeof(packedTexCoord));
+        CHECK(packedTexCoord[0] == VertexPacker::FloatToHalf(source.texCoords[i].x));
+        CHECK(packedTexCoord[1] == VertexPacker::FloatToHalf(source.texCoords[i].y));
+    }
+}
+
+ANITO3D_TEST(HalfConversion) {
+    CHECK(VertexPacker::FloatToHalf(1.0f) == 0x3C00);
+    CHECK(VertexPacker::FloatToHalf(-2.0f) == 0xC000);
+    CHECK(VertexPacker::FloatToHalf(65504.0f) == 0x7BFF);
+    CHECK(VertexPacker::FloatToHalf(0.0f) == 0x0000);
+    CHECK(VertexPacker::HalfToFloat(0x3C00) == 1.0f);
+    CHECK(VertexPacker::HalfToFloat(0x0001) == std::ldexp(1.0f, -24));
+    for (float value : { 0.1f, 0.5f, 3.14159f, -7.25f, 1e-5f }) {
+        CHECK_NEAR(VertexPacker::HalfToFloat(VertexPacker::FloatToHalf(value)), value, std::abs(value) / 2048.0f + 3.0e-8f);
+    }
+}
+
+ANITO3D_TEST(OctahedralPoles) {
+    for (const glm::vec3& normal : { glm::vec3(0, 0, 1), glm::vec3(0, 0, -1), glm::vec3(1, 0, 0), glm::vec3(0, -1, 0) }) {
+        int16_t x = 0, y = 0;
+        VertexPacker::EncodeOctahedral(normal, x, y);
+        CHECK(AngleBetween(VertexPacker::DecodeOctahedral(x, y), normal) < 1e-4f);
+    }
+}